@@ -0,0 +1,488 @@
+/*
+ * @Description: 报警规则引擎，规则编译为按通道分组的平坦数组，在解码线程中对每一帧求值
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 20:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "AlarmEngine.h"
+#include "TimeSeriesStore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+	std::string Trim(const std::string& text)
+	{
+		const size_t begin = text.find_first_not_of(" \t\r");
+		if (begin == std::string::npos)
+		{
+			return std::string();
+		}
+		const size_t end = text.find_last_not_of(" \t\r");
+		return text.substr(begin, end - begin + 1);
+	}
+
+	double ParseNumber(const std::string& text, const std::string& rule)
+	{
+		size_t used = 0;
+		double value = 0.0;
+		try
+		{
+			value = std::stod(text, &used);
+		}
+		catch (const std::exception&)
+		{
+			used = 0;
+		}
+		if (used == 0 || used != text.size() || !std::isfinite(value))
+		{
+			throw std::invalid_argument("Invalid number '" + text + "' in alarm rule '" + rule + "'.");
+		}
+		return value;
+	}
+
+	/**
+	 * @brief 解析时长，单位为 us、ms 或 s，没有单位时按毫秒。
+	 */
+	int64_t ParseDuration(const std::string& text, const std::string& rule)
+	{
+		const size_t unit = text.find_first_not_of("0123456789.");
+		const std::string number = text.substr(0, unit);
+		const std::string suffix = unit == std::string::npos ? std::string("ms") : text.substr(unit);
+		double scale = 0.0;
+		if (suffix == "us")
+		{
+			scale = 1e3;
+		}
+		else if (suffix == "ms")
+		{
+			scale = 1e6;
+		}
+		else if (suffix == "s")
+		{
+			scale = 1e9;
+		}
+		else
+		{
+			throw std::invalid_argument("Unknown duration unit '" + suffix + "' in alarm rule '" + rule + "', expected us, ms or s.");
+		}
+		const double value = ParseNumber(number, rule);
+		if (value < 0)
+		{
+			throw std::invalid_argument("Negative duration in alarm rule '" + rule + "'.");
+		}
+		return static_cast<int64_t>(std::llround(value * scale));
+	}
+}
+
+bool AlarmEngine::Compare(Op op, double x, double limit)
+{
+	switch (op)
+	{
+	case Op::Greater:
+		return x > limit;
+	case Op::GreaterEqual:
+		return x >= limit;
+	case Op::Less:
+		return x < limit;
+	case Op::LessEqual:
+		return x <= limit;
+	}
+	return false;
+}
+
+AlarmEngine::Op AlarmEngine::Inverse(Op op)
+{
+	switch (op)
+	{
+	case Op::Greater:
+		return Op::LessEqual;
+	case Op::GreaterEqual:
+		return Op::Less;
+	case Op::Less:
+		return Op::GreaterEqual;
+	case Op::LessEqual:
+		return Op::Greater;
+	}
+	return op;
+}
+
+/**
+ * @brief 解析一条规则：[名称:] [rate(]通道[)] 运算符 阈值 [clear 恢复阈值] [for 时长]。
+ */
+AlarmEngine::Rule AlarmEngine::ParseRule(const std::string& text, int index)
+{
+	Rule rule;
+	rule.index = index;
+
+	const size_t opPos = text.find_first_of("<>");
+	if (opPos == std::string::npos)
+	{
+		throw std::invalid_argument("Missing comparison operator in alarm rule '" + text + "'.");
+	}
+	std::string lhs = text.substr(0, opPos);
+	const size_t colon = lhs.find(':');
+	if (colon != std::string::npos)
+	{
+		rule.name = Trim(lhs.substr(0, colon));
+		lhs = lhs.substr(colon + 1);
+	}
+	lhs = Trim(lhs);
+	if (lhs.size() > 6 && lhs.compare(0, 5, "rate(") == 0 && lhs.back() == ')')
+	{
+		rule.rate = true;
+		lhs = Trim(lhs.substr(5, lhs.size() - 6));
+	}
+	if (lhs.empty())
+	{
+		throw std::invalid_argument("Missing channel name in alarm rule '" + text + "'.");
+	}
+	rule.channelName = lhs;
+	if (rule.name.empty())
+	{
+		rule.name = "rule" + std::to_string(index + 1);
+	}
+
+	const bool greater = text[opPos] == '>';
+	size_t pos = opPos + 1;
+	const bool orEqual = pos < text.size() && text[pos] == '=';
+	pos += orEqual ? 1 : 0;
+	rule.op = greater ? (orEqual ? Op::GreaterEqual : Op::Greater) : (orEqual ? Op::LessEqual : Op::Less);
+
+	std::vector<std::string> tokens;
+	const std::string rhs = text.substr(pos);
+	size_t at = 0;
+	while (at < rhs.size())
+	{
+		const size_t begin = rhs.find_first_not_of(" \t\r", at);
+		if (begin == std::string::npos)
+		{
+			break;
+		}
+		const size_t end = rhs.find_first_of(" \t\r", begin);
+		tokens.push_back(rhs.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+		at = end == std::string::npos ? rhs.size() : end;
+	}
+	if (tokens.empty())
+	{
+		throw std::invalid_argument("Missing limit in alarm rule '" + text + "'.");
+	}
+	rule.limit = ParseNumber(tokens[0], text);
+
+	for (size_t i = 1; i < tokens.size(); i += 2)
+	{
+		const std::string& keyword = tokens[i];
+		if (i + 1 >= tokens.size())
+		{
+			throw std::invalid_argument("Missing value after '" + keyword + "' in alarm rule '" + text + "'.");
+		}
+		std::string value = tokens[i + 1];
+		if (keyword == "clear")
+		{
+			rule.clearLimit = ParseNumber(value, text);
+			rule.hysteresis = true;
+		}
+		else if (keyword == "for")
+		{
+			// 允许 "for 50 ms" 的写法
+			if (i + 2 < tokens.size() && (tokens[i + 2] == "us" || tokens[i + 2] == "ms" || tokens[i + 2] == "s"))
+			{
+				value += tokens[i + 2];
+				++i;
+			}
+			rule.holdNs = ParseDuration(value, text);
+		}
+		else
+		{
+			throw std::invalid_argument("Unknown keyword '" + keyword + "' in alarm rule '" + text + "', expected clear or for.");
+		}
+	}
+
+	// 滞回的恢复阈值必须在触发阈值的另一侧，否则报警会在触发后立即恢复
+	if (rule.hysteresis && (rule.op == Op::Greater || rule.op == Op::GreaterEqual ? rule.clearLimit > rule.limit : rule.clearLimit < rule.limit))
+	{
+		throw std::invalid_argument("Clear limit is on the wrong side of the limit in alarm rule '" + text + "'.");
+	}
+	return rule;
+}
+
+/**
+ * @brief 编译规则：逐条解析后按通道稳定排序，建立通道编号和每个通道的规则区间。
+ */
+AlarmEngine AlarmEngine::Compile(const std::string& rules)
+{
+	AlarmEngine engine;
+	std::vector<Rule> parsed;
+	size_t begin = 0;
+	while (begin <= rules.size())
+	{
+		size_t end = rules.find_first_of(";\n", begin);
+		if (end == std::string::npos)
+		{
+			end = rules.size();
+		}
+		const std::string text = Trim(rules.substr(begin, end - begin));
+		begin = end + 1;
+		if (text.empty() || text[0] == '#')
+		{
+			continue;
+		}
+		parsed.push_back(ParseRule(text, static_cast<int>(parsed.size())));
+		engine.m_source += text;
+		engine.m_source += '\n';
+	}
+
+	for (Rule& rule : parsed)
+	{
+		auto [it, inserted] = engine.m_channelIds.emplace(rule.channelName, static_cast<int>(engine.m_channelIds.size()));
+		rule.channel = it->second;
+		engine.m_hasDuration = engine.m_hasDuration || rule.holdNs > 0;
+	}
+	std::stable_sort(parsed.begin(), parsed.end(), [](const Rule& a, const Rule& b) { return a.channel < b.channel; });
+
+	const size_t channelCount = engine.m_channelIds.size();
+	engine.m_ranges.assign(channelCount + 1, 0);
+	for (const Rule& rule : parsed)
+	{
+		++engine.m_ranges[static_cast<size_t>(rule.channel) + 1];
+	}
+	for (size_t c = 0; c < channelCount; ++c)
+	{
+		engine.m_ranges[c + 1] += engine.m_ranges[c];
+	}
+	engine.m_ruleSlots.resize(parsed.size());
+	for (size_t i = 0; i < parsed.size(); ++i)
+	{
+		engine.m_ruleSlots[static_cast<size_t>(parsed[i].index)] = static_cast<int>(i);
+	}
+	engine.m_rules = std::move(parsed);
+	return engine;
+}
+
+const std::string& AlarmEngine::RuleName(int rule) const
+{
+	return m_rules[static_cast<size_t>(m_ruleSlots[static_cast<size_t>(rule)])].name;
+}
+
+const std::string& AlarmEngine::RuleChannel(int rule) const
+{
+	return m_rules[static_cast<size_t>(m_ruleSlots[static_cast<size_t>(rule)])].channelName;
+}
+
+int AlarmEngine::ChannelId(const std::string& name) const
+{
+	auto it = m_channelIds.find(name);
+	return it == m_channelIds.end() ? -1 : it->second;
+}
+
+/**
+ * @brief 对一条记录求值。帧头类记录的通道名称只与帧头和字段序号有关，
+ * 第一次遇到某个帧头时查出各字段的通道编号并缓存，之后每帧只做一次查找；
+ * key=value 记录的键名逐条变化，按键名直接查找。
+ */
+void AlarmEngine::OnRecord(int64_t timeNs, const DecodedRecord& record, const std::string& prefix)
+{
+	if (m_rules.empty() || record.values == nullptr)
+	{
+		return;
+	}
+
+	if (record.keys != nullptr)
+	{
+		for (size_t i = 0; i < record.count; ++i)
+		{
+			if (std::isnan(record.values[i]))
+			{
+				continue;
+			}
+			TimeSeriesStore::ChannelKey(record, i, m_keyBuffer);
+			if (!prefix.empty())
+			{
+				m_keyBuffer.insert(0, prefix);
+			}
+			const int channel = ChannelId(m_keyBuffer);
+			if (channel >= 0)
+			{
+				Evaluate(channel, timeNs, record.values[i]);
+			}
+		}
+		return;
+	}
+
+	m_keyBuffer.assign(prefix);
+	m_keyBuffer.append(record.name.data(), record.name.size());
+	auto it = m_recordChannels.find(m_keyBuffer);
+	if (it == m_recordChannels.end())
+	{
+		it = m_recordChannels.emplace(m_keyBuffer, std::vector<int>()).first;
+	}
+	std::vector<int>& channels = it->second;
+	if (channels.size() < record.count)
+	{
+		std::string key;
+		for (size_t i = channels.size(); i < record.count; ++i)
+		{
+			TimeSeriesStore::ChannelKey(record, i, key);
+			channels.push_back(ChannelId(prefix + key));
+		}
+	}
+	for (size_t i = 0; i < record.count; ++i)
+	{
+		if (channels[i] >= 0 && !std::isnan(record.values[i]))
+		{
+			Evaluate(channels[i], timeNs, record.values[i]);
+		}
+	}
+}
+
+void AlarmEngine::OnValue(const std::string& channel, int64_t timeNs, double value)
+{
+	const int id = ChannelId(channel);
+	if (id >= 0 && !std::isnan(value))
+	{
+		Evaluate(id, timeNs, value);
+	}
+}
+
+/**
+ * @brief 顺序求值一个通道的全部规则。
+ * 未触发时比较触发条件，有持续时间要求的规则记录条件开始成立的时间；
+ * 已触发时比较恢复条件（有滞回时与恢复阈值比较，否则为触发条件不成立）。
+ */
+void AlarmEngine::Evaluate(int channel, int64_t timeNs, double value)
+{
+	Rule* rule = m_rules.data() + m_ranges[static_cast<size_t>(channel)];
+	Rule* const end = m_rules.data() + m_ranges[static_cast<size_t>(channel) + 1];
+	m_evaluations += static_cast<uint64_t>(end - rule);
+	for (; rule != end; ++rule)
+	{
+		double x = value;
+		if (rule->rate)
+		{
+			const bool hasLast = rule->hasLast;
+			const double dt = (timeNs - rule->lastNs) / 1e9;
+			const double last = rule->last;
+			rule->hasLast = true;
+			rule->last = value;
+			rule->lastNs = timeNs;
+			if (!hasLast || dt <= 0)
+			{
+				continue;
+			}
+			x = (value - last) / dt;
+		}
+		rule->lastMetric = x;
+
+		if (!rule->active)
+		{
+			if (!Compare(rule->op, x, rule->limit))
+			{
+				if (rule->pending)
+				{
+					rule->pending = false;
+					--m_pendingCount;
+				}
+			}
+			else if (rule->holdNs == 0)
+			{
+				Raise(*rule, timeNs);
+			}
+			else if (!rule->pending)
+			{
+				rule->pending = true;
+				rule->sinceNs = timeNs;
+				++m_pendingCount;
+			}
+			else if (timeNs - rule->sinceNs >= rule->holdNs)
+			{
+				Raise(*rule, timeNs);
+			}
+			continue;
+		}
+
+		const bool clear = rule->hysteresis ? Compare(Inverse(rule->op), x, rule->clearLimit)
+			: !Compare(rule->op, x, rule->limit);
+		if (clear)
+		{
+			rule->active = false;
+			--m_activeCount;
+			if (m_handler)
+			{
+				m_handler(AlarmEvent{ rule->index, false, x, timeNs });
+			}
+		}
+	}
+}
+
+void AlarmEngine::Raise(Rule& rule, int64_t timeNs)
+{
+	if (rule.pending)
+	{
+		rule.pending = false;
+		--m_pendingCount;
+	}
+	rule.active = true;
+	++m_activeCount;
+	if (m_handler)
+	{
+		m_handler(AlarmEvent{ rule.index, true, rule.lastMetric, timeNs });
+	}
+}
+
+/**
+ * @brief 没有等待中的规则时直接返回；否则触发持续时间已满的规则。
+ */
+void AlarmEngine::Tick(int64_t nowNs)
+{
+	if (m_pendingCount == 0)
+	{
+		return;
+	}
+	for (Rule& rule : m_rules)
+	{
+		if (rule.pending && nowNs - rule.sinceNs >= rule.holdNs)
+		{
+			Raise(rule, nowNs);
+		}
+	}
+}
+
+void AlarmEngine::Reset(const std::string& prefix)
+{
+	for (Rule& rule : m_rules)
+	{
+		if (rule.channelName.compare(0, prefix.size(), prefix) != 0)
+		{
+			continue;
+		}
+		m_pendingCount -= rule.pending ? 1 : 0;
+		m_activeCount -= rule.active ? 1 : 0;
+		rule.active = false;
+		rule.pending = false;
+		rule.hasLast = false;
+	}
+}
+
+std::string AlarmEngine::Format(const AlarmEvent& event) const
+{
+	const Rule& rule = m_rules[static_cast<size_t>(m_ruleSlots[static_cast<size_t>(event.rule)])];
+	char text[64];
+	std::snprintf(text, sizeof(text), "%.6f %s ", event.timeNs / 1e9, event.raised ? "RAISE" : "CLEAR");
+	std::string line = text;
+	line += rule.name;
+	line += ' ';
+	if (rule.rate)
+	{
+		line += "rate(" + rule.channelName + ")";
+	}
+	else
+	{
+		line += rule.channelName;
+	}
+	std::snprintf(text, sizeof(text), "=%g", event.value);
+	line += text;
+	return line;
+}
@@ -0,0 +1,166 @@
+/*
+ * @Description: 报警规则引擎，规则编译为按通道分组的平坦数组，在解码线程中对每一帧求值
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 20:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief 一次报警状态变化。
+ */
+struct AlarmEvent
+{
+	int rule;       /**< 规则序号，名称见 AlarmEngine::RuleName。 */
+	bool raised;    /**< true 为触发，false 为恢复。 */
+	double value;   /**< 触发或恢复时的数值，变化率规则为每秒变化量。 */
+	int64_t timeNs; /**< 触发或恢复的时间，与 OnRecord 传入的时间基准相同。 */
+};
+
+/**
+ * @brief AlarmEngine 对解码数值求值报警规则。
+ *
+ * 规则文本每行（或以分号分隔）一条：
+ *   [名称:] 通道 运算符 阈值 [clear 恢复阈值] [for 时长]
+ *   [名称:] rate(通道) 运算符 阈值 [clear 恢复阈值] [for 时长]
+ * 运算符为 > >= < <=；通道名称与曲线窗口相同（例如 START1.P、START1.3、key=value 的键名）；
+ * clear 给出滞回的恢复阈值，未给出时条件不成立即恢复；for 要求条件持续成立的时间（us、ms、s）；
+ * rate() 为相邻两个样本的每秒变化量。例如：
+ *   overheat: START1.D > 50 for 50ms
+ *   START2.P < 0 clear 5
+ *   rate(START1.P) > 100
+ *
+ * 编译时规则按通道排序为一个平坦数组，每条规则的参数和状态放在同一个结构体中，
+ * 每个通道对应数组中的一段。收到一个数值时只查一次通道编号，再顺序求值这一段，
+ * 不涉及规则总数，因此几千条规则也只在有规则的通道上产生开销。
+ * 报警在 OnRecord 内同步回调，检测延迟只取决于数据到达的时刻。
+ */
+class AlarmEngine
+{
+public:
+	using Handler = std::function<void(const AlarmEvent&)>;
+
+	/**
+	 * @brief 编译规则文本，空文本得到没有规则的引擎。
+	 * @throw std::invalid_argument 如果某条规则无法解析，信息中包含规则序号。
+	 */
+	static AlarmEngine Compile(const std::string& rules);
+
+	/**
+	 * @brief 设置报警回调，在调用 OnRecord/OnValue/Tick 的线程中调用。
+	 */
+	void SetHandler(Handler handler) { m_handler = std::move(handler); }
+
+	/**
+	 * @brief 对一条解码记录中的所有数值求值。
+	 * @param timeNs 时间（纳秒）。
+	 * @param record 解码记录。
+	 * @param prefix 加在通道名称前的前缀，多个串口时用于区分同名通道。
+	 */
+	void OnRecord(int64_t timeNs, const DecodedRecord& record, const std::string& prefix = std::string());
+
+	/**
+	 * @brief 对一个数值求值。
+	 */
+	void OnValue(const std::string& channel, int64_t timeNs, double value);
+
+	/**
+	 * @brief 检查持续时间规则：条件成立后没有新样本到达时，由定时器按时触发。
+	 */
+	void Tick(int64_t nowNs);
+
+	/**
+	 * @brief 清除规则的状态，不产生恢复事件，例如串口断开后数据不再连续时。
+	 * @param prefix 只清除通道名称以此开头的规则，为空时清除所有规则。
+	 */
+	void Reset(const std::string& prefix = std::string());
+
+	bool IsEmpty() const { return m_rules.empty(); }
+	size_t RuleCount() const { return m_rules.size(); }
+	bool HasDurationRules() const { return m_hasDuration; }
+	const std::string& RuleName(int rule) const;
+	const std::string& RuleChannel(int rule) const;
+
+	/**
+	 * @brief 处于触发状态的规则数量。
+	 */
+	size_t ActiveCount() const { return m_activeCount; }
+
+	/**
+	 * @brief 累计的规则求值次数。
+	 */
+	uint64_t Evaluations() const { return m_evaluations; }
+
+	/**
+	 * @brief 规则的原文，每行一条。
+	 */
+	const std::string& Source() const { return m_source; }
+
+	/**
+	 * @brief 把事件格式化为一行文本：秒数 RAISE|CLEAR 规则名 通道=数值。
+	 */
+	std::string Format(const AlarmEvent& event) const;
+
+private:
+	enum class Op : uint8_t
+	{
+		Greater,
+		GreaterEqual,
+		Less,
+		LessEqual
+	};
+
+	/**
+	 * @brief 一条编译后的规则，参数与状态放在一起，求值时只访问这一块内存。
+	 */
+	struct Rule
+	{
+		int channel = 0;          /**< 通道编号。 */
+		Op op = Op::Greater;      /**< 比较运算符。 */
+		bool rate = false;        /**< 是否按变化率比较。 */
+		bool hysteresis = false;  /**< 是否有单独的恢复阈值。 */
+		double limit = 0.0;       /**< 触发阈值。 */
+		double clearLimit = 0.0;  /**< 恢复阈值。 */
+		int64_t holdNs = 0;       /**< 条件需要持续的时间。 */
+
+		bool active = false;      /**< 是否处于触发状态。 */
+		bool pending = false;     /**< 条件成立、正在等待持续时间。 */
+		bool hasLast = false;     /**< 是否有上一个样本（变化率规则）。 */
+		int64_t sinceNs = 0;      /**< 条件开始成立的时间。 */
+		int64_t lastNs = 0;       /**< 上一个样本的时间。 */
+		double last = 0.0;        /**< 上一个样本的数值。 */
+		double lastMetric = 0.0;  /**< 上一次比较的数值，Tick 触发时报告。 */
+
+		int index = 0;            /**< 在规则文本中的序号。 */
+		std::string name;         /**< 规则名称。 */
+		std::string channelName;  /**< 通道名称。 */
+	};
+
+	static bool Compare(Op op, double x, double limit);
+	static Op Inverse(Op op);
+	static Rule ParseRule(const std::string& text, int index);
+
+	int ChannelId(const std::string& name) const;
+	void Evaluate(int channel, int64_t timeNs, double value);
+	void Raise(Rule& rule, int64_t timeNs);
+
+	std::vector<Rule> m_rules;                       /**< 按通道排序的规则。 */
+	std::vector<size_t> m_ranges;                    /**< 通道 c 的规则为 [m_ranges[c], m_ranges[c + 1])。 */
+	std::vector<int> m_ruleSlots;                    /**< 规则序号到 m_rules 下标的映射。 */
+	std::unordered_map<std::string, int> m_channelIds; /**< 通道名称到编号的映射，只包含有规则的通道。 */
+	std::unordered_map<std::string, std::vector<int>> m_recordChannels; /**< 帧头名称到各字段通道编号的缓存，-1 表示没有规则。 */
+	std::string m_keyBuffer;                         /**< 生成通道名称的缓冲。 */
+	std::string m_source;                            /**< 规则原文。 */
+	Handler m_handler;                               /**< 报警回调。 */
+	size_t m_pendingCount = 0;                       /**< 正在等待持续时间的规则数量。 */
+	size_t m_activeCount = 0;                        /**< 处于触发状态的规则数量。 */
+	uint64_t m_evaluations = 0;                      /**< 累计求值次数。 */
+	bool m_hasDuration = false;                      /**< 是否有持续时间规则。 */
+};
@@ -0,0 +1,1165 @@
+/*
+ * @Description: 命令行采集程序入口，只依赖 QtCore 与 QtSerialPort，不创建任何控件
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 10:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QFile>
+#include <QtCore/QTimer>
+#include <QtSerialPort/QSerialPortInfo>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <stdexcept>
+#include "AlarmEngine.h"
+#include "CrashHandler.h"
+#include "DecoderBench.h"
+#include "DerivedChannels.h"
+#include "FilterWorker.h"
+#include "StepWorker.h"
+#include "FlightRecorder.h"
+#include "HeadlessCapture.h"
+#include "ModbusBench.h"
+#include "ModbusSlaveSim.h"
+#include "ParallelDecoder.h"
+#include "PtyEcho.h"
+#include "SerialBackendBench.h"
+#include "TimeSeriesStore.h"
+#include "TraceRecorder.h"
+#include "WatchList.h"
+
+namespace
+{
+	std::atomic<bool> g_stopRequested{ false };
+	bool g_verbose = false;
+
+	/**
+	 * @brief SIGINT/SIGTERM 处理函数，只设置标志位，由事件循环中的定时器负责退出。
+	 */
+	void RequestStop(int)
+	{
+		g_stopRequested.store(true);
+	}
+
+	/**
+	 * @brief 命令行模式的日志处理函数。
+	 * 采集时 qDebug 输出会按数据块触发，默认丢弃以免拖慢采集，--verbose 时才输出。
+	 */
+	void MessageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+	{
+		if (type == QtDebugMsg && !g_verbose)
+		{
+			return;
+		}
+		std::fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+	}
+
+	/**
+	 * @brief 把以逗号分隔的选项值拆分为列表，并兼容重复给出的选项。
+	 */
+	QStringList SplitValues(const QStringList& values)
+	{
+		QStringList result;
+		for (const QString& value : values)
+		{
+			for (const QString& item : value.split(',', Qt::SkipEmptyParts))
+			{
+				result << item.trimmed();
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * @brief 读取规则类选项：值是已存在的文件时读取文件内容，否则按原样作为内联定义。
+	 * @return 文件无法读取时返回 false。
+	 */
+	bool ReadSpec(const QString& value, QString& spec)
+	{
+		spec = value;
+		if (value.isEmpty() || !QFile::exists(value))
+		{
+			return true;
+		}
+		QFile file(value);
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			std::fprintf(stderr, "Error: cannot read %s\n", value.toLocal8Bit().constData());
+			return false;
+		}
+		spec = QString::fromUtf8(file.readAll());
+		return true;
+	}
+
+	/**
+	 * @brief 运行解码器基准测试。
+	 * 指定 --bench-file 时所有被测解码器使用同一份采集数据，否则每个解码器使用各自协议的合成数据。
+	 * @return 进程退出码。
+	 */
+	int RunBench(const QCommandLineParser& parser)
+	{
+		QStringList decoders = SplitValues(parser.values("decoder"));
+		if (!parser.isSet("decoder"))
+		{
+			decoders.clear();
+			for (const std::string& name : DecoderRegistry::Instance().Names())
+			{
+				decoders << QString::fromStdString(name);
+			}
+		}
+
+		std::string capture;
+		if (parser.isSet("bench-file"))
+		{
+			QFile file(parser.value("bench-file"));
+			if (!file.open(QIODevice::ReadOnly))
+			{
+				std::fprintf(stderr, "Error: %s\n", file.errorString().toLocal8Bit().constData());
+				return 1;
+			}
+			const QByteArray content = file.readAll();
+			capture.assign(content.constData(), static_cast<size_t>(content.size()));
+		}
+
+		const size_t chunkSize = static_cast<size_t>(parser.value("bench-chunk").toULongLong());
+		const int repeat = parser.value("bench-repeat").toInt();
+		for (const QString& name : decoders)
+		{
+			std::unique_ptr<ProtocolDecoder> decoder;
+			try
+			{
+				decoder = DecoderRegistry::Instance().Create(name.toStdString());
+			}
+			catch (const std::exception& e)
+			{
+				std::fprintf(stderr, "Error: %s\n", e.what());
+				return 1;
+			}
+			const std::string data = capture.empty()
+				? DecoderBench::GenerateSample(name.toStdString(), 16u << 20)
+				: capture;
+			const DecoderBenchResult result = DecoderBench::Run(*decoder, data, chunkSize, repeat);
+			std::printf("%s\n", DecoderBench::Format(result).c_str());
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief 滤波基准测试：32 个通道各 1 kHz、共 60 秒的合成数据经 FilterWorker 处理，
+	 * 输出工作线程的处理速率及其在实时 1 kHz x 32 通道下的占用率。
+	 * @return 进程退出码。
+	 */
+	int RunFilterBench(const QCommandLineParser& parser)
+	{
+		constexpr int kChannels = 32;
+		constexpr int kRateHz = 1000;
+		constexpr int kSeconds = 60;
+
+		const std::string spec = parser.isSet("filter")
+			? parser.value("filter").toStdString() : "*=median:5,lowpass:20:1000,kalman:0.01:1";
+		FilterWorker worker;
+		try
+		{
+			worker.SetConfig(FilterConfig::Parse(spec));
+		}
+		catch (const std::invalid_argument& e)
+		{
+			std::fprintf(stderr, "Error: %s\n", e.what());
+			return 1;
+		}
+
+		std::vector<std::string> names;
+		for (int c = 0; c < kChannels; ++c)
+		{
+			names.push_back("START" + std::to_string(c / 3 + 1) + "." + std::to_string(c % 3));
+		}
+		std::vector<FilteredSample> output;
+		uint64_t drained = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < kRateHz * kSeconds; ++i)
+		{
+			const double t = static_cast<double>(i) / kRateHz;
+			for (int c = 0; c < kChannels; ++c)
+			{
+				// 正弦加确定性的伪噪声，保证每次运行的数据相同
+				const double noise = ((i * 7919 + c * 104729) % 2001) / 1000.0 - 1.0;
+				worker.Push(names[static_cast<size_t>(c)], t, std::sin(t * (c + 1)) + 0.1 * noise);
+			}
+			if (i % 100 == 0)
+			{
+				output.clear();
+				drained += worker.Drain(output);
+			}
+		}
+		worker.Flush();
+		output.clear();
+		drained += worker.Drain(output);
+		const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const double busy = worker.BusySeconds();
+		std::printf("filter %s\n", worker.Config().Describe().c_str());
+		std::printf("%d channels x %d Hz x %d s: %llu samples, wall %.3f s, worker %.3f s (%.1f Msamples/s)\n",
+			kChannels, kRateHz, kSeconds, static_cast<unsigned long long>(drained), wall, busy,
+			busy > 0 ? drained / busy / 1e6 : 0.0);
+		std::printf("worker load at real-time rate: %.3f%% of one core\n", busy / kSeconds * 100.0);
+		return 0;
+	}
+
+	/**
+	 * @brief 阶跃分析基准测试：16 个控制器各 1 kHz、共 60 秒的合成数据经 StepWorker 处理。
+	 * 每个控制器是一个二阶对象，设定值每 2 秒阶跃一次，增益每 20 秒更换一次，阻尼随增益变化，
+	 * 输出完成的阶跃数、工作线程的处理速率及其在实时速率下的占用率，最后打印第一个控制器的增益组历史。
+	 * @return 进程退出码。
+	 */
+	int RunStepBench()
+	{
+		constexpr int kControllers = 16;
+		constexpr int kRateHz = 1000;
+		constexpr int kSeconds = 60;
+		constexpr double kDt = 1.0 / kRateHz;
+
+		std::string spec;
+		for (int c = 1; c <= kControllers; ++c)
+		{
+			const std::string name = "START" + std::to_string(c);
+			spec += name + ": sp=" + name + ".sp pv=" + name + ".pv window=2 hold=0.3;";
+		}
+		StepWorker worker;
+		worker.SetConfig(StepConfig::Parse(spec));
+
+		struct Plant
+		{
+			std::string sp, pv, gains[3];
+			double x = 0.0, v = 0.0, setpoint = 0.0;
+		};
+		std::vector<Plant> plants(kControllers);
+		for (int c = 0; c < kControllers; ++c)
+		{
+			const std::string name = "START" + std::to_string(c + 1);
+			plants[static_cast<size_t>(c)].sp = name + ".sp";
+			plants[static_cast<size_t>(c)].pv = name + ".pv";
+			plants[static_cast<size_t>(c)].gains[0] = name + ".P";
+			plants[static_cast<size_t>(c)].gains[1] = name + ".I";
+			plants[static_cast<size_t>(c)].gains[2] = name + ".D";
+		}
+
+		std::vector<StepResult> output;
+		uint64_t drained = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < kRateHz * kSeconds; ++i)
+		{
+			const double t = i * kDt;
+			const int gainSet = i / (kRateHz * 20);
+			for (int c = 0; c < kControllers; ++c)
+			{
+				Plant& plant = plants[static_cast<size_t>(c)];
+				if (i % (kRateHz * 2) == 0)
+				{
+					plant.setpoint = (i / (kRateHz * 2)) % 2 == 0 ? 10.0 + c : 0.0;
+					worker.Push(plant.sp, t, plant.setpoint);
+				}
+				const double kp = 1.0 + gainSet * 0.5;
+				if (i % 100 == 0)
+				{
+					worker.Push(plant.gains[0], t, kp);
+					worker.Push(plant.gains[1], t, 0.1);
+					worker.Push(plant.gains[2], t, 0.02 * (c + 1));
+				}
+				const double wn = 8.0 + c;
+				const double zeta = 0.2 + 0.2 * gainSet;
+				plant.v += (wn * wn * (plant.setpoint - plant.x) - 2.0 * zeta * wn * plant.v) * kDt;
+				plant.x += plant.v * kDt;
+				worker.Push(plant.pv, t, plant.x);
+			}
+			if (i % 100 == 0)
+			{
+				output.clear();
+				drained += worker.Drain(output);
+			}
+		}
+		worker.Flush(true);
+		output.clear();
+		drained += worker.Drain(output);
+		const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const double busy = worker.BusySeconds();
+		const uint64_t samples = worker.ProcessedSamples();
+		std::printf("%d controllers x %d Hz x %d s: %llu samples, %llu steps, wall %.3f s, worker %.3f s (%.1f Msamples/s)\n",
+			kControllers, kRateHz, kSeconds, static_cast<unsigned long long>(samples),
+			static_cast<unsigned long long>(drained), wall, busy, busy > 0 ? samples / busy / 1e6 : 0.0);
+		std::printf("worker load at real-time rate: %.3f%% of one core\n", busy / kSeconds * 100.0);
+		std::printf("%s", FormatGainHistory("START1", worker.History(0)).c_str());
+		return 0;
+	}
+
+	/**
+	 * @brief 报警基准测试：在 16 个帧头共 48 个通道上生成指定数量的规则（阈值、滞回、变化率、持续时间轮流），
+	 * 对一百万条合成 PID 帧求值，输出每帧耗时和从调用 OnRecord 到回调的检测延迟。
+	 * @return 进程退出码。
+	 */
+	int RunAlarmBench(const QCommandLineParser& parser)
+	{
+		constexpr int kHeaders = 16;
+		constexpr int kFrames = 1000000;
+		static const char* const kFields[] = { "P", "I", "D" };
+
+		const int ruleCount = parser.value("alarm-bench").toInt();
+		if (ruleCount <= 0)
+		{
+			std::fprintf(stderr, "Error: --alarm-bench needs a positive rule count.\n");
+			return 1;
+		}
+		std::string spec;
+		for (int i = 0; i < ruleCount; ++i)
+		{
+			const std::string channel = "START" + std::to_string(i % kHeaders + 1) + "." + kFields[(i / kHeaders) % 3];
+			const int limit = 50 + i % 40;
+			switch (i % 4)
+			{
+			case 0:
+				spec += channel + " > " + std::to_string(limit);
+				break;
+			case 1:
+				spec += channel + " > " + std::to_string(limit) + " clear " + std::to_string(limit - 10);
+				break;
+			case 2:
+				spec += "rate(" + channel + ") > " + std::to_string(limit * 100);
+				break;
+			default:
+				spec += channel + " < " + std::to_string(limit - 40) + " for 2ms";
+				break;
+			}
+			spec += '\n';
+		}
+		AlarmEngine engine = AlarmEngine::Compile(spec);
+
+		uint64_t events = 0;
+		int64_t latencySumNs = 0;
+		int64_t latencyMaxNs = 0;
+		engine.SetHandler([&](const AlarmEvent& event) {
+			const int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count() - event.timeNs;
+			++events;
+			latencySumNs += latency;
+			latencyMaxNs = std::max(latencyMaxNs, latency);
+			});
+
+		std::vector<std::string> names;
+		for (int h = 0; h < kHeaders; ++h)
+		{
+			names.push_back("START" + std::to_string(h + 1));
+		}
+		double values[3];
+		DecodedRecord record;
+		record.kind = RecordKind::PidFrame;
+		record.values = values;
+		record.count = 3;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < kFrames; ++i)
+		{
+			const int h = i % kHeaders;
+			const double phase = i * 1e-4 * (h + 1);
+			values[0] = 50 + 45 * std::sin(phase);
+			values[1] = 50 + 45 * std::sin(phase * 1.3);
+			values[2] = 50 + 45 * std::sin(phase * 0.7);
+			record.index = static_cast<size_t>(h);
+			record.name = names[static_cast<size_t>(h)];
+			const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+			engine.OnRecord(now, record);
+			if (i % 64 == 0)
+			{
+				engine.Tick(now);
+			}
+		}
+		const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::printf("%zu rules, %d frames: %.1f ns/frame, %.2f ns/rule evaluation, %llu evaluations\n",
+			engine.RuleCount(), kFrames, wall / kFrames * 1e9,
+			engine.Evaluations() > 0 ? wall / engine.Evaluations() * 1e9 : 0.0,
+			static_cast<unsigned long long>(engine.Evaluations()));
+		std::printf("%llu events, detection latency mean %.0f ns max %.1f us\n",
+			static_cast<unsigned long long>(events), events > 0 ? static_cast<double>(latencySumNs) / events : 0.0,
+			latencyMaxNs / 1e3);
+		return 0;
+	}
+
+	/**
+	 * @brief 派生通道基准测试：对一百万条合成 PID 帧（START1 到 START3 轮流）求值，输出每个表达式的平均耗时。
+	 * @return 进程退出码。
+	 */
+	int RunDerivedBench(const QCommandLineParser& parser)
+	{
+		constexpr int kFrames = 1000000;
+		QString text;
+		if (!ReadSpec(parser.value("derived"), text))
+		{
+			return 1;
+		}
+		const std::string spec = !text.isEmpty() ? text.toStdString()
+			: "u1 = START1.P * 2.5 + START1.I * 0.1 - START1.D\n"
+			"u2 = START2.P * 1.8 + 32\n"
+			"mag = hypot(START3.P, START3.I)\n"
+			"sat = clamp(u1, -100, 100) / (1 + abs(START1.D))\n"
+			"err = u1 - u2 * 0.5 + sqrt(abs(mag))";
+		DerivedChannels derived;
+		try
+		{
+			derived = DerivedChannels::Compile(spec);
+		}
+		catch (const std::invalid_argument& e)
+		{
+			std::fprintf(stderr, "Error: %s\n", e.what());
+			return 1;
+		}
+
+		static const char* const kNames[] = { "START1", "START2", "START3" };
+		double values[3];
+		DecodedRecord record;
+		record.kind = RecordKind::PidFrame;
+		record.values = values;
+		record.count = 3;
+		uint64_t outputs = 0;
+		double checksum = 0;
+		auto sink = MakeRecordSink([&](const DecodedRecord& out) {
+			outputs += out.count;
+			checksum += out.values[0];
+			});
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < kFrames; ++i)
+		{
+			record.index = static_cast<size_t>(i % 3);
+			record.name = kNames[i % 3];
+			values[0] = i * 0.001;
+			values[1] = 1.0 + (i % 100);
+			values[2] = -0.5 * (i % 7);
+			derived.OnRecord(record, sink);
+		}
+		const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::printf("%zu derived channels, %zu bytecode instructions, %d frames: %llu evaluations, %llu outputs (checksum %g)\n",
+			derived.Count(), derived.CodeSize(), kFrames, static_cast<unsigned long long>(derived.Evaluations()),
+			static_cast<unsigned long long>(outputs), checksum);
+		std::printf("%.1f ns/frame, %.1f ns/expression including input lookup\n", wall / kFrames * 1e9,
+			derived.Evaluations() > 0 ? wall / derived.Evaluations() * 1e9 : 0.0);
+		return 0;
+	}
+
+	/**
+	 * @brief 历史存储基准测试：三种典型信号各 1 kHz、共 1 小时的合成数据写入 LodSeries，
+	 * 时间戳按串口数据块到达的方式生成（每 8 个样本共用一个带抖动的时间），
+	 * 输出每个样本占用的内存及与未压缩布局（16 字节样本加每 16 个样本一组的摘要，约 21 字节）的比值、
+	 * 追加和顺序解码每个样本的耗时，以及全范围和 10 秒窗口按 1920 像素查询的耗时。
+	 * @return 进程退出码。
+	 */
+	int RunHistoryBench()
+	{
+		constexpr int kRateHz = 1000;
+		constexpr int kSeconds = 3600;
+		constexpr size_t kSamples = static_cast<size_t>(kRateHz) * kSeconds;
+		constexpr size_t kPixels = 1920;
+		constexpr double kUncompressedBytes = 16.0 + 2.0 * 40.0 / 16.0;
+		static const char* const kSignals[] = { "constant gain", "float sine + noise", "counter" };
+
+		for (int signal = 0; signal < 3; ++signal)
+		{
+			std::vector<double> times(kSamples);
+			std::vector<double> values(kSamples);
+			for (size_t i = 0; i < kSamples; ++i)
+			{
+				// 确定性的伪随机抖动，保证每次运行的数据相同
+				const size_t chunk = i / 8 * 8;
+				times[i] = static_cast<double>(chunk + 8) / kRateHz + ((chunk * 7919) % 200) * 1e-6;
+				const double noise = ((i * 104729) % 2001) / 1000.0 - 1.0;
+				switch (signal)
+				{
+				case 0: values[i] = 2.5; break;
+				case 1: values[i] = static_cast<float>(std::sin(i * 0.002) * 100.0 + noise * 0.5); break;
+				default: values[i] = static_cast<double>(i / 10); break;
+				}
+			}
+
+			LodSeries series;
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < kSamples; ++i)
+			{
+				series.Append(times[i], values[i]);
+			}
+			const double encode = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			CompressedSeries::Cursor cursor(series.Samples());
+			cursor.Seek(series.Begin());
+			double checksum = 0.0;
+			start = std::chrono::steady_clock::now();
+			do
+			{
+				checksum += cursor.Value();
+			} while (cursor.Next());
+			const double decode = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::vector<LodBucket> buckets;
+			int level = 0;
+			start = std::chrono::steady_clock::now();
+			series.Query(series.FirstTime(), series.LastTime(), kPixels, buckets, &level);
+			const double queryAll = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			const double t0 = series.FirstTime() + kSeconds / 2;
+			start = std::chrono::steady_clock::now();
+			series.Query(t0, t0 + 10.0, kPixels, buckets);
+			const double queryWindow = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			const double bytes = static_cast<double>(series.MemoryBytes()) / kSamples;
+			std::printf("%-18s %zu samples: %.3f B/sample (%.1fx vs uncompressed), append %.1f ns/sample, "
+				"decode %.1f ns/sample (checksum %g), query all %.3f ms (level %d), query 10 s %.3f ms\n",
+				kSignals[signal], kSamples, bytes, kUncompressedBytes / bytes, encode / kSamples * 1e9,
+				decode / kSamples * 1e9, checksum, queryAll * 1e3, level, queryWindow * 1e3);
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief 监视列表基准测试：生成指定数量的模式（ERR、WDT reset、四位故障码和告警短语），
+	 * 以 4 KB 数据块扫描 64 MB 混有固件日志的合成遥测文本，对 1、10、100 个模式和指定数量分别输出每字节耗时，
+	 * 用于确认扫描开销与模式数量无关。
+	 * @return 进程退出码。
+	 */
+	int RunWatchBench(const QCommandLineParser& parser)
+	{
+		constexpr size_t kBytes = size_t(64) << 20;
+		constexpr size_t kChunk = 4096;
+
+		const int patternCount = parser.value("watch-bench").toInt();
+		if (patternCount <= 0)
+		{
+			std::fprintf(stderr, "Error: --watch-bench needs a positive pattern count.\n");
+			return 1;
+		}
+		std::vector<std::string> patterns = { "ERR", "WDT reset" };
+		for (int i = 0; static_cast<int>(patterns.size()) < patternCount; ++i)
+		{
+			char text[48];
+			if (i % 2 == 0)
+			{
+				std::snprintf(text, sizeof(text), "E%04d", i / 2);
+			}
+			else
+			{
+				std::snprintf(text, sizeof(text), "fault %d: phase %c", i / 2, "UVW"[i % 3]);
+			}
+			patterns.push_back(text);
+		}
+
+		// 确定性的合成数据：遥测帧为主，约每 50 行一条固件日志
+		std::string data;
+		data.reserve(kBytes + 128);
+		for (uint64_t line = 0; data.size() < kBytes; ++line)
+		{
+			char text[96];
+			if (line % 50 == 7)
+			{
+				std::snprintf(text, sizeof(text), "[E] ERR E%04u fault %u: phase %c\n",
+					static_cast<unsigned>(line * 7919 % 1000), static_cast<unsigned>(line % 500), "UVW"[line % 3]);
+			}
+			else if (line % 50 == 31)
+			{
+				std::snprintf(text, sizeof(text), "[W] WDT reset after %u ms\n", static_cast<unsigned>(line % 1000));
+			}
+			else
+			{
+				std::snprintf(text, sizeof(text), "START%u\n%.3f\n%.3f\n%.3f\nEND\n", static_cast<unsigned>(line % 3 + 1),
+					(line % 1000) * 0.01, (line % 777) * 0.1, (line % 333) * -0.5);
+			}
+			data += text;
+		}
+
+		std::vector<size_t> counts = { 1, 10, 100 };
+		counts.erase(std::remove_if(counts.begin(), counts.end(),
+			[&](size_t count) { return count >= patterns.size(); }), counts.end());
+		counts.push_back(patterns.size());
+		for (const size_t count : counts)
+		{
+			std::string spec;
+			for (size_t i = 0; i < count; ++i)
+			{
+				spec += patterns[i];
+				spec += '\n';
+			}
+			WatchList watch = WatchList::Compile(spec);
+			uint64_t events = 0;
+			watch.SetHandler([&events](const WatchHit&) { ++events; });
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t offset = 0; offset < data.size(); offset += kChunk)
+			{
+				watch.Scan(0, ByteSpan(data.data() + offset, std::min(kChunk, data.size() - offset)), static_cast<int64_t>(offset));
+			}
+			const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::printf("%5zu patterns: %zu states x %zu byte classes (%zu KB), %.2f ns/byte (%.0f MB/s), %llu hits\n",
+				count, watch.StateCount(), watch.ClassCount(), watch.TableBytes() / 1024, wall / data.size() * 1e9,
+				data.size() / wall / 1e6, static_cast<unsigned long long>(events));
+			std::printf("      top: %s\n", watch.FormatCounts(5).c_str());
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief 串口后端基准测试：同样的伪终端数据流和探测帧分别经过 QSerialPort 和原生后端。
+	 * @return 进程退出码。
+	 */
+	int RunSerialBench(const QCommandLineParser& parser)
+	{
+		const uint64_t bytes = parser.value("serial-bench-mb").toULongLong() * 1000000ull;
+		constexpr int kPings = 2000;
+		std::vector<SerialInfo::Backend> backends{ SerialInfo::Backend::QtSerialPort };
+		if (NativeSerialPort::IsSupported())
+		{
+			backends.push_back(SerialInfo::Backend::Native);
+		}
+		for (const SerialInfo::Backend backend : backends)
+		{
+			try
+			{
+				std::printf("%s\n", SerialBackendBench::Format(SerialBackendBench::Run(backend, bytes, kPings)).c_str());
+			}
+			catch (const std::runtime_error& e)
+			{
+				std::fprintf(stderr, "Error: %s\n", e.what());
+				return 1;
+			}
+			std::fflush(stdout);
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief 双口转发基准测试：两对伪终端模拟设备和控制器，分别用两种后端测量两个方向的转发延迟。
+	 * @return 进程退出码。
+	 */
+	int RunRelayBench(const QCommandLineParser& parser)
+	{
+		const int messages = parser.value("relay-bench").toInt();
+		if (messages <= 0)
+		{
+			std::fprintf(stderr, "Error: --relay-bench needs a positive message count.\n");
+			return 1;
+		}
+		std::vector<SerialInfo::Backend> backends{ SerialInfo::Backend::QtSerialPort };
+		if (NativeSerialPort::IsSupported())
+		{
+			backends.push_back(SerialInfo::Backend::Native);
+		}
+		for (const SerialInfo::Backend backend : backends)
+		{
+			try
+			{
+				std::printf("%s\n", SerialBackendBench::Format(SerialBackendBench::RunRelay(backend, messages)).c_str());
+			}
+			catch (const std::runtime_error& e)
+			{
+				std::fprintf(stderr, "Error: %s\n", e.what());
+				return 1;
+			}
+			std::fflush(stdout);
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief 断线重连基准测试：用伪终端模拟 USB 转串口反复拔插，分别测量两种后端检测断开和重新打开的时间。
+	 * @return 进程退出码，有周期没有重连成功或丢帧时为 1。
+	 */
+	int RunReconnectBench(const QCommandLineParser& parser)
+	{
+		const int cycles = parser.value("reconnect-bench").toInt();
+		if (cycles <= 0)
+		{
+			std::fprintf(stderr, "Error: --reconnect-bench needs a positive number of cycles.\n");
+			return 1;
+		}
+		std::vector<SerialInfo::Backend> backends{ SerialInfo::Backend::QtSerialPort };
+		if (NativeSerialPort::IsSupported())
+		{
+			backends.push_back(SerialInfo::Backend::Native);
+		}
+		int status = 0;
+		for (const SerialInfo::Backend backend : backends)
+		{
+			try
+			{
+				const ReconnectBenchResult result = SerialBackendBench::RunReconnect(backend, cycles);
+				std::printf("%s\n", SerialBackendBench::Format(result).c_str());
+				if (result.reconnected < result.cycles || result.framesDecoded != result.framesSent || result.decodeErrors > 0)
+				{
+					status = 1;
+				}
+			}
+			catch (const std::runtime_error& e)
+			{
+				std::fprintf(stderr, "Error: %s\n", e.what());
+				return 1;
+			}
+			std::fflush(stdout);
+		}
+		return status;
+	}
+
+	/**
+	 * @brief Modbus 轮询基准测试：同一份配置（--modbus 或内置配置）在模拟 --baud 线路的从站模拟器上
+	 * 先逐点请求、再合并请求各运行指定秒数，比较每秒读到的值和线路占用率。
+	 * @return 进程退出码。
+	 */
+	int RunModbusBench(const QCommandLineParser& parser)
+	{
+		const int seconds = parser.value("modbus-bench").toInt();
+		if (seconds <= 0)
+		{
+			std::fprintf(stderr, "Error: --modbus-bench needs a positive number of seconds.\n");
+			return 1;
+		}
+		QString spec;
+		if (!ReadSpec(parser.value("modbus"), spec))
+		{
+			return 1;
+		}
+		const std::string text = spec.isEmpty() ? ModbusBench::DefaultSpec() : spec.toStdString();
+		try
+		{
+			const SerialInfo::Backend backend = SerialInfo::BackendFromName(parser.value("serial-backend"));
+			for (const bool merge : { false, true })
+			{
+				const ModbusBenchResult result = ModbusBench::Run(text, merge, parser.value("baud").toInt(), seconds, backend);
+				std::printf("%s\n", ModbusBench::Format(result).c_str());
+				std::fflush(stdout);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "Error: %s\n", e.what());
+			return 1;
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief 64 位 FNV-1a 哈希，--decode-check 用它比较并行与顺序解码的输出而不保存整份输出。
+	 */
+	uint64_t HashText(uint64_t hash, const std::string& text)
+	{
+		for (const char c : text)
+		{
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	/**
+	 * @brief 离线解码采集文件：文件映射到内存后由 ParallelDecoder 多线程解码，帧按原顺序写入 --frames。
+	 * 指定 --decode-check 时再顺序解码一遍，比较输出哈希和计数。
+	 * @return 进程退出码。
+	 */
+	int RunDecodeFile(const QCommandLineParser& parser)
+	{
+		QFile file(parser.value("decode-file"));
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			std::fprintf(stderr, "Error: %s\n", file.errorString().toLocal8Bit().constData());
+			return 1;
+		}
+		QByteArray fallback;
+		ByteSpan data;
+		if (file.size() > 0)
+		{
+			if (const uchar* mapped = file.map(0, file.size()))
+			{
+				data = ByteSpan(reinterpret_cast<const char*>(mapped), static_cast<size_t>(file.size()));
+			}
+			else
+			{
+				fallback = file.readAll();
+				data = ByteSpan(fallback.constData(), static_cast<size_t>(fallback.size()));
+			}
+		}
+
+		DecoderOptions decoderOptions;
+		decoderOptions.headers.clear();
+		for (const QString& header : SplitValues({ parser.value("headers") }))
+		{
+			decoderOptions.headers.push_back(header.toStdString());
+		}
+		decoderOptions.endFrame = parser.value("end").toStdString();
+		const std::string decoderName = parser.value("decoder").toStdString();
+		ParallelDecoder::Factory factory = [decoderName, decoderOptions]() {
+			return DecoderRegistry::Instance().Create(decoderName, decoderOptions);
+		};
+		try
+		{
+			factory();
+		}
+		catch (const std::invalid_argument& e)
+		{
+			std::fprintf(stderr, "Error: %s\n", e.what());
+			return 1;
+		}
+
+		const QString framesPath = parser.value("frames");
+		std::FILE* frames = nullptr;
+		if (framesPath == "-")
+		{
+			frames = stdout;
+		}
+		else if (!framesPath.isEmpty())
+		{
+			frames = std::fopen(framesPath.toLocal8Bit().constData(), "wb");
+			if (frames == nullptr)
+			{
+				std::fprintf(stderr, "Error: cannot write %s\n", framesPath.toLocal8Bit().constData());
+				return 1;
+			}
+		}
+
+		const bool check = parser.isSet("decode-check");
+		uint64_t hash = 14695981039346656037ull;
+		ParallelDecoder decoder(factory, parser.value("decode-threads").toUInt(),
+			static_cast<size_t>(parser.value("decode-chunk").toULongLong()));
+		const ParallelDecodeResult result = decoder.Run(data, ParallelDecoder::FormatLine, [&](const std::string& text) {
+			if (frames != nullptr)
+			{
+				std::fwrite(text.data(), 1, text.size(), frames);
+			}
+			if (check)
+			{
+				hash = HashText(hash, text);
+			}
+			});
+		if (frames != nullptr && frames != stdout)
+		{
+			std::fclose(frames);
+		}
+		std::fprintf(stderr, "[decode] %s\n", ParallelDecoder::Format(result).c_str());
+		if (!check)
+		{
+			return 0;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		std::unique_ptr<ProtocolDecoder> sequential = factory();
+		uint64_t expected = 14695981039346656037ull;
+		std::string text;
+		auto sink = MakeRecordSink([&](const DecodedRecord& record) {
+			ParallelDecoder::FormatLine(record, text);
+			if (text.size() >= 65536)
+			{
+				expected = HashText(expected, text);
+				text.clear();
+			}
+			});
+		sequential->Feed(data, sink);
+		expected = HashText(expected, text);
+		const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		const bool same = expected == hash && sequential->RecordCount() == result.records
+			&& sequential->ErrorCount() == result.errors;
+		std::fprintf(stderr, "[decode] sequential %llu records, %llu errors, %.3f s (%.2fx): %s\n",
+			static_cast<unsigned long long>(sequential->RecordCount()),
+			static_cast<unsigned long long>(sequential->ErrorCount()), wall,
+			result.seconds > 0 ? wall / result.seconds : 0.0, same ? "identical" : "MISMATCH");
+		return same ? 0 : 2;
+	}
+}
+
+/**
+ * @brief 命令行采集程序的入口点。
+ *
+ * 使用 QCoreApplication 运行事件循环，按参数打开串口并开始采集，
+ * 收到 SIGINT/SIGTERM 或达到 --duration 后输出最终统计并退出。
+ *
+ * @param argc 命令行参数的数量。
+ * @param argv 命令行参数的数组。
+ * @return 应用程序的退出代码。
+ */
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName("MySoftwareCli");
+	qInstallMessageHandler(MessageHandler);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Headless serial capture and frame decoder.");
+	parser.addHelpOption();
+	parser.addOptions({
+		{ { "p", "port" }, "Serial port to open, may be repeated or comma separated; name:decoder selects a decoder per port (only when decoder is a registered name, so paths with colons work).", "name" },
+		{ { "d", "decoder" }, "Default protocol decoder (see --list-decoders).", "name", "pid" },
+		{ { "b", "baud" }, "Baud rate (default 115200).", "rate", "115200" },
+		{ "data-bits", "Data bits (default 8).", "bits", "8" },
+		{ "stop-bits", "Stop bits (default 1).", "bits", "1" },
+		{ "parity", "Parity: None, Even, Odd, Space, Mark.", "parity", "None" },
+		{ "serial-backend", "Serial port backend: qt (QSerialPort) or native (Linux termios/epoll).", "name", "qt" },
+		{ "headers", QString("Comma separated start headers (default START1..START%1, as in the GUI).").arg(kMaxPidControllers),
+			"list", HeadlessOptions::DefaultHeaders().join(',') },
+		{ "end", "End frame string.", "text", "END" },
+		{ "frames", "Decoded frame output, '-' for stdout, empty to disable.", "path", "-" },
+		{ "raw", "Raw capture output, port name is appended for multiple ports.", "path" },
+		{ "stats", "Statistics output, '-' for stderr.", "path", "-" },
+		{ "stats-interval", "Seconds between statistics lines, 0 for exit only.", "seconds", "10" },
+		{ "duration", "Stop after this many seconds, 0 to run until interrupted.", "seconds", "0" },
+		{ "fanout-tcp", "Share each port's stream on 127.0.0.1:port (port+1 for the next serial port).", "port" },
+		{ "fanout-local", "Share each port's stream on a local socket with this name.", "name" },
+		{ "shm", "Publish decoded frames to this POSIX shared-memory ring (see MySoftwareShmReader).", "name" },
+		{ "shm-slots", "Slots in the shared-memory ring.", "count", "4096" },
+		{ "probe", "Send round-trip latency probe frames at this rate (Hz) on each port.", "hz" },
+		{ "probe-timeout", "Milliseconds before an unanswered probe counts as lost.", "ms", "2000" },
+		{ "relay", "Relay mode: forward everything between the two --port devices and decode both directions." },
+		{ "relay-log", "Relay log (ms,src>dst,bytes,added_us,hex) per forwarded chunk, '-' for stdout.", "path" },
+		{ "echo-pty", "Create a pty that echoes everything back and capture from it when no --port is given." },
+		{ "echo-delay", "Delay in microseconds before the --echo-pty stand-in echoes.", "us", "0" },
+		{ "modbus", "Modbus RTU polling spec '[name=]slave:table:addr[-end][:type][*scale][@period]' (see README), inline separated by ';' or a file; selects the modbus decoder.", "spec" },
+		{ "modbus-timeout", "Milliseconds a Modbus slave may take to answer, on top of the transmission time.", "ms", "100" },
+		{ "modbus-sim", "Create a pty Modbus slave simulator paced at --baud and poll it when no --port is given." },
+		{ "send-file", "Send this file through the first port and exit when the transfer ends.", "path" },
+		{ "send-mode", "File transfer mode: ymodem, xmodem1k or raw.", "mode", "ymodem" },
+		{ "send-window", "Bytes kept queued in the serial write buffer in raw mode.", "bytes", "16384" },
+		{ "filter", "Per-channel filter chain, e.g. 'START1.*=median:5,lowpass:20:1000' (see README).", "spec" },
+		{ "filtered", "Filtered sample output (ms,channel,value), '-' for stdout.", "path" },
+		{ "filter-bench", "Benchmark the filter worker with 32 channels x 1 kHz of synthetic data and exit." },
+		{ "alarms", "Alarm rules (see README), inline separated by ';' or a file with one rule per line.", "rules" },
+		{ "alarm-tcp", "Broadcast alarm events and watch hits as text lines on 127.0.0.1:port.", "port" },
+		{ "watch", "Watch list of strings to find in the raw RX bytes (see README), inline separated by ';' or a file with one pattern per line.", "patterns" },
+		{ "watch-out", "Watch hits (ms,port,offset,pattern), '-' for stdout; without it hits are only counted.", "path" },
+		{ "no-reconnect", "Do not reopen a port automatically after the device disconnects." },
+		{ "derived", "Derived channels 'name = expression' (see README), inline separated by ';' or a file.", "defs" },
+		{ "steps", "Step-response analysis per controller 'NAME: sp=ch pv=ch [gains=..]' (see README), inline separated by ';' or a file.", "spec" },
+		{ "steps-out", "Step results (ms,controller,Kp,Ki,Kd,from,to,rise_ms,overshoot%,settling_ms,ess), '-' for stdout.", "path" },
+		{ "step-bench", "Benchmark the step analysis worker with 16 synthetic controllers x 1 kHz and exit." },
+		{ "derived-bench", "Benchmark derived channel evaluation (--derived or a built-in set) and exit." },
+		{ "history-bench", "Benchmark compressed channel history (bytes/sample, append, decode, query) on an hour of 1 kHz synthetic signals and exit." },
+		{ "alarm-bench", "Benchmark the alarm engine with this many synthetic rules and exit.", "count" },
+		{ "watch-bench", "Benchmark the watch list scan with this many synthetic patterns and exit.", "count" },
+		{ "list", "List available serial ports and exit." },
+		{ "list-decoders", "List registered protocol decoders and exit." },
+		{ "bench", "Benchmark protocol decoders instead of capturing." },
+		{ "bench-file", "Capture file used by --bench instead of synthetic data.", "path" },
+		{ "bench-chunk", "Bytes per Feed() call in --bench.", "bytes", "64" },
+		{ "bench-repeat", "Passes over the data in --bench.", "count", "4" },
+		{ "serial-bench", "Compare the qt and native serial backends on a pty (throughput, CPU per MB, probe latency) and exit." },
+		{ "serial-bench-mb", "Megabytes streamed through the pty by --serial-bench.", "mb", "64" },
+		{ "relay-bench", "Measure relay latency between two pty pairs with this many messages each way and exit.", "count" },
+		{ "reconnect-bench", "Unplug and replug a pty device this many times per backend, measuring reconnect time and checking no frames are lost, and exit.", "cycles" },
+		{ "modbus-bench", "Compare per-point and merged Modbus polling for this many seconds each against the pty slave simulator at --baud and exit.", "seconds" },
+		{ "decode-file", "Decode this capture file on all cores, write frames to --frames in order and exit.", "path" },
+		{ "decode-threads", "Worker threads for --decode-file, 0 for one per core.", "count", "0" },
+		{ "decode-chunk", "Bytes per work item in --decode-file.", "bytes", "8388608" },
+		{ "decode-check", "Also decode --decode-file sequentially and verify the output is identical." },
+		{ "memory-limit", "Memory cap in MB; over it, received chunks are shed until the backlog drains. 0 only reports usage.", "mb", "0" },
+		{ "flight-bytes", "Size of the always-on flight recorder ring dumped on crash, 0 to disable.", "bytes", "4194304" },
+		{ "flight-decode", "Print a .flight crash dump as text and exit.", "path" },
+		{ "trace", "Record pipeline trace zones and write them as Chrome trace JSON on exit.", "path" },
+		{ "verbose", "Print debug messages." },
+		});
+	parser.process(app);
+	g_verbose = parser.isSet("verbose");
+
+	if (parser.isSet("flight-decode"))
+	{
+		if (!FlightRecorder::Decode(parser.value("flight-decode").toLocal8Bit().constData(), stdout))
+		{
+			std::fprintf(stderr, "Error: %s is not a flight recorder dump.\n", parser.value("flight-decode").toLocal8Bit().constData());
+			return 1;
+		}
+		return 0;
+	}
+	FlightRecorder::Instance().Init(static_cast<size_t>(parser.value("flight-bytes").toULongLong()));
+	CrashHandler::Install("MySoftwareCli");
+
+	if (parser.isSet("list"))
+	{
+		for (const QSerialPortInfo& portInfo : QSerialPortInfo::availablePorts())
+		{
+			std::printf("%s  %s\n", portInfo.portName().toLocal8Bit().constData(),
+				portInfo.description().toLocal8Bit().constData());
+		}
+		return 0;
+	}
+	if (parser.isSet("list-decoders"))
+	{
+		for (const std::string& name : DecoderRegistry::Instance().Names())
+		{
+			std::printf("%-8s %s\n", name.c_str(), DecoderRegistry::Instance().Description(name).c_str());
+		}
+		return 0;
+	}
+	if (parser.isSet("bench"))
+	{
+		return RunBench(parser);
+	}
+	if (parser.isSet("filter-bench"))
+	{
+		return RunFilterBench(parser);
+	}
+	if (parser.isSet("step-bench"))
+	{
+		return RunStepBench();
+	}
+	if (parser.isSet("alarm-bench"))
+	{
+		return RunAlarmBench(parser);
+	}
+	if (parser.isSet("watch-bench"))
+	{
+		return RunWatchBench(parser);
+	}
+	if (parser.isSet("derived-bench"))
+	{
+		return RunDerivedBench(parser);
+	}
+	if (parser.isSet("history-bench"))
+	{
+		return RunHistoryBench();
+	}
+	if (parser.isSet("decode-file"))
+	{
+		return RunDecodeFile(parser);
+	}
+	if (parser.isSet("serial-bench"))
+	{
+		return RunSerialBench(parser);
+	}
+	if (parser.isSet("relay-bench"))
+	{
+		return RunRelayBench(parser);
+	}
+	if (parser.isSet("reconnect-bench"))
+	{
+		return RunReconnectBench(parser);
+	}
+	if (parser.isSet("modbus-bench"))
+	{
+		return RunModbusBench(parser);
+	}
+
+	HeadlessOptions options;
+	options.ports = SplitValues(parser.values("port"));
+	options.decoder = parser.value("decoder");
+	options.baudRate = parser.value("baud").toInt();
+	options.dataBits = parser.value("data-bits").toInt();
+	options.stopBits = parser.value("stop-bits").toInt();
+	options.parity = parser.value("parity");
+	options.serialBackend = parser.value("serial-backend");
+	options.headers = SplitValues({ parser.value("headers") });
+	options.endFrame = parser.value("end");
+	options.framesPath = parser.value("frames");
+	options.rawPath = parser.value("raw");
+	options.statsPath = parser.value("stats");
+	options.statsIntervalSec = parser.value("stats-interval").toInt();
+	options.durationSec = parser.value("duration").toInt();
+	options.fanoutTcpPort = static_cast<quint16>(parser.value("fanout-tcp").toUInt());
+	options.fanoutLocal = parser.value("fanout-local");
+	options.shmName = parser.value("shm");
+	options.shmSlots = parser.value("shm-slots").toUInt();
+	options.relay = parser.isSet("relay");
+	options.relayLogPath = parser.value("relay-log");
+	options.memoryLimitMb = parser.value("memory-limit").toULongLong();
+	options.probeRateHz = parser.value("probe").toDouble();
+	options.probeTimeoutMs = parser.value("probe-timeout").toInt();
+	options.sendFile = parser.value("send-file");
+	options.sendMode = parser.value("send-mode");
+	options.sendWindow = parser.value("send-window").toLongLong();
+	options.filterSpec = parser.value("filter");
+	options.filteredPath = parser.value("filtered");
+	options.stepsPath = parser.value("steps-out");
+	if (!ReadSpec(parser.value("alarms"), options.alarmSpec) || !ReadSpec(parser.value("derived"), options.derivedSpec)
+		|| !ReadSpec(parser.value("steps"), options.stepSpec) || !ReadSpec(parser.value("modbus"), options.modbusSpec)
+		|| !ReadSpec(parser.value("watch"), options.watchSpec))
+	{
+		return 1;
+	}
+	options.modbusTimeoutMs = parser.value("modbus-timeout").toInt();
+	if (!options.modbusSpec.isEmpty() && !parser.isSet("decoder"))
+	{
+		options.decoder = "modbus";
+	}
+	options.alarmTcpPort = static_cast<quint16>(parser.value("alarm-tcp").toUInt());
+	options.watchPath = parser.value("watch-out");
+	options.reconnect = !parser.isSet("no-reconnect");
+
+	// 没有硬件时用伪终端回显桩代替设备，例如 --echo-pty --probe 100 --duration 10
+	PtyEcho echo;
+	if (parser.isSet("echo-pty"))
+	{
+		try
+		{
+			echo.Start(parser.value("echo-delay").toInt());
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "Error: %s\n", e.what());
+			return 1;
+		}
+		std::fprintf(stderr, "[echo] pty stand-in at %s\n", echo.SlavePath().c_str());
+		if (options.ports.isEmpty())
+		{
+			options.ports << QString::fromStdString(echo.SlavePath());
+		}
+	}
+
+	// 没有设备时用 Modbus 从站模拟器，例如 --modbus-sim --modbus "1:hr:0-15@50ms" --baud 19200 --duration 10
+	ModbusSlaveSim modbusSim;
+	if (parser.isSet("modbus-sim"))
+	{
+		try
+		{
+			modbusSim.Start(options.baudRate);
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "Error: %s\n", e.what());
+			return 1;
+		}
+		std::fprintf(stderr, "[modbus-sim] slave simulator at %s\n", modbusSim.SlavePath().c_str());
+		if (options.ports.isEmpty())
+		{
+			options.ports << QString::fromStdString(modbusSim.SlavePath());
+		}
+	}
+
+	if (parser.isSet("trace"))
+	{
+		TraceRecorder::SetThreadName("main");
+		TraceRecorder::Start();
+	}
+
+	HeadlessCapture capture(options);
+	try
+	{
+		capture.Start();
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "Error: %s\n", e.what());
+		return 1;
+	}
+
+	std::signal(SIGINT, RequestStop);
+	std::signal(SIGTERM, RequestStop);
+	QTimer stopPoll;
+	QObject::connect(&stopPoll, &QTimer::timeout, &app, [&app]() {
+		if (g_stopRequested.load())
+		{
+			app.quit();
+		}
+		});
+	stopPoll.start(200);
+	QObject::connect(&capture, &HeadlessCapture::Finished, &app, &QCoreApplication::quit);
+
+	const int result = app.exec();
+	capture.Stop();
+	if (parser.isSet("trace"))
+	{
+		TraceRecorder::Stop();
+		const long long count = TraceRecorder::WriteChromeJson(parser.value("trace").toStdString());
+		std::fprintf(stderr, "[trace] %lld events written to %s\n", count, parser.value("trace").toLocal8Bit().constData());
+	}
+	return result;
+}
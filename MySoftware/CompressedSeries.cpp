@@ -0,0 +1,372 @@
+/*
+ * @Description: 压缩的样本序列，时间用二阶差分、数值用 XOR 编码（Gorilla），按块保存，按需顺序解码
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-19 00:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "CompressedSeries.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	int LeadingZeros(uint64_t x)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse64(&index, x);
+		return 63 - static_cast<int>(index);
+#else
+		return __builtin_clzll(x);
+#endif
+	}
+
+	int TrailingZeros(uint64_t x)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, x);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(x);
+#endif
+	}
+
+	uint64_t ToBits(double value)
+	{
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	double FromBits(uint64_t bits)
+	{
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	uint64_t Mask(int count)
+	{
+		return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+	}
+
+	int64_t SignExtend(uint64_t value, int count)
+	{
+		const uint64_t sign = uint64_t(1) << (count - 1);
+		return static_cast<int64_t>((value ^ sign) - sign);
+	}
+
+	/**
+	 * @brief 二阶差分的编码区间：前缀位数、前缀、数值位数，依次尝试，最后一项为 64 位原样写出。
+	 * 时间单位是微秒，区间比按秒计时的 Gorilla 宽：7 位覆盖 ±64 us 的抖动，12 位覆盖 ±2 ms，
+	 * 20 位覆盖 ±0.5 s，串口按数据块打时间戳时块间的跳变落在后两档。
+	 */
+	struct DodBucket
+	{
+		int prefixBits;
+		uint64_t prefix;
+		int valueBits;
+	};
+	constexpr DodBucket kDodBuckets[] = {
+		{ 2, 0b10, 7 },
+		{ 3, 0b110, 12 },
+		{ 4, 0b1110, 20 },
+		{ 5, 0b11110, 32 },
+		{ 5, 0b11111, 64 },
+	};
+}
+
+inline void CompressedSeries::WriteBits(Block& block, uint64_t value, int count)
+{
+	value &= Mask(count);
+	const int used = static_cast<int>(block.bits & 63);
+	if (used == 0)
+	{
+		block.words.push_back(0);
+	}
+	const int free = 64 - used;
+	if (count <= free)
+	{
+		block.words.back() |= value << (free - count);
+	}
+	else
+	{
+		block.words.back() |= value >> (count - free);
+		block.words.push_back(value << (64 - (count - free)));
+	}
+	block.bits += static_cast<size_t>(count);
+}
+
+/**
+ * @brief 追加一个样本。
+ * 每块第一个样本的时间写在块头、数值原样写出 64 位；之后的样本依次写时间的二阶差分和数值的异或。
+ * 一个样本的各段先拼在一个 64 位字里，通常只写一次位流。
+ * 新块按上一块的实际长度预留空间，一块写满后释放位流多余的容量。
+ */
+void CompressedSeries::Append(double t, double value)
+{
+	const double scaled = t * kTicksPerSecond;
+	int64_t tick = static_cast<int64_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+	if (m_size > Begin() && tick < m_lastTick)
+	{
+		tick = m_lastTick;
+	}
+	const uint64_t bits = ToBits(value);
+
+	if (m_size % kBlockSamples == 0)
+	{
+		size_t reserve = 64;
+		if (!m_blocks.empty())
+		{
+			m_blocks.back().words.shrink_to_fit();
+			reserve = m_blocks.back().words.size() + 8;
+		}
+		m_blocks.emplace_back();
+		Block& block = m_blocks.back();
+		block.words.reserve(reserve);
+		block.firstTick = tick;
+		block.lastTick = tick;
+		WriteBits(block, bits, 64);
+		m_lastTick = tick;
+		m_lastDelta = 0;
+		m_lastBits = bits;
+		m_leading = 64;
+		m_trailing = 0;
+		++m_size;
+		return;
+	}
+
+	Block& block = m_blocks.back();
+	uint64_t code = 0;
+	int codeBits = 0;
+	auto emit = [&](uint64_t part, int count) {
+		if (codeBits + count > 64)
+		{
+			WriteBits(block, code, codeBits);
+			code = 0;
+			codeBits = 0;
+		}
+		code = count >= 64 ? part : (code << count) | (part & Mask(count));
+		codeBits += count;
+	};
+
+	const int64_t delta = tick - m_lastTick;
+	const int64_t dod = delta - m_lastDelta;
+	if (dod == 0)
+	{
+		emit(0, 1);
+	}
+	else
+	{
+		for (const DodBucket& bucket : kDodBuckets)
+		{
+			const int64_t limit = bucket.valueBits >= 64 ? INT64_MAX : (int64_t(1) << (bucket.valueBits - 1)) - 1;
+			if (bucket.valueBits >= 64 || (dod >= -limit - 1 && dod <= limit))
+			{
+				emit(bucket.prefix, bucket.prefixBits);
+				emit(static_cast<uint64_t>(dod), bucket.valueBits);
+				break;
+			}
+		}
+	}
+	m_lastTick = tick;
+	m_lastDelta = delta;
+	block.lastTick = tick;
+
+	const uint64_t x = bits ^ m_lastBits;
+	if (x == 0)
+	{
+		emit(0, 1);
+	}
+	else
+	{
+		// 前导零个数用 5 位表示，最多 31
+		const int leading = std::min(LeadingZeros(x), 31);
+		const int trailing = TrailingZeros(x);
+		if (m_leading != 64 && leading >= m_leading && trailing >= m_trailing)
+		{
+			emit(0b10, 2);
+			emit(x >> m_trailing, 64 - m_leading - m_trailing);
+		}
+		else
+		{
+			const int length = 64 - leading - trailing;
+			emit((uint64_t(0b11) << 11) | (static_cast<uint64_t>(leading) << 6) | static_cast<uint64_t>(length & 63), 13);
+			emit(x >> trailing, length);
+			m_leading = leading;
+			m_trailing = trailing;
+		}
+	}
+	WriteBits(block, code, codeBits);
+	m_lastBits = bits;
+	++m_size;
+}
+
+double CompressedSeries::FirstTime() const
+{
+	return m_blocks.empty() ? 0.0 : m_blocks.front().firstTick * kTimeResolution;
+}
+
+/**
+ * @brief 先按块尾时间二分找到第一个可能满足条件的块，再在块内顺序解码。
+ */
+template<typename Before>
+size_t CompressedSeries::Partition(Before before) const
+{
+	const auto block = std::partition_point(m_blocks.begin(), m_blocks.end(),
+		[&before](const Block& b) { return before(b.lastTick * kTimeResolution); });
+	if (block == m_blocks.end())
+	{
+		return m_size;
+	}
+	size_t index = (m_droppedBlocks + static_cast<size_t>(block - m_blocks.begin())) * kBlockSamples;
+	Cursor cursor(*this);
+	cursor.Seek(index);
+	while (before(cursor.Time()) && cursor.Next())
+	{
+	}
+	return cursor.Index();
+}
+
+size_t CompressedSeries::LowerBound(double t) const
+{
+	return Partition([t](double time) { return time < t; });
+}
+
+size_t CompressedSeries::UpperBound(double t) const
+{
+	return Partition([t](double time) { return time <= t; });
+}
+
+size_t CompressedSeries::MemoryBytes() const
+{
+	size_t bytes = m_blocks.capacity() * sizeof(Block);
+	for (const Block& block : m_blocks)
+	{
+		bytes += block.words.capacity() * sizeof(uint64_t);
+	}
+	return bytes;
+}
+
+void CompressedSeries::DropBefore(size_t index)
+{
+	const size_t blocks = std::min(index / kBlockSamples, m_size / kBlockSamples);
+	if (blocks > m_droppedBlocks)
+	{
+		m_blocks.erase(m_blocks.begin(), m_blocks.begin() + static_cast<std::ptrdiff_t>(blocks - m_droppedBlocks));
+		m_droppedBlocks = blocks;
+	}
+}
+
+void CompressedSeries::Clear()
+{
+	m_blocks.clear();
+	m_blocks.shrink_to_fit();
+	m_droppedBlocks = 0;
+	m_size = 0;
+	m_leading = 64;
+}
+
+void CompressedSeries::Cursor::Seek(size_t index)
+{
+	const size_t block = index / kBlockSamples - m_series->m_droppedBlocks;
+	if (block != m_block || index < m_index)
+	{
+		Restart(block);
+	}
+	while (m_index < index)
+	{
+		DecodeNext();
+	}
+}
+
+bool CompressedSeries::Cursor::Next()
+{
+	if (m_index + 1 >= m_series->m_size)
+	{
+		// 停在最后一个样本之后，Index() 等于 Size()
+		m_index = m_series->m_size;
+		return false;
+	}
+	if (m_index + 1 == m_blockEnd)
+	{
+		Restart(m_block + 1);
+		return true;
+	}
+	DecodeNext();
+	return true;
+}
+
+void CompressedSeries::Cursor::Restart(size_t block)
+{
+	const Block& data = m_series->m_blocks[block];
+	m_block = block;
+	m_words = data.words.data();
+	m_index = (m_series->m_droppedBlocks + block) * kBlockSamples;
+	m_blockEnd = m_index + kBlockSamples;
+	m_bit = 0;
+	m_tick = data.firstTick;
+	m_delta = 0;
+	m_bits = ReadBits(64);
+	m_value = FromBits(m_bits);
+	m_leading = 64;
+	m_trailing = 0;
+}
+
+uint64_t CompressedSeries::Cursor::ReadBits(int count)
+{
+	const size_t word = m_bit >> 6;
+	const int offset = static_cast<int>(m_bit & 63);
+	const int available = 64 - offset;
+	uint64_t value = (m_words[word] << offset) >> (64 - count);
+	if (count > available)
+	{
+		value |= m_words[word + 1] >> (64 - (count - available));
+	}
+	m_bit += static_cast<size_t>(count);
+	return value;
+}
+
+bool CompressedSeries::Cursor::ReadBit()
+{
+	const bool bit = (m_words[m_bit >> 6] >> (63 - (m_bit & 63))) & 1;
+	++m_bit;
+	return bit;
+}
+
+void CompressedSeries::Cursor::DecodeNext()
+{
+	if (ReadBit())
+	{
+		int bucket = 0;
+		while (bucket < 4 && ReadBit())
+		{
+			++bucket;
+		}
+		const int valueBits = kDodBuckets[bucket].valueBits;
+		const uint64_t raw = ReadBits(valueBits);
+		m_delta += valueBits >= 64 ? static_cast<int64_t>(raw) : SignExtend(raw, valueBits);
+	}
+	m_tick += m_delta;
+
+	if (ReadBit())
+	{
+		if (ReadBit())
+		{
+			m_leading = static_cast<int>(ReadBits(5));
+			int length = static_cast<int>(ReadBits(6));
+			length = length == 0 ? 64 : length;
+			m_trailing = 64 - m_leading - length;
+		}
+		const int length = 64 - m_leading - m_trailing;
+		m_bits ^= ReadBits(length) << m_trailing;
+		m_value = FromBits(m_bits);
+	}
+	++m_index;
+}
@@ -0,0 +1,150 @@
+/*
+ * @Description: 压缩的样本序列，时间用二阶差分、数值用 XOR 编码（Gorilla），按块保存，按需顺序解码
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-19 00:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief CompressedSeries 保存一个通道的 (时间, 数值) 样本，每 4096 个样本一块，块内按位压缩。
+ *
+ * 时间按微秒取整为整数，块内第一个样本的时间记在块头，之后每个样本写入与上一个间隔之差（二阶差分），
+ * 等间隔采样时每个样本只占 1 位，抖动在几十微秒以内时占 9 位。
+ * 数值与上一个数值的 IEEE 754 位模式做异或，相同时占 1 位，否则只写出异或结果中间的有效位，
+ * 前导零和末尾零的位置与上一个相同时不重复写出。由 float 转换而来的数值末尾 29 位总是零，压缩效果更好。
+ *
+ * 每块独立解码，读取时用 Cursor 从块头开始顺序解码，按块丢弃最旧的样本后下标保持不变，与 BlockArray 相同。
+ * 时间必须单调不减，Append 把更早的时间按上一个样本的时间记录。
+ */
+class CompressedSeries
+{
+public:
+	static constexpr size_t kBlockSamples = 4096; /**< 每块的样本数。 */
+	static constexpr double kTimeResolution = 1e-6; /**< 时间分辨率（秒）。 */
+	static constexpr double kTicksPerSecond = 1e6;  /**< 每秒的时间单位数。 */
+
+	/**
+	 * @brief 追加一个样本。
+	 * @param t 时间（秒），按 kTimeResolution 取整。
+	 * @param value 数值。
+	 */
+	void Append(double t, double value);
+
+	/**
+	 * @brief 样本数量，包括已丢弃的样本，样本下标从 Begin() 开始有效。
+	 */
+	size_t Size() const { return m_size; }
+	size_t Begin() const { return m_droppedBlocks * kBlockSamples; }
+
+	/**
+	 * @brief 第一个未丢弃的样本和最后一个样本的时间（取整后），没有样本时为 0。
+	 */
+	double FirstTime() const;
+	double LastTime() const { return m_size > Begin() ? m_lastTick * kTimeResolution : 0.0; }
+
+	/**
+	 * @brief 第一个时间不小于 t 的样本下标，没有时返回 Size()。
+	 */
+	size_t LowerBound(double t) const;
+
+	/**
+	 * @brief 第一个时间大于 t 的样本下标，没有时返回 Size()。
+	 */
+	size_t UpperBound(double t) const;
+
+	/**
+	 * @brief 占用的内存（字节），包括块头。
+	 */
+	size_t MemoryBytes() const;
+
+	/**
+	 * @brief 丢弃下标小于 index 的所有完整块。
+	 */
+	void DropBefore(size_t index);
+
+	void Clear();
+
+	/**
+	 * @brief 顺序读取样本。
+	 *
+	 * Seek 到同一块中更靠后的位置时接着解码，否则从目标块的块头重新解码，
+	 * 因此按下标递增的访问每个样本只解码一次。序列追加或丢弃样本后应重新 Seek。
+	 */
+	class Cursor
+	{
+	public:
+		explicit Cursor(const CompressedSeries& series) : m_series(&series) {}
+
+		/**
+		 * @brief 定位到第 index 个样本，index 必须在 [Begin(), Size()) 内。
+		 */
+		void Seek(size_t index);
+
+		/**
+		 * @brief 前进到下一个样本，当前样本已是最后一个时返回 false。
+		 */
+		bool Next();
+
+		size_t Index() const { return m_index; }
+		double Time() const { return m_tick * kTimeResolution; }
+		double Value() const { return m_value; }
+
+	private:
+		void Restart(size_t block);
+		void DecodeNext();
+		uint64_t ReadBits(int count);
+		bool ReadBit();
+
+		const CompressedSeries* m_series;
+		const uint64_t* m_words = nullptr; /**< 当前块的位流。 */
+		size_t m_block = SIZE_MAX;         /**< 当前块在 m_blocks 中的下标。 */
+		size_t m_blockEnd = 0;             /**< 当前块之后第一个样本的下标。 */
+		size_t m_index = 0;                /**< 当前样本下标。 */
+		size_t m_bit = 0;                  /**< 位流中的读取位置。 */
+		int64_t m_tick = 0;                /**< 当前时间（微秒）。 */
+		int64_t m_delta = 0;               /**< 上一个时间间隔。 */
+		uint64_t m_bits = 0;               /**< 当前数值的位模式。 */
+		double m_value = 0.0;              /**< 当前数值。 */
+		int m_leading = 0;                 /**< 上一个异或结果的前导零个数。 */
+		int m_trailing = 0;                /**< 上一个异或结果的末尾零个数。 */
+	};
+
+private:
+	/**
+	 * @brief 一块样本。
+	 */
+	struct Block
+	{
+		int64_t firstTick = 0;         /**< 第一个样本的时间。 */
+		int64_t lastTick = 0;          /**< 最后一个样本的时间，用于二分查找。 */
+		std::vector<uint64_t> words;   /**< 位流，从每个字的最高位开始写。 */
+		size_t bits = 0;               /**< 位流的长度。 */
+	};
+
+	/**
+	 * @brief 把 value 的低 count 位（1～64）追加到位流。
+	 */
+	void WriteBits(Block& block, uint64_t value, int count);
+
+	/**
+	 * @brief 第一个满足 !before(时间) 的样本下标，before 对时间单调。
+	 */
+	template<typename Before>
+	size_t Partition(Before before) const;
+
+	std::vector<Block> m_blocks;   /**< 未丢弃的块。 */
+	size_t m_droppedBlocks = 0;    /**< 已丢弃的块数。 */
+	size_t m_size = 0;             /**< 样本数量，包括已丢弃的部分。 */
+
+	// 编码器状态，属于最后一块
+	int64_t m_lastTick = 0;        /**< 上一个样本的时间。 */
+	int64_t m_lastDelta = 0;       /**< 上一个时间间隔。 */
+	uint64_t m_lastBits = 0;       /**< 上一个数值的位模式。 */
+	int m_leading = 64;            /**< 上一个异或窗口的前导零个数，64 表示还没有窗口。 */
+	int m_trailing = 0;            /**< 上一个异或窗口的末尾零个数。 */
+};
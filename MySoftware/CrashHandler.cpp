@@ -0,0 +1,295 @@
+/*
+ * @Description: 跨平台崩溃处理，Windows 生成 minidump，Linux/macOS 使用异步信号安全的信号处理函数，并转储飞行记录仪
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 18:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "CrashHandler.h"
+#include "FlightRecorder.h"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <DbgHelp.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#pragma comment(lib, "Dbghelp.lib")
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#if defined(__has_include)
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define CRASH_HAVE_BACKTRACE 1
+#endif
+#endif
+#endif
+
+namespace
+{
+	char g_prefix[512] = {}; /**< "<目录>/<程序名>"，Install 时填好。 */
+}
+
+#ifdef _WIN32
+
+namespace
+{
+	/**
+	 * @brief 未处理异常过滤函数：写出 minidump 与飞行记录仪内容。
+	 */
+	LONG WINAPI CreateMiniDump(EXCEPTION_POINTERS* pep)
+	{
+		// 获取当前时间，用于命名dump文件
+		auto t = std::time(nullptr);
+		auto tm = *std::localtime(&t);
+
+		std::ostringstream oss;
+		oss << g_prefix << "crash_dump_" << std::put_time(&tm, "%Y%m%d_%H%M%S");
+		const std::string baseName = oss.str();
+		const std::string dumpFileName = baseName + ".dmp";
+
+		HANDLE hFile = CreateFileA(dumpFileName.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+			FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hFile != INVALID_HANDLE_VALUE)
+		{
+			MINIDUMP_EXCEPTION_INFORMATION mdei;
+			mdei.ThreadId = GetCurrentThreadId();
+			mdei.ExceptionPointers = pep;
+			mdei.ClientPointers = FALSE;
+
+			MiniDumpWriteDump(GetCurrentProcess(), GetCurrentProcessId(), hFile, MiniDumpNormal, &mdei, NULL, NULL);
+			CloseHandle(hFile);
+			std::cerr << "Dump file created: " << dumpFileName << std::endl;
+		}
+		else
+		{
+			std::cerr << "Failed to create dump file. Error: " << GetLastError() << std::endl;
+		}
+
+		const std::string flightFileName = baseName + ".flight";
+		if (FlightRecorder::Instance().Dump(flightFileName.c_str()))
+		{
+			std::cerr << "Flight recorder saved: " << flightFileName << std::endl;
+		}
+
+		// 返回EXCEPTION_EXECUTE_HANDLER表示异常已处理，程序将终止
+		return EXCEPTION_EXECUTE_HANDLER;
+	}
+}
+
+void CrashHandler::Install(const char* appName, const char* directory)
+{
+	(void)appName;
+	g_prefix[0] = '\0';
+	if (directory != nullptr)
+	{
+		std::strncat(g_prefix, directory, sizeof(g_prefix) - 2);
+		std::strcat(g_prefix, "\\");
+	}
+	SetUnhandledExceptionFilter(CreateMiniDump);
+}
+
+/**
+ * @brief 栈溢出时异常过滤函数运行在溢出的线程上，需要为它保留一段栈空间。
+ */
+void CrashHandler::InstallThreadStack()
+{
+	ULONG size = 64 * 1024;
+	SetThreadStackGuarantee(&size);
+}
+
+#else
+
+namespace
+{
+	constexpr int kSignals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+	constexpr size_t kAltStackSize = 64 * 1024;
+	char g_altStack[kAltStackSize];
+
+	/**
+	 * @brief 工作线程的备用栈，线程结束时先注销再释放。
+	 */
+	struct ThreadAltStack
+	{
+		~ThreadAltStack()
+		{
+			if (memory == nullptr)
+			{
+				return;
+			}
+			stack_t disable{};
+			disable.ss_flags = SS_DISABLE;
+			sigaltstack(&disable, nullptr);
+			std::free(memory);
+		}
+
+		void* memory = nullptr;
+	};
+	thread_local ThreadAltStack t_altStack;
+
+	/**
+	 * @brief 以下辅助函数只操作调用方提供的缓冲区，可在信号处理函数中使用。
+	 */
+	size_t Append(char* buffer, size_t size, size_t used, const char* text)
+	{
+		while (*text != '\0' && used + 1 < size)
+		{
+			buffer[used++] = *text++;
+		}
+		buffer[used] = '\0';
+		return used;
+	}
+
+	size_t AppendNumber(char* buffer, size_t size, size_t used, unsigned long long value, unsigned base = 10)
+	{
+		char digits[24];
+		size_t count = 0;
+		do
+		{
+			digits[count++] = "0123456789abcdef"[value % base];
+			value /= base;
+		} while (value != 0 && count < sizeof(digits));
+		while (count > 0 && used + 1 < size)
+		{
+			buffer[used++] = digits[--count];
+		}
+		buffer[used] = '\0';
+		return used;
+	}
+
+	void WriteText(int fd, const char* text)
+	{
+		const ssize_t ignored = write(fd, text, std::strlen(text));
+		(void)ignored;
+	}
+
+	const char* SignalName(int signal)
+	{
+		switch (signal)
+		{
+		case SIGSEGV: return "SIGSEGV";
+		case SIGBUS: return "SIGBUS";
+		case SIGFPE: return "SIGFPE";
+		case SIGILL: return "SIGILL";
+		case SIGABRT: return "SIGABRT";
+		default: return "signal";
+		}
+	}
+
+	/**
+	 * @brief 崩溃信号处理函数。
+	 * 只使用 write/open/close/getpid/time 等异步信号安全的调用；backtrace 在 Install 时预先调用过一次，
+	 * 避免第一次调用时加载 libgcc 分配内存。
+	 */
+	void OnCrashSignal(int signal, siginfo_t* info, void*)
+	{
+		char base[640];
+		size_t used = Append(base, sizeof(base), 0, g_prefix);
+		used = Append(base, sizeof(base), used, "_crash_");
+		used = AppendNumber(base, sizeof(base), used, static_cast<unsigned long long>(getpid()));
+		used = Append(base, sizeof(base), used, "_");
+		used = AppendNumber(base, sizeof(base), used, static_cast<unsigned long long>(time(nullptr)));
+
+		char path[672];
+		size_t pathLength = Append(path, sizeof(path), 0, base);
+		Append(path, sizeof(path), pathLength, ".txt");
+
+		char line[256];
+		size_t lineLength = Append(line, sizeof(line), 0, "Crashed: ");
+		lineLength = Append(line, sizeof(line), lineLength, SignalName(signal));
+		lineLength = Append(line, sizeof(line), lineLength, " (");
+		lineLength = AppendNumber(line, sizeof(line), lineLength, static_cast<unsigned long long>(signal));
+		lineLength = Append(line, sizeof(line), lineLength, ") at address 0x");
+		lineLength = AppendNumber(line, sizeof(line), lineLength,
+			static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(info != nullptr ? info->si_addr : nullptr)), 16);
+		Append(line, sizeof(line), lineLength, "\n");
+
+		const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd >= 0)
+		{
+			WriteText(fd, line);
+#ifdef CRASH_HAVE_BACKTRACE
+			WriteText(fd, "Backtrace:\n");
+			void* frames[64];
+			const int count = backtrace(frames, 64);
+			backtrace_symbols_fd(frames, count, fd);
+#endif
+			close(fd);
+		}
+		WriteText(STDERR_FILENO, line);
+		WriteText(STDERR_FILENO, "Crash report: ");
+		WriteText(STDERR_FILENO, path);
+		WriteText(STDERR_FILENO, "\n");
+
+		Append(path, sizeof(path), pathLength, ".flight");
+		if (FlightRecorder::Instance().Dump(path))
+		{
+			WriteText(STDERR_FILENO, "Flight recorder saved: ");
+			WriteText(STDERR_FILENO, path);
+			WriteText(STDERR_FILENO, "\n");
+		}
+
+		// SA_RESETHAND 已恢复默认处理，重新触发信号以保留默认行为（core 文件、退出码）
+		raise(signal);
+	}
+}
+
+void CrashHandler::Install(const char* appName, const char* directory)
+{
+	size_t used = 0;
+	if (directory != nullptr)
+	{
+		used = Append(g_prefix, sizeof(g_prefix), used, directory);
+		used = Append(g_prefix, sizeof(g_prefix), used, "/");
+	}
+	Append(g_prefix, sizeof(g_prefix), used, appName);
+
+#ifdef CRASH_HAVE_BACKTRACE
+	void* warmup[1];
+	backtrace(warmup, 1);
+#endif
+
+	stack_t altStack{};
+	altStack.ss_sp = g_altStack;
+	altStack.ss_size = kAltStackSize;
+	sigaltstack(&altStack, nullptr);
+
+	struct sigaction action {};
+	action.sa_sigaction = OnCrashSignal;
+	action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESETHAND;
+	sigemptyset(&action.sa_mask);
+	for (const int signal : kSignals)
+	{
+		sigaction(signal, &action, nullptr);
+	}
+}
+
+void CrashHandler::InstallThreadStack()
+{
+	if (t_altStack.memory != nullptr)
+	{
+		return;
+	}
+	void* memory = std::malloc(kAltStackSize);
+	if (memory == nullptr)
+	{
+		return;
+	}
+	stack_t altStack{};
+	altStack.ss_sp = memory;
+	altStack.ss_size = kAltStackSize;
+	if (sigaltstack(&altStack, nullptr) != 0)
+	{
+		std::free(memory);
+		return;
+	}
+	t_altStack.memory = memory;
+}
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * @Description: 跨平台崩溃处理，Windows 生成 minidump，Linux/macOS 使用异步信号安全的信号处理函数，并转储飞行记录仪
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 18:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+
+/**
+ * @brief CrashHandler 在程序崩溃时写出诊断文件。
+ *
+ * - Windows：SetUnhandledExceptionFilter，写出 crash_dump_<时间>.dmp 与同名 .flight。
+ * - POSIX：为 SIGSEGV/SIGBUS/SIGFPE/SIGILL/SIGABRT 安装 sigaction，处理函数运行在备用栈上，
+ *   只调用异步信号安全的函数，写出 <程序名>_crash_<pid>_<时间>.txt（信号、地址、调用栈）与同名 .flight，
+ *   然后恢复默认处理并重新触发信号，系统仍会按配置生成 core 文件。
+ *
+ * 所有文件名所需的内容都在 Install 时准备好，崩溃时不分配内存。
+ * 备用栈（POSIX）和栈溢出保留空间（Windows）是线程级的，Install 只覆盖主线程，
+ * 其他线程需要在线程函数开头调用 InstallThreadStack，否则栈溢出时来不及写出诊断文件。
+ */
+namespace CrashHandler
+{
+	/**
+	 * @brief 安装崩溃处理函数，应在 main 开头调用一次。
+	 * @param appName 诊断文件名前缀。
+	 * @param directory 诊断文件目录，nullptr 表示当前目录。
+	 */
+	void Install(const char* appName, const char* directory = nullptr);
+
+	/**
+	 * @brief 为当前线程准备栈溢出时处理函数可用的栈空间，在工作线程的线程函数开头调用。
+	 * 重复调用无效果；POSIX 上的备用栈在线程结束时注销并释放。
+	 */
+	void InstallThreadStack();
+}
@@ -0,0 +1,140 @@
+/*
+ * @Description: 解码器基准测试，所有协议使用同一套数据切块和计时方法
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 11:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "DecoderBench.h"
+#include "NmeaDecoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+	volatile double g_benchSink = 0.0;
+
+	/**
+	 * @brief 统计记录数并读取数值，防止编译器把解码结果优化掉。
+	 */
+	class CountingSink : public RecordSink
+	{
+	public:
+		void OnRecord(const DecodedRecord& record) override
+		{
+			++records;
+			for (size_t i = 0; i < record.count; ++i)
+			{
+				checksum += record.values[i] == record.values[i] ? record.values[i] : 0.0;
+			}
+		}
+
+		uint64_t records = 0;
+		double checksum = 0.0;
+	};
+
+	void AppendPid(std::string& out, unsigned n)
+	{
+		char text[128];
+		const int length = std::snprintf(text, sizeof(text), "START%u\n%.3f\n%.4f\n%.5f\nEND\n",
+			n % 3 + 1, 1.0 + (n % 100) * 0.01, 0.1 + (n % 37) * 0.001, 0.01 + (n % 11) * 0.0001);
+		out.append(text, length);
+	}
+
+	void AppendNmea(std::string& out, unsigned n)
+	{
+		char body[96];
+		const int length = std::snprintf(body, sizeof(body),
+			"GPGGA,%02u%02u%02u.00,4807.%03u,N,01131.%03u,E,1,08,0.9,545.4,M,46.9,M,,",
+			(n / 3600) % 24, (n / 60) % 60, n % 60, n % 1000, (n * 7) % 1000);
+		char sentence[128];
+		const int total = std::snprintf(sentence, sizeof(sentence), "$%.*s*%02X\r\n", length, body,
+			NmeaDecoder::Checksum(ByteSpan(body, length)));
+		out.append(sentence, total);
+	}
+
+	void AppendKeyValue(std::string& out, unsigned n)
+	{
+		char text[128];
+		const int length = std::snprintf(text, sizeof(text), "t=%u sp1=%.2f pv1=%.3f out1=%.4f mode=auto\n",
+			n, 1.5, 1.5 - (n % 50) * 0.001, (n % 200) * 0.005);
+		out.append(text, length);
+	}
+}
+
+/**
+ * @brief 生成指定协议的合成数据。
+ */
+std::string DecoderBench::GenerateSample(const std::string& decoder, size_t bytes)
+{
+	void (*append)(std::string&, unsigned) = nullptr;
+	if (decoder == "pid")
+		append = AppendPid;
+	else if (decoder == "nmea")
+		append = AppendNmea;
+	else if (decoder == "kv")
+		append = AppendKeyValue;
+	if (append == nullptr)
+	{
+		return std::string();
+	}
+
+	std::string out;
+	out.reserve(bytes + 128);
+	for (unsigned n = 0; out.size() < bytes; ++n)
+	{
+		append(out, n);
+	}
+	return out;
+}
+
+/**
+ * @brief 把数据按 chunkSize 切块后重复输入解码器 repeat 次并计时。
+ */
+DecoderBenchResult DecoderBench::Run(ProtocolDecoder& decoder, ByteSpan data, size_t chunkSize, int repeat)
+{
+	CountingSink sink;
+	chunkSize = std::max<size_t>(chunkSize, 1);
+	repeat = std::max(repeat, 1);
+	const uint64_t errorsBefore = decoder.ErrorCount();
+
+	const auto begin = std::chrono::steady_clock::now();
+	for (int r = 0; r < repeat; ++r)
+	{
+		for (size_t offset = 0; offset < data.size(); offset += chunkSize)
+		{
+			decoder.Feed(data.substr(offset, chunkSize), sink);
+		}
+	}
+	const auto end = std::chrono::steady_clock::now();
+	g_benchSink = sink.checksum;
+
+	DecoderBenchResult result;
+	result.decoder = decoder.Name();
+	result.bytes = static_cast<uint64_t>(data.size()) * repeat;
+	result.records = sink.records;
+	result.errors = decoder.ErrorCount() - errorsBefore;
+	result.seconds = std::chrono::duration<double>(end - begin).count();
+	return result;
+}
+
+/**
+ * @brief 把结果格式化为一行文本。
+ */
+std::string DecoderBench::Format(const DecoderBenchResult& result)
+{
+	const double seconds = std::max(result.seconds, 1e-9);
+	char text[256];
+	const int length = std::snprintf(text, sizeof(text),
+		"[bench] decoder=%-6s bytes=%llu records=%llu errors=%llu time=%.3fs %.1f MB/s %.2f ns/byte %.2f Mrec/s",
+		result.decoder.c_str(),
+		static_cast<unsigned long long>(result.bytes),
+		static_cast<unsigned long long>(result.records),
+		static_cast<unsigned long long>(result.errors),
+		result.seconds,
+		result.bytes / seconds / 1e6,
+		seconds * 1e9 / std::max<uint64_t>(result.bytes, 1),
+		result.records / seconds / 1e6);
+	return std::string(text, length > 0 ? static_cast<size_t>(length) : 0);
+}
@@ -0,0 +1,57 @@
+/*
+ * @Description: 解码器基准测试，所有协议使用同一套数据切块和计时方法
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 11:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief 一次基准测试的结果。
+ */
+struct DecoderBenchResult
+{
+	std::string decoder;   /**< 解码器名称。 */
+	uint64_t bytes = 0;    /**< 输入的总字节数（含重复次数）。 */
+	uint64_t records = 0;  /**< 输出的记录数。 */
+	uint64_t errors = 0;   /**< 错误计数。 */
+	double seconds = 0.0;  /**< 耗时（秒）。 */
+};
+
+/**
+ * @brief DecoderBench 用固定大小的数据块模拟串口的 readyRead，对任意解码器计时。
+ *
+ * 内置协议和后来登记的协议使用同一个 Run()，结果可以直接对比。
+ * 没有现成采集文件时可以用 GenerateSample() 生成对应协议的合成数据。
+ */
+class DecoderBench
+{
+public:
+	/**
+	 * @brief 生成指定协议的合成数据。
+	 * @param decoder 解码器名称 (pid、nmea、kv)，其他名称返回空字符串。
+	 * @param bytes 期望的数据量，结果会在最后一个完整帧处截断。
+	 * @return 合成数据。
+	 */
+	static std::string GenerateSample(const std::string& decoder, size_t bytes);
+
+	/**
+	 * @brief 把数据按 chunkSize 切块后重复输入解码器 repeat 次并计时。
+	 * @param decoder 被测解码器。
+	 * @param data 输入数据。
+	 * @param chunkSize 每次输入的字节数，模拟一次 readyRead。
+	 * @param repeat 重复次数。
+	 * @return 测试结果。
+	 */
+	static DecoderBenchResult Run(ProtocolDecoder& decoder, ByteSpan data, size_t chunkSize, int repeat);
+
+	/**
+	 * @brief 把结果格式化为一行文本 (MB/s、ns/byte、记录速率)。
+	 */
+	static std::string Format(const DecoderBenchResult& result);
+};
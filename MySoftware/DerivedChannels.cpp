@@ -0,0 +1,590 @@
+/*
+ * @Description: 派生通道，用户表达式编译为栈式字节码，在解码线程中按帧求值
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 21:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "DerivedChannels.h"
+#include "TimeSeriesStore.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace
+{
+	/**
+	 * @brief 求值栈的最大深度，编译时超过即报错，运行时不再检查。
+	 */
+	constexpr int kMaxStack = 32;
+
+	std::string Trim(const std::string& text)
+	{
+		const size_t begin = text.find_first_not_of(" \t\r");
+		if (begin == std::string::npos)
+		{
+			return std::string();
+		}
+		const size_t end = text.find_last_not_of(" \t\r");
+		return text.substr(begin, end - begin + 1);
+	}
+
+	bool IsNameChar(char c)
+	{
+		return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+	}
+}
+
+/**
+ * @brief 递归下降解析一个表达式并生成字节码。
+ * 优先级从低到高：+ -，* / %，一元负号，^（右结合），函数调用与括号。
+ */
+class DerivedChannels::Parser
+{
+public:
+	/**
+	 * @param owner 字节码和变量表的所有者。
+	 * @param text 表达式。
+	 * @param definition 整条定义，用于错误信息。
+	 * @param undefined 尚未定义的派生通道名称，引用它们属于错误。
+	 */
+	Parser(DerivedChannels& owner, const std::string& text, const std::string& definition,
+		const std::unordered_set<std::string>& undefined)
+		: m_owner(owner), m_text(text), m_definition(definition), m_undefined(undefined), m_begin(owner.m_code.size())
+	{
+	}
+
+	/**
+	 * @brief 对 a 中的 arity 个操作数执行运算，a[0] 为最先压栈的操作数，只用于常量折叠。
+	 */
+	static double Apply(OpCode op, const double* a);
+
+	/**
+	 * @brief 解析整个表达式，返回引用的变量编号。
+	 */
+	std::vector<uint32_t> Parse()
+	{
+		ParseSum();
+		SkipSpace();
+		if (m_pos != m_text.size())
+		{
+			Fail("Unexpected '" + m_text.substr(m_pos, 1) + "'");
+		}
+		std::sort(m_inputs.begin(), m_inputs.end());
+		m_inputs.erase(std::unique(m_inputs.begin(), m_inputs.end()), m_inputs.end());
+		return m_inputs;
+	}
+
+private:
+	[[noreturn]] void Fail(const std::string& message) const
+	{
+		throw std::invalid_argument(message + " in derived channel '" + m_definition + "'.");
+	}
+
+	void SkipSpace()
+	{
+		while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+		{
+			++m_pos;
+		}
+	}
+
+	bool Accept(char c)
+	{
+		SkipSpace();
+		if (m_pos < m_text.size() && m_text[m_pos] == c)
+		{
+			++m_pos;
+			return true;
+		}
+		return false;
+	}
+
+	void Expect(char c)
+	{
+		if (!Accept(c))
+		{
+			Fail(std::string("Expected '") + c + "'");
+		}
+	}
+
+	void Push(int delta)
+	{
+		m_depth += delta;
+		if (m_depth > kMaxStack)
+		{
+			Fail("Expression too deeply nested");
+		}
+	}
+
+	/**
+	 * @brief 生成一条运算指令，操作数全为常量时直接折叠为一个常量。
+	 */
+	void Emit(OpCode op, int arity)
+	{
+		std::vector<Instruction>& code = m_owner.m_code;
+		const size_t size = code.size();
+		bool constant = size >= static_cast<size_t>(arity) && size - static_cast<size_t>(arity) >= m_begin;
+		for (int i = 1; constant && i <= arity; ++i)
+		{
+			constant = code[size - static_cast<size_t>(i)].op == OpCode::Const;
+		}
+		if (constant)
+		{
+			double stack[3];
+			for (int i = 0; i < arity; ++i)
+			{
+				stack[i] = code[size - static_cast<size_t>(arity - i)].constant;
+			}
+			code.resize(size - static_cast<size_t>(arity));
+			code.push_back(Instruction{ OpCode::Const, 0, Apply(op, stack) });
+		}
+		else
+		{
+			code.push_back(Instruction{ op, 0, 0.0 });
+		}
+		m_depth -= arity - 1;
+	}
+
+	void ParseSum()
+	{
+		ParseProduct();
+		for (;;)
+		{
+			if (Accept('+'))
+			{
+				ParseProduct();
+				Emit(OpCode::Add, 2);
+			}
+			else if (Accept('-'))
+			{
+				ParseProduct();
+				Emit(OpCode::Sub, 2);
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+
+	void ParseProduct()
+	{
+		ParseUnary();
+		for (;;)
+		{
+			if (Accept('*'))
+			{
+				ParseUnary();
+				Emit(OpCode::Mul, 2);
+			}
+			else if (Accept('/'))
+			{
+				ParseUnary();
+				Emit(OpCode::Div, 2);
+			}
+			else if (Accept('%'))
+			{
+				ParseUnary();
+				Emit(OpCode::Mod, 2);
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+
+	void ParseUnary()
+	{
+		if (Accept('-'))
+		{
+			ParseUnary();
+			Emit(OpCode::Neg, 1);
+			return;
+		}
+		if (Accept('+'))
+		{
+			ParseUnary();
+			return;
+		}
+		ParsePrimary();
+		if (Accept('^'))
+		{
+			ParseUnary();
+			Emit(OpCode::Pow, 2);
+		}
+	}
+
+	void ParsePrimary()
+	{
+		SkipSpace();
+		if (m_pos >= m_text.size())
+		{
+			Fail("Unexpected end of expression");
+		}
+		const char c = m_text[m_pos];
+		if (c == '(')
+		{
+			++m_pos;
+			ParseSum();
+			Expect(')');
+			return;
+		}
+		if (c == '[')
+		{
+			const size_t close = m_text.find(']', m_pos);
+			if (close == std::string::npos)
+			{
+				Fail("Missing ']'");
+			}
+			const std::string name = Trim(m_text.substr(m_pos + 1, close - m_pos - 1));
+			m_pos = close + 1;
+			if (name.empty())
+			{
+				Fail("Empty channel name");
+			}
+			Load(name);
+			return;
+		}
+		if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+		{
+			const char* begin = m_text.c_str() + m_pos;
+			char* end = nullptr;
+			const double value = std::strtod(begin, &end);
+			if (end == begin)
+			{
+				Fail("Invalid number");
+			}
+			m_pos += static_cast<size_t>(end - begin);
+			m_owner.m_code.push_back(Instruction{ OpCode::Const, 0, value });
+			Push(1);
+			return;
+		}
+		if (!IsNameChar(c))
+		{
+			Fail("Unexpected '" + std::string(1, c) + "'");
+		}
+
+		const size_t begin = m_pos;
+		while (m_pos < m_text.size() && IsNameChar(m_text[m_pos]))
+		{
+			++m_pos;
+		}
+		const std::string name = m_text.substr(begin, m_pos - begin);
+		if (Accept('('))
+		{
+			ParseCall(name);
+			return;
+		}
+		Load(name);
+	}
+
+	void ParseCall(const std::string& name)
+	{
+		struct Function
+		{
+			const char* name;
+			OpCode op;
+			int arity;
+		};
+		static const Function kFunctions[] = {
+			{ "abs", OpCode::Abs, 1 }, { "sqrt", OpCode::Sqrt, 1 }, { "exp", OpCode::Exp, 1 },
+			{ "log", OpCode::Log, 1 }, { "sin", OpCode::Sin, 1 }, { "cos", OpCode::Cos, 1 },
+			{ "tan", OpCode::Tan, 1 }, { "atan", OpCode::Atan, 1 }, { "min", OpCode::Min, 2 },
+			{ "max", OpCode::Max, 2 }, { "pow", OpCode::Pow, 2 }, { "atan2", OpCode::Atan2, 2 },
+			{ "hypot", OpCode::Hypot, 2 }, { "clamp", OpCode::Clamp, 3 },
+		};
+		const Function* function = nullptr;
+		for (const Function& candidate : kFunctions)
+		{
+			if (name == candidate.name)
+			{
+				function = &candidate;
+			}
+		}
+		if (function == nullptr)
+		{
+			Fail("Unknown function '" + name + "'");
+		}
+		for (int i = 0; i < function->arity; ++i)
+		{
+			if (i > 0)
+			{
+				Expect(',');
+			}
+			ParseSum();
+		}
+		Expect(')');
+		Emit(function->op, function->arity);
+	}
+
+	void Load(const std::string& name)
+	{
+		if (m_undefined.count(name) != 0)
+		{
+			Fail("Derived channel '" + name + "' used before it is defined");
+		}
+		const uint32_t slot = m_owner.Slot(name);
+		m_inputs.push_back(slot);
+		m_owner.m_code.push_back(Instruction{ OpCode::Load, slot, 0.0 });
+		Push(1);
+	}
+
+	DerivedChannels& m_owner;
+	const std::string& m_text;
+	const std::string& m_definition;
+	const std::unordered_set<std::string>& m_undefined;
+	const size_t m_begin;            /**< 当前表达式的字节码起始位置，常量折叠不越过它。 */
+	size_t m_pos = 0;
+	int m_depth = 0;
+	std::vector<uint32_t> m_inputs;
+};
+
+double DerivedChannels::Parser::Apply(OpCode op, const double* a)
+{
+	switch (op)
+	{
+	case OpCode::Add: return a[0] + a[1];
+	case OpCode::Sub: return a[0] - a[1];
+	case OpCode::Mul: return a[0] * a[1];
+	case OpCode::Div: return a[0] / a[1];
+	case OpCode::Mod: return std::fmod(a[0], a[1]);
+	case OpCode::Pow: return std::pow(a[0], a[1]);
+	case OpCode::Neg: return -a[0];
+	case OpCode::Abs: return std::fabs(a[0]);
+	case OpCode::Sqrt: return std::sqrt(a[0]);
+	case OpCode::Exp: return std::exp(a[0]);
+	case OpCode::Log: return std::log(a[0]);
+	case OpCode::Sin: return std::sin(a[0]);
+	case OpCode::Cos: return std::cos(a[0]);
+	case OpCode::Tan: return std::tan(a[0]);
+	case OpCode::Atan: return std::atan(a[0]);
+	case OpCode::Min: return std::min(a[0], a[1]);
+	case OpCode::Max: return std::max(a[0], a[1]);
+	case OpCode::Atan2: return std::atan2(a[0], a[1]);
+	case OpCode::Hypot: return std::hypot(a[0], a[1]);
+	case OpCode::Clamp: return std::min(std::max(a[0], a[1]), a[2]);
+	default: return std::numeric_limits<double>::quiet_NaN();
+	}
+}
+
+/**
+ * @brief 编译定义：先收集所有派生通道名称，再按顺序解析，
+ * 这样引用后面才定义的派生通道会报错，而不是被当作同名的输入通道。
+ */
+DerivedChannels DerivedChannels::Compile(const std::string& spec)
+{
+	DerivedChannels derived;
+	std::vector<std::pair<std::string, std::string>> definitions;
+	std::unordered_set<std::string> undefined;
+	size_t begin = 0;
+	while (begin <= spec.size())
+	{
+		size_t end = spec.find_first_of(";\n", begin);
+		if (end == std::string::npos)
+		{
+			end = spec.size();
+		}
+		const std::string text = Trim(spec.substr(begin, end - begin));
+		begin = end + 1;
+		if (text.empty() || text[0] == '#')
+		{
+			continue;
+		}
+		const size_t equal = text.find('=');
+		const std::string name = equal == std::string::npos ? std::string() : Trim(text.substr(0, equal));
+		if (name.empty() || !std::all_of(name.begin(), name.end(), IsNameChar))
+		{
+			throw std::invalid_argument("Expected 'name = expression' in derived channel '" + text + "'.");
+		}
+		if (!undefined.insert(name).second)
+		{
+			throw std::invalid_argument("Duplicate derived channel '" + name + "'.");
+		}
+		definitions.emplace_back(name, text);
+	}
+
+	for (const auto& [name, text] : definitions)
+	{
+		undefined.erase(name);
+		const std::string expression = Trim(text.substr(text.find('=') + 1));
+		Expression compiled;
+		compiled.name = name;
+		compiled.begin = derived.m_code.size();
+		// 自身也视为未定义，禁止 x = x + 1 这样的递归定义
+		undefined.insert(name);
+		compiled.inputs = Parser(derived, expression, text, undefined).Parse();
+		undefined.erase(name);
+		// 派生通道只在某个输入更新时计算，没有输入的定义永远不会输出
+		if (compiled.inputs.empty())
+		{
+			throw std::invalid_argument("Derived channel '" + name + "' does not reference any channel; use a constant in the expressions that need it.");
+		}
+		compiled.end = derived.m_code.size();
+		compiled.output = derived.Slot(name);
+		derived.m_expressions.push_back(std::move(compiled));
+		derived.m_source += text;
+		derived.m_source += '\n';
+	}
+	return derived;
+}
+
+uint32_t DerivedChannels::Slot(const std::string& name)
+{
+	auto [it, inserted] = m_slotIds.emplace(name, static_cast<uint32_t>(m_slots.size()));
+	if (inserted)
+	{
+		m_slots.push_back(std::numeric_limits<double>::quiet_NaN());
+		m_stamps.push_back(0);
+	}
+	return it->second;
+}
+
+/**
+ * @brief 执行一个表达式的字节码。栈深度在编译时已经检查，这里不做边界检查。
+ */
+double DerivedChannels::Run(const Expression& expression) const
+{
+	double stack[kMaxStack];
+	double* top = stack - 1;
+	const double* slots = m_slots.data();
+	const Instruction* code = m_code.data();
+	for (size_t i = expression.begin; i < expression.end; ++i)
+	{
+		const Instruction& instruction = code[i];
+		switch (instruction.op)
+		{
+		case OpCode::Const: *++top = instruction.constant; break;
+		case OpCode::Load: *++top = slots[instruction.slot]; break;
+		case OpCode::Add: top[-1] += top[0]; --top; break;
+		case OpCode::Sub: top[-1] -= top[0]; --top; break;
+		case OpCode::Mul: top[-1] *= top[0]; --top; break;
+		case OpCode::Div: top[-1] /= top[0]; --top; break;
+		case OpCode::Mod: top[-1] = std::fmod(top[-1], top[0]); --top; break;
+		case OpCode::Pow: top[-1] = std::pow(top[-1], top[0]); --top; break;
+		case OpCode::Neg: top[0] = -top[0]; break;
+		case OpCode::Abs: top[0] = std::fabs(top[0]); break;
+		case OpCode::Sqrt: top[0] = std::sqrt(top[0]); break;
+		case OpCode::Exp: top[0] = std::exp(top[0]); break;
+		case OpCode::Log: top[0] = std::log(top[0]); break;
+		case OpCode::Sin: top[0] = std::sin(top[0]); break;
+		case OpCode::Cos: top[0] = std::cos(top[0]); break;
+		case OpCode::Tan: top[0] = std::tan(top[0]); break;
+		case OpCode::Atan: top[0] = std::atan(top[0]); break;
+		case OpCode::Min: top[-1] = std::min(top[-1], top[0]); --top; break;
+		case OpCode::Max: top[-1] = std::max(top[-1], top[0]); --top; break;
+		case OpCode::Atan2: top[-1] = std::atan2(top[-1], top[0]); --top; break;
+		case OpCode::Hypot: top[-1] = std::hypot(top[-1], top[0]); --top; break;
+		case OpCode::Clamp: top[-2] = std::min(std::max(top[-2], top[-1]), top[0]); top -= 2; break;
+		}
+	}
+	return *top;
+}
+
+void DerivedChannels::Update(uint32_t slot, double value)
+{
+	m_slots[slot] = value;
+	m_stamps[slot] = m_stamp;
+}
+
+/**
+ * @brief 更新输入并求值。帧头类记录的字段变量编号按帧头缓存，与 AlarmEngine 相同；
+ * 表达式按定义顺序检查，只要有一个输入在本条记录中更新过就重新求值，
+ * 结果也会标记为已更新，后面引用它的表达式随之重新求值。
+ */
+void DerivedChannels::OnRecord(const DecodedRecord& record, RecordSink& sink, const std::string& prefix)
+{
+	if (m_expressions.empty() || record.values == nullptr)
+	{
+		return;
+	}
+	++m_stamp;
+	bool updated = false;
+
+	if (record.keys != nullptr)
+	{
+		for (size_t i = 0; i < record.count; ++i)
+		{
+			if (std::isnan(record.values[i]))
+			{
+				continue;
+			}
+			TimeSeriesStore::ChannelKey(record, i, m_keyBuffer);
+			if (!prefix.empty())
+			{
+				m_keyBuffer.insert(0, prefix);
+			}
+			auto it = m_slotIds.find(m_keyBuffer);
+			if (it != m_slotIds.end())
+			{
+				Update(it->second, record.values[i]);
+				updated = true;
+			}
+		}
+	}
+	else
+	{
+		m_keyBuffer.assign(prefix);
+		m_keyBuffer.append(record.name.data(), record.name.size());
+		std::vector<int>& slots = m_recordSlots[m_keyBuffer];
+		if (slots.size() < record.count)
+		{
+			std::string key;
+			for (size_t i = slots.size(); i < record.count; ++i)
+			{
+				TimeSeriesStore::ChannelKey(record, i, key);
+				auto it = m_slotIds.find(prefix + key);
+				slots.push_back(it == m_slotIds.end() ? -1 : static_cast<int>(it->second));
+			}
+		}
+		for (size_t i = 0; i < record.count; ++i)
+		{
+			if (slots[i] >= 0 && !std::isnan(record.values[i]))
+			{
+				Update(static_cast<uint32_t>(slots[i]), record.values[i]);
+				updated = true;
+			}
+		}
+	}
+	if (!updated)
+	{
+		return;
+	}
+
+	m_outKeys.clear();
+	m_outValues.clear();
+	for (const Expression& expression : m_expressions)
+	{
+		const bool affected = std::any_of(expression.inputs.begin(), expression.inputs.end(),
+			[this](uint32_t slot) { return m_stamps[slot] == m_stamp; });
+		if (!affected)
+		{
+			continue;
+		}
+		++m_evaluations;
+		const double value = Run(expression);
+		if (std::isnan(value))
+		{
+			continue;
+		}
+		Update(expression.output, value);
+		m_outKeys.emplace_back(expression.name);
+		m_outValues.push_back(value);
+	}
+	if (m_outValues.empty())
+	{
+		return;
+	}
+
+	DecodedRecord derived;
+	derived.kind = RecordKind::KeyValue;
+	derived.raw = record.raw;
+	derived.keys = m_outKeys.data();
+	derived.values = m_outValues.data();
+	derived.count = m_outValues.size();
+	sink.OnRecord(derived);
+}
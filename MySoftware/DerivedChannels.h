@@ -0,0 +1,136 @@
+/*
+ * @Description: 派生通道，用户表达式编译为栈式字节码，在解码线程中按帧求值
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 21:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief DerivedChannels 按用户表达式从解码数值计算新的通道。
+ *
+ * 定义每行（或以分号分隔）一条：名称 = 表达式，例如
+ *   u1 = START1.P * err + START1.I * acc
+ *   temp_f = START2.0 * 1.8 + 32
+ *   power = [volt] * [amp]
+ * 表达式支持 + - * / % ^、一元负号、括号和函数 abs sqrt exp log sin cos tan atan min max pow atan2 hypot clamp；
+ * 变量为曲线窗口中的通道名称（字母、数字、下划线和点），其他字符的名称写在方括号中；
+ * 可以引用前面定义的派生通道。
+ *
+ * 每个表达式编译一次为栈式字节码，常量子表达式在编译时折叠。求值时变量按编号从数组中读取，
+ * 没有字符串查找和内存分配。一条记录只会触发引用了其中某个通道的表达式，
+ * 结果以 key=value 记录的形式交给 RecordSink，键名为派生通道名称，
+ * 因此曲线、报警、滤波和帧输出都可以像普通通道一样使用它们。
+ * 任一输入尚未出现过（或结果为 NaN）时不输出该通道。
+ */
+class DerivedChannels
+{
+public:
+	/**
+	 * @brief 编译派生通道定义，空文本得到没有派生通道的对象。
+	 * @throw std::invalid_argument 如果某条定义无法解析，信息中包含定义原文。
+	 * 不引用任何通道的定义（如 k = 2 * 3）永远不会被求值，同样报错。
+	 */
+	static DerivedChannels Compile(const std::string& spec);
+
+	/**
+	 * @brief 用一条记录更新输入，求值受影响的表达式，把结果作为一条记录交给 sink。
+	 * @param record 解码记录，派生记录本身不应再传入。
+	 * @param sink 接收派生记录。
+	 * @param prefix 加在输入通道名称前的前缀，多个串口时用于区分同名通道。
+	 */
+	void OnRecord(const DecodedRecord& record, RecordSink& sink, const std::string& prefix = std::string());
+
+	bool IsEmpty() const { return m_expressions.empty(); }
+	size_t Count() const { return m_expressions.size(); }
+	const std::string& Name(size_t i) const { return m_expressions[i].name; }
+
+	/**
+	 * @brief 定义的原文，每行一条。
+	 */
+	const std::string& Source() const { return m_source; }
+
+	/**
+	 * @brief 累计的表达式求值次数。
+	 */
+	uint64_t Evaluations() const { return m_evaluations; }
+
+	/**
+	 * @brief 字节码指令总数。
+	 */
+	size_t CodeSize() const { return m_code.size(); }
+
+private:
+	enum class OpCode : uint8_t
+	{
+		Const,
+		Load,
+		Add,
+		Sub,
+		Mul,
+		Div,
+		Mod,
+		Pow,
+		Neg,
+		Abs,
+		Sqrt,
+		Exp,
+		Log,
+		Sin,
+		Cos,
+		Tan,
+		Atan,
+		Min,
+		Max,
+		Atan2,
+		Hypot,
+		Clamp
+	};
+
+	/**
+	 * @brief 一条字节码指令，Const 使用 constant，Load 使用 slot。
+	 */
+	struct Instruction
+	{
+		OpCode op;
+		uint32_t slot;
+		double constant;
+	};
+
+	/**
+	 * @brief 一个编译后的表达式。
+	 */
+	struct Expression
+	{
+		std::string name;            /**< 派生通道名称。 */
+		uint32_t output = 0;         /**< 结果写入的变量编号。 */
+		size_t begin = 0;            /**< 字节码在 m_code 中的起始位置。 */
+		size_t end = 0;              /**< 字节码的结束位置。 */
+		std::vector<uint32_t> inputs; /**< 引用的变量编号，去重。 */
+	};
+
+	class Parser;
+
+	uint32_t Slot(const std::string& name);
+	double Run(const Expression& expression) const;
+	void Update(uint32_t slot, double value);
+
+	std::vector<Expression> m_expressions;           /**< 按定义顺序排列的表达式。 */
+	std::vector<Instruction> m_code;                 /**< 所有表达式的字节码。 */
+	std::unordered_map<std::string, uint32_t> m_slotIds; /**< 变量名称到编号的映射。 */
+	std::vector<double> m_slots;                     /**< 各变量的最新值，未出现过为 NaN。 */
+	std::vector<uint64_t> m_stamps;                  /**< 各变量最近一次更新时的记录序号。 */
+	uint64_t m_stamp = 0;                            /**< 当前记录序号。 */
+	std::unordered_map<std::string, std::vector<int>> m_recordSlots; /**< 帧头名称到各字段变量编号的缓存，-1 表示未引用。 */
+	std::string m_keyBuffer;                         /**< 生成通道名称的缓冲。 */
+	std::vector<ByteSpan> m_outKeys;                 /**< 派生记录的键名。 */
+	std::vector<double> m_outValues;                 /**< 派生记录的数值。 */
+	std::string m_source;                            /**< 定义原文。 */
+	uint64_t m_evaluations = 0;                      /**< 累计求值次数。 */
+};
@@ -0,0 +1,121 @@
+/*
+ * @Description: 界面刷新调度器，按固定帧率合并刷新标签、计数和接收区
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 15:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "DisplayScheduler.h"
+#include "TraceRecorder.h"
+#include <QtCore/QDebug>
+#include <QtCore/QStringList>
+#include <stdexcept>
+
+DisplayScheduler::DisplayScheduler(QObject* parent, int intervalMs)
+	: QObject(parent)
+{
+	m_timer.setTimerType(Qt::PreciseTimer);
+	m_timer.setInterval(intervalMs);
+	connect(&m_timer, &QTimer::timeout, this, &DisplayScheduler::Tick);
+}
+
+/**
+ * @brief 登记一个刷新区域。
+ * @throw std::length_error 如果区域数量超过 64。
+ */
+DisplayScheduler::RegionId DisplayScheduler::AddRegion(const char* name, std::function<void()> flush)
+{
+	if (m_regions.size() >= 64)
+	{
+		throw std::length_error("Too many display regions.");
+	}
+	m_regions.push_back({ name, std::move(flush) });
+	return static_cast<RegionId>(m_regions.size() - 1);
+}
+
+/**
+ * @brief 标记区域需要刷新，时钟未运行时启动时钟。
+ */
+void DisplayScheduler::MarkDirty(RegionId id)
+{
+	m_dirty |= quint64(1) << id;
+	if (!m_timer.isActive())
+	{
+		m_timer.start();
+	}
+}
+
+void DisplayScheduler::FlushNow()
+{
+	Tick();
+}
+
+/**
+ * @brief 刷新所有被标记的区域；没有被标记的区域时停止时钟。
+ * 先清除标记再调用刷新函数，刷新函数内部再次标记的区域留到下一个周期。
+ */
+void DisplayScheduler::Tick()
+{
+	if (m_dirty == 0)
+	{
+		m_timer.stop();
+		return;
+	}
+
+	TRACE_ZONE("DisplayScheduler::Tick");
+	const quint64 dirty = m_dirty;
+	m_dirty = 0;
+	++m_flushCount;
+	for (size_t i = 0; i < m_regions.size(); ++i)
+	{
+		if (dirty & (quint64(1) << i))
+		{
+			TRACE_ZONE(m_regions[i].name);
+			m_regions[i].flush();
+		}
+	}
+}
+
+ConsoleBuffer::ConsoleBuffer(int maxLines)
+	: m_maxLines(static_cast<size_t>(maxLines > 0 ? maxLines : 1))
+{
+}
+
+/**
+ * @brief 追加一行文本，积压超过上限时丢弃最旧的行。
+ */
+void ConsoleBuffer::Append(QString line)
+{
+	if (m_lines.size() == m_maxLines)
+	{
+		m_lines.pop_front();
+		++m_skipped;
+	}
+	m_lines.push_back(std::move(line));
+}
+
+/**
+ * @brief 取出所有待输出的行，以换行连接；有行被丢弃时在开头注明数量。
+ */
+QString ConsoleBuffer::Take()
+{
+	QStringList lines;
+	lines.reserve(static_cast<int>(m_lines.size()) + 1);
+	if (m_skipped != 0)
+	{
+		lines << QString("... %1 lines skipped").arg(m_skipped);
+	}
+	for (QString& line : m_lines)
+	{
+		lines << std::move(line);
+	}
+	m_lines.clear();
+	m_skipped = 0;
+	return lines.join('\n');
+}
+
+void ConsoleBuffer::Clear()
+{
+	m_lines.clear();
+	m_skipped = 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * @Description: 界面刷新调度器，按固定帧率合并刷新标签、计数和接收区
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 15:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <deque>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief DisplayScheduler 把界面刷新集中到一个约 60 Hz 的时钟上。
+ *
+ * 数据到达时只更新状态并调用 MarkDirty 标记对应区域，不直接操作控件；
+ * 每个时钟周期对所有被标记的区域各调用一次刷新函数，刷新函数只显示最新状态。
+ * 因此无论输入速率多高，每个区域每秒最多刷新 60 次。
+ * 没有区域被标记时时钟自动停止，空闲时不产生任何开销。
+ */
+class DisplayScheduler : public QObject
+{
+	Q_OBJECT
+
+public:
+	using RegionId = int;
+
+	/**
+	 * @brief 默认刷新间隔（毫秒），约 60 Hz。
+	 */
+	static constexpr int kDefaultIntervalMs = 16;
+
+	/**
+	 * @brief 构造函数。
+	 * @param parent 父对象。
+	 * @param intervalMs 刷新间隔（毫秒）。
+	 */
+	explicit DisplayScheduler(QObject* parent = nullptr, int intervalMs = kDefaultIntervalMs);
+
+	/**
+	 * @brief 登记一个刷新区域。
+	 * @param name 区域名称，用于调试输出。
+	 * @param flush 刷新函数，在 GUI 线程中调用。
+	 * @return 区域编号，最多 64 个区域。
+	 */
+	RegionId AddRegion(const char* name, std::function<void()> flush);
+
+	/**
+	 * @brief 标记区域需要刷新，实际刷新发生在下一个时钟周期。
+	 * @param id 区域编号。
+	 */
+	void MarkDirty(RegionId id);
+
+	/**
+	 * @brief 立即刷新所有被标记的区域，例如在关闭串口时显示最终状态。
+	 */
+	void FlushNow();
+
+	/**
+	 * @brief 实际执行过刷新的时钟周期数。
+	 */
+	quint64 FlushCount() const { return m_flushCount; }
+
+private slots:
+	/**
+	 * @brief 时钟周期处理函数。
+	 */
+	void Tick();
+
+private:
+	/**
+	 * @brief 刷新区域。
+	 */
+	struct Region
+	{
+		const char* name;            /**< 区域名称。 */
+		std::function<void()> flush; /**< 刷新函数。 */
+	};
+
+	std::vector<Region> m_regions; /**< 已登记的区域。 */
+	quint64 m_dirty = 0;           /**< 被标记区域的位掩码。 */
+	quint64 m_flushCount = 0;      /**< 执行过刷新的时钟周期数。 */
+	QTimer m_timer;                /**< 刷新时钟。 */
+};
+
+/**
+ * @brief ConsoleBuffer 暂存要追加到接收区的文本行，由刷新函数一次性取出。
+ *
+ * 每次刷新最多保留 maxLines 行，积压更多时丢弃最旧的行并在输出中注明跳过的行数，
+ * 这样高速输入下每帧追加到文本框的内容也是有上限的。
+ */
+class ConsoleBuffer
+{
+public:
+	/**
+	 * @brief 构造函数。
+	 * @param maxLines 每次刷新最多输出的行数。
+	 */
+	explicit ConsoleBuffer(int maxLines = 200);
+
+	/**
+	 * @brief 追加一行文本。
+	 */
+	void Append(QString line);
+
+	/**
+	 * @brief 是否没有待输出的文本。
+	 */
+	bool IsEmpty() const { return m_lines.empty() && m_skipped == 0; }
+
+	/**
+	 * @brief 取出所有待输出的行，以换行连接。
+	 */
+	QString Take();
+
+	/**
+	 * @brief 丢弃所有待输出的行。
+	 */
+	void Clear();
+
+private:
+	std::deque<QString> m_lines; /**< 待输出的行。 */
+	size_t m_maxLines;           /**< 每次刷新最多输出的行数。 */
+	quint64 m_skipped = 0;       /**< 本周期被丢弃的行数。 */
+};
@@ -0,0 +1,114 @@
+/*
+ * @Description: 报警等事件的本地 TCP 广播，每个事件一行文本
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 20:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "EventBridge.h"
+#include "SerialFanout.h"
+#include <QtCore/QDebug>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <algorithm>
+#include <stdexcept>
+
+EventBridge::EventBridge(QObject* parent)
+	: QObject(parent)
+{
+}
+
+EventBridge::~EventBridge()
+{
+	Close();
+}
+
+/**
+ * @brief 在 127.0.0.1 上监听 TCP 端口。
+ * @throw std::runtime_error 如果监听失败。
+ */
+void EventBridge::ListenTcp(quint16 port)
+{
+	if (m_server == nullptr)
+	{
+		m_server = new QTcpServer(this);
+		connect(m_server, &QTcpServer::newConnection, this, [this]() {
+			while (QTcpSocket* socket = m_server->nextPendingConnection())
+			{
+				socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+				connect(socket, &QTcpSocket::disconnected, this, [this, socket]() { RemoveClient(socket, false); });
+				// 丢弃客户端发来的数据，避免在接收缓冲区中堆积
+				connect(socket, &QTcpSocket::readyRead, socket, [socket]() { socket->readAll(); });
+				m_clients.push_back(socket);
+				qDebug() << "Event bridge client connected, total" << m_clients.size();
+			}
+			});
+	}
+	if (!m_server->listen(QHostAddress::LocalHost, port))
+	{
+		throw std::runtime_error(QString("Failed to listen on 127.0.0.1:%1: %2")
+			.arg(port).arg(m_server->errorString()).toStdString());
+	}
+	qDebug() << "Event bridge listening on 127.0.0.1:" << m_server->serverPort();
+}
+
+void EventBridge::Close()
+{
+	if (m_server)
+	{
+		m_server->close();
+	}
+	const std::vector<QTcpSocket*> sockets = m_clients;
+	for (QTcpSocket* socket : sockets)
+	{
+		RemoveClient(socket, false);
+	}
+}
+
+bool EventBridge::IsListening() const
+{
+	return m_server != nullptr && m_server->isListening();
+}
+
+/**
+ * @brief 向所有客户端发送一行。按下标倒序遍历，断开客户端不影响后续下标。
+ */
+void EventBridge::Broadcast(const QByteArray& line)
+{
+	if (m_clients.empty())
+	{
+		return;
+	}
+	++m_eventsSent;
+	for (size_t i = m_clients.size(); i > 0; --i)
+	{
+		QTcpSocket* socket = m_clients[i - 1];
+		if (socket->bytesToWrite() > SerialFanout::kSocketHighWater)
+		{
+			RemoveClient(socket, true);
+			continue;
+		}
+		socket->write(line);
+		socket->write("\n", 1);
+		socket->flush();
+	}
+}
+
+void EventBridge::RemoveClient(QTcpSocket* socket, bool dropped)
+{
+	auto it = std::find(m_clients.begin(), m_clients.end(), socket);
+	if (it == m_clients.end())
+	{
+		return;
+	}
+	m_clients.erase(it);
+	if (dropped)
+	{
+		++m_droppedClients;
+		qDebug() << "Event bridge client dropped: too slow";
+	}
+	socket->disconnect(this);
+	socket->abort();
+	socket->deleteLater();
+}
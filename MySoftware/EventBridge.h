@@ -0,0 +1,62 @@
+/*
+ * @Description: 报警等事件的本地 TCP 广播，每个事件一行文本
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 20:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <vector>
+
+class QTcpServer;
+class QTcpSocket;
+
+/**
+ * @brief EventBridge 在 127.0.0.1 上监听一个 TCP 端口，把事件按行广播给所有客户端。
+ *
+ * SerialFanout 的客户端收到的是原样的串口字节流，事件混在其中会破坏客户端的解析，
+ * 因此事件使用单独的端口。事件写入后立即 flush，不等待事件循环下一次调度；
+ * 单个客户端积压超过 SerialFanout::kSocketHighWater 时断开，不让慢客户端占用内存。
+ * 客户端发来的数据被忽略。
+ */
+class EventBridge : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit EventBridge(QObject* parent = nullptr);
+	~EventBridge();
+
+	/**
+	 * @brief 在 127.0.0.1 上监听 TCP 端口。
+	 * @param port TCP 端口号。
+	 * @throw std::runtime_error 如果监听失败。
+	 */
+	void ListenTcp(quint16 port);
+
+	/**
+	 * @brief 关闭监听并断开所有客户端。
+	 */
+	void Close();
+
+	bool IsListening() const;
+
+	/**
+	 * @brief 向所有客户端发送一行，line 不含换行符。
+	 */
+	void Broadcast(const QByteArray& line);
+
+	int ClientCount() const { return static_cast<int>(m_clients.size()); }
+	quint64 DroppedClients() const { return m_droppedClients; }
+	quint64 EventsSent() const { return m_eventsSent; }
+
+private:
+	void RemoveClient(QTcpSocket* socket, bool dropped);
+
+	QTcpServer* m_server = nullptr;     /**< TCP 监听。 */
+	std::vector<QTcpSocket*> m_clients; /**< 已连接的客户端。 */
+	quint64 m_droppedClients = 0;       /**< 因积压过多被断开的客户端数量。 */
+	quint64 m_eventsSent = 0;           /**< 广播的事件数量。 */
+};
@@ -0,0 +1,350 @@
+/*
+ * @Description: 文件/固件发送，把内存映射的文件通过串口发送通道以 XMODEM-1K、YMODEM 或带窗口的原始流发出
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 17:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "FileTransfer.h"
+#include "SerialInfo.h"
+#include <QtCore/QFileInfo>
+#include <stdexcept>
+
+QStringList FileTransfer::ModeNames()
+{
+	return { "ymodem", "xmodem1k", "raw" };
+}
+
+FileTransfer::Mode FileTransfer::ParseMode(const QString& name)
+{
+	const int index = ModeNames().indexOf(name.toLower());
+	if (index < 0)
+	{
+		throw std::invalid_argument(QString("Unknown transfer mode: %1").arg(name).toStdString());
+	}
+	return static_cast<Mode>(index);
+}
+
+FileTransfer::FileTransfer(SerialInfo* serial, QObject* parent)
+	: QObject(parent), m_serial(serial)
+{
+	m_timeout.setSingleShot(true);
+	connect(&m_timeout, &QTimer::timeout, this, &FileTransfer::HandleTimeout);
+}
+
+/**
+ * @brief 析构时仍在发送则通知接收端取消，但不再发出信号，避免接收方在析构过程中弹出对话框。
+ */
+FileTransfer::~FileTransfer()
+{
+	if (m_running)
+	{
+		blockSignals(true);
+		Cancel();
+	}
+}
+
+/**
+ * @brief 开始发送文件。
+ * XMODEM/YMODEM 模式下先等待接收端发出 'C'，原始模式立即开始写出。
+ * @throw std::runtime_error 如果已有发送在进行、串口未打开、使用原生后端或文件无法打开。
+ */
+void FileTransfer::Start(const QString& path, Mode mode, qint64 window)
+{
+	if (m_running)
+	{
+		throw std::runtime_error("A file transfer is already running.");
+	}
+	if (m_serial->GetBackend() != SerialInfo::Backend::QtSerialPort)
+	{
+		throw std::runtime_error("File transfer requires the QSerialPort backend.");
+	}
+	// QSerialPort 在串口线程中，对它的调用都经 RunOnPortThread 执行，bytesWritten 排队送到本线程
+	QSerialPort* port = m_serial->GetSerialPort();
+	if (port == nullptr || !m_serial->RunOnPortThread([port]() { return port->isOpen(); }))
+	{
+		throw std::runtime_error("Serial port is not open.");
+	}
+
+	m_file.close();
+	m_file.setFileName(path);
+	if (!m_file.open(QIODevice::ReadOnly))
+	{
+		throw std::runtime_error(QString("Failed to open %1: %2").arg(path, m_file.errorString()).toStdString());
+	}
+	m_fallback.clear();
+	m_data = ByteSpan();
+	if (m_file.size() > 0)
+	{
+		if (const uchar* mapped = m_file.map(0, m_file.size()))
+		{
+			m_data = ByteSpan(reinterpret_cast<const char*>(mapped), static_cast<size_t>(m_file.size()));
+		}
+		else
+		{
+			m_fallback = m_file.readAll();
+			m_data = ByteSpan(m_fallback.constData(), static_cast<size_t>(m_fallback.size()));
+		}
+	}
+
+	m_mode = mode;
+	m_window = qMax<qint64>(window, 256);
+	m_rawOffset = 0;
+	m_output.clear();
+	m_elapsedNs = 0;
+	m_clock.invalidate();
+	m_running = true;
+
+	m_writtenConnection = connect(port, &QSerialPort::bytesWritten, this, &FileTransfer::HandleBytesWritten);
+	if (mode == Mode::Raw)
+	{
+		m_xmodem.reset();
+		PumpRaw();
+		return;
+	}
+
+	m_xmodem = std::make_unique<XmodemSender>(m_data,
+		mode == Mode::Ymodem ? XmodemSender::Variant::Ymodem : XmodemSender::Variant::Xmodem1k,
+		QFileInfo(path).fileName().toStdString());
+	m_dataConnection = connect(m_serial, &SerialInfo::DataReceived, this, &FileTransfer::HandleData);
+	m_timeout.start(PacketTimeoutMs());
+	qDebug() << "File transfer waiting for receiver:" << path << ModeNames().at(static_cast<int>(mode));
+}
+
+void FileTransfer::Cancel()
+{
+	if (!m_running)
+	{
+		return;
+	}
+	if (m_xmodem)
+	{
+		m_xmodem->Cancel(m_output);
+		FlushOutput();
+	}
+	Finish(false, "Cancelled.");
+}
+
+qint64 FileTransfer::SentBytes() const
+{
+	if (m_xmodem)
+	{
+		return static_cast<qint64>(m_xmodem->AckedBytes());
+	}
+	return m_rawOffset;
+}
+
+QString FileTransfer::FileName() const
+{
+	return QFileInfo(m_file.fileName()).fileName();
+}
+
+/**
+ * @brief 线路速率上限：每个字符包含 1 个起始位、数据位、可选的校验位和停止位。
+ */
+double FileTransfer::LineRate() const
+{
+	const QSerialPort* port = m_serial->GetSerialPort();
+	if (port == nullptr)
+	{
+		return 0;
+	}
+	return m_serial->RunOnPortThread([port]() {
+		double bits = 1.0 + static_cast<int>(port->dataBits());
+		bits += port->parity() == QSerialPort::NoParity ? 0.0 : 1.0;
+		switch (port->stopBits())
+		{
+		case QSerialPort::OneAndHalfStop:
+			bits += 1.5;
+			break;
+		case QSerialPort::TwoStop:
+			bits += 2.0;
+			break;
+		default:
+			bits += 1.0;
+			break;
+		}
+		return port->baudRate() / bits;
+		});
+}
+
+double FileTransfer::Throughput() const
+{
+	const qint64 elapsedNs = m_running ? (m_clock.isValid() ? m_clock.nsecsElapsed() : 0) : m_elapsedNs;
+	return elapsedNs > 0 ? SentBytes() / (elapsedNs / 1e9) : 0.0;
+}
+
+QString FileTransfer::Summary() const
+{
+	const qint64 elapsedNs = m_running ? (m_clock.isValid() ? m_clock.nsecsElapsed() : 0) : m_elapsedNs;
+	const double lineRate = LineRate();
+	const double throughput = Throughput();
+	QString text = QString("%1 %2/%3 bytes in %4 s, %5 B/s")
+		.arg(FileName())
+		.arg(SentBytes())
+		.arg(TotalBytes())
+		.arg(elapsedNs / 1e9, 0, 'f', 2)
+		.arg(throughput, 0, 'f', 0);
+	if (lineRate > 0)
+	{
+		text += QString(" (%1% of %2 B/s line rate)").arg(100.0 * throughput / lineRate, 0, 'f', 1).arg(lineRate, 0, 'f', 0);
+	}
+	if (m_xmodem)
+	{
+		text += QString(", %1 retries").arg(m_xmodem->Retries());
+	}
+	return text;
+}
+
+/**
+ * @brief 把接收端的应答交给状态机，并立即写出它产生的下一块数据。
+ */
+void FileTransfer::HandleData(const QByteArray& data)
+{
+	if (!m_running || !m_xmodem)
+	{
+		return;
+	}
+	const size_t acked = m_xmodem->AckedBytes();
+	m_xmodem->OnReceive(ByteSpan(data.constData(), static_cast<size_t>(data.size())), m_output);
+	FlushOutput();
+	if (!m_running)
+	{
+		return;
+	}
+	if (m_xmodem->AckedBytes() != acked)
+	{
+		emit Progress(SentBytes(), TotalBytes());
+	}
+
+	if (m_xmodem->GetState() == XmodemSender::State::Done)
+	{
+		Finish(true, Summary());
+	}
+	else if (m_xmodem->GetState() == XmodemSender::State::Failed)
+	{
+		Finish(false, QString::fromStdString(m_xmodem->Error()));
+	}
+	else
+	{
+		m_timeout.start(PacketTimeoutMs());
+	}
+}
+
+/**
+ * @brief 串口写出了一部分数据：原始模式补充窗口，全部写出后结束。
+ */
+void FileTransfer::HandleBytesWritten(qint64)
+{
+	if (!m_running || m_xmodem)
+	{
+		return;
+	}
+	PumpRaw();
+}
+
+void FileTransfer::HandleTimeout()
+{
+	if (!m_running || !m_xmodem)
+	{
+		return;
+	}
+	m_xmodem->OnTimeout(m_output);
+	FlushOutput();
+	if (!m_running)
+	{
+		return;
+	}
+	if (m_xmodem->GetState() == XmodemSender::State::Failed)
+	{
+		Finish(false, QString::fromStdString(m_xmodem->Error()));
+		return;
+	}
+	m_timeout.start(PacketTimeoutMs());
+}
+
+void FileTransfer::Write(const char* data, qint64 length)
+{
+	if (!m_clock.isValid())
+	{
+		m_clock.start();
+	}
+	QSerialPort* port = m_serial->GetSerialPort();
+	const QString error = m_serial->RunOnPortThread([port, data, length]() {
+		return port->write(data, length) == length ? QString() : port->errorString();
+		});
+	if (!error.isNull())
+	{
+		Finish(false, QString("Serial write failed: %1").arg(error));
+		return;
+	}
+	FlightRecorder::Instance().Record(FlightRecorder::Kind::Tx, m_serial->FlightChannel(), data, static_cast<size_t>(length));
+}
+
+void FileTransfer::FlushOutput()
+{
+	if (!m_output.empty())
+	{
+		Write(m_output.data(), static_cast<qint64>(m_output.size()));
+		m_output.clear();
+	}
+}
+
+/**
+ * @brief 原始模式：把写缓冲补充到 m_window 字节，文件写完且缓冲为空时结束。
+ */
+void FileTransfer::PumpRaw()
+{
+	QSerialPort* port = m_serial->GetSerialPort();
+	auto bytesToWrite = [this, port]() { return m_serial->RunOnPortThread([port]() { return port->bytesToWrite(); }); };
+	const qint64 total = TotalBytes();
+	const qint64 before = m_rawOffset;
+	while (m_running && m_rawOffset < total)
+	{
+		const qint64 room = m_window - bytesToWrite();
+		if (room <= 0)
+		{
+			break;
+		}
+		const qint64 length = qMin(room, total - m_rawOffset);
+		Write(m_data.data() + m_rawOffset, length);
+		m_rawOffset += length;
+	}
+	if (!m_running)
+	{
+		return;
+	}
+	if (m_rawOffset != before)
+	{
+		emit Progress(m_rawOffset, total);
+	}
+	if (m_rawOffset >= total && bytesToWrite() == 0)
+	{
+		Finish(true, Summary());
+	}
+}
+
+void FileTransfer::Finish(bool ok, const QString& message)
+{
+	if (!m_running)
+	{
+		return;
+	}
+	m_elapsedNs = m_clock.isValid() ? m_clock.nsecsElapsed() : 0;
+	m_running = false;
+	m_timeout.stop();
+	disconnect(m_dataConnection);
+	disconnect(m_writtenConnection);
+	qDebug() << "File transfer finished:" << ok << message;
+	emit Finished(ok, message);
+}
+
+/**
+ * @brief 等待应答的超时：至少 3 秒，低波特率下按两个 1K 数据包的发送时间放宽。
+ */
+int FileTransfer::PacketTimeoutMs() const
+{
+	const double lineRate = LineRate();
+	const int packetMs = lineRate > 0 ? static_cast<int>(2 * 1029 * 1000 / lineRate) : 0;
+	return qMax(3000, packetMs + 1000);
+}
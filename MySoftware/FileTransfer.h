@@ -0,0 +1,138 @@
+/*
+ * @Description: 文件/固件发送，把内存映射的文件通过串口发送通道以 XMODEM-1K、YMODEM 或带窗口的原始流发出
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 17:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <memory>
+#include <string>
+#include "ProtocolDecoder.h"
+#include "XmodemSender.h"
+
+class SerialInfo;
+
+/**
+ * @brief FileTransfer 把一个文件通过 SerialInfo 的发送通道发送出去。
+ *
+ * 文件用 QFile::map 映射到内存，数据块直接从映射区复制到串口写缓冲，不整体读入。
+ * XMODEM-1K/YMODEM 由 XmodemSender 驱动，收到 ACK 后立即写出下一块；
+ * 原始模式下串口写缓冲中最多保留 window 字节，每写出一部分就补充一部分，
+ * 既能让线路保持满载，又不会把整个文件一次性堆进写缓冲。
+ * 进度和有效吞吐量可以与线路速率上限（波特率除以每字符位数）对比。
+ */
+class FileTransfer : public QObject
+{
+	Q_OBJECT
+
+public:
+	/**
+	 * @brief 发送模式。
+	 */
+	enum class Mode
+	{
+		Ymodem,   /**< YMODEM 单文件批次，接收端可以得到文件名和长度。 */
+		Xmodem1k, /**< XMODEM-1K，CRC16 校验。 */
+		Raw       /**< 原始字节流，不等待确认。 */
+	};
+
+	/**
+	 * @brief 所有模式的名称，顺序与 Mode 一致。
+	 */
+	static QStringList ModeNames();
+
+	/**
+	 * @brief 按名称查找模式。
+	 * @throw std::invalid_argument 如果名称未知。
+	 */
+	static Mode ParseMode(const QString& name);
+
+	/**
+	 * @brief 构造函数。
+	 * @param serial 发送使用的串口，必须比本对象活得更久。
+	 * @param parent 父对象。
+	 */
+	explicit FileTransfer(SerialInfo* serial, QObject* parent = nullptr);
+	~FileTransfer();
+
+	/**
+	 * @brief 开始发送文件。
+	 * @param path 文件路径。
+	 * @param mode 发送模式。
+	 * @param window 原始模式下串口写缓冲中最多保留的字节数。
+	 * @throw std::runtime_error 如果已有发送在进行、串口未打开、使用原生后端或文件无法打开。
+	 */
+	void Start(const QString& path, Mode mode, qint64 window = 16384);
+
+	/**
+	 * @brief 取消发送，XMODEM/YMODEM 会通知接收端。
+	 */
+	void Cancel();
+
+	bool IsRunning() const { return m_running; }
+	qint64 SentBytes() const;
+	qint64 TotalBytes() const { return static_cast<qint64>(m_data.size()); }
+	QString FileName() const;
+
+	/**
+	 * @brief 当前串口配置下的线路速率上限（字节/秒）。
+	 */
+	double LineRate() const;
+
+	/**
+	 * @brief 从第一个字节写出开始计算的有效吞吐量（字节/秒）。
+	 */
+	double Throughput() const;
+
+	/**
+	 * @brief 一行进度摘要：字节数、耗时、吞吐量及其占线路速率的比例。
+	 */
+	QString Summary() const;
+
+signals:
+	/**
+	 * @brief 发送进度，已确认（原始模式为已写出）的字节数。
+	 */
+	void Progress(qint64 sent, qint64 total);
+
+	/**
+	 * @brief 发送结束。
+	 * @param ok 是否成功。
+	 * @param message 成功时为摘要，失败时为原因。
+	 */
+	void Finished(bool ok, const QString& message);
+
+private slots:
+	void HandleData(const QByteArray& data);
+	void HandleBytesWritten(qint64 bytes);
+	void HandleTimeout();
+
+private:
+	void Write(const char* data, qint64 length);
+	void FlushOutput();
+	void PumpRaw();
+	void Finish(bool ok, const QString& message);
+	int PacketTimeoutMs() const;
+
+	SerialInfo* m_serial;                   /**< 发送使用的串口。 */
+	QFile m_file;                           /**< 正在发送的文件。 */
+	QByteArray m_fallback;                  /**< 文件无法映射时（例如管道）读入的内容。 */
+	ByteSpan m_data;                        /**< 映射区或 m_fallback 中的文件内容。 */
+	Mode m_mode = Mode::Ymodem;             /**< 发送模式。 */
+	qint64 m_window = 16384;                /**< 原始模式的写缓冲窗口。 */
+	qint64 m_rawOffset = 0;                 /**< 原始模式已交给串口的字节数。 */
+	std::unique_ptr<XmodemSender> m_xmodem; /**< XMODEM/YMODEM 状态机。 */
+	std::string m_output;                   /**< 状态机产生的待发送数据。 */
+	QTimer m_timeout;                       /**< 等待接收端应答的超时。 */
+	QElapsedTimer m_clock;                  /**< 第一个字节写出时启动。 */
+	qint64 m_elapsedNs = 0;                 /**< 结束时的总耗时。 */
+	bool m_running = false;                 /**< 是否正在发送。 */
+	QMetaObject::Connection m_dataConnection;    /**< 接收数据的连接。 */
+	QMetaObject::Connection m_writtenConnection; /**< 写出进度的连接。 */
+};
@@ -0,0 +1,337 @@
+/*
+ * @Description: 在工作线程上按数据块对各通道运行滤波器链，输出滤波后的样本
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 19:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "FilterWorker.h"
+#include "CrashHandler.h"
+#include "TimeSeriesStore.h"
+#include "TraceRecorder.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+	int64_t NowNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+FilterWorker::FilterWorker(size_t blockSamples, int maxLatencyMs)
+	: m_blockSamples(blockSamples), m_maxLatencyMs(maxLatencyMs), m_startNs(NowNs())
+{
+	m_thread = std::thread(&FilterWorker::Run, this);
+}
+
+FilterWorker::~FilterWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_one();
+	m_thread.join();
+}
+
+/**
+ * @brief 更换配置：按新配置重新匹配所有已知通道，工作线程在下一批开始前重建全部滤波器链。
+ */
+void FilterWorker::SetConfig(const FilterConfig& config)
+{
+	m_config = config;
+	std::vector<std::pair<int, int>> channels;
+	for (size_t i = 0; i < m_names.size(); ++i)
+	{
+		m_channelRules[i] = m_config.Match(m_names[i]);
+		channels.emplace_back(static_cast<int>(i), m_channelRules[i]);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_newConfig = std::make_unique<FilterConfig>(m_config);
+	m_newChannels = std::move(channels);
+}
+
+int FilterWorker::FilteredChannel(const std::string& name)
+{
+	auto it = m_channelIds.find(name);
+	if (it != m_channelIds.end())
+	{
+		return m_channelRules[static_cast<size_t>(it->second)] < 0 ? -1 : it->second;
+	}
+
+	const int channel = static_cast<int>(m_names.size());
+	const int rule = m_config.Match(name);
+	m_channelIds.emplace(name, channel);
+	m_names.push_back(name);
+	m_channelRules.push_back(rule);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_newChannels.emplace_back(channel, rule);
+	}
+	return rule < 0 ? -1 : channel;
+}
+
+/**
+ * @brief 提交一条记录：先在不加锁的情况下查出各值的通道，再一次加锁追加。
+ */
+void FilterWorker::PushRecord(double t, const DecodedRecord& record, const std::string& prefix)
+{
+	if (record.values == nullptr || m_config.IsEmpty())
+	{
+		return;
+	}
+
+	Input inputs[16];
+	size_t count = 0;
+	auto submit = [this, &inputs, &count]() {
+		bool wake = false;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pending.insert(m_pending.end(), inputs, inputs + count);
+			m_submitted += count;
+			wake = m_pending.size() >= m_blockSamples;
+		}
+		if (wake)
+		{
+			m_wake.notify_one();
+		}
+		count = 0;
+		};
+	for (size_t i = 0; i < record.count; ++i)
+	{
+		if (std::isnan(record.values[i]))
+		{
+			continue;
+		}
+		TimeSeriesStore::ChannelKey(record, i, m_keyBuffer);
+		if (!prefix.empty())
+		{
+			m_keyBuffer.insert(0, prefix);
+		}
+		const int channel = FilteredChannel(m_keyBuffer);
+		if (channel < 0)
+		{
+			continue;
+		}
+		inputs[count++] = Input{ channel, t, record.values[i] };
+		if (count == sizeof(inputs) / sizeof(inputs[0]))
+		{
+			submit();
+		}
+	}
+	if (count > 0)
+	{
+		submit();
+	}
+}
+
+void FilterWorker::Push(const std::string& channelName, double t, double value)
+{
+	if (m_config.IsEmpty() || std::isnan(value))
+	{
+		return;
+	}
+	const int channel = FilteredChannel(channelName);
+	if (channel < 0)
+	{
+		return;
+	}
+	bool wake = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending.push_back(Input{ channel, t, value });
+		++m_submitted;
+		wake = m_pending.size() >= m_blockSamples;
+	}
+	if (wake)
+	{
+		m_wake.notify_one();
+	}
+}
+
+void FilterWorker::Flush()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_flushRequested = true;
+	m_wake.notify_one();
+	m_idle.wait(lock, [this]() { return m_processed == m_submitted; });
+}
+
+/**
+ * @brief 借用登记新通道的路径：工作线程在下一批开始前为这些通道重新创建滤波器链。
+ */
+void FilterWorker::Reset(const std::string& prefix)
+{
+	if (m_config.IsEmpty())
+	{
+		return;
+	}
+	Flush();
+	std::vector<std::pair<int, int>> channels;
+	for (size_t i = 0; i < m_names.size(); ++i)
+	{
+		if (m_channelRules[i] >= 0 && m_names[i].compare(0, prefix.size(), prefix) == 0)
+		{
+			channels.emplace_back(static_cast<int>(i), m_channelRules[i]);
+		}
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_newChannels.insert(m_newChannels.end(), channels.begin(), channels.end());
+}
+
+size_t FilterWorker::Drain(std::vector<FilteredSample>& out)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const size_t count = m_output.size();
+	out.insert(out.end(), m_output.begin(), m_output.end());
+	m_output.clear();
+	return count;
+}
+
+uint64_t FilterWorker::ProcessedSamples() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_processed;
+}
+
+double FilterWorker::BusySeconds() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_busyNs / 1e9;
+}
+
+std::string FilterWorker::Format() const
+{
+	int filtered = 0;
+	for (const int rule : m_channelRules)
+	{
+		filtered += rule >= 0 ? 1 : 0;
+	}
+	const double elapsed = (NowNs() - m_startNs) / 1e9;
+	char text[160];
+	std::snprintf(text, sizeof(text), "filter channels=%d samples=%llu busy=%.3fs load=%.2f%%",
+		filtered, static_cast<unsigned long long>(ProcessedSamples()), BusySeconds(),
+		elapsed > 0 ? BusySeconds() / elapsed * 100.0 : 0.0);
+	return text;
+}
+
+/**
+ * @brief 工作线程：等待一整块或超时，取走待处理样本后在锁外处理。
+ */
+void FilterWorker::Run()
+{
+	TraceRecorder::SetThreadName("filter");
+	CrashHandler::InstallThreadStack();
+	std::vector<Input> batch;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stop)
+	{
+		m_wake.wait_for(lock, std::chrono::milliseconds(m_maxLatencyMs), [this]() {
+			return m_stop || m_flushRequested || m_pending.size() >= m_blockSamples;
+			});
+		if (m_stop)
+		{
+			break;
+		}
+		m_flushRequested = false;
+		if (m_pending.empty() && !m_newConfig && m_newChannels.empty())
+		{
+			m_idle.notify_all();
+			continue;
+		}
+
+		batch.swap(m_pending);
+		std::unique_ptr<FilterConfig> config = std::move(m_newConfig);
+		std::vector<std::pair<int, int>> channels = std::move(m_newChannels);
+		m_newChannels.clear();
+		lock.unlock();
+
+		const int64_t startNs = NowNs();
+		if (config)
+		{
+			m_workerConfig = std::move(*config);
+			m_chains.clear();
+		}
+		for (const auto& [channel, rule] : channels)
+		{
+			if (static_cast<size_t>(channel) >= m_chains.size())
+			{
+				m_chains.resize(static_cast<size_t>(channel) + 1);
+			}
+			m_chains[static_cast<size_t>(channel)] = rule < 0 ? nullptr
+				: std::make_unique<FilterChain>(m_workerConfig.Create(rule));
+		}
+		ProcessBatch(batch);
+		const int64_t busyNs = NowNs() - startNs;
+
+		lock.lock();
+		m_processed += batch.size();
+		m_busyNs += busyNs;
+		batch.clear();
+		m_idle.notify_all();
+		if (m_readyHandler && !m_output.empty())
+		{
+			lock.unlock();
+			m_readyHandler();
+			lock.lock();
+		}
+	}
+}
+
+/**
+ * @brief 处理一批样本：按通道计数排序为连续数组，每个通道调用一次滤波器链，再按通道顺序输出。
+ * 同一通道内的样本保持提交顺序。
+ */
+void FilterWorker::ProcessBatch(std::vector<Input>& batch)
+{
+	if (batch.empty())
+	{
+		return;
+	}
+	TRACE_ZONE("FilterWorker::ProcessBatch");
+
+	const size_t channelCount = m_chains.size();
+	m_offsets.assign(channelCount + 1, 0);
+	for (const Input& input : batch)
+	{
+		++m_offsets[static_cast<size_t>(input.channel) + 1];
+	}
+	for (size_t c = 0; c < channelCount; ++c)
+	{
+		m_offsets[c + 1] += m_offsets[c];
+	}
+	m_values.resize(batch.size());
+	m_times.resize(batch.size());
+	m_cursor.assign(m_offsets.begin(), m_offsets.end() - 1);
+	for (const Input& input : batch)
+	{
+		const size_t at = m_cursor[static_cast<size_t>(input.channel)]++;
+		m_values[at] = input.value;
+		m_times[at] = input.t;
+	}
+
+	std::vector<FilteredSample> output;
+	output.reserve(batch.size());
+	for (size_t c = 0; c < channelCount; ++c)
+	{
+		const size_t begin = m_offsets[c];
+		const size_t count = m_offsets[c + 1] - begin;
+		if (count == 0 || !m_chains[c])
+		{
+			continue;
+		}
+		m_chains[c]->Process(m_values.data() + begin, count);
+		for (size_t i = begin; i < begin + count; ++i)
+		{
+			output.push_back(FilteredSample{ static_cast<int>(c), m_times[i], m_values[i] });
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_output.insert(m_output.end(), output.begin(), output.end());
+}
@@ -0,0 +1,168 @@
+/*
+ * @Description: 在工作线程上按数据块对各通道运行滤波器链，输出滤波后的样本
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 19:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ProtocolDecoder.h"
+#include "SignalFilter.h"
+
+/**
+ * @brief 一个滤波后的样本。
+ */
+struct FilteredSample
+{
+	int channel;  /**< FilterWorker 中的通道编号，名称见 ChannelName。 */
+	double t;     /**< 原始样本的时间（秒）。 */
+	double value; /**< 滤波输出。 */
+};
+
+/**
+ * @brief FilterWorker 把解码数值交给工作线程，按 FilterConfig 为每个通道运行独立的滤波器链。
+ *
+ * 解码线程（生产者）只把样本追加到待处理数组，累积到 blockSamples 个或等待超过 maxLatencyMs 后，
+ * 工作线程一次取走整批，按通道归并为连续的数组，再对每个通道调用一次 FilterChain::Process。
+ * 这样每级滤波器的内层循环只处理一个通道的连续数据，状态保存在寄存器中，没有逐样本的虚函数调用和加锁。
+ *
+ * 通道命名与 TimeSeriesStore 相同，没有匹配规则的通道不会进入队列。
+ * SetConfig、PushRecord、Push、Flush、Drain 和 ChannelName 应在同一个线程（生产者线程）中调用。
+ */
+class FilterWorker
+{
+public:
+	/**
+	 * @brief 构造函数，启动工作线程。
+	 * @param blockSamples 累积到多少个样本时立即唤醒工作线程。
+	 * @param maxLatencyMs 样本最多等待多久被处理（毫秒）。
+	 */
+	explicit FilterWorker(size_t blockSamples = 1024, int maxLatencyMs = 10);
+
+	/**
+	 * @brief 析构函数，停止工作线程，未处理的样本被丢弃。
+	 */
+	~FilterWorker();
+
+	FilterWorker(const FilterWorker&) = delete;
+	FilterWorker& operator=(const FilterWorker&) = delete;
+
+	/**
+	 * @brief 更换滤波配置，所有通道的滤波器状态重新开始。
+	 */
+	void SetConfig(const FilterConfig& config);
+	const FilterConfig& Config() const { return m_config; }
+
+	/**
+	 * @brief 提交一条解码记录中的所有数值。
+	 * @param t 时间（秒）。
+	 * @param record 解码记录。
+	 * @param prefix 加在通道名称前的前缀，多个串口时用于区分同名通道。
+	 */
+	void PushRecord(double t, const DecodedRecord& record, const std::string& prefix = std::string());
+
+	/**
+	 * @brief 提交一个样本。
+	 */
+	void Push(const std::string& channel, double t, double value);
+
+	/**
+	 * @brief 等待已提交的样本全部处理完。
+	 */
+	void Flush();
+
+	/**
+	 * @brief 数据中断后让滤波器链重新开始：先处理完已提交的样本，再重建匹配通道的滤波器链。
+	 * @param prefix 只重建名称以此开头的通道，为空时重建所有通道。
+	 */
+	void Reset(const std::string& prefix = std::string());
+
+	/**
+	 * @brief 取出已处理的样本，追加到 out。
+	 * @return 取出的样本数。
+	 */
+	size_t Drain(std::vector<FilteredSample>& out);
+
+	/**
+	 * @brief 设置有新输出时的回调，在工作线程中调用，应在提交样本之前设置。
+	 */
+	void SetReadyHandler(std::function<void()> handler) { m_readyHandler = std::move(handler); }
+
+	int ChannelCount() const { return static_cast<int>(m_names.size()); }
+	const std::string& ChannelName(int channel) const { return m_names[static_cast<size_t>(channel)]; }
+
+	/**
+	 * @brief 已处理的样本数与工作线程实际处理的时间（秒）。
+	 */
+	uint64_t ProcessedSamples() const;
+	double BusySeconds() const;
+
+	/**
+	 * @brief 统计信息：滤波通道数、样本数和工作线程占用率。
+	 */
+	std::string Format() const;
+
+private:
+	/**
+	 * @brief 待处理的样本。
+	 */
+	struct Input
+	{
+		int channel;
+		double t;
+		double value;
+	};
+
+	/**
+	 * @brief 生产者线程中查找或登记通道，返回 -1 表示该通道不滤波。
+	 */
+	int FilteredChannel(const std::string& name);
+
+	void Run();
+	void ProcessBatch(std::vector<Input>& batch);
+
+	const size_t m_blockSamples;                 /**< 立即唤醒工作线程的样本数。 */
+	const int m_maxLatencyMs;                    /**< 最长等待时间。 */
+	std::function<void()> m_readyHandler;        /**< 有新输出时的回调。 */
+
+	// 生产者线程使用
+	FilterConfig m_config;                       /**< 当前配置。 */
+	std::unordered_map<std::string, int> m_channelIds; /**< 名称到编号的映射。 */
+	std::vector<std::string> m_names;            /**< 各通道名称。 */
+	std::vector<int> m_channelRules;             /**< 各通道匹配的规则序号，-1 表示不滤波。 */
+	std::string m_keyBuffer;                     /**< 生成通道名称的缓冲。 */
+
+	// 由 m_mutex 保护
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;              /**< 唤醒工作线程。 */
+	std::condition_variable m_idle;              /**< 一批处理完成。 */
+	std::vector<Input> m_pending;                /**< 待处理的样本。 */
+	std::vector<std::pair<int, int>> m_newChannels; /**< 新登记的通道及其规则。 */
+	std::unique_ptr<FilterConfig> m_newConfig;   /**< 待生效的配置。 */
+	uint64_t m_submitted = 0;                    /**< 已提交的样本数。 */
+	uint64_t m_processed = 0;                    /**< 已处理的样本数。 */
+	int64_t m_busyNs = 0;                        /**< 工作线程处理耗时。 */
+	bool m_stop = false;                         /**< 是否停止。 */
+	bool m_flushRequested = false;               /**< Flush 正在等待，工作线程不等满一块。 */
+	std::vector<FilteredSample> m_output;        /**< 已处理、等待取出的样本。 */
+
+	// 工作线程使用
+	FilterConfig m_workerConfig;                 /**< 工作线程使用的配置副本。 */
+	std::vector<std::unique_ptr<FilterChain>> m_chains; /**< 各通道的滤波器链，不滤波的通道为空。 */
+	std::vector<size_t> m_offsets;               /**< 归并时各通道的起始位置。 */
+	std::vector<size_t> m_cursor;                /**< 归并时各通道的写入位置。 */
+	std::vector<double> m_values;                /**< 按通道归并后的数值。 */
+	std::vector<double> m_times;                 /**< 按通道归并后的时间。 */
+
+	int64_t m_startNs = 0;                       /**< 启动时间，用于计算占用率。 */
+	std::thread m_thread;                        /**< 工作线程，最后构造。 */
+};
@@ -0,0 +1,308 @@
+/*
+ * @Description: 串口飞行记录仪，在固定大小的无锁环形缓冲区中保留最近的收发字节和解码帧，崩溃时写到磁盘
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 18:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#define FLIGHT_OPEN(path) _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644)
+#define FLIGHT_WRITE _write
+#define FLIGHT_CLOSE _close
+#else
+#include <unistd.h>
+#define FLIGHT_OPEN(path) open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)
+#define FLIGHT_WRITE write
+#define FLIGHT_CLOSE close
+#endif
+
+namespace
+{
+	constexpr uint16_t kSync = 0xF17E;
+	constexpr size_t kMaxFrameText = 512;
+	constexpr char kMagic[8] = { 'F', 'L', 'I', 'G', 'H', 'T', '1', '\0' };
+
+	/**
+	 * @brief 记录头，16 字节。
+	 */
+	struct RecordHeader
+	{
+		uint16_t sync;        /**< 同步字，用于在被覆盖的开头处重新找到记录边界。 */
+		uint8_t kind;         /**< 记录类型。 */
+		uint8_t channel;      /**< 通道号。 */
+		uint32_t length;      /**< 数据长度。 */
+		int64_t timestampNs;  /**< 单调时钟纳秒。 */
+	};
+	static_assert(sizeof(RecordHeader) == 16, "RecordHeader must be 16 bytes");
+
+	/**
+	 * @brief 转储文件头。
+	 */
+	struct DumpHeader
+	{
+		char magic[8];        /**< "FLIGHT1"。 */
+		uint64_t capacity;    /**< 环形缓冲区容量。 */
+		uint64_t cursor;      /**< 转储时的累计写入位置。 */
+		int64_t dumpNs;       /**< 转储时的单调时钟纳秒。 */
+	};
+
+	int64_t NowNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	size_t Align8(size_t value)
+	{
+		return (value + 7) & ~size_t(7);
+	}
+
+	bool WriteAll(int fd, const char* data, size_t length)
+	{
+		while (length > 0)
+		{
+			const auto written = FLIGHT_WRITE(fd, data, static_cast<unsigned>(std::min<size_t>(length, 1u << 30)));
+			if (written <= 0)
+			{
+				return false;
+			}
+			data += written;
+			length -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+	const char* KindName(uint8_t kind)
+	{
+		switch (kind)
+		{
+		case 1: return "RX";
+		case 2: return "TX";
+		case 3: return "FRAME";
+		case 4: return "NOTE";
+		default: return "?";
+		}
+	}
+}
+
+FlightRecorder& FlightRecorder::Instance()
+{
+	static FlightRecorder recorder;
+	return recorder;
+}
+
+void FlightRecorder::Init(size_t capacityBytes)
+{
+	if (m_buffer != nullptr || capacityBytes == 0)
+	{
+		return;
+	}
+	size_t capacity = 4096;
+	while (capacity < capacityBytes)
+	{
+		capacity <<= 1;
+	}
+	// 不清零：未写过的页不会被实际分配，启动时也不需要触碰整个缓冲区
+	m_buffer = new char[capacity];
+	m_capacity = capacity;
+}
+
+uint8_t FlightRecorder::NextChannel()
+{
+	static std::atomic<uint8_t> next{ 0 };
+	return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FlightRecorder::CopyIn(uint64_t position, const void* data, size_t length)
+{
+	const size_t offset = static_cast<size_t>(position & (m_capacity - 1));
+	const size_t first = std::min(length, m_capacity - offset);
+	std::memcpy(m_buffer + offset, data, first);
+	if (first < length)
+	{
+		std::memcpy(m_buffer, static_cast<const char*>(data) + first, length - first);
+	}
+}
+
+void FlightRecorder::Record(Kind kind, uint8_t channel, const char* data, size_t length)
+{
+	if (m_buffer == nullptr)
+	{
+		return;
+	}
+	const size_t maxLength = m_capacity / 4;
+	if (length > maxLength)
+	{
+		data += length - maxLength;
+		length = maxLength;
+	}
+
+	const RecordHeader header{ kSync, static_cast<uint8_t>(kind), channel, static_cast<uint32_t>(length), NowNs() };
+	const uint64_t position = m_cursor.fetch_add(Align8(sizeof(header) + length), std::memory_order_relaxed);
+	CopyIn(position, &header, sizeof(header));
+	CopyIn(position + sizeof(header), data, length);
+}
+
+/**
+ * @brief 按 FormatRecord(record, ",") 的格式把记录写进栈上的定长缓冲区。
+ * 每帧都会调用，不分配堆内存；超出 kMaxFrameText 的部分截断，与 Record 按容量截断的行为一致。
+ */
+void FlightRecorder::RecordFrame(uint8_t channel, const DecodedRecord& record)
+{
+	if (m_buffer == nullptr)
+	{
+		return;
+	}
+
+	char text[kMaxFrameText];
+	size_t length = 0;
+	const auto append = [&](const char* data, size_t size)
+	{
+		const size_t count = std::min(size, sizeof(text) - length);
+		std::memcpy(text + length, data, count);
+		length += count;
+	};
+
+	append(record.name.data(), record.name.size());
+	for (size_t i = 0; i < record.count && length < sizeof(text); ++i)
+	{
+		if (length != 0)
+		{
+			append(",", 1);
+		}
+		if (record.keys != nullptr)
+		{
+			append(record.keys[i].data(), record.keys[i].size());
+			append("=", 1);
+		}
+		if (record.texts != nullptr)
+		{
+			append(record.texts[i].data(), record.texts[i].size());
+		}
+		else
+		{
+			char value[32];
+			const int size = std::snprintf(value, sizeof(value), "%g", static_cast<double>(static_cast<float>(record.values[i])));
+			append(value, size > 0 ? static_cast<size_t>(size) : 0);
+		}
+	}
+	Record(Kind::Frame, channel, text, length);
+}
+
+/**
+ * @brief 写出文件头，再按从旧到新的顺序写出缓冲区的两段。
+ * 只调用 open/write/close 与 clock_gettime，不分配内存，可在信号处理函数中使用。
+ */
+bool FlightRecorder::Dump(const char* path) const
+{
+	if (m_buffer == nullptr)
+	{
+		return false;
+	}
+	const int fd = FLIGHT_OPEN(path);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	DumpHeader header;
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.capacity = m_capacity;
+	header.cursor = m_cursor.load(std::memory_order_acquire);
+	header.dumpNs = NowNs();
+
+	const uint64_t used = std::min<uint64_t>(header.cursor, m_capacity);
+	const size_t start = static_cast<size_t>((header.cursor - used) & (m_capacity - 1));
+	const size_t first = std::min<size_t>(static_cast<size_t>(used), m_capacity - start);
+	bool ok = WriteAll(fd, reinterpret_cast<const char*>(&header), sizeof(header));
+	ok = ok && WriteAll(fd, m_buffer + start, first);
+	ok = ok && WriteAll(fd, m_buffer, static_cast<size_t>(used) - first);
+	FLIGHT_CLOSE(fd);
+	return ok;
+}
+
+/**
+ * @brief 解析转储文件。
+ * 缓冲区写满后最旧的一条记录可能只剩后半段，因此按 8 字节对齐查找同步字，
+ * 遇到不合法的记录头时同样向后查找，跳过崩溃瞬间只写了一半的记录。
+ */
+bool FlightRecorder::Decode(const char* path, FILE* out)
+{
+	FILE* file = std::fopen(path, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	std::vector<char> content;
+	char chunk[65536];
+	size_t length = 0;
+	while ((length = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+	{
+		content.insert(content.end(), chunk, chunk + length);
+	}
+	std::fclose(file);
+
+	DumpHeader header;
+	if (content.size() < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(&header, content.data(), sizeof(header));
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+	{
+		return false;
+	}
+	std::fprintf(out, "# capacity=%llu total=%llu\n",
+		static_cast<unsigned long long>(header.capacity), static_cast<unsigned long long>(header.cursor));
+
+	const char* data = content.data() + sizeof(header);
+	const size_t size = content.size() - sizeof(header);
+	// 转储内容的第一个字节对应累计位置 cursor - size，对齐到 8 字节边界
+	size_t position = static_cast<size_t>((8 - ((header.cursor - size) & 7)) & 7);
+	size_t skipped = 0;
+	while (position + sizeof(RecordHeader) <= size)
+	{
+		RecordHeader record;
+		std::memcpy(&record, data + position, sizeof(record));
+		const bool valid = record.sync == kSync && record.kind >= 1 && record.kind <= 4 &&
+			position + sizeof(record) + record.length <= size;
+		if (!valid)
+		{
+			position += 8;
+			skipped += 8;
+			continue;
+		}
+
+		std::fprintf(out, "%+.6f %-5s ch%u %u ", (record.timestampNs - header.dumpNs) / 1e9,
+			KindName(record.kind), record.channel, record.length);
+		const char* payload = data + position + sizeof(record);
+		for (uint32_t i = 0; i < record.length; ++i)
+		{
+			const unsigned char c = static_cast<unsigned char>(payload[i]);
+			if (c >= 0x20 && c < 0x7F && c != '\\')
+			{
+				std::fputc(c, out);
+			}
+			else
+			{
+				std::fprintf(out, "\\x%02X", c);
+			}
+		}
+		std::fputc('\n', out);
+		position += Align8(sizeof(record) + record.length);
+	}
+	if (skipped > 0)
+	{
+		std::fprintf(out, "# skipped %zu bytes of partial records\n", skipped);
+	}
+	return true;
+}
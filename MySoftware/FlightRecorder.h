@@ -0,0 +1,101 @@
+/*
+ * @Description: 串口飞行记录仪，在固定大小的无锁环形缓冲区中保留最近的收发字节和解码帧，崩溃时写到磁盘
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 18:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief FlightRecorder 是进程内唯一的飞行记录仪。
+ *
+ * 每条记录由 16 字节的记录头（同步字、类型、通道、长度、单调时钟纳秒）和数据组成，按 8 字节对齐。
+ * 写入方用一次 fetch_add 预留空间后直接 memcpy，不加锁、不分配内存，多个线程可以同时写入，
+ * 旧数据被新数据覆盖，因此内存占用固定，记录的时间跨度取决于容量与数据速率。
+ *
+ * Dump 只使用 open/write/close，可以在信号处理函数中调用，
+ * 输出的文件按从旧到新的顺序保存环形缓冲区内容，用 Decode 转换为文本。
+ */
+class FlightRecorder
+{
+public:
+	/**
+	 * @brief 记录类型。
+	 */
+	enum class Kind : uint8_t
+	{
+		Rx = 1,    /**< 串口接收的字节。 */
+		Tx = 2,    /**< 串口发送的字节。 */
+		Frame = 3, /**< 格式化后的解码帧。 */
+		Note = 4   /**< 其他事件文本。 */
+	};
+
+	/**
+	 * @brief 默认容量，115200 波特满速收发约可保留 3 分钟。
+	 */
+	static constexpr size_t kDefaultCapacity = 4u << 20;
+
+	/**
+	 * @brief 获取全局实例。
+	 */
+	static FlightRecorder& Instance();
+
+	/**
+	 * @brief 分配环形缓冲区，容量向上取整为 2 的幂。
+	 * 应在启动其他线程之前调用一次，缓冲区在进程结束前不会释放，以便崩溃时仍可访问。
+	 * @param capacityBytes 容量（字节），0 表示关闭记录。
+	 */
+	void Init(size_t capacityBytes = kDefaultCapacity);
+
+	/**
+	 * @brief 写入一条记录，未初始化时直接返回。超过容量四分之一的数据只保留末尾部分。
+	 * @param kind 记录类型。
+	 * @param channel 通道号，例如串口序号。
+	 * @param data 数据。
+	 * @param length 数据长度。
+	 */
+	void Record(Kind kind, uint8_t channel, const char* data, size_t length);
+
+	/**
+	 * @brief 把一条解码记录格式化为文本后写入。
+	 */
+	void RecordFrame(uint8_t channel, const DecodedRecord& record);
+
+	/**
+	 * @brief 分配一个通道号，供每个串口对象使用。
+	 */
+	static uint8_t NextChannel();
+
+	/**
+	 * @brief 把环形缓冲区写到文件，只使用异步信号安全的系统调用。
+	 * @param path 文件路径。
+	 * @return 是否成功。
+	 */
+	bool Dump(const char* path) const;
+
+	/**
+	 * @brief 把 Dump 生成的文件转换为文本，每条记录一行，时间相对于转储时刻。
+	 * @param path 文件路径。
+	 * @param out 输出流。
+	 * @return 文件格式正确时返回 true。
+	 */
+	static bool Decode(const char* path, FILE* out);
+
+	bool IsEnabled() const { return m_buffer != nullptr; }
+	size_t Capacity() const { return m_capacity; }
+	uint64_t TotalBytes() const { return m_cursor.load(std::memory_order_relaxed); }
+
+private:
+	FlightRecorder() = default;
+	void CopyIn(uint64_t position, const void* data, size_t length);
+
+	char* m_buffer = nullptr;          /**< 环形缓冲区，进程结束前不释放。 */
+	size_t m_capacity = 0;             /**< 容量，2 的幂。 */
+	std::atomic<uint64_t> m_cursor{ 0 }; /**< 累计写入位置，取模得到缓冲区偏移。 */
+};
@@ -0,0 +1,219 @@
+/*
+ * @Description: START/浮点数/END 文本帧解码器，GUI 与命令行模式共用
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 10:05:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "FrameDecoder.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+
+/**
+ * @brief 构造函数。
+ * @param headers 合法帧头列表。
+ * @param endFrame 帧尾字符串。
+ */
+FrameDecoder::FrameDecoder(std::vector<std::string> headers, std::string endFrame)
+	: m_headers(std::move(headers)), m_endFrame(std::move(endFrame))
+{
+}
+
+void FrameDecoder::SetTraceHandler(TraceHandler handler)
+{
+	m_onTrace = std::move(handler);
+}
+
+/**
+ * @brief 输入一段原始字节，按行驱动状态机。
+ * @param chunk 接收缓冲区中的一段连续字节。
+ * @param sink 完整帧的接收方。
+ */
+void FrameDecoder::Feed(ByteSpan chunk, RecordSink& sink)
+{
+	m_framer.Feed(chunk.data(), chunk.size(), [this, &sink](std::string_view line) { FeedLine(line, sink); });
+}
+
+/**
+ * @brief 输入一个字段，驱动状态机转移一次。
+ * - WaitingForStart: 字段必须是帧头列表中的一项。
+ * - WaitingForData1~3: 字段必须是浮点数。
+ * - WaitingForEnd: 字段必须等于帧尾，成功后发出完整帧。
+ * @param line 行内容。
+ * @param sink 完整帧的接收方。
+ */
+void FrameDecoder::FeedLine(std::string_view line, RecordSink& sink)
+{
+	const std::string_view token = Trim(line);
+	if (token.empty())
+	{
+		return;
+	}
+
+	switch (m_state)
+	{
+	case WaitingForStart:
+	{
+		auto ret = std::find(m_headers.begin(), m_headers.end(), token);
+		if (ret == m_headers.end())
+		{
+			Fail(TraceKind::InvalidStart, 0, token);
+			break;
+		}
+		m_current.headerIndex = static_cast<size_t>(std::distance(m_headers.begin(), ret));
+		m_state = WaitingForData1;
+		Trace(TraceKind::StartFrame, 0, token);
+		break;
+	}
+	case WaitingForData1:
+	case WaitingForData2:
+	case WaitingForData3:
+	{
+		const int field = m_state - WaitingForData1 + 1;
+		float value;
+		if (!ParseFloat(token, value))
+		{
+			Fail(TraceKind::InvalidData, field, token);
+			break;
+		}
+		m_current.values[field - 1] = value;
+		m_state = static_cast<State>(m_state + 1);
+		Trace(TraceKind::DataFrame, field, token, &m_current);
+		break;
+	}
+	case WaitingForEnd:
+	{
+		if (token != m_endFrame)
+		{
+			Fail(TraceKind::InvalidEnd, 0, token);
+			break;
+		}
+		m_state = WaitingForStart;
+		++m_recordCount;
+		Trace(TraceKind::EndFrame, 0, token);
+		Trace(TraceKind::Packet, 0, token, &m_current);
+
+		DecodedRecord record;
+		record.kind = RecordKind::PidFrame;
+		record.index = m_current.headerIndex;
+		record.name = m_headers[m_current.headerIndex];
+		record.raw = line;
+		for (int i = 0; i < 3; ++i)
+		{
+			m_values[i] = m_current.values[i];
+		}
+		record.values = m_values;
+		record.count = 3;
+		sink.OnRecord(record);
+		break;
+	}
+	}
+}
+
+/**
+ * @brief 丢弃半帧和半行，回到等待帧头状态。
+ */
+void FrameDecoder::Reset()
+{
+	m_framer.Reset();
+	m_state = WaitingForStart;
+	m_current = PidFrame{};
+}
+
+void FrameDecoder::Trace(TraceKind kind, int field, std::string_view token, const PidFrame* frame)
+{
+	if (m_onTrace)
+	{
+		std::string_view header;
+		if (frame != nullptr)
+		{
+			header = m_headers[frame->headerIndex];
+		}
+		m_onTrace(TraceEvent{ kind, field, token, frame, header });
+	}
+}
+
+/**
+ * @brief 记录一个非法字段并把状态机复位。
+ */
+void FrameDecoder::Fail(TraceKind kind, int field, std::string_view token)
+{
+	++m_errorCount;
+	m_state = WaitingForStart;
+	m_current = PidFrame{};
+	Trace(kind, field, token);
+}
+
+/**
+ * @brief 把跟踪事件格式化为接收区显示的文本。
+ * @param event 跟踪事件。
+ * @return 格式化后的文本。
+ */
+std::string FrameDecoder::FormatTrace(const TraceEvent& event)
+{
+	const std::string token(event.token);
+	const std::string field = std::to_string(event.field);
+	switch (event.kind)
+	{
+	case TraceKind::StartFrame:
+		return "Received Start Frame: " + token;
+	case TraceKind::DataFrame:
+		return "Received Data Frame " + field + ": " + FormatValue(event.frame->values[event.field - 1]);
+	case TraceKind::EndFrame:
+		return "Received End Frame: " + token;
+	case TraceKind::InvalidStart:
+		return "Invalid Start Frame: " + token;
+	case TraceKind::InvalidData:
+		return "Invalid Data Frame " + field + ": " + token;
+	case TraceKind::InvalidEnd:
+		return "Invalid End Frame: " + token;
+	case TraceKind::Packet:
+		break;
+	}
+
+	const PidFrame& frame = *event.frame;
+	return "Complete Packet - Start: " + std::string(event.header) +
+		", Data1: " + FormatValue(frame.values[0]) +
+		", Data2: " + FormatValue(frame.values[1]) +
+		", Data3: " + FormatValue(frame.values[2]) +
+		", End: " + token;
+}
+
+/**
+ * @brief 按 QString::number(float) 的格式 (%g) 输出浮点数。
+ */
+std::string FrameDecoder::FormatValue(float value)
+{
+	char text[32];
+	const int length = std::snprintf(text, sizeof(text), "%g", static_cast<double>(value));
+	return std::string(text, length > 0 ? static_cast<size_t>(length) : 0);
+}
+
+std::string_view FrameDecoder::Trim(std::string_view text)
+{
+	const auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; };
+	while (!text.empty() && isSpace(text.front()))
+	{
+		text.remove_prefix(1);
+	}
+	while (!text.empty() && isSpace(text.back()))
+	{
+		text.remove_suffix(1);
+	}
+	return text;
+}
+
+/**
+ * @brief 解析浮点数，整个字段都必须是合法数字。
+ */
+bool FrameDecoder::ParseFloat(std::string_view text, float& value)
+{
+	if (!text.empty() && text.front() == '+')
+	{
+		text.remove_prefix(1);
+	}
+	const char* end = text.data() + text.size();
+	auto result = std::from_chars(text.data(), end, value);
+	return result.ec == std::errc() && result.ptr == end;
+}
@@ -0,0 +1,140 @@
+/*
+ * @Description: START/浮点数/END 文本帧解码器，GUI 与命令行模式共用
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 10:05:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LineFramer.h"
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief 一帧完整的 PID 数据。
+ */
+struct PidFrame
+{
+	size_t headerIndex; /**< 帧头在帧头列表中的下标。 */
+	float values[3];    /**< 三个数据帧的浮点数值 (Kp, Ki, Kd)。 */
+};
+
+/**
+ * @brief FrameDecoder 实现 START/数据1/数据2/数据3/END 的逐行状态机。
+ *
+ * 每一行去掉首尾空白后作为一个字段参与状态转移，空行被忽略。
+ * 任意阶段收到非法字段都会回到等待帧头状态。
+ * 此类不依赖 Qt 控件，USARTAss 与命令行模式使用同一份代码，保证解码结果一致。
+ * 每收到一帧输出一条 RecordKind::PidFrame 记录，values 为三个数据帧。
+ */
+class FrameDecoder : public ProtocolDecoder
+{
+public:
+	/**
+	 * @brief 状态机的跟踪事件类型，用于在接收区回显解码过程。
+	 */
+	enum class TraceKind
+	{
+		StartFrame,   /**< 收到合法帧头。 */
+		DataFrame,    /**< 收到合法数据帧。 */
+		EndFrame,     /**< 收到合法帧尾。 */
+		Packet,       /**< 一帧完整数据。 */
+		InvalidStart, /**< 非法帧头。 */
+		InvalidData,  /**< 非法数据帧。 */
+		InvalidEnd    /**< 非法帧尾。 */
+	};
+
+	/**
+	 * @brief 跟踪事件。
+	 */
+	struct TraceEvent
+	{
+		TraceKind kind;         /**< 事件类型。 */
+		int field;              /**< 数据帧序号 (1~3)，其他事件为 0。 */
+		std::string_view token; /**< 触发事件的字段，仅在回调期间有效。 */
+		const PidFrame* frame;  /**< DataFrame/Packet 事件对应的帧，其他事件为 nullptr。 */
+		std::string_view header; /**< frame 对应的帧头，frame 为空时为空。 */
+	};
+
+	using TraceHandler = std::function<void(const TraceEvent&)>;
+
+	/**
+	 * @brief 构造函数。
+	 * @param headers 合法帧头列表，帧头的下标即 PidFrame::headerIndex。
+	 * @param endFrame 帧尾字符串。
+	 */
+	explicit FrameDecoder(std::vector<std::string> headers = DefaultPidHeaders(),
+		std::string endFrame = "END");
+
+	/**
+	 * @brief 设置跟踪事件回调，未设置时不产生跟踪事件。
+	 */
+	void SetTraceHandler(TraceHandler handler);
+
+	const char* Name() const override { return "pid"; }
+
+	/**
+	 * @brief 输入一段原始字节，按行驱动状态机。
+	 * @param chunk 接收缓冲区中的一段连续字节。
+	 * @param sink 完整帧的接收方。
+	 */
+	void Feed(ByteSpan chunk, RecordSink& sink) override;
+
+	/**
+	 * @brief 输入一个已经切分好的字段（一行）。
+	 * @param line 行内容，可以包含首尾空白。
+	 * @param sink 完整帧的接收方。
+	 */
+	void FeedLine(std::string_view line, RecordSink& sink);
+
+	/**
+	 * @brief 丢弃半帧和半行，回到等待帧头状态。
+	 */
+	void Reset() override;
+
+	/**
+	 * @brief 等待帧头且没有半行时为空闲，此时 m_current 会在下一个帧头处重新填写。
+	 */
+	bool IsIdle() const override { return m_state == WaitingForStart && !m_framer.HasPartialLine(); }
+
+	/**
+	 * @brief 把跟踪事件格式化为接收区显示的文本。
+	 * @param event 跟踪事件。
+	 * @return 格式化后的文本。
+	 */
+	static std::string FormatTrace(const TraceEvent& event);
+
+	/**
+	 * @brief 按 QString::number(float) 的格式 (%g) 输出浮点数。
+	 */
+	static std::string FormatValue(float value);
+
+private:
+	enum State
+	{
+		WaitingForStart, /**< 等待接收帧头状态。 */
+		WaitingForData1, /**< 等待接收第一个数据帧状态。 */
+		WaitingForData2, /**< 等待接收第二个数据帧状态。 */
+		WaitingForData3, /**< 等待接收第三个数据帧状态。 */
+		WaitingForEnd	 /**< 等待接收帧尾状态。 */
+	};
+
+	void Trace(TraceKind kind, int field, std::string_view token, const PidFrame* frame = nullptr);
+	void Fail(TraceKind kind, int field, std::string_view token);
+
+	static std::string_view Trim(std::string_view text);
+	static bool ParseFloat(std::string_view text, float& value);
+
+	std::vector<std::string> m_headers; /**< 合法帧头列表。 */
+	std::string m_endFrame;             /**< 帧尾字符串。 */
+	LineFramer m_framer;                /**< 行切分器。 */
+	State m_state = WaitingForStart;    /**< 当前状态。 */
+	PidFrame m_current{};               /**< 正在接收的帧。 */
+	double m_values[3] = {};            /**< 输出记录使用的数值暂存区。 */
+	TraceHandler m_onTrace;             /**< 跟踪事件回调。 */
+};
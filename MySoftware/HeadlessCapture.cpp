@@ -0,0 +1,973 @@
+/*
+ * @Description: 无界面采集模式，打开一个或多个串口并把帧、统计和原始数据写到文件或标准输出
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 10:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "HeadlessCapture.h"
+#include "SerialFanout.h"
+#include "TraceRecorder.h"
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <cstdio>
+#include <stdexcept>
+
+QStringList HeadlessOptions::DefaultHeaders()
+{
+	QStringList headers;
+	for (const std::string& header : DefaultPidHeaders())
+	{
+		headers << QString::fromStdString(header);
+	}
+	return headers;
+}
+
+/**
+ * @brief 构造函数。
+ * @param options 采集配置。
+ * @param parent 父对象。
+ */
+HeadlessCapture::HeadlessCapture(HeadlessOptions options, QObject* parent)
+	: QObject(parent), m_options(std::move(options))
+{
+	connect(&m_statsTimer, &QTimer::timeout, this, &HeadlessCapture::ReportStats);
+	connect(&m_probeTimer, &QTimer::timeout, this, &HeadlessCapture::SendProbes);
+	m_probeTimer.setTimerType(Qt::PreciseTimer);
+	connect(&m_filterTimer, &QTimer::timeout, this, &HeadlessCapture::WriteFiltered);
+	connect(&m_filterTimer, &QTimer::timeout, this, &HeadlessCapture::WriteSteps);
+	connect(&m_alarmTimer, &QTimer::timeout, this, [this]() { m_alarms.Tick(m_clock.nsecsElapsed()); });
+	m_alarmTimer.setTimerType(Qt::PreciseTimer);
+	connect(&m_memoryTimer, &QTimer::timeout, this, []() { MemoryBudget::Instance().Enforce(); });
+}
+
+/**
+ * @brief 析构函数，关闭所有串口并刷新输出。
+ */
+HeadlessCapture::~HeadlessCapture()
+{
+	Stop();
+}
+
+/**
+ * @brief 打开输出文件和所有串口。
+ * 任意一个串口打开失败都会抛出异常，由调用方决定是否退出。
+ * @throw std::runtime_error 如果输出文件或串口打开失败。
+ */
+void HeadlessCapture::Start()
+{
+	if (m_options.ports.isEmpty())
+	{
+		throw std::runtime_error("No serial port specified.");
+	}
+	if (m_options.relay && m_options.ports.size() != 2)
+	{
+		throw std::runtime_error("Relay mode needs exactly two ports.");
+	}
+
+	if (!m_options.framesPath.isEmpty())
+	{
+		m_framesFile = OpenOutput(m_options.framesPath, stdout);
+	}
+	m_statsFile = OpenOutput(m_options.statsPath, stderr);
+	if (m_options.relay && !m_options.relayLogPath.isEmpty())
+	{
+		m_relayFile = OpenOutput(m_options.relayLogPath, stdout);
+	}
+	if (!m_options.filterSpec.isEmpty())
+	{
+		FilterConfig config;
+		try
+		{
+			config = FilterConfig::Parse(m_options.filterSpec.toStdString());
+		}
+		catch (const std::invalid_argument& e)
+		{
+			throw std::runtime_error(e.what());
+		}
+		if (!m_options.filteredPath.isEmpty())
+		{
+			m_filteredFile = OpenOutput(m_options.filteredPath, stdout);
+		}
+		m_filter = std::make_unique<FilterWorker>();
+		m_filter->SetConfig(config);
+	}
+	if (!m_options.stepSpec.isEmpty())
+	{
+		StepConfig config;
+		try
+		{
+			config = StepConfig::Parse(m_options.stepSpec.toStdString());
+		}
+		catch (const std::invalid_argument& e)
+		{
+			throw std::runtime_error(e.what());
+		}
+		if (!m_options.stepsPath.isEmpty())
+		{
+			m_stepsFile = OpenOutput(m_options.stepsPath, stdout);
+		}
+		m_steps = std::make_unique<StepWorker>();
+		m_steps->SetConfig(config);
+	}
+	if (!m_options.derivedSpec.isEmpty())
+	{
+		try
+		{
+			m_derived = DerivedChannels::Compile(m_options.derivedSpec.toStdString());
+		}
+		catch (const std::invalid_argument& e)
+		{
+			throw std::runtime_error(e.what());
+		}
+	}
+	if (!m_options.alarmSpec.isEmpty())
+	{
+		StartAlarms();
+	}
+	if (!m_options.watchSpec.isEmpty())
+	{
+		StartWatch();
+	}
+	if (!m_options.shmName.isEmpty())
+	{
+		m_shm.Open(m_options.shmName.toStdString(), m_options.shmSlots);
+	}
+
+	DecoderOptions decoderOptions;
+	decoderOptions.headers.clear();
+	for (const QString& header : m_options.headers)
+	{
+		decoderOptions.headers.push_back(header.toStdString());
+	}
+	decoderOptions.endFrame = m_options.endFrame.toStdString();
+
+	for (const QString& portSpec : m_options.ports)
+	{
+		// "COM3:nmea" 为单个串口指定解码器，未指定时使用 m_options.decoder；
+		// 设备路径本身可能含冒号（/dev/serial/by-path/pci-0000:00:14.0-usb-0:1:1.0-port0），
+		// 只有最后一个冒号之后是已登记的解码器名称时才拆分
+		QString portName = portSpec;
+		QString decoderName = m_options.decoder;
+		const int colon = portSpec.lastIndexOf(':');
+		if (colon > 0)
+		{
+			const QString suffix = portSpec.mid(colon + 1);
+			if (suffix == "modbus" || DecoderRegistry::Instance().Contains(suffix.toStdString()))
+			{
+				portName = portSpec.left(colon);
+				decoderName = suffix;
+			}
+		}
+
+		auto port = std::make_unique<PortContext>();
+		port->name = portName;
+		port->label = QFileInfo(portName).fileName().toStdString();
+		// 多个串口时通道名称加上串口标签，例如 ttyUSB0.START1.P
+		port->channelPrefix = m_options.ports.size() > 1 ? port->label + "." : std::string();
+		port->index = static_cast<quint32>(m_ports.size());
+		try
+		{
+			if (decoderName == "modbus")
+			{
+				// Modbus 主站需要轮询配置，不经过解码器注册表；每个串口是一条独立的总线，各有一份调度
+				if (m_options.modbusSpec.isEmpty())
+				{
+					throw std::invalid_argument("The modbus decoder needs a polling spec (--modbus).");
+				}
+				if (m_options.relay)
+				{
+					throw std::invalid_argument("Modbus polling cannot be used in relay mode.");
+				}
+				auto master = std::make_unique<ModbusMaster>(ModbusConfig::Parse(m_options.modbusSpec.toStdString()));
+				master->SetResponseTimeout(static_cast<int64_t>(m_options.modbusTimeoutMs) * 1000000);
+				qDebug().noquote() << QString("Modbus plan for %1:\n%2").arg(portName, QString::fromStdString(master->DescribePlan()).trimmed());
+				port->modbus = master.get();
+				port->decoder = std::move(master);
+			}
+			else
+			{
+				port->decoder = DecoderRegistry::Instance().Create(decoderName.toStdString(), decoderOptions);
+			}
+		}
+		catch (const std::invalid_argument& e)
+		{
+			throw std::runtime_error(e.what());
+		}
+
+		PortContext* context = port.get();
+
+		if (!m_options.rawPath.isEmpty())
+		{
+			QString rawPath = m_options.rawPath;
+			if (m_options.ports.size() > 1)
+			{
+				// 多个串口时在扩展名前插入串口名，例如 capture.bin -> capture.COM3.bin
+				const QFileInfo info(rawPath);
+				const QString suffix = info.completeSuffix();
+				rawPath = info.path() + "/" + info.baseName() + "." + QFileInfo(portName).fileName() +
+					(suffix.isEmpty() ? QString() : "." + suffix);
+			}
+			port->rawFile = OpenOutput(rawPath, stdout);
+		}
+
+		port->serial = std::make_unique<SerialInfo>();
+		if (m_options.relay)
+		{
+			// 转发在串口读取线程中完成，这里收到的是已经写到对端的数据块，时间戳取读到数据的时刻
+			connect(port->serial.get(), &SerialInfo::DataRelayed, this,
+				[this, context](const QByteArray& data, qint64 receivedNs, qint64 relayedNs) {
+					HandleRelayed(*context, data, receivedNs, relayedNs);
+				});
+		}
+		else
+		{
+			connect(port->serial.get(), &SerialInfo::DataReceived, this, [this, context](const QByteArray& data, qint64 receivedNs) {
+				// 数据块可能在事件队列中等了一段时间，帧和报警的时间取读到数据的时刻
+				HandleData(*context, data, qMax<qint64>(receivedNs - m_startNs, 0));
+				context->serial->ChunkConsumed(data.size());
+				});
+			port->serial->TrackMemory("rx " + port->label);
+			if (port->modbus != nullptr)
+			{
+				port->poller = std::make_unique<ModbusPoller>(port->serial.get(), port->modbus);
+			}
+		}
+
+		// SetSerialConfiguration 对非法波特率、BackendFromName 对未知后端抛出 std::invalid_argument
+		try
+		{
+			port->serial->SetBackend(SerialInfo::BackendFromName(m_options.serialBackend));
+			port->serial->SetSerialConfiguration(m_options.baudRate, m_options.dataBits, m_options.stopBits,
+				m_options.parity, portName);
+		}
+		catch (const std::invalid_argument& e)
+		{
+			throw std::runtime_error(e.what());
+		}
+		port->serial->SetAutoReconnect(m_options.reconnect);
+		connect(port->serial.get(), &SerialInfo::ConnectionLost, this, [this, context](const QString& reason) {
+			HandleLinkLost(*context, reason);
+			});
+		connect(port->serial.get(), &SerialInfo::Reconnected, this, [this, context](qint64 outageNs, qint64 reopenNs) {
+			HandleLinkRestored(*context, outageNs, reopenNs);
+			});
+		// 超过内存预算丢弃数据与断线一样处理，丢弃前的半帧不会与恢复后的数据拼在一起
+		connect(port->serial.get(), &SerialInfo::SheddingStarted, this, [this, context]() {
+			ResetStream(*context);
+			WriteLinkEvent(*context, m_clock.nsecsElapsed(), "shedding over memory budget");
+			});
+		connect(port->serial.get(), &SerialInfo::SheddingStopped, this, [this, context](quint64 droppedBytes) {
+			WriteLinkEvent(*context, m_clock.nsecsElapsed(), QString("resumed dropped_bytes=%1").arg(droppedBytes));
+			});
+		if (m_options.fanoutTcpPort != 0 || !m_options.fanoutLocal.isEmpty())
+		{
+			// 多个串口时 TCP 端口依次加一，本地套接字名加上串口名，例如 bridge-ttyUSB0
+			const quint16 tcpPort = m_options.fanoutTcpPort == 0 ? 0
+				: static_cast<quint16>(m_options.fanoutTcpPort + m_ports.size());
+			QString localName = m_options.fanoutLocal;
+			if (!localName.isEmpty() && m_options.ports.size() > 1)
+			{
+				localName += "-" + QString::fromStdString(port->label);
+			}
+			port->serial->EnableFanout(tcpPort, localName);
+		}
+		if (m_options.probeRateHz > 0)
+		{
+			port->probe = std::make_unique<LatencyProbe>(static_cast<int64_t>(m_options.probeTimeoutMs) * 1000000);
+		}
+		m_ports.push_back(std::move(port));
+	}
+
+	// 转发目标要在打开串口之前设置好，否则打开后最先到达的数据不会被转发
+	if (m_options.relay)
+	{
+		m_ports[0]->serial->SetRelayTarget(m_ports[1]->serial.get());
+		m_ports[1]->serial->SetRelayTarget(m_ports[0]->serial.get());
+	}
+	MemoryBudget::Instance().SetLimit(static_cast<size_t>(m_options.memoryLimitMb) << 20);
+	m_flightBudget = MemoryBudget::Instance().Register("flight recorder", MemoryBudget::Policy::Fixed,
+		[]() { return FlightRecorder::Instance().Capacity(); });
+	m_memoryTimer.start(1000);
+	m_clock.start();
+	m_startNs = TraceRecorder::NowNs();
+	for (auto& port : m_ports)
+	{
+		port->serial->SerialChangestate(false);
+	}
+	for (auto& port : m_ports)
+	{
+		if (port->poller)
+		{
+			port->poller->Start();
+		}
+	}
+	m_running = true;
+	if (m_options.statsIntervalSec > 0)
+	{
+		m_statsTimer.start(m_options.statsIntervalSec * 1000);
+	}
+	if (m_options.durationSec > 0)
+	{
+		QTimer::singleShot(m_options.durationSec * 1000, this, &HeadlessCapture::Finished);
+	}
+	if (!m_options.sendFile.isEmpty())
+	{
+		StartTransfer();
+	}
+	if (m_options.probeRateHz > 0)
+	{
+		m_probeTimer.start(qMax(1, qRound(1000.0 / m_options.probeRateHz)));
+	}
+	if (m_filter || m_steps)
+	{
+		m_filterTimer.start(100);
+	}
+	if (m_alarms.HasDurationRules())
+	{
+		m_alarmTimer.start(5);
+	}
+}
+
+/**
+ * @brief 关闭所有串口，输出最终统计并刷新文件。
+ */
+void HeadlessCapture::Stop()
+{
+	if (!m_running)
+	{
+		return;
+	}
+	m_running = false;
+	m_statsTimer.stop();
+	m_probeTimer.stop();
+	m_filterTimer.stop();
+	m_alarmTimer.stop();
+	m_memoryTimer.stop();
+	if (m_transfer)
+	{
+		m_transfer->Cancel();
+	}
+
+	for (auto& port : m_ports)
+	{
+		if (port->poller)
+		{
+			port->poller->Stop();
+		}
+		if (port->serial != nullptr)
+		{
+			port->serial->SetRelayTarget(nullptr);
+		}
+	}
+	for (auto& port : m_ports)
+	{
+		if (port->serial != nullptr)
+		{
+			port->serial->SerialChangestate(true);
+		}
+	}
+	if (m_filter)
+	{
+		m_filter->Flush();
+		WriteFiltered();
+	}
+	if (m_steps)
+	{
+		m_steps->Flush(true);
+		WriteSteps();
+	}
+	ReportStats();
+	if (m_steps)
+	{
+		// 每组增益的平均指标只在结束时输出一次
+		const QString history = QString::fromStdString(m_steps->FormatHistory());
+		for (const QString& line : history.split('\n', Qt::SkipEmptyParts))
+		{
+			m_statsFile->write(QString("[stats] step %1\n").arg(line).toUtf8());
+		}
+		m_statsFile->flush();
+	}
+
+	for (auto& port : m_ports)
+	{
+		if (port->rawFile)
+		{
+			port->rawFile->flush();
+		}
+	}
+	if (m_framesFile)
+	{
+		m_framesFile->flush();
+	}
+	if (m_relayFile)
+	{
+		m_relayFile->flush();
+	}
+	if (m_filteredFile)
+	{
+		m_filteredFile->flush();
+	}
+	if (m_stepsFile)
+	{
+		m_stepsFile->flush();
+	}
+	if (m_watchFile)
+	{
+		m_watchFile->flush();
+	}
+	if (m_eventBridge)
+	{
+		m_eventBridge->Close();
+	}
+	m_shm.Close();
+}
+
+/**
+ * @brief 处理某个串口收到的数据：先原样写入原始数据文件，再交给解码器。
+ * @param receivedNs 数据块的接收时间（相对采集开始），作为这一块中所有帧的时间戳。
+ */
+void HeadlessCapture::HandleData(PortContext& port, const QByteArray& data, qint64 receivedNs)
+{
+	TRACE_ZONE("HeadlessCapture::HandleData");
+	port.bytes += static_cast<quint64>(data.size());
+	port.chunkNs = receivedNs;
+	if (port.rawFile)
+	{
+		port.rawFile->write(data);
+	}
+	if (!m_watch.IsEmpty())
+	{
+		m_watch.Scan(static_cast<int>(port.index), ByteSpan(data.constData(), static_cast<size_t>(data.size())), receivedNs);
+	}
+	if (port.probe)
+	{
+		port.probe->OnReceive(ByteSpan(data.constData(), static_cast<size_t>(data.size())), receivedNs);
+	}
+	// 解码记录和派生记录共用的处理：帧输出、报警、滤波和阶跃分析，派生通道名称不加串口前缀
+	auto consume = [this, &port](const DecodedRecord& record, const std::string& prefix) {
+		WriteRecord(port, record);
+		if (record.values != nullptr && (m_filter || m_steps || !m_alarms.IsEmpty()))
+		{
+			const qint64 ns = port.chunkNs;
+			m_alarms.OnRecord(ns, record, prefix);
+			if (m_filter)
+			{
+				m_filter->PushRecord(ns / 1e9, record, prefix);
+			}
+			if (m_steps)
+			{
+				m_steps->PushRecord(ns / 1e9, record, prefix);
+			}
+		}
+	};
+	auto derivedSink = MakeRecordSink([&consume](const DecodedRecord& record) { consume(record, std::string()); });
+	auto sink = MakeRecordSink([this, &port, &consume, &derivedSink](const DecodedRecord& record) {
+		m_shm.Publish(port.index, record);
+		FlightRecorder::Instance().RecordFrame(port.serial->FlightChannel(), record);
+		consume(record, port.channelPrefix);
+		m_derived.OnRecord(record, derivedSink, port.channelPrefix);
+		});
+	TRACE_ZONE("decode");
+	port.decoder->Feed(ByteSpan(data.constData(), static_cast<size_t>(data.size())), sink);
+}
+
+/**
+ * @brief 通过第一个串口发送 sendFile，结束后输出摘要并结束采集。
+ * @throw std::runtime_error 如果模式未知或文件无法打开。
+ */
+void HeadlessCapture::StartTransfer()
+{
+	FileTransfer::Mode mode;
+	try
+	{
+		mode = FileTransfer::ParseMode(m_options.sendMode);
+	}
+	catch (const std::invalid_argument& e)
+	{
+		throw std::runtime_error(e.what());
+	}
+
+	m_transfer = std::make_unique<FileTransfer>(m_ports.front()->serial.get());
+	connect(m_transfer.get(), &FileTransfer::Finished, this, [this](bool ok, const QString& message) {
+		if (m_statsFile)
+		{
+			m_statsFile->write(QString("[transfer] %1 %2\n").arg(ok ? "done" : "failed", message).toUtf8());
+			m_statsFile->flush();
+		}
+		// 空文件的原始发送在 Start 内就会结束，排队发出以保证调用方已经连接 Finished
+		QTimer::singleShot(0, this, &HeadlessCapture::Finished);
+		});
+	m_transfer->Start(m_options.sendFile, mode, m_options.sendWindow);
+}
+
+/**
+ * @brief 编译报警规则。事件写到统计输出并立即刷新，指定 alarmTcpPort 时同时按行广播。
+ * @throw std::runtime_error 如果规则无法解析或端口监听失败。
+ */
+void HeadlessCapture::StartAlarms()
+{
+	try
+	{
+		m_alarms = AlarmEngine::Compile(m_options.alarmSpec.toStdString());
+	}
+	catch (const std::invalid_argument& e)
+	{
+		throw std::runtime_error(e.what());
+	}
+	if (m_options.alarmTcpPort != 0)
+	{
+		m_eventBridge = std::make_unique<EventBridge>();
+		m_eventBridge->ListenTcp(m_options.alarmTcpPort);
+	}
+	m_alarms.SetHandler([this](const AlarmEvent& event) {
+		const std::string line = m_alarms.Format(event);
+		if (m_statsFile)
+		{
+			m_statsFile->write("[alarm] ");
+			m_statsFile->write(line.data(), static_cast<qint64>(line.size()));
+			m_statsFile->write("\n");
+			m_statsFile->flush();
+		}
+		if (m_eventBridge)
+		{
+			m_eventBridge->Broadcast(QByteArray::fromStdString(line));
+		}
+		});
+}
+
+/**
+ * @brief 编译监视列表。每次匹配按 "毫秒,串口,偏移,模式" 写一行到匹配输出（模式放在最后，其中可以有逗号），
+ * 报警广播已打开时同时广播 Format 格式的一行；未指定匹配输出时只计数，统计中给出次数最多的模式。
+ * @throw std::runtime_error 如果列表无法编译或输出文件打开失败。
+ */
+void HeadlessCapture::StartWatch()
+{
+	try
+	{
+		m_watch = WatchList::Compile(m_options.watchSpec.toStdString());
+	}
+	catch (const std::invalid_argument& e)
+	{
+		throw std::runtime_error(e.what());
+	}
+	if (!m_options.watchPath.isEmpty())
+	{
+		m_watchFile = OpenOutput(m_options.watchPath, stdout);
+	}
+	if (m_options.alarmTcpPort != 0 && !m_eventBridge)
+	{
+		m_eventBridge = std::make_unique<EventBridge>();
+		m_eventBridge->ListenTcp(m_options.alarmTcpPort);
+	}
+	m_watch.SetHandler([this](const WatchHit& hit) {
+		if (m_watchFile)
+		{
+			char prefix[64];
+			const int length = std::snprintf(prefix, sizeof(prefix), "%.3f,", hit.timeNs / 1e6);
+			m_lineBuffer.assign(prefix, length > 0 ? static_cast<size_t>(length) : 0);
+			m_lineBuffer.append(m_ports[static_cast<size_t>(hit.stream)]->label);
+			m_lineBuffer.push_back(',');
+			m_lineBuffer.append(std::to_string(hit.offset));
+			m_lineBuffer.push_back(',');
+			m_lineBuffer.append(m_watch.Pattern(hit.pattern));
+			m_lineBuffer.push_back('\n');
+			m_watchFile->write(m_lineBuffer.data(), static_cast<qint64>(m_lineBuffer.size()));
+		}
+		if (m_eventBridge)
+		{
+			m_eventBridge->Broadcast(QByteArray::fromStdString(m_watch.Format(hit)));
+		}
+		});
+	qDebug() << "Watch list compiled:" << m_watch.PatternCount() << "patterns," << m_watch.StateCount() << "states";
+}
+
+/**
+ * @brief 向每个串口发送一个延迟探测帧。
+ * 探测帧与其他发送数据（例如分发桥客户端的写入）共用 SerialSendBytes，
+ * 串口未打开等发送失败只计入丢失，不中断采集。
+ */
+void HeadlessCapture::SendProbes()
+{
+	const qint64 nowNs = m_clock.nsecsElapsed();
+	for (auto& port : m_ports)
+	{
+		if (!port->probe)
+		{
+			continue;
+		}
+		const std::string& ping = port->probe->NextPing(nowNs);
+		try
+		{
+			port->serial->SerialSendBytes(QByteArray(ping.data(), static_cast<int>(ping.size())));
+		}
+		catch (const std::runtime_error& e)
+		{
+			qDebug() << "Probe send failed:" << e.what();
+		}
+	}
+}
+
+/**
+ * @brief 取出滤波线程的输出并写到滤波输出文件。
+ * 每个样本一行：相对采集开始的毫秒数,通道,滤波值，时间为原始样本的时间。
+ */
+void HeadlessCapture::WriteFiltered()
+{
+	m_filteredSamples.clear();
+	if (!m_filter || m_filter->Drain(m_filteredSamples) == 0 || !m_filteredFile)
+	{
+		return;
+	}
+	for (const FilteredSample& sample : m_filteredSamples)
+	{
+		char value[96];
+		const int length = std::snprintf(value, sizeof(value), "%.3f,", sample.t * 1e3);
+		m_lineBuffer.assign(value, length > 0 ? static_cast<size_t>(length) : 0);
+		m_lineBuffer.append(m_filter->ChannelName(sample.channel));
+		const int valueLength = std::snprintf(value, sizeof(value), ",%.9g\n", sample.value);
+		m_lineBuffer.append(value, valueLength > 0 ? static_cast<size_t>(valueLength) : 0);
+		m_filteredFile->write(m_lineBuffer.data(), static_cast<qint64>(m_lineBuffer.size()));
+	}
+}
+
+/**
+ * @brief 取出阶跃分析线程完成的阶跃并写到阶跃结果文件。
+ * 每次阶跃一行：阶跃时间（毫秒）,控制器,Kp,Ki,Kd,起点,终点,上升ms,超调%,调节ms,稳态误差。
+ */
+void HeadlessCapture::WriteSteps()
+{
+	m_stepResults.clear();
+	if (!m_steps || m_steps->Drain(m_stepResults) == 0 || !m_stepsFile)
+	{
+		return;
+	}
+	const std::vector<StepRule>& rules = m_steps->Config().Rules();
+	for (const StepResult& result : m_stepResults)
+	{
+		char time[32];
+		const int length = std::snprintf(time, sizeof(time), "%.3f,", result.metrics.t0 * 1e3);
+		m_lineBuffer.assign(time, length > 0 ? static_cast<size_t>(length) : 0);
+		m_lineBuffer.append(FormatStepResult(result, rules[static_cast<size_t>(result.controller)].name));
+		m_lineBuffer.push_back('\n');
+		m_stepsFile->write(m_lineBuffer.data(), static_cast<qint64>(m_lineBuffer.size()));
+	}
+}
+
+/**
+ * @brief 处理转发模式下已经写到对端的数据块。
+ * 转发记录每个数据块一行：毫秒数,源>目标,字节数,转发附加延迟(微秒),十六进制数据；
+ * 写到对端失败时延迟一栏为 -1。时间戳都是源串口读到数据的时刻，与帧输出一致。
+ */
+void HeadlessCapture::HandleRelayed(PortContext& port, const QByteArray& data, qint64 receivedNs, qint64 relayedNs)
+{
+	const PortContext& peer = *m_ports[&port == m_ports[0].get() ? 1 : 0];
+	const qint64 chunkNs = qMax<qint64>(receivedNs - m_startNs, 0);
+	if (relayedNs >= 0)
+	{
+		++port.relayChunks;
+		port.relayLatency.Record(relayedNs - receivedNs);
+	}
+	else
+	{
+		++port.relayDropped;
+	}
+	if (m_relayFile)
+	{
+		char prefix[64];
+		const int length = std::snprintf(prefix, sizeof(prefix), "%.3f,", chunkNs / 1e6);
+		m_lineBuffer.assign(prefix, length > 0 ? static_cast<size_t>(length) : 0);
+		m_lineBuffer.append(port.label);
+		m_lineBuffer.push_back('>');
+		m_lineBuffer.append(peer.label);
+		m_lineBuffer.push_back(',');
+		m_lineBuffer.append(std::to_string(data.size()));
+		m_lineBuffer.push_back(',');
+		m_lineBuffer.append(relayedNs >= 0 ? std::to_string((relayedNs - receivedNs) / 1000) : std::string("-1"));
+		m_lineBuffer.push_back(',');
+		m_lineBuffer.append(data.toHex().constData());
+		m_lineBuffer.push_back('\n');
+		m_relayFile->write(m_lineBuffer.data(), static_cast<qint64>(m_lineBuffer.size()));
+	}
+	HandleData(port, data, chunkNs);
+}
+
+/**
+ * @brief 串口断开。ConnectionLost 排在断开前最后一个数据块之后，此时完整的帧都已经输出，
+ * 解码器中剩下的半帧和监视列表中匹配到一半的前缀都属于断开前的数据，在这里丢弃，不会与重连后的数据拼在一起。
+ */
+void HeadlessCapture::HandleLinkLost(PortContext& port, const QString& reason)
+{
+	ResetStream(port);
+	const qint64 nowNs = m_clock.nsecsElapsed();
+	WriteLinkEvent(port, nowNs, "lost " + reason);
+	if (m_statsFile)
+	{
+		m_statsFile->write(QString("[link] t=%1s port=%2 lost: %3, reconnecting\n")
+			.arg(nowNs / 1e9, 0, 'f', 3).arg(port.name, reason).toUtf8());
+		m_statsFile->flush();
+	}
+}
+
+void HeadlessCapture::HandleLinkRestored(PortContext& port, qint64 outageNs, qint64 reopenNs)
+{
+	const qint64 nowNs = m_clock.nsecsElapsed();
+	WriteLinkEvent(port, nowNs, QString("restored outage_ms=%1 reopen_ms=%2")
+		.arg(outageNs / 1e6, 0, 'f', 1).arg(reopenNs / 1e6, 0, 'f', 1));
+	if (m_statsFile)
+	{
+		m_statsFile->write(QString("[link] t=%1s port=%2 restored after %3 ms, reopened %4 ms after the device returned\n")
+			.arg(nowNs / 1e9, 0, 'f', 3).arg(port.name).arg(outageNs / 1e6, 0, 'f', 1).arg(reopenNs / 1e6, 0, 'f', 1).toUtf8());
+		m_statsFile->flush();
+	}
+}
+
+void HeadlessCapture::ResetStream(PortContext& port)
+{
+	port.decoder->Reset();
+	m_watch.Reset(static_cast<int>(port.index));
+	m_alarms.Reset(port.channelPrefix);
+	if (m_filter)
+	{
+		m_filter->Reset(port.channelPrefix);
+	}
+	if (m_steps)
+	{
+		m_steps->Reset(port.channelPrefix);
+	}
+}
+
+void HeadlessCapture::WriteLinkEvent(const PortContext& port, qint64 ns, const QString& event)
+{
+	if (!m_framesFile)
+	{
+		return;
+	}
+	char prefix[64];
+	const int length = std::snprintf(prefix, sizeof(prefix), "%.3f,", ns / 1e6);
+	m_lineBuffer.assign(prefix, length > 0 ? static_cast<size_t>(length) : 0);
+	m_lineBuffer.append(port.label);
+	m_lineBuffer.append(",LINK,");
+	m_lineBuffer.append(event.toStdString());
+	m_lineBuffer.push_back('\n');
+	m_framesFile->write(m_lineBuffer.data(), static_cast<qint64>(m_lineBuffer.size()));
+}
+
+/**
+ * @brief 把一条解码记录写到帧输出。
+ * 每条记录一行：相对采集开始的毫秒数,串口,名称,字段...
+ */
+void HeadlessCapture::WriteRecord(const PortContext& port, const DecodedRecord& record)
+{
+	if (!m_framesFile)
+	{
+		return;
+	}
+
+	char prefix[64];
+	const int length = std::snprintf(prefix, sizeof(prefix), "%.3f,", port.chunkNs / 1e6);
+	m_lineBuffer.assign(prefix, length > 0 ? static_cast<size_t>(length) : 0);
+	m_lineBuffer.append(port.label);
+	m_lineBuffer.push_back(',');
+	m_lineBuffer.append(FormatRecord(record, ","));
+	m_lineBuffer.push_back('\n');
+	m_framesFile->write(m_lineBuffer.data(), static_cast<qint64>(m_lineBuffer.size()));
+}
+
+/**
+ * @brief 输出一次所有串口的统计信息，包括累计值和本周期的速率。
+ */
+void HeadlessCapture::ReportStats()
+{
+	if (!m_statsFile)
+	{
+		return;
+	}
+
+	const qint64 nowMs = m_clock.isValid() ? m_clock.elapsed() : 0;
+	const double seconds = qMax<qint64>(nowMs - m_lastStatsMs, 1) / 1000.0;
+	m_lastStatsMs = nowMs;
+
+	for (auto& port : m_ports)
+	{
+		const quint64 frames = port->decoder->RecordCount();
+		const QString line = QString("[stats] t=%1s port=%2 decoder=%3 bytes=%4 frames=%5 errors=%6 rate=%7 B/s %8 frames/s\n")
+			.arg(nowMs / 1000.0, 0, 'f', 1)
+			.arg(port->name)
+			.arg(port->decoder->Name())
+			.arg(port->bytes)
+			.arg(frames)
+			.arg(port->decoder->ErrorCount())
+			.arg((port->bytes - port->lastBytes) / seconds, 0, 'f', 0)
+			.arg((frames - port->lastFrames) / seconds, 0, 'f', 1);
+		m_statsFile->write(line.toUtf8());
+		if (const SerialFanout* fanout = port->serial->GetFanout())
+		{
+			const QString bridge = QString("[stats] t=%1s port=%2 bridge clients=%3 dropped=%4 sent=%5 received=%6\n")
+				.arg(nowMs / 1000.0, 0, 'f', 1)
+				.arg(port->name)
+				.arg(fanout->ClientCount())
+				.arg(fanout->DroppedClients())
+				.arg(fanout->BytesSent())
+				.arg(fanout->BytesFromClients());
+			m_statsFile->write(bridge.toUtf8());
+		}
+		if (port->probe)
+		{
+			port->probe->Expire(m_clock.nsecsElapsed());
+			const QString probe = QString("[stats] t=%1s port=%2 probe %3\n")
+				.arg(nowMs / 1000.0, 0, 'f', 1)
+				.arg(port->name)
+				.arg(QString::fromStdString(port->probe->Format()));
+			m_statsFile->write(probe.toUtf8());
+		}
+		if (m_options.relay)
+		{
+			const PortContext& peer = *m_ports[port == m_ports[0] ? 1 : 0];
+			const RttHistogram& added = port->relayLatency;
+			const QString relay = QString("[stats] t=%1s relay %2>%3 chunks=%4 dropped=%5 added p50=%6us p99=%7us max=%8us\n")
+				.arg(nowMs / 1000.0, 0, 'f', 1)
+				.arg(QString::fromStdString(port->label))
+				.arg(QString::fromStdString(peer.label))
+				.arg(port->relayChunks)
+				.arg(port->relayDropped)
+				.arg(added.Percentile(0.5) / 1e3, 0, 'f', 1)
+				.arg(added.Percentile(0.99) / 1e3, 0, 'f', 1)
+				.arg(added.Max() / 1e3, 0, 'f', 1);
+			m_statsFile->write(relay.toUtf8());
+		}
+		if (port->modbus != nullptr)
+		{
+			const QString modbus = QString("[stats] t=%1s port=%2 %3\n")
+				.arg(nowMs / 1000.0, 0, 'f', 1)
+				.arg(port->name)
+				.arg(QString::fromStdString(port->modbus->Format()));
+			m_statsFile->write(modbus.toUtf8());
+		}
+		const SerialInfo::ReconnectStats& link = port->serial->GetReconnectStats();
+		if (link.losses > 0)
+		{
+			const QString reconnect = QString("[stats] t=%1s port=%2 link losses=%3 reconnects=%4%5 failed_opens=%6 "
+				"last outage=%7ms reopen=%8ms max reopen=%9ms\n")
+				.arg(nowMs / 1000.0, 0, 'f', 1)
+				.arg(port->name)
+				.arg(link.losses)
+				.arg(link.reconnects)
+				.arg(port->serial->IsReconnecting() ? " (down)" : "")
+				.arg(link.failedOpens)
+				.arg(link.lastOutageNs / 1e6, 0, 'f', 1)
+				.arg(link.lastReopenNs / 1e6, 0, 'f', 1)
+				.arg(link.maxReopenNs / 1e6, 0, 'f', 1);
+			m_statsFile->write(reconnect.toUtf8());
+		}
+		if (port->serial->ShedBytes() > 0)
+		{
+			const QString shed = QString("[stats] t=%1s port=%2 shed=%3 bytes over the memory budget\n")
+				.arg(nowMs / 1000.0, 0, 'f', 1)
+				.arg(port->name)
+				.arg(port->serial->ShedBytes());
+			m_statsFile->write(shed.toUtf8());
+		}
+		port->lastBytes = port->bytes;
+		port->lastFrames = frames;
+	}
+	if (m_transfer && m_transfer->IsRunning())
+	{
+		const QString transfer = QString("[stats] t=%1s transfer %2\n")
+			.arg(nowMs / 1000.0, 0, 'f', 1)
+			.arg(m_transfer->Summary());
+		m_statsFile->write(transfer.toUtf8());
+	}
+	if (m_filter)
+	{
+		const QString filter = QString("[stats] t=%1s %2\n")
+			.arg(nowMs / 1000.0, 0, 'f', 1)
+			.arg(QString::fromStdString(m_filter->Format()));
+		m_statsFile->write(filter.toUtf8());
+	}
+	if (m_steps)
+	{
+		const QString steps = QString("[stats] t=%1s %2\n")
+			.arg(nowMs / 1000.0, 0, 'f', 1)
+			.arg(QString::fromStdString(m_steps->Format()));
+		m_statsFile->write(steps.toUtf8());
+	}
+	if (!m_alarms.IsEmpty())
+	{
+		const QString alarms = QString("[stats] t=%1s alarms rules=%2 active=%3 evaluations=%4 clients=%5\n")
+			.arg(nowMs / 1000.0, 0, 'f', 1)
+			.arg(m_alarms.RuleCount())
+			.arg(m_alarms.ActiveCount())
+			.arg(m_alarms.Evaluations())
+			.arg(m_eventBridge ? m_eventBridge->ClientCount() : 0);
+		m_statsFile->write(alarms.toUtf8());
+	}
+	if (!m_watch.IsEmpty())
+	{
+		const QString watch = QString("[stats] t=%1s watch patterns=%2 states=%3 scanned=%4 hits=%5 %6\n")
+			.arg(nowMs / 1000.0, 0, 'f', 1)
+			.arg(m_watch.PatternCount())
+			.arg(m_watch.StateCount())
+			.arg(m_watch.ScannedBytes())
+			.arg(m_watch.TotalHits())
+			.arg(QString::fromStdString(m_watch.FormatCounts()));
+		m_statsFile->write(watch.toUtf8());
+	}
+	const QString memory = QString("[stats] t=%1s %2\n")
+		.arg(nowMs / 1000.0, 0, 'f', 1)
+		.arg(QString::fromStdString(MemoryBudget::Instance().Format()));
+	m_statsFile->write(memory.toUtf8());
+	if (m_shm.IsOpen())
+	{
+		const QString shm = QString("[stats] t=%1s shm=%2 published=%3\n")
+			.arg(nowMs / 1000.0, 0, 'f', 1)
+			.arg(QString::fromStdString(m_shm.Name()))
+			.arg(m_shm.PublishedCount());
+		m_statsFile->write(shm.toUtf8());
+	}
+	m_statsFile->flush();
+	if (m_framesFile)
+	{
+		m_framesFile->flush();
+	}
+	if (m_relayFile)
+	{
+		m_relayFile->flush();
+	}
+	if (m_filteredFile)
+	{
+		m_filteredFile->flush();
+	}
+	if (m_stepsFile)
+	{
+		m_stepsFile->flush();
+	}
+}
+
+/**
+ * @brief 打开输出文件，"-" 对应给定的标准流。
+ * @param path 文件路径。
+ * @param stdStream 路径为 "-" 时使用的标准流。
+ * @return 打开的文件。
+ * @throw std::runtime_error 如果打开失败。
+ */
+std::unique_ptr<QFile> HeadlessCapture::OpenOutput(const QString& path, FILE* stdStream)
+{
+	auto file = std::make_unique<QFile>();
+	bool opened = false;
+	if (path == "-")
+	{
+		opened = file->open(stdStream, QIODevice::WriteOnly);
+	}
+	else
+	{
+		file->setFileName(path);
+		opened = file->open(QIODevice::WriteOnly | QIODevice::Truncate);
+	}
+	if (!opened)
+	{
+		throw std::runtime_error(QString("Failed to open output %1: %2")
+			.arg(path, file->errorString()).toStdString());
+	}
+	return file;
+}
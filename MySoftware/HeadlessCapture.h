@@ -0,0 +1,260 @@
+/*
+ * @Description: 无界面采集模式，打开一个或多个串口并把帧、统计和原始数据写到文件或标准输出
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 10:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AlarmEngine.h"
+#include "DerivedChannels.h"
+#include "EventBridge.h"
+#include "FileTransfer.h"
+#include "FilterWorker.h"
+#include "StepWorker.h"
+#include "LatencyProbe.h"
+#include "ModbusMaster.h"
+#include "ModbusPoller.h"
+#include "ProtocolDecoder.h"
+#include "SerialInfo.h"
+#include "ShmFramePublisher.h"
+#include "WatchList.h"
+
+/**
+ * @brief 命令行采集模式的配置。
+ */
+struct HeadlessOptions
+{
+	/**
+	 * @brief DefaultPidHeaders() 的 QStringList 形式。
+	 */
+	static QStringList DefaultHeaders();
+
+	QStringList ports;                /**< 串口列表，"名称:协议" 可为单个串口指定解码器。 */
+	QString decoder = "pid";          /**< 未单独指定时使用的解码器名称。 */
+	qint32 baudRate = 115200;         /**< 波特率。 */
+	qint32 dataBits = 8;              /**< 数据位。 */
+	qint32 stopBits = 1;              /**< 停止位。 */
+	QString parity = "None";          /**< 校验位。 */
+	QString serialBackend = "qt";     /**< 串口后端："qt" 或 "native"（Linux termios/epoll）。 */
+	QStringList headers = DefaultHeaders(); /**< 合法帧头列表，默认与界面相同。 */
+	QString endFrame = "END";         /**< 帧尾字符串。 */
+	QString framesPath = "-";         /**< 帧输出路径，"-" 表示标准输出，空表示不输出。 */
+	QString rawPath;                  /**< 原始数据输出路径，多个串口时自动加上串口名后缀。 */
+	QString statsPath = "-";          /**< 统计输出路径，"-" 表示标准错误输出。 */
+	int statsIntervalSec = 10;        /**< 统计输出间隔（秒），0 表示只在退出时输出。 */
+	int durationSec = 0;              /**< 运行时长（秒），0 表示一直运行。 */
+	quint16 fanoutTcpPort = 0;        /**< 分发桥 TCP 端口，多个串口时依次加一，0 表示不启用。 */
+	QString fanoutLocal;              /**< 分发桥本地套接字名称，多个串口时加上串口名后缀，空表示不启用。 */
+	QString shmName;                  /**< 解码帧共享内存名称，空表示不发布。 */
+	quint32 shmSlots = 4096;          /**< 共享内存环形缓冲区的槽数量。 */
+	double probeRateHz = 0;           /**< 延迟探测帧的发送频率（每个串口），0 表示不探测。 */
+	int probeTimeoutMs = 2000;        /**< 探测帧等待回显的超时时间（毫秒）。 */
+	QString sendFile;                 /**< 通过第一个串口发送的文件，空表示不发送。 */
+	QString sendMode = "ymodem";      /**< 文件发送模式：ymodem、xmodem1k 或 raw。 */
+	qint64 sendWindow = 16384;        /**< 原始模式下串口写缓冲中最多保留的字节数。 */
+	QString filterSpec;               /**< 滤波配置，格式见 FilterConfig，空表示不滤波。 */
+	QString filteredPath;             /**< 滤波输出路径，"-" 表示标准输出，空表示不输出。 */
+	QString alarmSpec;                /**< 报警规则，格式见 AlarmEngine，空表示不启用。 */
+	quint16 alarmTcpPort = 0;         /**< 报警事件和监视匹配广播的 TCP 端口，0 表示不广播。 */
+	QString derivedSpec;              /**< 派生通道定义，格式见 DerivedChannels，空表示不启用。 */
+	QString stepSpec;                 /**< 阶跃分析配置，格式见 StepConfig，空表示不分析。 */
+	QString stepsPath;                /**< 阶跃结果输出路径，"-" 表示标准输出，空表示不输出。 */
+	bool relay = false;               /**< 双口转发模式：两个串口收到的数据原样写到对方，同时解码。 */
+	QString relayLogPath;             /**< 转发记录输出路径，每个数据块一行，"-" 表示标准输出，空表示不输出。 */
+	quint64 memoryLimitMb = 0;        /**< 内存上限（MB），超过时暂停分发接收数据块，0 表示只统计。 */
+	QString modbusSpec;               /**< Modbus 轮询配置，格式见 ModbusConfig，解码器为 "modbus" 的串口使用。 */
+	int modbusTimeoutMs = 100;        /**< Modbus 从站响应超时（毫秒），不含传输时间。 */
+	QString watchSpec;                /**< 原始数据监视列表，格式见 WatchList，空表示不启用。 */
+	QString watchPath;                /**< 监视匹配输出路径，每次匹配一行，"-" 表示标准输出，空表示只计数。 */
+	bool reconnect = true;            /**< 设备断开后自动重新打开，见 SerialInfo::SetAutoReconnect。 */
+};
+
+/**
+ * @brief HeadlessCapture 在没有 QApplication 和控件的情况下完成串口采集与解码。
+ *
+ * 每个串口对应一个 SerialInfo 和一个按名称创建的 ProtocolDecoder，解码逻辑与 USARTAss 完全相同。
+ * 输出全部是流式写入：帧按行写出，原始数据原样追加，统计信息定期输出，
+ * 内部不保存任何历史数据，因此长时间运行时内存占用保持不变。
+ */
+class HeadlessCapture : public QObject
+{
+	Q_OBJECT
+
+public:
+	/**
+	 * @brief 构造函数。
+	 * @param options 采集配置。
+	 * @param parent 父对象。
+	 */
+	explicit HeadlessCapture(HeadlessOptions options, QObject* parent = nullptr);
+	/**
+	 * @brief 析构函数，关闭所有串口并刷新输出。
+	 */
+	~HeadlessCapture();
+
+	/**
+	 * @brief 打开输出文件和所有串口。
+	 * @throw std::runtime_error 如果输出文件或串口打开失败。
+	 */
+	void Start();
+
+	/**
+	 * @brief 关闭所有串口，输出最终统计并刷新文件。
+	 */
+	void Stop();
+
+signals:
+	/**
+	 * @brief 达到运行时长后发出的信号。
+	 */
+	void Finished();
+
+private slots:
+	/**
+	 * @brief 输出一次所有串口的统计信息。
+	 */
+	void ReportStats();
+
+	/**
+	 * @brief 向每个串口发送一个延迟探测帧。
+	 */
+	void SendProbes();
+
+	/**
+	 * @brief 取出滤波线程的输出并写到滤波输出文件。
+	 */
+	void WriteFiltered();
+
+	/**
+	 * @brief 取出阶跃分析线程完成的阶跃并写到阶跃结果文件。
+	 */
+	void WriteSteps();
+
+private:
+	/**
+	 * @brief 通过第一个串口发送 sendFile。
+	 */
+	void StartTransfer();
+
+	/**
+	 * @brief 编译报警规则，打开事件广播。
+	 * @throw std::runtime_error 如果规则无法解析或端口监听失败。
+	 */
+	void StartAlarms();
+
+	/**
+	 * @brief 编译监视列表，打开匹配输出。
+	 * @throw std::runtime_error 如果列表无法编译或输出文件打开失败。
+	 */
+	void StartWatch();
+
+	/**
+	 * @brief 单个串口的采集上下文。
+	 */
+	struct PortContext
+	{
+		QString name;                    /**< 串口名称。 */
+		std::string label;               /**< 输出中使用的串口标签（去掉路径）。 */
+		std::string channelPrefix;       /**< 滤波、报警和派生通道的输入名称前缀，多个串口时为 "标签."。 */
+		quint32 index = 0;               /**< 串口序号，写入共享内存帧的 source 字段。 */
+		std::unique_ptr<SerialInfo> serial; /**< 串口对象，没有父对象，在自己的串口线程中读取和转发。 */
+		std::unique_ptr<ProtocolDecoder> decoder; /**< 协议解码器。 */
+		std::unique_ptr<QFile> rawFile;  /**< 原始数据输出文件。 */
+		std::unique_ptr<LatencyProbe> probe; /**< 往返延迟探测，未启用时为空。 */
+		quint64 bytes = 0;               /**< 累计接收字节数。 */
+		quint64 lastBytes = 0;           /**< 上一次统计时的字节数。 */
+		quint64 lastFrames = 0;          /**< 上一次统计时的帧数。 */
+		qint64 chunkNs = 0;              /**< 当前数据块的接收时间（相对采集开始），作为帧输出的时间戳。 */
+		RttHistogram relayLatency;       /**< 转发附加延迟：从读到数据块到写到对端串口。 */
+		quint64 relayChunks = 0;         /**< 转发到对端的数据块数。 */
+		quint64 relayDropped = 0;        /**< 写到对端失败的数据块数。 */
+		ModbusMaster* modbus = nullptr;  /**< 解码器为 Modbus 主站时指向 decoder，否则为空。 */
+		std::unique_ptr<ModbusPoller> poller; /**< Modbus 轮询，在 DataReceived 的解码连接之后连接。 */
+	};
+
+	/**
+	 * @brief 处理某个串口收到的数据。
+	 */
+	void HandleData(PortContext& port, const QByteArray& data, qint64 receivedNs);
+
+	/**
+	 * @brief 处理转发模式下一个已经写到对端的数据块：记录转发延迟和转发记录，再按普通数据处理。
+	 */
+	void HandleRelayed(PortContext& port, const QByteArray& data, qint64 receivedNs, qint64 relayedNs);
+
+	/**
+	 * @brief 串口断开：丢弃解码器和监视列表中断开前的半帧，在帧输出和统计输出中标记断开。
+	 */
+	void HandleLinkLost(PortContext& port, const QString& reason);
+
+	/**
+	 * @brief 串口重新打开：在帧输出和统计输出中标记恢复和重连耗时。
+	 */
+	void HandleLinkRestored(PortContext& port, qint64 outageNs, qint64 reopenNs);
+
+	/**
+	 * @brief 串口数据中断（断线或超过内存预算丢弃数据）时丢弃解码器和监视列表中中断前的半帧，
+	 * 并让该串口通道上的报警、滤波和阶跃分析状态重新开始。
+	 */
+	void ResetStream(PortContext& port);
+
+	/**
+	 * @brief 把一行串口状态事件写到帧输出，格式为 "毫秒,串口,LINK,事件"。
+	 */
+	void WriteLinkEvent(const PortContext& port, qint64 ns, const QString& event);
+
+	/**
+	 * @brief 把一条解码记录写到帧输出。
+	 */
+	void WriteRecord(const PortContext& port, const DecodedRecord& record);
+
+	/**
+	 * @brief 打开输出文件，"-" 对应给定的标准流。
+	 * @param path 文件路径。
+	 * @param stdStream 路径为 "-" 时使用的标准流。
+	 * @return 打开的文件。
+	 * @throw std::runtime_error 如果打开失败。
+	 */
+	static std::unique_ptr<QFile> OpenOutput(const QString& path, FILE* stdStream);
+
+	HeadlessOptions m_options;                        /**< 采集配置。 */
+	std::vector<std::unique_ptr<PortContext>> m_ports; /**< 各串口的上下文。 */
+	std::unique_ptr<QFile> m_framesFile;              /**< 帧输出。 */
+	std::unique_ptr<QFile> m_statsFile;               /**< 统计输出。 */
+	std::unique_ptr<QFile> m_relayFile;               /**< 转发记录输出。 */
+	ShmFramePublisher m_shm;                          /**< 解码帧共享内存发布。 */
+	std::unique_ptr<FileTransfer> m_transfer;         /**< 文件发送，未指定 sendFile 时为空。 */
+	std::unique_ptr<FilterWorker> m_filter;           /**< 滤波线程，未指定 filterSpec 时为空。 */
+	std::unique_ptr<QFile> m_filteredFile;            /**< 滤波输出。 */
+	std::vector<FilteredSample> m_filteredSamples;    /**< 取出的滤波输出，重复使用。 */
+	QTimer m_filterTimer;                             /**< 滤波和阶跃结果输出定时器。 */
+	std::unique_ptr<StepWorker> m_steps;              /**< 阶跃分析线程，未指定 stepSpec 时为空。 */
+	std::unique_ptr<QFile> m_stepsFile;               /**< 阶跃结果输出。 */
+	std::vector<StepResult> m_stepResults;            /**< 取出的阶跃结果，重复使用。 */
+	DerivedChannels m_derived;                        /**< 派生通道，在解码回调中求值，所有串口共用。 */
+	AlarmEngine m_alarms;                             /**< 报警规则，在解码回调中求值。 */
+	std::unique_ptr<EventBridge> m_eventBridge;       /**< 报警事件和监视匹配广播，未指定 alarmTcpPort 时为空。 */
+	WatchList m_watch;                                /**< 原始数据监视列表，在解码前扫描每个数据块。 */
+	std::unique_ptr<QFile> m_watchFile;               /**< 监视匹配输出。 */
+	QTimer m_alarmTimer;                              /**< 持续时间规则的检查定时器。 */
+	QTimer m_statsTimer;                              /**< 统计定时器。 */
+	QTimer m_probeTimer;                              /**< 探测帧发送定时器。 */
+	QTimer m_memoryTimer;                             /**< 内存上限检查定时器。 */
+	QElapsedTimer m_clock;                            /**< 采集开始后的计时。 */
+	qint64 m_lastStatsMs = 0;                         /**< 上一次统计的时间点。 */
+	qint64 m_startNs = 0;                             /**< 采集开始时的 TraceRecorder::NowNs，用于换算接收和转发时间戳。 */
+	std::string m_lineBuffer;                         /**< 帧输出的行缓冲，重复使用避免每帧分配。 */
+	bool m_running = false;                           /**< 是否正在采集。 */
+	MemoryBudget::Registration m_flightBudget;        /**< 飞行记录仪在内存预算中的登记项。 */
+};
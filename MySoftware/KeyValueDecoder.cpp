@@ -0,0 +1,97 @@
+/*
+ * @Description: 按行分隔的 key=value 解码器
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 11:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "KeyValueDecoder.h"
+#include <charconv>
+#include <limits>
+
+namespace
+{
+	bool IsSeparator(char c)
+	{
+		return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+	}
+}
+
+KeyValueDecoder::KeyValueDecoder()
+	: m_framer(4096)
+{
+}
+
+void KeyValueDecoder::Feed(ByteSpan chunk, RecordSink& sink)
+{
+	m_framer.Feed(chunk.data(), chunk.size(), [this, &sink](ByteSpan line) { FeedLine(line, sink); });
+}
+
+void KeyValueDecoder::Reset()
+{
+	m_framer.Reset();
+}
+
+/**
+ * @brief 解码一行 key=value 列表。
+ * 不含 '=' 的单词和超出 kMaxPairs 的键值对各计一次错误，其余键值对照常输出。
+ */
+void KeyValueDecoder::FeedLine(ByteSpan line, RecordSink& sink)
+{
+	size_t count = 0;
+	size_t pos = 0;
+	while (pos < line.size())
+	{
+		while (pos < line.size() && IsSeparator(line[pos]))
+		{
+			++pos;
+		}
+		size_t end = pos;
+		while (end < line.size() && !IsSeparator(line[end]))
+		{
+			++end;
+		}
+		if (end == pos)
+		{
+			break;
+		}
+
+		const ByteSpan token = line.substr(pos, end - pos);
+		pos = end;
+		const size_t equal = token.find('=');
+		if (equal == ByteSpan::npos || equal == 0 || count == kMaxPairs)
+		{
+			++m_errorCount;
+			continue;
+		}
+
+		const ByteSpan text = token.substr(equal + 1);
+		double value = std::numeric_limits<double>::quiet_NaN();
+		const char* textEnd = text.data() + text.size();
+		auto result = std::from_chars(text.data(), textEnd, value);
+		if (text.empty() || result.ec != std::errc() || result.ptr != textEnd)
+		{
+			value = std::numeric_limits<double>::quiet_NaN();
+		}
+
+		m_keys[count] = token.substr(0, equal);
+		m_texts[count] = text;
+		m_values[count] = value;
+		++count;
+	}
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	DecodedRecord record;
+	record.kind = RecordKind::KeyValue;
+	record.raw = line;
+	record.keys = m_keys;
+	record.texts = m_texts;
+	record.values = m_values;
+	record.count = count;
+	++m_recordCount;
+	sink.OnRecord(record);
+}
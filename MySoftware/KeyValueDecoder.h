@@ -0,0 +1,45 @@
+/*
+ * @Description: 按行分隔的 key=value 解码器
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 11:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include "LineFramer.h"
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief KeyValueDecoder 把形如 "t=12 sp1=1.5 pv1=1.43" 的一行解码为一条记录。
+ *
+ * 键值对之间可以用空白、',' 或 ';' 分隔。keys 为键名片段，texts 为值的原文片段，
+ * values 为对应数值，非数字的值为 NaN。不含 '=' 的单词计为错误，没有任何键值对的行不输出记录。
+ */
+class KeyValueDecoder : public ProtocolDecoder
+{
+public:
+	/**
+	 * @brief 单行允许的最大键值对数量，超出部分计为错误并丢弃。
+	 */
+	static constexpr size_t kMaxPairs = 64;
+
+	KeyValueDecoder();
+
+	const char* Name() const override { return "kv"; }
+	void Feed(ByteSpan chunk, RecordSink& sink) override;
+	void Reset() override;
+	bool IsIdle() const override { return !m_framer.HasPartialLine(); }
+
+	/**
+	 * @brief 解码一行 key=value 列表。
+	 * @param line 一行文本。
+	 * @param sink 记录接收方。
+	 */
+	void FeedLine(ByteSpan line, RecordSink& sink);
+
+private:
+	LineFramer m_framer;          /**< 行切分器。 */
+	ByteSpan m_keys[kMaxPairs];   /**< 键名片段暂存区。 */
+	ByteSpan m_texts[kMaxPairs];  /**< 值原文片段暂存区。 */
+	double m_values[kMaxPairs];   /**< 数值暂存区。 */
+};
@@ -0,0 +1,233 @@
+/*
+ * @Description: 主机与设备之间的往返延迟探测，发送带序号的探测帧并在接收数据中匹配回显
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 17:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "LatencyProbe.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+	constexpr int kSubBits = 4;                  /**< 每个 2 的幂区间 16 个桶。 */
+	constexpr uint64_t kSubCount = 1u << kSubBits;
+	constexpr int kMaxExponent = 40;             /**< 上限约 1100 秒。 */
+	constexpr char kPrefix[] = "~PRB";
+	constexpr size_t kPrefixLength = 4;
+	constexpr size_t kDigits = 8;
+
+	int HexValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		return -1;
+	}
+
+	int Log2(uint64_t value)
+	{
+		int exponent = 0;
+		while (value >>= 1)
+		{
+			++exponent;
+		}
+		return exponent;
+	}
+}
+
+RttHistogram::RttHistogram()
+	: m_buckets(BucketOf(~uint64_t(0)) + 1, 0)
+{
+}
+
+size_t RttHistogram::BucketOf(uint64_t value)
+{
+	if (value < kSubCount)
+	{
+		return static_cast<size_t>(value);
+	}
+	const int exponent = std::min(Log2(value), kMaxExponent);
+	const uint64_t mantissa = std::min<uint64_t>((value >> (exponent - kSubBits)) & (kSubCount - 1), kSubCount - 1);
+	return static_cast<size_t>((exponent - kSubBits + 1) * kSubCount + mantissa);
+}
+
+uint64_t RttHistogram::BucketLow(size_t bucket)
+{
+	if (bucket < kSubCount)
+	{
+		return bucket;
+	}
+	const int exponent = static_cast<int>(bucket / kSubCount) + kSubBits - 1;
+	const uint64_t mantissa = bucket % kSubCount;
+	return (kSubCount + mantissa) << (exponent - kSubBits);
+}
+
+void RttHistogram::Record(int64_t valueNs)
+{
+	if (valueNs < 0)
+	{
+		valueNs = 0;
+	}
+	if (m_count == 0 || valueNs < m_min)
+	{
+		m_min = valueNs;
+	}
+	if (m_count == 0 || valueNs > m_max)
+	{
+		m_max = valueNs;
+	}
+	++m_count;
+	++m_buckets[BucketOf(static_cast<uint64_t>(valueNs))];
+}
+
+/**
+ * @brief 第 q 分位数，返回所在桶的中点，并限制在精确的最小值与最大值之间。
+ */
+int64_t RttHistogram::Percentile(double q) const
+{
+	if (m_count == 0)
+	{
+		return 0;
+	}
+	const uint64_t rank = static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * (m_count - 1)) + 1;
+	uint64_t seen = 0;
+	for (size_t bucket = 0; bucket < m_buckets.size(); ++bucket)
+	{
+		seen += m_buckets[bucket];
+		if (seen >= rank)
+		{
+			const uint64_t low = BucketLow(bucket);
+			const uint64_t high = bucket + 1 < m_buckets.size() ? BucketLow(bucket + 1) : low;
+			const int64_t middle = static_cast<int64_t>(low + (high - low) / 2);
+			return std::clamp(middle, m_min, m_max);
+		}
+	}
+	return m_max;
+}
+
+void RttHistogram::Clear()
+{
+	std::fill(m_buckets.begin(), m_buckets.end(), 0);
+	m_count = 0;
+	m_min = 0;
+	m_max = 0;
+}
+
+LatencyProbe::LatencyProbe(int64_t timeoutNs)
+	: m_timeoutNs(timeoutNs), m_outstanding(kMaxOutstanding, Outstanding{ 0, 0, false })
+{
+}
+
+/**
+ * @brief 生成下一个探测帧。
+ * 等待列表已满时，最早的探测帧直接计为丢失。
+ */
+const std::string& LatencyProbe::NextPing(int64_t nowNs)
+{
+	Expire(nowNs);
+	const uint32_t sequence = m_nextSequence++;
+	Outstanding& slot = m_outstanding[sequence % kMaxOutstanding];
+	if (slot.active)
+	{
+		++m_lost;
+	}
+	slot = Outstanding{ sequence, nowNs, true };
+	if (m_nextSequence - m_oldestSequence > kMaxOutstanding)
+	{
+		m_oldestSequence = m_nextSequence - static_cast<uint32_t>(kMaxOutstanding);
+	}
+	++m_sent;
+
+	char frame[32];
+	const int length = std::snprintf(frame, sizeof(frame), "%s%08X\n", kPrefix, sequence);
+	m_frame.assign(frame, static_cast<size_t>(length));
+	return m_frame;
+}
+
+/**
+ * @brief 在接收数据中逐字节匹配 "~PRB" + 8 位十六进制 + '\n'。
+ */
+void LatencyProbe::OnReceive(ByteSpan chunk, int64_t nowNs)
+{
+	for (const char c : chunk)
+	{
+		if (m_matchState < kPrefixLength)
+		{
+			if (c == kPrefix[m_matchState])
+			{
+				++m_matchState;
+			}
+			else
+			{
+				m_matchState = c == kPrefix[0] ? 1 : 0;
+			}
+			continue;
+		}
+
+		if (m_matchState < kPrefixLength + kDigits)
+		{
+			const int digit = HexValue(c);
+			if (digit < 0)
+			{
+				m_matchState = c == kPrefix[0] ? 1 : 0;
+				continue;
+			}
+			m_matchValue = (m_matchState == kPrefixLength ? 0 : m_matchValue << 4) | static_cast<uint32_t>(digit);
+			++m_matchState;
+			continue;
+		}
+
+		if (c == '\n' || c == '\r')
+		{
+			Match(m_matchValue, nowNs);
+		}
+		m_matchState = c == kPrefix[0] ? 1 : 0;
+	}
+}
+
+void LatencyProbe::Match(uint32_t sequence, int64_t nowNs)
+{
+	Outstanding& slot = m_outstanding[sequence % kMaxOutstanding];
+	if (!slot.active || slot.sequence != sequence)
+	{
+		++m_unexpected;
+		return;
+	}
+	slot.active = false;
+	m_histogram.Record(nowNs - slot.sentNs);
+}
+
+/**
+ * @brief 从最早的序号开始，把超时的探测帧计为丢失，已回显的直接跳过。
+ */
+void LatencyProbe::Expire(int64_t nowNs)
+{
+	while (m_oldestSequence != m_nextSequence)
+	{
+		Outstanding& slot = m_outstanding[m_oldestSequence % kMaxOutstanding];
+		if (slot.active && slot.sequence == m_oldestSequence)
+		{
+			if (nowNs - slot.sentNs < m_timeoutNs)
+			{
+				break;
+			}
+			slot.active = false;
+			++m_lost;
+		}
+		++m_oldestSequence;
+	}
+}
+
+std::string LatencyProbe::Format() const
+{
+	char text[256];
+	std::snprintf(text, sizeof(text),
+		"sent=%llu received=%llu lost=%llu unexpected=%llu rtt us: min=%.1f p50=%.1f p99=%.1f max=%.1f",
+		static_cast<unsigned long long>(m_sent), static_cast<unsigned long long>(Received()),
+		static_cast<unsigned long long>(m_lost), static_cast<unsigned long long>(m_unexpected),
+		m_histogram.Min() / 1e3, m_histogram.Percentile(0.5) / 1e3,
+		m_histogram.Percentile(0.99) / 1e3, m_histogram.Max() / 1e3);
+	return text;
+}
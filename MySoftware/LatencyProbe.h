@@ -0,0 +1,130 @@
+/*
+ * @Description: 主机与设备之间的往返延迟探测，发送带序号的探测帧并在接收数据中匹配回显
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 17:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief RttHistogram 是对数线性分桶的延迟直方图。
+ *
+ * 每个 2 的幂区间再均分为 16 个桶，百分位数的相对误差不超过 1/16，
+ * 占用固定内存，记录一次只是一次数组自增，最小值与最大值精确保存。
+ */
+class RttHistogram
+{
+public:
+	RttHistogram();
+
+	/**
+	 * @brief 记录一个延迟值（纳秒）。
+	 */
+	void Record(int64_t valueNs);
+
+	/**
+	 * @brief 第 q 分位数（0 到 1），没有样本时返回 0。
+	 */
+	int64_t Percentile(double q) const;
+
+	uint64_t Count() const { return m_count; }
+	int64_t Min() const { return m_count ? m_min : 0; }
+	int64_t Max() const { return m_count ? m_max : 0; }
+
+	void Clear();
+
+private:
+	static size_t BucketOf(uint64_t value);
+	static uint64_t BucketLow(size_t bucket);
+
+	std::vector<uint64_t> m_buckets; /**< 各桶计数。 */
+	uint64_t m_count = 0;            /**< 样本数。 */
+	int64_t m_min = 0;               /**< 最小值。 */
+	int64_t m_max = 0;               /**< 最大值。 */
+};
+
+/**
+ * @brief LatencyProbe 生成探测帧并在接收数据中匹配回显，统计往返延迟。
+ *
+ * 探测帧为一行 "~PRB" + 8 位十六进制序号，例如 "~PRB0000002A\n"，
+ * 设备（或回显桩）原样返回即可。接收端用一个小状态机逐字节匹配，
+ * 探测帧可以和正常数据交错出现，也可以被拆分到多个数据块中。
+ * 超过超时时间仍未收到回显的探测帧计为丢失。
+ * 此类不依赖 Qt，时间由调用方以纳秒传入。
+ */
+class LatencyProbe
+{
+public:
+	/**
+	 * @brief 同时等待回显的最大探测帧数量。
+	 */
+	static constexpr size_t kMaxOutstanding = 4096;
+
+	/**
+	 * @brief 构造函数。
+	 * @param timeoutNs 等待回显的超时时间（纳秒）。
+	 */
+	explicit LatencyProbe(int64_t timeoutNs = 2000000000);
+
+	/**
+	 * @brief 生成下一个探测帧，并记录发送时间。
+	 * @param nowNs 发送时间（纳秒）。
+	 * @return 要写到串口的探测帧。
+	 */
+	const std::string& NextPing(int64_t nowNs);
+
+	/**
+	 * @brief 在接收数据中查找探测帧回显。
+	 * @param chunk 接收到的数据块。
+	 * @param nowNs 接收时间（纳秒）。
+	 */
+	void OnReceive(ByteSpan chunk, int64_t nowNs);
+
+	/**
+	 * @brief 把超时未回显的探测帧计为丢失。
+	 * @param nowNs 当前时间（纳秒）。
+	 */
+	void Expire(int64_t nowNs);
+
+	uint64_t Sent() const { return m_sent; }
+	uint64_t Received() const { return m_histogram.Count(); }
+	uint64_t Lost() const { return m_lost; }
+	uint64_t Unexpected() const { return m_unexpected; }
+	const RttHistogram& Histogram() const { return m_histogram; }
+
+	/**
+	 * @brief 格式化统计结果，时间单位为微秒。
+	 */
+	std::string Format() const;
+
+private:
+	/**
+	 * @brief 一个等待回显的探测帧。
+	 */
+	struct Outstanding
+	{
+		uint32_t sequence;  /**< 序号。 */
+		int64_t sentNs;     /**< 发送时间。 */
+		bool active;        /**< 是否仍在等待回显。 */
+	};
+
+	void Match(uint32_t sequence, int64_t nowNs);
+
+	int64_t m_timeoutNs;                   /**< 超时时间。 */
+	uint32_t m_nextSequence = 0;           /**< 下一个序号。 */
+	uint32_t m_oldestSequence = 0;         /**< 最早的可能仍在等待的序号。 */
+	std::vector<Outstanding> m_outstanding; /**< 按序号取模保存的等待列表。 */
+	std::string m_frame;                   /**< 探测帧缓冲，重复使用。 */
+	RttHistogram m_histogram;              /**< 往返延迟直方图。 */
+	uint64_t m_sent = 0;                   /**< 发送的探测帧数。 */
+	uint64_t m_lost = 0;                   /**< 超时的探测帧数。 */
+	uint64_t m_unexpected = 0;             /**< 无法匹配的回显数（重复或已超时）。 */
+
+	size_t m_matchState = 0;               /**< 已匹配的前缀长度，4 以后为序号位数 + 4。 */
+	uint32_t m_matchValue = 0;             /**< 正在解析的序号。 */
+};
@@ -0,0 +1,77 @@
+/*
+ * @Description: 按需创建的子系统容器，重量级模块在第一次使用时才构造
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 09:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <functional>
+#include <memory>
+#include "StartupTrace.h"
+
+/**
+ * @brief LazySubsystem 持有一个延迟构造的子系统对象。
+ *
+ * 构造时只保存工厂函数，第一次调用 Get() 时才真正创建对象，
+ * 并在启动计时中记录一次创建事件。对象由本容器独占持有；
+ * 对于带父对象的 QObject，提前析构会自动从父对象的子列表中移除，不会重复释放。
+ *
+ * @tparam T 子系统类型。
+ */
+template <typename T>
+class LazySubsystem
+{
+public:
+	using Factory = std::function<std::unique_ptr<T>()>;
+
+	/**
+	 * @brief 构造函数。
+	 * @param name 子系统名称，必须是静态字符串，用于启动计时。
+	 * @param factory 创建子系统的工厂函数。
+	 */
+	LazySubsystem(const char* name, Factory factory)
+		: m_name(name), m_factory(std::move(factory))
+	{
+	}
+
+	LazySubsystem(const LazySubsystem&) = delete;
+	LazySubsystem& operator=(const LazySubsystem&) = delete;
+
+	/**
+	 * @brief 获取子系统对象，不存在时立即创建。
+	 * @return 指向子系统对象的指针。
+	 */
+	T* Get()
+	{
+		if (!m_instance)
+		{
+			m_instance = m_factory();
+			StartupTrace::Mark(m_name);
+		}
+		return m_instance.get();
+	}
+
+	T* operator->() { return Get(); }
+
+	/**
+	 * @brief 获取子系统对象，但不触发创建。
+	 * @return 已创建时返回对象指针，否则返回 nullptr。
+	 */
+	T* Peek() const { return m_instance.get(); }
+
+	/**
+	 * @brief 子系统是否已经创建。
+	 */
+	bool IsCreated() const { return m_instance != nullptr; }
+
+	/**
+	 * @brief 释放子系统对象，下一次 Get() 会重新创建。
+	 */
+	void Reset() { m_instance.reset(); }
+
+private:
+	const char* m_name;           /**< 子系统名称。 */
+	Factory m_factory;            /**< 创建子系统的工厂函数。 */
+	std::unique_ptr<T> m_instance; /**< 已创建的子系统对象。 */
+};
@@ -0,0 +1,134 @@
+/*
+ * @Description: 按行切分串口字节流，跨数据块的半行会被暂存到下一次
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 10:05:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief LineFramer 把任意切分的字节块还原为以 '\n' 结尾的行。
+ *
+ * 完整落在当前数据块内的行直接以 std::string_view 的形式指向输入缓冲区，
+ * 不做拷贝；只有跨越数据块边界的半行才会拷贝到内部暂存区。
+ * 行尾的 '\r' 会被去掉。超过 maxLineLength 的行会被丢弃直到下一个换行，
+ * 因此暂存区的大小是有上限的，长时间运行时内存占用不变。
+ */
+class LineFramer
+{
+public:
+	/**
+	 * @brief 构造函数。
+	 * @param maxLineLength 单行允许的最大字节数。
+	 */
+	explicit LineFramer(size_t maxLineLength = 4096)
+		: m_maxLineLength(maxLineLength)
+	{
+		m_carry.reserve(maxLineLength);
+	}
+
+	/**
+	 * @brief 输入一个数据块，对其中每个完整的行调用回调。
+	 * @param data 数据块首地址。
+	 * @param size 数据块字节数。
+	 * @param onLine 行回调，参数为 std::string_view，仅在回调期间有效。
+	 */
+	template <typename OnLine>
+	void Feed(const char* data, size_t size, OnLine&& onLine)
+	{
+		const char* cursor = data;
+		const char* end = data + size;
+		while (cursor < end)
+		{
+			const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+			if (newline == nullptr)
+			{
+				Carry(cursor, end - cursor);
+				return;
+			}
+
+			if (m_discarding)
+			{
+				// 超长行的剩余部分直接丢弃
+				m_discarding = false;
+			}
+			else if (!m_carry.empty())
+			{
+				Carry(cursor, newline - cursor);
+				if (!m_discarding)
+				{
+					onLine(StripCr(std::string_view(m_carry)));
+				}
+				m_discarding = false;
+				m_carry.clear();
+			}
+			else if (static_cast<size_t>(newline - cursor) <= m_maxLineLength)
+			{
+				onLine(StripCr(std::string_view(cursor, newline - cursor)));
+			}
+			else
+			{
+				++m_overflows;
+			}
+			cursor = newline + 1;
+		}
+	}
+
+	/**
+	 * @brief 丢弃暂存的半行，例如在重新打开串口或切换协议时调用。
+	 */
+	void Reset()
+	{
+		m_carry.clear();
+		m_discarding = false;
+	}
+
+	/**
+	 * @brief 是否有尚未结束的半行。
+	 */
+	bool HasPartialLine() const { return !m_carry.empty() || m_discarding; }
+
+	/**
+	 * @brief 因超长而被丢弃的行数。
+	 */
+	size_t Overflows() const { return m_overflows; }
+
+private:
+	/**
+	 * @brief 把半行追加到暂存区，超过上限时转入丢弃状态。
+	 */
+	void Carry(const char* data, size_t size)
+	{
+		if (m_discarding)
+		{
+			return;
+		}
+		if (m_carry.size() + size > m_maxLineLength)
+		{
+			m_carry.clear();
+			m_discarding = true;
+			++m_overflows;
+			return;
+		}
+		m_carry.append(data, size);
+	}
+
+	static std::string_view StripCr(std::string_view line)
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.remove_suffix(1);
+		}
+		return line;
+	}
+
+	std::string m_carry;         /**< 跨数据块的半行暂存区。 */
+	size_t m_maxLineLength;      /**< 单行允许的最大字节数。 */
+	bool m_discarding = false;   /**< 当前是否正在丢弃超长行。 */
+	size_t m_overflows = 0;      /**< 被丢弃的超长行数。 */
+};
@@ -0,0 +1,197 @@
+/*
+ * @Description: 全局内存预算，各模块登记自己的缓冲区，总用量超过上限时按各自的策略释放
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 22:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "MemoryBudget.h"
+#include <algorithm>
+#include <cstdio>
+
+MemoryBudget::Registration& MemoryBudget::Registration::operator=(Registration&& other) noexcept
+{
+	if (this != &other)
+	{
+		Reset();
+		m_id = other.m_id;
+		other.m_id = -1;
+	}
+	return *this;
+}
+
+void MemoryBudget::Registration::Reset()
+{
+	if (m_id >= 0)
+	{
+		MemoryBudget::Instance().Unregister(m_id);
+		m_id = -1;
+	}
+}
+
+MemoryBudget& MemoryBudget::Instance()
+{
+	static MemoryBudget budget;
+	return budget;
+}
+
+MemoryBudget::Registration MemoryBudget::Register(std::string name, Policy policy, UsageFn usage, ReleaseFn release)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const ConsumerId id = m_nextId++;
+	m_consumers.push_back(Consumer{ id, Usage{ std::move(name), policy, 0, 0 }, std::move(usage), std::move(release) });
+	return Registration(id);
+}
+
+void MemoryBudget::Unregister(ConsumerId id)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_consumers.erase(std::remove_if(m_consumers.begin(), m_consumers.end(),
+		[id](const Consumer& consumer) { return consumer.id == id; }), m_consumers.end());
+}
+
+void MemoryBudget::SetPolicy(const std::string& name, Policy policy)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (Consumer& consumer : m_consumers)
+	{
+		if (consumer.usage.name == name && consumer.usage.policy != Policy::Fixed)
+		{
+			consumer.usage.policy = policy;
+		}
+	}
+}
+
+void MemoryBudget::SetLimit(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_limit = bytes;
+}
+
+size_t MemoryBudget::Limit() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_limit;
+}
+
+/**
+ * @brief 统计用量并在超过上限时释放。
+ * 先从用量最大的登记项开始释放，每项最多释放它自己的用量；
+ * 释放后重新测量该项，以实际用量而不是释放函数的返回值计算总量。
+ */
+size_t MemoryBudget::Enforce()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t total = 0;
+	for (Consumer& consumer : m_consumers)
+	{
+		consumer.usage.bytes = consumer.measure();
+		total += consumer.usage.bytes;
+	}
+	m_total = total;
+	if (m_limit == 0 || total <= m_limit)
+	{
+		return 0;
+	}
+
+	const size_t target = m_limit / 10 * 9;
+	std::vector<Consumer*> order;
+	for (Consumer& consumer : m_consumers)
+	{
+		if (consumer.usage.policy != Policy::Fixed && consumer.release && consumer.usage.bytes > 0)
+		{
+			order.push_back(&consumer);
+		}
+	}
+	std::sort(order.begin(), order.end(),
+		[](const Consumer* a, const Consumer* b) { return a->usage.bytes > b->usage.bytes; });
+
+	size_t released = 0;
+	for (Consumer* consumer : order)
+	{
+		if (total <= target)
+		{
+			break;
+		}
+		const size_t before = consumer->usage.bytes;
+		consumer->release(std::min(total - target, before), consumer->usage.policy);
+		const size_t after = consumer->measure();
+		consumer->usage.bytes = after;
+		if (after < before)
+		{
+			consumer->usage.releasedBytes += before - after;
+			released += before - after;
+			total -= before - after;
+		}
+	}
+	m_total = total;
+	m_released += released;
+	return released;
+}
+
+size_t MemoryBudget::TotalBytes() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_total;
+}
+
+std::vector<MemoryBudget::Usage> MemoryBudget::Snapshot() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<Usage> usages;
+	usages.reserve(m_consumers.size());
+	for (const Consumer& consumer : m_consumers)
+	{
+		usages.push_back(consumer.usage);
+	}
+	return usages;
+}
+
+std::string MemoryBudget::Format() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	char text[96];
+	if (m_limit > 0)
+	{
+		std::snprintf(text, sizeof(text), "mem %.1f/%.1f MB", m_total / 1048576.0, m_limit / 1048576.0);
+	}
+	else
+	{
+		std::snprintf(text, sizeof(text), "mem %.1f MB", m_total / 1048576.0);
+	}
+	std::string line = text;
+	const char* separator = " (";
+	for (const Consumer& consumer : m_consumers)
+	{
+		if (consumer.usage.bytes == 0)
+		{
+			continue;
+		}
+		std::snprintf(text, sizeof(text), "%s%s %.1f", separator, consumer.usage.name.c_str(),
+			consumer.usage.bytes / 1048576.0);
+		line += text;
+		separator = ", ";
+	}
+	if (separator[0] == ',')
+	{
+		line += ")";
+	}
+	if (m_released > 0)
+	{
+		std::snprintf(text, sizeof(text), " released %.1f MB", m_released / 1048576.0);
+		line += text;
+	}
+	return line;
+}
+
+const char* MemoryBudget::PolicyName(Policy policy)
+{
+	switch (policy)
+	{
+	case Policy::Fixed: return "fixed";
+	case Policy::DropOldest: return "drop-oldest";
+	case Policy::SpillToDisk: return "spill";
+	case Policy::DropNewest: return "drop-newest";
+	}
+	return "?";
+}
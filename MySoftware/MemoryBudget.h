@@ -0,0 +1,152 @@
+/*
+ * @Description: 全局内存预算，各模块登记自己的缓冲区，总用量超过上限时按各自的策略释放
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 22:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief MemoryBudget 是进程内唯一的内存预算。
+ *
+ * 每个会随运行时间增长的缓冲区登记一个用量函数和一个释放函数，
+ * 固定大小的缓冲区（飞行记录仪、分发桥环形缓冲区）只登记用量，计入总量但不会被要求释放。
+ * Enforce 由拥有这些缓冲区的线程（界面线程或命令行主线程）定期调用：
+ * 总用量超过上限时按用量从大到小依次要求释放，直到回到上限的 90% 以下，
+ * 留出的余量避免每次检查都刚好越线、频繁地小块释放。
+ * 登记的回调在 Enforce 中持锁调用，回调中不能再登记或注销。
+ */
+class MemoryBudget
+{
+public:
+	/**
+	 * @brief 超过上限时的处理策略。
+	 */
+	enum class Policy
+	{
+		Fixed,       /**< 固定大小，只计入用量。 */
+		DropOldest,  /**< 丢弃最旧的数据。 */
+		SpillToDisk, /**< 把最旧的数据写到文件后再丢弃，文件位置由登记方决定。 */
+		DropNewest   /**< 暂停接收新数据，直到积压的数据被处理完。 */
+	};
+
+	using ConsumerId = int;
+	using UsageFn = std::function<size_t()>;
+	/**
+	 * @brief 释放函数：参数为希望释放的字节数和策略，返回实际释放的字节数。
+	 */
+	using ReleaseFn = std::function<size_t(size_t bytes, Policy policy)>;
+
+	/**
+	 * @brief 登记项的 RAII 句柄，析构时注销。
+	 */
+	class Registration
+	{
+	public:
+		Registration() = default;
+		explicit Registration(ConsumerId id) : m_id(id) {}
+		~Registration() { Reset(); }
+		Registration(Registration&& other) noexcept : m_id(other.m_id) { other.m_id = -1; }
+		Registration& operator=(Registration&& other) noexcept;
+		Registration(const Registration&) = delete;
+		Registration& operator=(const Registration&) = delete;
+
+		/**
+		 * @brief 注销登记项。
+		 */
+		void Reset();
+
+	private:
+		ConsumerId m_id = -1; /**< 登记项编号，-1 表示未登记。 */
+	};
+
+	/**
+	 * @brief 一个登记项的用量，供状态栏和统计输出使用。
+	 */
+	struct Usage
+	{
+		std::string name;       /**< 名称。 */
+		Policy policy;          /**< 策略。 */
+		size_t bytes;           /**< 最近一次检查时的用量。 */
+		size_t releasedBytes;   /**< 累计释放的字节数。 */
+	};
+
+	/**
+	 * @brief 获取全局实例。
+	 */
+	static MemoryBudget& Instance();
+
+	/**
+	 * @brief 登记一个缓冲区。
+	 * @param name 名称，用于状态显示。
+	 * @param policy 超过上限时的策略。
+	 * @param usage 用量函数，返回当前占用的字节数。
+	 * @param release 释放函数，策略为 Fixed 时可为空。
+	 * @return 登记项句柄。
+	 */
+	Registration Register(std::string name, Policy policy, UsageFn usage, ReleaseFn release = nullptr);
+
+	/**
+	 * @brief 修改登记项的策略，例如界面上在丢弃与溢出之间切换。
+	 */
+	void SetPolicy(const std::string& name, Policy policy);
+
+	/**
+	 * @brief 设置总用量上限。
+	 * @param bytes 上限（字节），0 表示不限制，只统计用量。
+	 */
+	void SetLimit(size_t bytes);
+	size_t Limit() const;
+
+	/**
+	 * @brief 统计所有登记项的用量，超过上限时要求释放。
+	 * @return 本次释放的字节数。
+	 */
+	size_t Enforce();
+
+	/**
+	 * @brief 最近一次 Enforce 统计的总用量。
+	 */
+	size_t TotalBytes() const;
+
+	/**
+	 * @brief 最近一次 Enforce 时各登记项的用量。
+	 */
+	std::vector<Usage> Snapshot() const;
+
+	/**
+	 * @brief 格式化为一行文本，例如 "mem 312.5/1024.0 MB (history 280.1, console 2.3) released 96.0 MB"。
+	 */
+	std::string Format() const;
+
+	/**
+	 * @brief 策略名称：fixed、drop-oldest、spill 或 drop-newest。
+	 */
+	static const char* PolicyName(Policy policy);
+
+private:
+	MemoryBudget() = default;
+
+	void Unregister(ConsumerId id);
+
+	struct Consumer
+	{
+		ConsumerId id;
+		Usage usage;
+		UsageFn measure;
+		ReleaseFn release;
+	};
+
+	mutable std::mutex m_mutex;        /**< 保护以下成员。 */
+	std::vector<Consumer> m_consumers; /**< 登记项。 */
+	ConsumerId m_nextId = 0;           /**< 下一个登记项编号。 */
+	size_t m_limit = 0;                /**< 总用量上限，0 表示不限制。 */
+	size_t m_total = 0;                /**< 最近一次统计的总用量。 */
+	size_t m_released = 0;             /**< 累计释放的字节数。 */
+};
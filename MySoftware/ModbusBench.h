@@ -0,0 +1,58 @@
+/*
+ * @Description: Modbus 轮询基准测试，在伪终端从站模拟器上比较逐点请求与合并请求每秒读到的寄存器数
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:55:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include "SerialInfo.h"
+
+/**
+ * @brief 一次 Modbus 轮询测试的结果。
+ */
+struct ModbusBenchResult
+{
+	bool merge = false;          /**< 是否合并请求。 */
+	int baudRate = 0;            /**< 模拟的波特率。 */
+	size_t points = 0;           /**< 轮询点数。 */
+	size_t blocks = 0;           /**< 请求块数。 */
+	uint64_t records = 0;        /**< 主站输出的记录数。 */
+	double seconds = 0.0;        /**< 测试时长（秒）。 */
+	std::string master;          /**< 主站统计，格式见 ModbusMaster::Format。 */
+	std::string slave;           /**< 模拟器统计，格式见 ModbusSlaveSim::Format。 */
+};
+
+/**
+ * @brief ModbusBench 用 ModbusSlaveSim 代替设备，让 SerialInfo、ModbusMaster 和 ModbusPoller 按实际采集的路径轮询，
+ * 同一份配置分别以逐点请求和合并请求运行相同时间，比较每秒请求数、读到的值、线路占用率和迟到的轮询。
+ * 模拟器按设定的波特率延迟响应，结果反映的是线路而不是伪终端的速度。
+ */
+class ModbusBench
+{
+public:
+	/**
+	 * @brief 默认的测试配置：三个从站上快慢不一、地址相邻或有间隙的一百多个点。
+	 */
+	static std::string DefaultSpec();
+
+	/**
+	 * @brief 运行一次测试。
+	 * @param spec 轮询配置，格式见 ModbusConfig。
+	 * @param merge 是否合并请求。
+	 * @param baudRate 模拟的波特率。
+	 * @param seconds 测试时长（秒）。
+	 * @param backend 串口后端。
+	 * @return 测试结果。
+	 * @throw std::invalid_argument 如果配置格式错误或波特率不受支持。
+	 * @throw std::runtime_error 如果创建伪终端或打开串口失败。
+	 */
+	static ModbusBenchResult Run(const std::string& spec, bool merge, int baudRate, int seconds, SerialInfo::Backend backend);
+
+	/**
+	 * @brief 把结果格式化为一行文本。
+	 */
+	static std::string Format(const ModbusBenchResult& result);
+};
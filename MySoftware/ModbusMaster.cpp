@@ -0,0 +1,755 @@
+/*
+ * @Description: Modbus RTU 主站：轮询点配置、合并相邻寄存器的请求计划、按波特率计算帧间隔的轮询调度和响应解析
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "ModbusMaster.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+	constexpr int64_t kNsPerMs = 1000000;
+	constexpr int64_t kNever = std::numeric_limits<int64_t>::max();
+
+	const char* const kTableNames[] = { "coil", "di", "hr", "ir" };
+	const char* const kTypeNames[] = { "bit", "u16", "i16", "u32", "i32", "f32" };
+
+	std::string Trim(const std::string& text)
+	{
+		const size_t begin = text.find_first_not_of(" \t\r");
+		if (begin == std::string::npos)
+		{
+			return std::string();
+		}
+		const size_t end = text.find_last_not_of(" \t\r");
+		return text.substr(begin, end - begin + 1);
+	}
+
+	std::vector<std::string> Split(const std::string& text, const char* separators, bool keepEmpty = false)
+	{
+		std::vector<std::string> parts;
+		size_t begin = 0;
+		while (begin <= text.size())
+		{
+			const size_t end = text.find_first_of(separators, begin);
+			const std::string part = Trim(text.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+			if (keepEmpty || !part.empty())
+			{
+				parts.push_back(part);
+			}
+			if (end == std::string::npos)
+			{
+				break;
+			}
+			begin = end + 1;
+		}
+		return parts;
+	}
+
+	unsigned long ParseUnsigned(const std::string& text, unsigned long max, const std::string& entry)
+	{
+		char* end = nullptr;
+		const unsigned long value = std::strtoul(text.c_str(), &end, 0);
+		if (text.empty() || end == nullptr || *end != '\0' || value > max)
+		{
+			throw std::invalid_argument("Invalid number '" + text + "' in Modbus entry '" + entry + "'.");
+		}
+		return value;
+	}
+
+	/**
+	 * @brief 解析时长，单位为 us、ms 或 s，没有单位时按毫秒。
+	 */
+	int64_t ParseDuration(const std::string& text, const std::string& entry)
+	{
+		double scale = 1e6;
+		std::string number = text;
+		if (text.size() > 2 && text.compare(text.size() - 2, 2, "us") == 0)
+		{
+			scale = 1e3;
+			number = text.substr(0, text.size() - 2);
+		}
+		else if (text.size() > 2 && text.compare(text.size() - 2, 2, "ms") == 0)
+		{
+			number = text.substr(0, text.size() - 2);
+		}
+		else if (text.size() > 1 && text.back() == 's')
+		{
+			scale = 1e9;
+			number = text.substr(0, text.size() - 1);
+		}
+		char* end = nullptr;
+		const double value = std::strtod(number.c_str(), &end);
+		if (number.empty() || end == nullptr || *end != '\0' || !std::isfinite(value) || value < 0)
+		{
+			throw std::invalid_argument("Invalid period '" + text + "' in Modbus entry '" + entry + "'.");
+		}
+		return static_cast<int64_t>(value * scale);
+	}
+
+	std::string FormatDuration(int64_t ns)
+	{
+		char text[32];
+		if (ns >= 1000000000 && ns % 1000000000 == 0)
+		{
+			std::snprintf(text, sizeof(text), "%llds", static_cast<long long>(ns / 1000000000));
+		}
+		else if (ns % 1000000 == 0)
+		{
+			std::snprintf(text, sizeof(text), "%lldms", static_cast<long long>(ns / 1000000));
+		}
+		else
+		{
+			std::snprintf(text, sizeof(text), "%lldus", static_cast<long long>(ns / 1000));
+		}
+		return text;
+	}
+
+	bool IsBitTable(ModbusTable table)
+	{
+		return table == ModbusTable::Coil || table == ModbusTable::DiscreteInput;
+	}
+
+	uint8_t FunctionCode(ModbusTable table)
+	{
+		return static_cast<uint8_t>(static_cast<int>(table) + 1);
+	}
+
+	/**
+	 * @brief 正常响应中数据部分的字节数。
+	 */
+	uint32_t DataBytes(ModbusTable table, uint32_t count)
+	{
+		return IsBitTable(table) ? (count + 7) / 8 : count * 2;
+	}
+
+	std::array<uint16_t, 256> MakeCrcTable()
+	{
+		std::array<uint16_t, 256> table{};
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			uint16_t crc = static_cast<uint16_t>(i);
+			for (int bit = 0; bit < 8; ++bit)
+			{
+				crc = static_cast<uint16_t>(crc & 1 ? (crc >> 1) ^ 0xA001 : crc >> 1);
+			}
+			table[i] = crc;
+		}
+		return table;
+	}
+}
+
+uint16_t ModbusPoint::Width() const
+{
+	return type == ModbusType::U32 || type == ModbusType::I32 || type == ModbusType::F32 ? 2 : 1;
+}
+
+ModbusConfig ModbusConfig::Parse(const std::string& spec)
+{
+	ModbusConfig config;
+	for (const std::string& entry : Split(spec, ";\n"))
+	{
+		std::string text = entry;
+		std::string name;
+		const size_t equals = text.find('=');
+		if (equals != std::string::npos)
+		{
+			name = Trim(text.substr(0, equals));
+			text = text.substr(equals + 1);
+		}
+
+		ModbusPoint point;
+		const size_t at = text.find('@');
+		if (at != std::string::npos)
+		{
+			const std::string period = Trim(text.substr(at + 1));
+			text = text.substr(0, at);
+			const size_t dots = period.find("..");
+			if (period == "auto")
+			{
+				point.periodNs = 10 * kNsPerMs;
+				point.maxPeriodNs = 1000 * kNsPerMs;
+			}
+			else if (dots != std::string::npos)
+			{
+				point.periodNs = ParseDuration(period.substr(0, dots), entry);
+				point.maxPeriodNs = ParseDuration(period.substr(dots + 2), entry);
+				if (point.maxPeriodNs <= point.periodNs)
+				{
+					throw std::invalid_argument("Adaptive period needs min < max in Modbus entry '" + entry + "'.");
+				}
+			}
+			else
+			{
+				point.periodNs = ParseDuration(period, entry);
+			}
+		}
+		const size_t star = text.find('*');
+		if (star != std::string::npos)
+		{
+			const std::string scale = Trim(text.substr(star + 1));
+			text = text.substr(0, star);
+			char* end = nullptr;
+			point.scale = std::strtod(scale.c_str(), &end);
+			if (scale.empty() || end == nullptr || *end != '\0' || !std::isfinite(point.scale))
+			{
+				throw std::invalid_argument("Invalid scale '" + scale + "' in Modbus entry '" + entry + "'.");
+			}
+		}
+
+		const std::vector<std::string> fields = Split(text, ":", true);
+		if (fields.size() < 3 || fields.size() > 4)
+		{
+			throw std::invalid_argument("Modbus entry '" + entry + "' should be [name=]slave:table:address[-end][:type][*scale][@period].");
+		}
+		point.slave = static_cast<uint8_t>(ParseUnsigned(fields[0], 247, entry));
+		if (point.slave == 0)
+		{
+			throw std::invalid_argument("Broadcast address 0 cannot be polled in Modbus entry '" + entry + "'.");
+		}
+		const auto table = std::find(std::begin(kTableNames), std::end(kTableNames), fields[1]);
+		if (table == std::end(kTableNames))
+		{
+			throw std::invalid_argument("Unknown table '" + fields[1] + "' (coil, di, hr, ir) in Modbus entry '" + entry + "'.");
+		}
+		point.table = static_cast<ModbusTable>(table - std::begin(kTableNames));
+		point.type = IsBitTable(point.table) ? ModbusType::Bit : ModbusType::U16;
+		if (fields.size() == 4)
+		{
+			const auto type = std::find(std::begin(kTypeNames), std::end(kTypeNames), fields[3]);
+			if (type == std::end(kTypeNames))
+			{
+				throw std::invalid_argument("Unknown type '" + fields[3] + "' in Modbus entry '" + entry + "'.");
+			}
+			point.type = static_cast<ModbusType>(type - std::begin(kTypeNames));
+			if (IsBitTable(point.table) != (point.type == ModbusType::Bit))
+			{
+				throw std::invalid_argument("Type '" + fields[3] + "' does not match table '" + fields[1] + "' in Modbus entry '" + entry + "'.");
+			}
+		}
+
+		const size_t dash = fields[2].find('-');
+		const unsigned long first = ParseUnsigned(Trim(fields[2].substr(0, dash)), 65535, entry);
+		const unsigned long last = dash == std::string::npos ? first + point.Width() - 1
+			: ParseUnsigned(Trim(fields[2].substr(dash + 1)), 65535, entry);
+		if (last < first || last > 65535 || (last - first + 1) % point.Width() != 0)
+		{
+			throw std::invalid_argument("Address range '" + fields[2] + "' does not fit the type in Modbus entry '" + entry + "'.");
+		}
+
+		const bool single = last - first + 1 == point.Width();
+		for (unsigned long address = first; address <= last; address += point.Width())
+		{
+			point.address = static_cast<uint16_t>(address);
+			if (name.empty())
+			{
+				point.name = "mb" + std::to_string(point.slave) + "." + kTableNames[static_cast<int>(point.table)] + std::to_string(address);
+			}
+			else
+			{
+				point.name = single ? name : name + "." + std::to_string(address);
+			}
+			config.m_points.push_back(point);
+		}
+	}
+	return config;
+}
+
+std::string ModbusConfig::Describe() const
+{
+	std::string text;
+	for (const ModbusPoint& point : m_points)
+	{
+		if (!text.empty())
+		{
+			text += ";";
+		}
+		text += point.name + "=" + std::to_string(point.slave) + ":" + kTableNames[static_cast<int>(point.table)] + ":"
+			+ std::to_string(point.address);
+		if (point.type != ModbusType::Bit && point.type != ModbusType::U16)
+		{
+			text += std::string(":") + kTypeNames[static_cast<int>(point.type)];
+		}
+		if (point.scale != 1.0)
+		{
+			char scale[32];
+			std::snprintf(scale, sizeof(scale), "*%g", point.scale);
+			text += scale;
+		}
+		text += "@" + FormatDuration(point.periodNs);
+		if (point.maxPeriodNs > 0)
+		{
+			text += ".." + FormatDuration(point.maxPeriodNs);
+		}
+	}
+	return text;
+}
+
+ModbusMaster::ModbusMaster(ModbusConfig config, bool merge)
+	: m_config(std::move(config))
+{
+	Plan(merge);
+	m_request.reserve(8);
+	m_rx.reserve(5 + kMaxRegisters * 2);
+}
+
+uint16_t ModbusMaster::Crc16(const char* data, size_t length)
+{
+	static const std::array<uint16_t, 256> table = MakeCrcTable();
+	uint16_t crc = 0xFFFF;
+	for (size_t i = 0; i < length; ++i)
+	{
+		crc = static_cast<uint16_t>((crc >> 8) ^ table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF]);
+	}
+	return crc;
+}
+
+/**
+ * @brief 一次读请求在线路上占用的字符数：请求 8 字节、响应头和 CRC 5 字节、数据，以及前后各 3.5 个字符的静默。
+ */
+double ModbusMaster::RequestChars(ModbusTable table, uint32_t count)
+{
+	return 8.0 + 5.0 + DataBytes(table, count) + 7.0;
+}
+
+/**
+ * @brief 波特率高于 19200 时帧间静默固定为 1.75 ms，否则为 3.5 个字符时间（Modbus over serial line 2.5.1.1）。
+ */
+void ModbusMaster::SetLineTiming(int baudRate, double bitsPerChar)
+{
+	if (baudRate <= 0 || bitsPerChar <= 0)
+	{
+		return;
+	}
+	m_charNs = static_cast<int64_t>(bitsPerChar * 1e9 / baudRate);
+	m_silenceNs = baudRate > 19200 ? 1750000 : m_charNs * 7 / 2;
+}
+
+void ModbusMaster::Plan(bool merge)
+{
+	std::vector<size_t> order(m_config.Points().size());
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	const std::vector<ModbusPoint>& points = m_config.Points();
+	std::stable_sort(order.begin(), order.end(), [&points](size_t a, size_t b) {
+		if (points[a].slave != points[b].slave)
+		{
+			return points[a].slave < points[b].slave;
+		}
+		if (points[a].table != points[b].table)
+		{
+			return points[a].table < points[b].table;
+		}
+		return points[a].address < points[b].address;
+		});
+
+	size_t begin = 0;
+	while (begin < order.size())
+	{
+		size_t end = begin + 1;
+		while (end < order.size() && points[order[end]].slave == points[order[begin]].slave
+			&& points[order[end]].table == points[order[begin]].table)
+		{
+			++end;
+		}
+		std::vector<Block> blocks = PlanGroup(std::vector<size_t>(order.begin() + begin, order.begin() + end), merge);
+		for (Block& block : blocks)
+		{
+			m_blocks.push_back(std::move(block));
+		}
+		begin = end;
+	}
+}
+
+/**
+ * @brief 规划同一从站、同一数据区中按地址排好序的点。
+ * 每个块以其中最快的点的频率轮询，代价为频率乘以每次请求的字符数；
+ * 把下一个点并入当前块的代价不超过两者分开请求的代价之和时合并，否则开始新块。
+ * 周期为 0 的点按 1 kHz 计算代价，只用于比较。
+ */
+std::vector<ModbusMaster::Block> ModbusMaster::PlanGroup(const std::vector<size_t>& points, bool merge) const
+{
+	const std::vector<ModbusPoint>& all = m_config.Points();
+	auto rate = [&all](size_t point) { return 1e9 / std::max<int64_t>(all[point].periodNs, kNsPerMs); };
+	const ModbusTable table = all[points.front()].table;
+	const uint32_t limit = IsBitTable(table) ? kMaxBits : kMaxRegisters;
+
+	std::vector<Block> blocks;
+	uint32_t start = 0;
+	uint32_t end = 0;
+	double blockRate = 0.0;
+	std::vector<size_t> members;
+	auto flush = [&]() {
+		if (members.empty())
+		{
+			return;
+		}
+		Block block;
+		block.slave = all[members.front()].slave;
+		block.table = table;
+		block.start = static_cast<uint16_t>(start);
+		block.count = static_cast<uint16_t>(end - start);
+		block.points = std::move(members);
+		InitBlock(block);
+		blocks.push_back(std::move(block));
+		members.clear();
+		};
+
+	for (const size_t point : points)
+	{
+		const uint32_t pointStart = all[point].address;
+		const uint32_t pointEnd = pointStart + all[point].Width();
+		if (!members.empty() && merge)
+		{
+			const uint32_t mergedEnd = std::max(end, pointEnd);
+			const double mergedRate = std::max(blockRate, rate(point));
+			const double separate = blockRate * RequestChars(table, end - start) + rate(point) * RequestChars(table, pointEnd - pointStart);
+			const double merged = mergedRate * RequestChars(table, mergedEnd - start);
+			if (mergedEnd - start <= limit && merged <= separate)
+			{
+				end = mergedEnd;
+				blockRate = mergedRate;
+				members.push_back(point);
+				continue;
+			}
+		}
+		flush();
+		start = pointStart;
+		end = pointEnd;
+		blockRate = rate(point);
+		members.push_back(point);
+	}
+	flush();
+	return blocks;
+}
+
+/**
+ * @brief 计算块的周期：固定周期取成员中最短的；有自适应成员时在其范围内调整，但不长于固定成员的周期。
+ */
+void ModbusMaster::InitBlock(Block& block) const
+{
+	int64_t fixed = kNever;
+	int64_t adaptiveMin = kNever;
+	int64_t adaptiveMax = kNever;
+	for (const size_t index : block.points)
+	{
+		const ModbusPoint& point = m_config.Points()[index];
+		if (point.maxPeriodNs > 0)
+		{
+			adaptiveMin = std::min(adaptiveMin, point.periodNs);
+			adaptiveMax = std::min(adaptiveMax, point.maxPeriodNs);
+		}
+		else
+		{
+			fixed = std::min(fixed, point.periodNs);
+		}
+	}
+	if (adaptiveMin == kNever)
+	{
+		block.minPeriodNs = block.maxPeriodNs = fixed;
+	}
+	else
+	{
+		block.minPeriodNs = std::min(adaptiveMin, fixed);
+		block.maxPeriodNs = std::max(block.minPeriodNs, std::min(adaptiveMax, fixed));
+	}
+	block.periodNs = block.minPeriodNs;
+	block.dueNs = 0;
+}
+
+/**
+ * @brief 合并后的块被从站以非法地址拒绝时（间隙中有未实现的寄存器），拆成每个点一个块。
+ */
+void ModbusMaster::SplitBlock(size_t index)
+{
+	const std::vector<size_t> points = std::move(m_blocks[index].points);
+	m_blocks.erase(m_blocks.begin() + static_cast<std::ptrdiff_t>(index));
+	for (const size_t point : points)
+	{
+		for (Block& block : PlanGroup({ point }, false))
+		{
+			m_blocks.push_back(std::move(block));
+		}
+	}
+}
+
+void ModbusMaster::Reset()
+{
+	m_waiting = false;
+	m_rx.clear();
+}
+
+/**
+ * @brief 推进调度。
+ * 等待响应时只检查超时；空闲时先保证帧间静默，再从到期的块中选出优先级最高的一个发出请求。
+ * 优先级为 (过期时间 + 周期) / 周期 × (1 + 变化比例)，周期为 0 的块以一次请求的传输时间代替周期。
+ */
+int64_t ModbusMaster::Poll(int64_t nowNs, std::string& out)
+{
+	if (m_waiting)
+	{
+		if (nowNs < m_deadlineNs)
+		{
+			return m_deadlineNs;
+		}
+		++m_timeouts;
+		Complete(nowNs);
+	}
+	if (m_blocks.empty())
+	{
+		return kNever;
+	}
+	if (nowNs < m_quietUntilNs)
+	{
+		return m_quietUntilNs;
+	}
+
+	size_t best = m_blocks.size();
+	double bestScore = 0.0;
+	int64_t nextDue = kNever;
+	for (size_t i = 0; i < m_blocks.size(); ++i)
+	{
+		const Block& block = m_blocks[i];
+		if (block.dueNs > nowNs)
+		{
+			nextDue = std::min(nextDue, block.dueNs);
+			continue;
+		}
+		const double period = std::max<double>(static_cast<double>(block.periodNs),
+			RequestChars(block.table, block.count) * static_cast<double>(m_charNs));
+		const double score = (static_cast<double>(nowNs - block.dueNs) + period) / period * (1.0 + block.changeScore);
+		if (best == m_blocks.size() || score > bestScore)
+		{
+			best = i;
+			bestScore = score;
+		}
+	}
+	if (best == m_blocks.size())
+	{
+		return nextDue;
+	}
+
+	Block& block = m_blocks[best];
+	if (block.periodNs > 0 && block.dueNs > 0 && nowNs - block.dueNs > block.periodNs)
+	{
+		++m_late;
+	}
+	block.dueNs = std::max(block.dueNs + block.periodNs, nowNs);
+	++block.polls;
+
+	const uint8_t function = FunctionCode(block.table);
+	m_request.clear();
+	m_request.push_back(static_cast<char>(block.slave));
+	m_request.push_back(static_cast<char>(function));
+	m_request.push_back(static_cast<char>(block.start >> 8));
+	m_request.push_back(static_cast<char>(block.start & 0xFF));
+	m_request.push_back(static_cast<char>(block.count >> 8));
+	m_request.push_back(static_cast<char>(block.count & 0xFF));
+	const uint16_t crc = Crc16(m_request.data(), m_request.size());
+	m_request.push_back(static_cast<char>(crc & 0xFF));
+	m_request.push_back(static_cast<char>(crc >> 8));
+	out.append(m_request);
+
+	m_expected = 3 + DataBytes(block.table, block.count) + 2;
+	m_waiting = true;
+	m_current = best;
+	m_sentNs = nowNs;
+	m_deadlineNs = nowNs + static_cast<int64_t>(m_request.size() + m_expected) * m_charNs + m_timeoutNs;
+	m_rx.clear();
+	++m_requests;
+	m_lineChars += m_request.size();
+	if (m_firstNs < 0)
+	{
+		m_firstNs = nowNs;
+	}
+	m_lastNs = nowNs;
+	return m_deadlineNs;
+}
+
+void ModbusMaster::Feed(ByteSpan chunk, RecordSink& sink)
+{
+	OnReceive(chunk, TraceRecorder::NowNs(), sink);
+}
+
+/**
+ * @brief 收齐一个响应：第二个字节带 0x80 时为 5 字节的异常响应，否则为请求时计算出的长度。
+ * 没有请求时收到的数据说明线路上还有其他数据（例如超时后才到的响应），丢弃并重新计算静默时间。
+ */
+void ModbusMaster::OnReceive(ByteSpan chunk, int64_t nowNs, RecordSink& sink)
+{
+	m_lastNs = nowNs;
+	if (!m_waiting)
+	{
+		m_unexpected += chunk.size();
+		m_quietUntilNs = std::max(m_quietUntilNs, nowNs + m_silenceNs);
+		return;
+	}
+	m_rx.append(chunk.data(), chunk.size());
+	if (m_rx.size() < 2)
+	{
+		return;
+	}
+	const size_t length = static_cast<uint8_t>(m_rx[1]) & 0x80 ? 5 : m_expected;
+	if (m_rx.size() < length)
+	{
+		return;
+	}
+	m_unexpected += m_rx.size() - length;
+	HandleResponse(m_rx.data(), length, nowNs, sink);
+}
+
+void ModbusMaster::HandleResponse(const char* frame, size_t length, int64_t nowNs, RecordSink& sink)
+{
+	Block& block = m_blocks[m_current];
+	m_lineChars += length;
+	const uint16_t crc = Crc16(frame, length - 2);
+	const uint8_t function = FunctionCode(block.table);
+	if (static_cast<uint8_t>(frame[length - 2]) != (crc & 0xFF) || static_cast<uint8_t>(frame[length - 1]) != (crc >> 8)
+		|| static_cast<uint8_t>(frame[0]) != block.slave || (static_cast<uint8_t>(frame[1]) & 0x7F) != function)
+	{
+		++m_crcErrors;
+		++m_errorCount;
+		Complete(nowNs);
+		return;
+	}
+	if (static_cast<uint8_t>(frame[1]) & 0x80)
+	{
+		++m_exceptions;
+		const uint8_t code = static_cast<uint8_t>(frame[2]);
+		const bool split = (code == 2 || code == 3) && block.points.size() > 1;
+		Complete(nowNs);
+		if (split)
+		{
+			SplitBlock(m_current);
+		}
+		return;
+	}
+	const uint32_t bytes = DataBytes(block.table, block.count);
+	if (static_cast<uint8_t>(frame[2]) != bytes)
+	{
+		++m_crcErrors;
+		++m_errorCount;
+		Complete(nowNs);
+		return;
+	}
+
+	// 数值变化的块提高优先级；自适应周期变化时减半，不变时放长一半，从本次请求的发送时间起算
+	const char* data = frame + 3;
+	const bool changed = block.last.size() != bytes || std::memcmp(block.last.data(), data, bytes) != 0;
+	block.last.assign(data, bytes);
+	block.changeScore = block.changeScore * 0.8 + (changed ? 0.2 : 0.0);
+	if (block.maxPeriodNs > block.minPeriodNs)
+	{
+		block.periodNs = changed ? std::max(block.minPeriodNs, block.periodNs / 2)
+			: std::min(block.maxPeriodNs, block.periodNs + block.periodNs / 2);
+		block.dueNs = m_sentNs + block.periodNs;
+	}
+
+	m_keys.clear();
+	m_values.clear();
+	for (const size_t index : block.points)
+	{
+		const ModbusPoint& point = m_config.Points()[index];
+		const uint32_t offset = point.address - block.start;
+		auto word = [data](uint32_t i) {
+			return static_cast<uint16_t>(static_cast<uint8_t>(data[2 * i]) << 8 | static_cast<uint8_t>(data[2 * i + 1]));
+			};
+		double value = 0.0;
+		switch (point.type)
+		{
+		case ModbusType::Bit:
+			value = (static_cast<uint8_t>(data[offset / 8]) >> (offset % 8)) & 1;
+			break;
+		case ModbusType::U16:
+			value = word(offset);
+			break;
+		case ModbusType::I16:
+			value = static_cast<int16_t>(word(offset));
+			break;
+		case ModbusType::U32:
+			value = static_cast<uint32_t>(word(offset)) << 16 | word(offset + 1);
+			break;
+		case ModbusType::I32:
+			value = static_cast<int32_t>(static_cast<uint32_t>(word(offset)) << 16 | word(offset + 1));
+			break;
+		case ModbusType::F32:
+		{
+			const uint32_t bits = static_cast<uint32_t>(word(offset)) << 16 | word(offset + 1);
+			float real;
+			std::memcpy(&real, &bits, sizeof(real));
+			value = real;
+			break;
+		}
+		}
+		m_keys.emplace_back(point.name);
+		m_values.push_back(value * point.scale);
+	}
+	++m_responses;
+	m_valuesRead += m_values.size();
+	++m_recordCount;
+
+	DecodedRecord record;
+	record.kind = RecordKind::KeyValue;
+	record.raw = ByteSpan(frame, length);
+	record.keys = m_keys.data();
+	record.values = m_values.data();
+	record.count = m_values.size();
+	sink.OnRecord(record);
+	Complete(nowNs);
+}
+
+/**
+ * @brief 结束当前请求：响应或超时之后线路至少静默 3.5 个字符时间才能发出下一个请求。
+ */
+void ModbusMaster::Complete(int64_t nowNs)
+{
+	m_waiting = false;
+	m_rx.clear();
+	m_quietUntilNs = nowNs + m_silenceNs;
+	m_lastNs = nowNs;
+}
+
+std::string ModbusMaster::DescribePlan() const
+{
+	std::string text;
+	char line[160];
+	for (const Block& block : m_blocks)
+	{
+		const bool bits = IsBitTable(block.table);
+		std::snprintf(line, sizeof(line), "slave %u %s %u-%u: %u %s, %zu points, period %s",
+			block.slave, kTableNames[static_cast<int>(block.table)], block.start, block.start + block.count - 1,
+			block.count, bits ? "bits" : "registers", block.points.size(), FormatDuration(block.minPeriodNs).c_str());
+		text += line;
+		if (block.maxPeriodNs > block.minPeriodNs)
+		{
+			text += ".." + FormatDuration(block.maxPeriodNs);
+		}
+		text += "\n";
+	}
+	return text;
+}
+
+std::string ModbusMaster::Format() const
+{
+	const double seconds = m_firstNs >= 0 && m_lastNs > m_firstNs ? (m_lastNs - m_firstNs) / 1e9 : 0.0;
+	char text[256];
+	std::snprintf(text, sizeof(text),
+		"modbus blocks=%zu requests=%llu responses=%llu timeouts=%llu crc=%llu exceptions=%llu late=%llu values=%llu (%.0f/s) line=%.1f%%",
+		m_blocks.size(), static_cast<unsigned long long>(m_requests), static_cast<unsigned long long>(m_responses),
+		static_cast<unsigned long long>(m_timeouts), static_cast<unsigned long long>(m_crcErrors),
+		static_cast<unsigned long long>(m_exceptions), static_cast<unsigned long long>(m_late),
+		static_cast<unsigned long long>(m_valuesRead), seconds > 0 ? m_valuesRead / seconds : 0.0,
+		seconds > 0 ? m_lineChars * static_cast<double>(m_charNs) / (seconds * 1e9) * 100.0 : 0.0);
+	return text;
+}
@@ -0,0 +1,241 @@
+/*
+ * @Description: Modbus RTU 主站：轮询点配置、合并相邻寄存器的请求计划、按波特率计算帧间隔的轮询调度和响应解析
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief Modbus 数据区。
+ */
+enum class ModbusTable : uint8_t
+{
+	Coil,            /**< 线圈，功能码 1。 */
+	DiscreteInput,   /**< 离散输入，功能码 2。 */
+	HoldingRegister, /**< 保持寄存器，功能码 3。 */
+	InputRegister    /**< 输入寄存器，功能码 4。 */
+};
+
+/**
+ * @brief 寄存器的数值类型，32 位类型占两个寄存器，高位字在前。
+ */
+enum class ModbusType : uint8_t
+{
+	Bit,
+	U16,
+	I16,
+	U32,
+	I32,
+	F32
+};
+
+/**
+ * @brief 一个轮询点，对应一个通道。
+ */
+struct ModbusPoint
+{
+	std::string name;            /**< 通道名称。 */
+	uint8_t slave = 1;           /**< 从站地址。 */
+	ModbusTable table = ModbusTable::HoldingRegister; /**< 数据区。 */
+	uint16_t address = 0;        /**< 起始地址。 */
+	ModbusType type = ModbusType::U16; /**< 数值类型。 */
+	double scale = 1.0;          /**< 输出值为原始值乘以 scale。 */
+	int64_t periodNs = 100000000; /**< 轮询周期，0 表示线路允许的最快速度；自适应时为最短周期。 */
+	int64_t maxPeriodNs = 0;     /**< 自适应的最长周期，0 表示固定周期。 */
+
+	/**
+	 * @brief 占用的寄存器或位数。
+	 */
+	uint16_t Width() const;
+};
+
+/**
+ * @brief Modbus 轮询配置。
+ *
+ * 文本格式：条目之间用 ';' 或换行分隔，每个条目为 "[名称=]从站:数据区:地址[-结束地址][:类型][*比例][@周期]"。
+ * 数据区为 hr、ir、coil、di；类型为 u16（默认）、i16、u32、i32、f32；
+ * 周期例如 100ms、1s、0（尽快），或 "最短..最长" 表示自适应周期（例如 20ms..2s），auto 等同于 10ms..1s，默认 100ms。
+ * 地址范围按类型宽度展开为多个点，通道名称默认为 "mb从站.数据区地址"（例如 mb1.hr100），
+ * 指定名称时单个点使用该名称，范围内的点为 "名称.地址"。
+ */
+class ModbusConfig
+{
+public:
+	/**
+	 * @brief 解析配置文本。
+	 * @throw std::invalid_argument 如果格式错误、地址越界或类型与数据区不匹配。
+	 */
+	static ModbusConfig Parse(const std::string& spec);
+
+	/**
+	 * @brief 转换回配置文本，每个点一个条目。
+	 */
+	std::string Describe() const;
+
+	bool IsEmpty() const { return m_points.empty(); }
+	const std::vector<ModbusPoint>& Points() const { return m_points; }
+
+private:
+	std::vector<ModbusPoint> m_points; /**< 所有轮询点。 */
+};
+
+/**
+ * @brief ModbusMaster 是 Modbus RTU 主站的协议部分，不依赖 Qt，也不做任何 I/O。
+ *
+ * 构造时把轮询点规划为请求块：同一从站、同一数据区的点按地址排序后贪心合并，
+ * 以线路上每秒占用的字符数为代价——每个请求的固定开销（请求 8 字节、响应头和 CRC 5 字节、前后各 3.5 个字符的静默）
+ * 与合并后多读的间隙寄存器和被更快的点带着提高轮询频率的代价相比较，合并更省时才合并，单个请求不超过 125 个寄存器或 2000 个位。
+ * 合并后的请求被从站以非法地址拒绝时拆回单个点。
+ *
+ * Poll 由调用方按返回的时刻调用：上一个响应结束后至少等待 3.5 个字符时间（19200 波特以上为 1.75 ms）才发出下一个请求；
+ * 同时到期的请求块中，过期时间占周期比例越大、最近几次轮询数值变化越多的优先，线路饱和时变化快的寄存器先得到带宽。
+ * 自适应周期的块数值变化时周期减半，不变时逐步放长。
+ *
+ * 作为 ProtocolDecoder 安装到串口上：Feed 按请求计算出的长度收齐响应，校验 CRC 后输出 key=value 记录，
+ * 通道名称即轮询点名称，因此报警、滤波、派生通道和曲线窗口按名称使用 Modbus 数据，与其他协议相同。
+ */
+class ModbusMaster : public ProtocolDecoder
+{
+public:
+	/**
+	 * @brief 构造函数，规划请求块。
+	 * @param config 轮询配置。
+	 * @param merge 是否合并请求，false 时每个点单独请求，用于对比测试。
+	 */
+	explicit ModbusMaster(ModbusConfig config, bool merge = true);
+
+	const char* Name() const override { return "modbus"; }
+
+	/**
+	 * @brief 输入收到的数据，时间取 TraceRecorder::NowNs。
+	 */
+	void Feed(ByteSpan chunk, RecordSink& sink) override;
+
+	/**
+	 * @brief 输入收到的数据。
+	 * @param nowNs 收到数据的时间，与 Poll 使用同一个时钟。
+	 */
+	void OnReceive(ByteSpan chunk, int64_t nowNs, RecordSink& sink);
+
+	/**
+	 * @brief 放弃正在等待的响应。
+	 */
+	void Reset() override;
+
+	/**
+	 * @brief 设置线路参数，用于计算帧间隔和响应超时。
+	 * @param baudRate 波特率。
+	 * @param bitsPerChar 每个字符的位数，包括起始位、数据位、校验位和停止位。
+	 */
+	void SetLineTiming(int baudRate, double bitsPerChar);
+
+	/**
+	 * @brief 设置从站的响应超时，不含请求和响应本身在线路上的传输时间。
+	 */
+	void SetResponseTimeout(int64_t ns) { m_timeoutNs = ns; }
+
+	/**
+	 * @brief 推进调度：处理超时，需要发送请求时追加到 out。
+	 * @param nowNs 当前时间。
+	 * @param out 需要写到串口的请求追加到这里。
+	 * @return 下一次应调用 Poll 的时刻；正在等待响应时为超时时刻，收到响应后应立即再调用一次。
+	 */
+	int64_t Poll(int64_t nowNs, std::string& out);
+
+	/**
+	 * @brief 是否正在等待响应。
+	 */
+	bool IsWaiting() const { return m_waiting; }
+
+	const ModbusConfig& Config() const { return m_config; }
+	size_t BlockCount() const { return m_blocks.size(); }
+
+	/**
+	 * @brief 请求计划，每个请求块一行。
+	 */
+	std::string DescribePlan() const;
+
+	uint64_t Requests() const { return m_requests; }
+	uint64_t Responses() const { return m_responses; }
+	uint64_t Timeouts() const { return m_timeouts; }
+	uint64_t Exceptions() const { return m_exceptions; }
+	uint64_t ValuesRead() const { return m_valuesRead; }
+
+	/**
+	 * @brief 统计信息：请求块数、请求数、响应、超时、CRC 错误、异常、迟到的轮询、每秒读取的值和线路占用率。
+	 */
+	std::string Format() const;
+
+	/**
+	 * @brief Modbus CRC16（多项式 0xA001 反射，初值 0xFFFF），按字节查表。
+	 */
+	static uint16_t Crc16(const char* data, size_t length);
+
+	static constexpr uint16_t kMaxRegisters = 125; /**< 一个读寄存器请求最多的寄存器数。 */
+	static constexpr uint16_t kMaxBits = 2000;     /**< 一个读线圈请求最多的位数。 */
+
+private:
+	/**
+	 * @brief 一个请求块：一次读请求覆盖的连续地址及其中的轮询点。
+	 */
+	struct Block
+	{
+		uint8_t slave;               /**< 从站地址。 */
+		ModbusTable table;           /**< 数据区。 */
+		uint16_t start;              /**< 起始地址。 */
+		uint16_t count;              /**< 寄存器或位数。 */
+		std::vector<size_t> points;  /**< 块内的轮询点。 */
+		int64_t minPeriodNs;         /**< 最短周期。 */
+		int64_t maxPeriodNs;         /**< 最长周期，与最短周期相同时为固定周期。 */
+		int64_t periodNs;            /**< 当前周期。 */
+		int64_t dueNs = 0;           /**< 下一次到期时间。 */
+		double changeScore = 1.0;    /**< 最近几次轮询中数值变化的比例（指数平均）。 */
+		std::string last;            /**< 上一次响应的数据部分，用于判断是否变化。 */
+		uint64_t polls = 0;          /**< 轮询次数。 */
+	};
+
+	static double RequestChars(ModbusTable table, uint32_t count);
+	void Plan(bool merge);
+	std::vector<Block> PlanGroup(const std::vector<size_t>& points, bool merge) const;
+	void InitBlock(Block& block) const;
+	void Complete(int64_t nowNs);
+	void HandleResponse(const char* frame, size_t length, int64_t nowNs, RecordSink& sink);
+	void SplitBlock(size_t index);
+
+	ModbusConfig m_config;           /**< 轮询配置。 */
+	std::vector<Block> m_blocks;     /**< 请求块。 */
+
+	int64_t m_charNs = 86806;        /**< 一个字符的传输时间，默认 115200 波特、10 位。 */
+	int64_t m_silenceNs = 1750000;   /**< 帧间静默时间（3.5 个字符）。 */
+	int64_t m_timeoutNs = 100000000; /**< 从站响应超时。 */
+
+	bool m_waiting = false;          /**< 是否正在等待响应。 */
+	size_t m_current = 0;            /**< 正在等待响应的请求块。 */
+	int64_t m_sentNs = 0;            /**< 当前请求的发送时间。 */
+	int64_t m_deadlineNs = 0;        /**< 当前请求的超时时刻。 */
+	int64_t m_quietUntilNs = 0;      /**< 线路静默到这个时刻后才能发送下一个请求。 */
+	size_t m_expected = 0;           /**< 当前请求正常响应的长度。 */
+	std::string m_request;           /**< 当前请求。 */
+	std::string m_rx;                /**< 已收到的响应字节。 */
+
+	std::vector<ByteSpan> m_keys;    /**< 输出记录的键名，指向轮询点名称。 */
+	std::vector<double> m_values;    /**< 输出记录的数值。 */
+
+	int64_t m_firstNs = -1;          /**< 第一个请求的发送时间。 */
+	int64_t m_lastNs = 0;            /**< 最近一次收发的时间。 */
+	uint64_t m_requests = 0;         /**< 发出的请求数。 */
+	uint64_t m_responses = 0;        /**< 正常响应数。 */
+	uint64_t m_timeouts = 0;         /**< 超时数。 */
+	uint64_t m_crcErrors = 0;        /**< CRC 或格式错误的响应数。 */
+	uint64_t m_exceptions = 0;       /**< 异常响应数。 */
+	uint64_t m_late = 0;             /**< 晚于到期时间一个周期以上才发出的请求数。 */
+	uint64_t m_unexpected = 0;       /**< 没有请求时收到的字节数。 */
+	uint64_t m_valuesRead = 0;       /**< 读到的值的个数。 */
+	uint64_t m_lineChars = 0;        /**< 请求和响应在线路上的字符数。 */
+};
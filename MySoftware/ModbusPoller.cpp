@@ -0,0 +1,95 @@
+/*
+ * @Description: 按 ModbusMaster 的调度在串口上发出 Modbus RTU 轮询请求
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "ModbusPoller.h"
+#include "ModbusMaster.h"
+#include "SerialInfo.h"
+#include "TraceRecorder.h"
+#include <QtCore/QDebug>
+#include <limits>
+#include <stdexcept>
+
+ModbusPoller::ModbusPoller(SerialInfo* serial, ModbusMaster* master, QObject* parent)
+	: QObject(parent), m_serial(serial), m_master(master)
+{
+	m_timer.setSingleShot(true);
+	m_timer.setTimerType(Qt::PreciseTimer);
+	connect(&m_timer, &QTimer::timeout, this, &ModbusPoller::Pump);
+}
+
+/**
+ * @brief 每个字符包含 1 个起始位、数据位、可选的校验位和停止位，与 FileTransfer::LineRate 相同。
+ */
+void ModbusPoller::Start()
+{
+	if (m_running)
+	{
+		return;
+	}
+	double bits = 1.0 + static_cast<int>(m_serial->dataBits);
+	bits += m_serial->parity == QSerialPort::NoParity ? 0.0 : 1.0;
+	bits += m_serial->stopBits == QSerialPort::TwoStop ? 2.0 : m_serial->stopBits == QSerialPort::OneAndHalfStop ? 1.5 : 1.0;
+	m_master->SetLineTiming(static_cast<int>(m_serial->baudRate), bits);
+	m_master->Reset();
+	m_running = true;
+	m_dataConnection = connect(m_serial, &SerialInfo::DataReceived, this, &ModbusPoller::Pump);
+	qDebug() << "Modbus polling started:" << m_master->BlockCount() << "requests per cycle";
+	Pump();
+}
+
+void ModbusPoller::Stop()
+{
+	if (!m_running)
+	{
+		return;
+	}
+	m_running = false;
+	m_timer.stop();
+	disconnect(m_dataConnection);
+	m_master->Reset();
+	qDebug() << "Modbus polling stopped:" << Summary();
+}
+
+QString ModbusPoller::Summary() const
+{
+	return QString::fromStdString(m_master->Format());
+}
+
+/**
+ * @brief 推进调度：发出到期的请求，把定时器设到下一次调度时刻。
+ * 发送失败（例如串口被拔出）时停止轮询。
+ */
+void ModbusPoller::Pump()
+{
+	if (!m_running)
+	{
+		return;
+	}
+	m_output.clear();
+	const int64_t nowNs = TraceRecorder::NowNs();
+	const int64_t nextNs = m_master->Poll(nowNs, m_output);
+	if (!m_output.empty())
+	{
+		try
+		{
+			m_serial->SerialSendBytes(QByteArray(m_output.data(), static_cast<int>(m_output.size())));
+		}
+		catch (const std::runtime_error& e)
+		{
+			qWarning() << "Modbus request failed:" << e.what();
+			Stop();
+			return;
+		}
+	}
+	if (nextNs == std::numeric_limits<int64_t>::max())
+	{
+		m_timer.stop();
+		return;
+	}
+	const int64_t waitNs = nextNs > nowNs ? nextNs - nowNs : 0;
+	m_timer.start(static_cast<int>((waitNs + 999999) / 1000000));
+}
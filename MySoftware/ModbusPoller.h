@@ -0,0 +1,65 @@
+/*
+ * @Description: 按 ModbusMaster 的调度在串口上发出 Modbus RTU 轮询请求
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <string>
+
+class ModbusMaster;
+class SerialInfo;
+
+/**
+ * @brief ModbusPoller 把 ModbusMaster 接到串口上：按 Poll 返回的时刻发出请求，收到响应后立即安排下一个。
+ *
+ * 响应由安装为串口解码器的同一个 ModbusMaster 解析，输出的记录进入通常的记录处理流程；
+ * 本对象连接 DataReceived 的时间晚于解码器，在同一个数据块被解码之后才调用 Poll，
+ * 因此响应一收齐就能在帧间静默结束时发出下一个请求。
+ * 定时器使用 Qt::PreciseTimer，毫秒精度向上取整，实际静默时间略长于 3.5 个字符。
+ */
+class ModbusPoller : public QObject
+{
+	Q_OBJECT
+
+public:
+	/**
+	 * @brief 构造函数。
+	 * @param serial 发送使用的串口，必须比本对象活得更久。
+	 * @param master Modbus 主站，必须比本对象活得更久。
+	 * @param parent 父对象。
+	 */
+	ModbusPoller(SerialInfo* serial, ModbusMaster* master, QObject* parent = nullptr);
+
+	/**
+	 * @brief 按串口当前配置设置线路参数，开始轮询。串口应已打开。
+	 */
+	void Start();
+
+	/**
+	 * @brief 停止轮询，正在等待的响应被放弃。
+	 */
+	void Stop();
+
+	bool IsRunning() const { return m_running; }
+
+	/**
+	 * @brief 一行摘要，见 ModbusMaster::Format。
+	 */
+	QString Summary() const;
+
+private slots:
+	void Pump();
+
+private:
+	SerialInfo* m_serial;            /**< 发送使用的串口。 */
+	ModbusMaster* m_master;          /**< Modbus 主站。 */
+	QTimer m_timer;                  /**< 到下一次调度时刻的单次定时器。 */
+	std::string m_output;            /**< 待发送的请求。 */
+	bool m_running = false;          /**< 是否正在轮询。 */
+	QMetaObject::Connection m_dataConnection; /**< 接收数据的连接。 */
+};
@@ -0,0 +1,234 @@
+/*
+ * @Description: 伪终端上的 Modbus RTU 从站模拟器，按波特率模拟线路时间，用于没有设备时测试主站和轮询调度
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:50:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "ModbusSlaveSim.h"
+#include "CrashHandler.h"
+#include "ModbusMaster.h"
+#include "PtyPair.h"
+#include "TraceRecorder.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#define MYSOFTWARE_HAVE_PTY 1
+#endif
+
+namespace
+{
+	constexpr size_t kRequestSize = 8;
+	constexpr uint32_t kFirstMissing = 50000;
+
+	void AppendCrc(std::string& frame, size_t begin)
+	{
+		const uint16_t crc = ModbusMaster::Crc16(frame.data() + begin, frame.size() - begin);
+		frame.push_back(static_cast<char>(crc & 0xFF));
+		frame.push_back(static_cast<char>(crc >> 8));
+	}
+
+	uint16_t Register(uint32_t address, double seconds)
+	{
+		if (address < 100)
+		{
+			const double period = 1.0 + address % 10;
+			return static_cast<uint16_t>(std::lround(1000.0 + 1000.0 * std::sin(2.0 * 3.14159265358979 * seconds / period + address)));
+		}
+		if (address < 200)
+		{
+			return static_cast<uint16_t>(static_cast<uint32_t>(seconds) + address);
+		}
+		return static_cast<uint16_t>(address);
+	}
+}
+
+ModbusSlaveSim::ModbusSlaveSim() = default;
+
+ModbusSlaveSim::~ModbusSlaveSim()
+{
+	Stop();
+}
+
+void ModbusSlaveSim::Start(int baudRate, double bitsPerChar)
+{
+	Stop();
+#ifdef MYSOFTWARE_HAVE_PTY
+	m_pty = std::make_unique<PtyPair>();
+	m_charNs = baudRate > 0 ? static_cast<int64_t>(bitsPerChar * 1e9 / baudRate) : 0;
+	m_stop.store(false);
+	m_requests.store(0);
+	m_exceptions.store(0);
+	m_crcErrors.store(0);
+	m_thread = std::thread(&ModbusSlaveSim::Run, this);
+#else
+	(void)baudRate;
+	(void)bitsPerChar;
+	throw std::runtime_error("The Modbus slave simulator requires POSIX ptys.");
+#endif
+}
+
+void ModbusSlaveSim::Stop()
+{
+	m_stop.store(true);
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+	m_pty.reset();
+}
+
+const std::string& ModbusSlaveSim::SlavePath() const
+{
+	static const std::string empty;
+	return m_pty ? m_pty->SlavePath() : empty;
+}
+
+std::string ModbusSlaveSim::Format() const
+{
+	char text[128];
+	std::snprintf(text, sizeof(text), "modbus-sim requests=%llu exceptions=%llu dropped=%llu",
+		static_cast<unsigned long long>(Requests()), static_cast<unsigned long long>(Exceptions()),
+		static_cast<unsigned long long>(CrcErrors()));
+	return text;
+}
+
+/**
+ * @brief 生成响应：读请求的地址范围超出 65536 或数量为 0、超过上限时返回异常码 3，
+ * 范围内有不存在的地址时返回异常码 2。
+ */
+bool ModbusSlaveSim::Respond(const char* request, double seconds, std::string& response)
+{
+	const size_t begin = response.size();
+	const uint8_t slave = static_cast<uint8_t>(request[0]);
+	const uint8_t function = static_cast<uint8_t>(request[1]);
+	const uint32_t start = static_cast<uint32_t>(static_cast<uint8_t>(request[2]) << 8 | static_cast<uint8_t>(request[3]));
+	const uint32_t count = static_cast<uint32_t>(static_cast<uint8_t>(request[4]) << 8 | static_cast<uint8_t>(request[5]));
+	const bool bits = function == 1 || function == 2;
+	const uint32_t limit = bits ? ModbusMaster::kMaxBits : ModbusMaster::kMaxRegisters;
+
+	uint8_t exception = 0;
+	if (function < 1 || function > 4)
+	{
+		exception = 1;
+	}
+	else if (count == 0 || count > limit || start + count > 65536)
+	{
+		exception = 3;
+	}
+	else if (start + count > kFirstMissing)
+	{
+		exception = 2;
+	}
+	response.push_back(static_cast<char>(slave));
+	if (exception != 0)
+	{
+		response.push_back(static_cast<char>(function | 0x80));
+		response.push_back(static_cast<char>(exception));
+		AppendCrc(response, begin);
+		return true;
+	}
+
+	response.push_back(static_cast<char>(function));
+	if (bits)
+	{
+		const uint32_t second = static_cast<uint32_t>(seconds);
+		std::string data((count + 7) / 8, '\0');
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t address = start + i;
+			const bool on = address < 100 ? (address + second) % 2 == 1 : address % 3 == 0;
+			data[i / 8] = static_cast<char>(data[i / 8] | (on ? 1 << (i % 8) : 0));
+		}
+		response.push_back(static_cast<char>(data.size()));
+		response += data;
+	}
+	else
+	{
+		response.push_back(static_cast<char>(count * 2));
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint16_t value = Register(start + i, seconds);
+			response.push_back(static_cast<char>(value >> 8));
+			response.push_back(static_cast<char>(value & 0xFF));
+		}
+	}
+	AppendCrc(response, begin);
+	return false;
+}
+
+/**
+ * @brief 模拟线程：收齐 8 字节且 CRC 正确的请求后，等待线路时间再写出响应。
+ * 广播地址 0 和 248 以上的地址不响应。
+ */
+void ModbusSlaveSim::Run()
+{
+#ifdef MYSOFTWARE_HAVE_PTY
+	TraceRecorder::SetThreadName("modbus-sim");
+	CrashHandler::InstallThreadStack();
+	const int master = m_pty->Master();
+	const int64_t startNs = TraceRecorder::NowNs();
+	std::string pending;
+	std::string response;
+	char buffer[512];
+	while (!m_stop.load())
+	{
+		pollfd descriptor{ master, POLLIN, 0 };
+		const int ready = poll(&descriptor, 1, 100);
+		if (ready == 0)
+		{
+			m_crcErrors.fetch_add(pending.size(), std::memory_order_relaxed);
+			pending.clear();
+			continue;
+		}
+		if (ready < 0 || !(descriptor.revents & POLLIN))
+		{
+			continue;
+		}
+		const ssize_t length = read(master, buffer, sizeof(buffer));
+		if (length <= 0)
+		{
+			continue;
+		}
+		pending.append(buffer, static_cast<size_t>(length));
+
+		size_t begin = 0;
+		while (pending.size() - begin >= kRequestSize)
+		{
+			const char* request = pending.data() + begin;
+			const uint16_t crc = ModbusMaster::Crc16(request, kRequestSize - 2);
+			if (static_cast<uint8_t>(request[6]) != (crc & 0xFF) || static_cast<uint8_t>(request[7]) != (crc >> 8))
+			{
+				m_crcErrors.fetch_add(1, std::memory_order_relaxed);
+				++begin;
+				continue;
+			}
+			begin += kRequestSize;
+			const uint8_t slave = static_cast<uint8_t>(request[0]);
+			if (slave == 0 || slave > 247)
+			{
+				continue;
+			}
+			m_requests.fetch_add(1, std::memory_order_relaxed);
+			response.clear();
+			if (Respond(request, (TraceRecorder::NowNs() - startNs) / 1e9, response))
+			{
+				m_exceptions.fetch_add(1, std::memory_order_relaxed);
+			}
+			if (m_charNs > 0)
+			{
+				std::this_thread::sleep_for(std::chrono::nanoseconds(
+					static_cast<int64_t>(kRequestSize + response.size()) * m_charNs + m_charNs * 7 / 2));
+			}
+			m_pty->WriteAll(response.data(), response.size());
+		}
+		pending.erase(0, begin);
+	}
+#endif
+}
@@ -0,0 +1,83 @@
+/*
+ * @Description: 伪终端上的 Modbus RTU 从站模拟器，按波特率模拟线路时间，用于没有设备时测试主站和轮询调度
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:50:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+class PtyPair;
+
+/**
+ * @brief ModbusSlaveSim 在一对伪终端上模拟挂在同一条总线上的所有 Modbus RTU 从站（地址 1~247）。
+ *
+ * 支持功能码 1~4，寄存器内容为合成数据：地址 0~99 为快速变化的正弦，100~199 为每秒加一的计数，
+ * 其余地址的值等于地址本身；线圈和离散输入按地址和秒数交替。
+ * 地址 50000 及以上不存在，返回异常码 2；其他功能码返回异常码 1。
+ *
+ * 伪终端本身没有波特率，模拟器收到请求后等待请求和响应在设定波特率下的传输时间再加 3.5 个字符才写出响应，
+ * 主站因此看到与真实线路相同的每秒请求数上限。伪终端不保留字符间隔，请求按功能码的固定长度（8 字节）分帧，
+ * CRC 错误时丢弃一个字节重新同步，超过 100 ms 没有数据时丢弃残留字节。仅支持 POSIX 系统。
+ */
+class ModbusSlaveSim
+{
+public:
+	ModbusSlaveSim();
+	~ModbusSlaveSim();
+
+	ModbusSlaveSim(const ModbusSlaveSim&) = delete;
+	ModbusSlaveSim& operator=(const ModbusSlaveSim&) = delete;
+
+	/**
+	 * @brief 创建伪终端并启动模拟线程。
+	 * @param baudRate 模拟的波特率，0 表示不模拟线路时间。
+	 * @param bitsPerChar 每个字符的位数。
+	 * @throw std::runtime_error 如果创建伪终端失败或平台不支持。
+	 */
+	void Start(int baudRate, double bitsPerChar = 10.0);
+
+	/**
+	 * @brief 停止模拟线程并关闭伪终端。
+	 */
+	void Stop();
+
+	/**
+	 * @brief 从端设备路径，主站打开这个路径。
+	 */
+	const std::string& SlavePath() const;
+
+	uint64_t Requests() const { return m_requests.load(std::memory_order_relaxed); }
+	uint64_t Exceptions() const { return m_exceptions.load(std::memory_order_relaxed); }
+	uint64_t CrcErrors() const { return m_crcErrors.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief 统计信息：请求数、异常响应数和丢弃的字节数。
+	 */
+	std::string Format() const;
+
+	/**
+	 * @brief 按请求生成响应。
+	 * @param request 8 字节请求，CRC 已校验。
+	 * @param seconds 模拟器启动后的时间，用于生成合成数据。
+	 * @param response 响应追加到这里，含 CRC。
+	 * @return 是否为异常响应。
+	 */
+	static bool Respond(const char* request, double seconds, std::string& response);
+
+private:
+	void Run();
+
+	std::unique_ptr<PtyPair> m_pty;          /**< 伪终端。 */
+	int64_t m_charNs = 0;                    /**< 一个字符的模拟传输时间。 */
+	std::thread m_thread;                    /**< 模拟线程。 */
+	std::atomic<bool> m_stop{ false };       /**< 停止标志。 */
+	std::atomic<uint64_t> m_requests{ 0 };   /**< 收到的请求数。 */
+	std::atomic<uint64_t> m_exceptions{ 0 }; /**< 异常响应数。 */
+	std::atomic<uint64_t> m_crcErrors{ 0 };  /**< 重新同步时丢弃的字节数。 */
+};
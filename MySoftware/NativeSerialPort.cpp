@@ -0,0 +1,346 @@
+/*
+ * @Description: Linux 原生串口后端，termios 配置串口，epoll 等待数据，read 直接读入接收数据块
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 22:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "NativeSerialPort.h"
+#include "CrashHandler.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/file.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#define MYSOFTWARE_HAVE_EPOLL 1
+#endif
+
+namespace
+{
+#ifdef MYSOFTWARE_HAVE_EPOLL
+	/**
+	 * @brief 把波特率数值转换为 termios 的速率常量，不支持时返回 B0。
+	 */
+	speed_t SpeedOf(int baudRate)
+	{
+		switch (baudRate)
+		{
+		case 1200: return B1200;
+		case 2400: return B2400;
+		case 4800: return B4800;
+		case 9600: return B9600;
+		case 19200: return B19200;
+		case 38400: return B38400;
+		case 57600: return B57600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+		case 460800: return B460800;
+		case 921600: return B921600;
+		default: return B0;
+		}
+	}
+
+	std::runtime_error SystemError(const std::string& what)
+	{
+		return std::runtime_error(what + ": " + std::strerror(errno));
+	}
+#endif
+}
+
+NativeSerialPort::~NativeSerialPort()
+{
+	Close();
+}
+
+bool NativeSerialPort::IsSupported()
+{
+#ifdef MYSOFTWARE_HAVE_EPOLL
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief 打开并配置串口。
+ * 串口设置为原始模式、无流控，加 flock 独占锁，避免两个程序同时读同一个串口。
+ * 校验位的数值与 QSerialPort::Parity 相同：0 无、2 偶、3 奇、4 空格、5 标记。
+ */
+void NativeSerialPort::Open(const std::string& name, const Settings& settings)
+{
+	Close();
+#ifdef MYSOFTWARE_HAVE_EPOLL
+	const std::string path = !name.empty() && name[0] == '/' ? name : "/dev/" + name;
+	const speed_t speed = SpeedOf(settings.baudRate);
+	if (speed == B0)
+	{
+		throw std::runtime_error("Unsupported baud rate " + std::to_string(settings.baudRate) + ".");
+	}
+	if (settings.stopBits != 1 && settings.stopBits != 2)
+	{
+		throw std::runtime_error("The native serial backend supports 1 or 2 stop bits only.");
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_writeMutex);
+		m_fd = open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	}
+	if (m_fd < 0)
+	{
+		throw SystemError("Failed to open " + path);
+	}
+	if (flock(m_fd, LOCK_EX | LOCK_NB) != 0)
+	{
+		const std::runtime_error error = SystemError(path + " is in use");
+		CloseDescriptors();
+		throw error;
+	}
+
+	termios options;
+	if (tcgetattr(m_fd, &options) != 0)
+	{
+		const std::runtime_error error = SystemError("tcgetattr " + path);
+		CloseDescriptors();
+		throw error;
+	}
+	cfmakeraw(&options);
+	options.c_cflag |= CLOCAL | CREAD;
+	options.c_cflag &= ~(CSIZE | CSTOPB | PARENB | PARODD | CMSPAR | CRTSCTS);
+	options.c_iflag &= ~(IXON | IXOFF | IXANY | INPCK);
+	switch (settings.dataBits)
+	{
+	case 5: options.c_cflag |= CS5; break;
+	case 6: options.c_cflag |= CS6; break;
+	case 7: options.c_cflag |= CS7; break;
+	default: options.c_cflag |= CS8; break;
+	}
+	options.c_cflag |= settings.stopBits == 2 ? CSTOPB : 0;
+	switch (settings.parity)
+	{
+	case 2: options.c_cflag |= PARENB; break;
+	case 3: options.c_cflag |= PARENB | PARODD; break;
+	case 4: options.c_cflag |= PARENB | CMSPAR; break;
+	case 5: options.c_cflag |= PARENB | CMSPAR | PARODD; break;
+	default: break;
+	}
+	options.c_iflag |= settings.parity != 0 ? INPCK : 0;
+	options.c_cc[VMIN] = 0;
+	options.c_cc[VTIME] = 0;
+	cfsetispeed(&options, speed);
+	cfsetospeed(&options, speed);
+	if (tcsetattr(m_fd, TCSANOW, &options) != 0)
+	{
+		const std::runtime_error error = SystemError("tcsetattr " + path);
+		CloseDescriptors();
+		throw error;
+	}
+	tcflush(m_fd, TCIFLUSH);
+
+	m_epoll = epoll_create1(EPOLL_CLOEXEC);
+	m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	epoll_event portEvent{};
+	portEvent.events = EPOLLIN;
+	portEvent.data.fd = m_fd;
+	epoll_event wakeEvent{};
+	wakeEvent.events = EPOLLIN;
+	wakeEvent.data.fd = m_wake;
+	if (m_epoll < 0 || m_wake < 0 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_fd, &portEvent) != 0
+		|| epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &wakeEvent) != 0)
+	{
+		const std::runtime_error error = SystemError("epoll setup for " + path);
+		CloseDescriptors();
+		throw error;
+	}
+
+	m_readBytes.store(0);
+	m_readCalls.store(0);
+	m_thread = std::thread(&NativeSerialPort::Run, this);
+#else
+	(void)name;
+	(void)settings;
+	throw std::runtime_error("The native serial backend requires Linux.");
+#endif
+}
+
+void NativeSerialPort::Close()
+{
+#ifdef MYSOFTWARE_HAVE_EPOLL
+	if (m_thread.joinable())
+	{
+		const uint64_t one = 1;
+		if (write(m_wake, &one, sizeof(one)) < 0)
+		{
+			// eventfd 计数器不会溢出，写入失败时读取线程仍会在下一次数据或挂断时退出
+		}
+		m_thread.join();
+	}
+#endif
+	CloseDescriptors();
+}
+
+/**
+ * @brief 串口描述符在 m_writeMutex 下关闭并清除：Write 在其他线程中调用，
+ * 不加锁时正在进行的写入可能写到已关闭、甚至被重新分配给其他文件的描述符号上。
+ */
+void NativeSerialPort::CloseDescriptors()
+{
+#ifdef MYSOFTWARE_HAVE_EPOLL
+	{
+		std::lock_guard<std::mutex> lock(m_writeMutex);
+		if (m_fd >= 0)
+		{
+			close(m_fd);
+		}
+		m_fd = -1;
+	}
+	for (int* fd : { &m_epoll, &m_wake })
+	{
+		if (*fd >= 0)
+		{
+			close(*fd);
+		}
+		*fd = -1;
+	}
+#endif
+}
+
+/**
+ * @brief 写出全部数据。
+ * 串口为非阻塞模式，写缓冲满（EAGAIN）时用 poll 等待可写，超过 1 秒仍不可写视为失败。
+ */
+void NativeSerialPort::Write(const char* data, size_t length)
+{
+#ifdef MYSOFTWARE_HAVE_EPOLL
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+	if (m_fd < 0)
+	{
+		throw std::runtime_error("Serial port is not open.");
+	}
+	size_t written = 0;
+	while (written < length)
+	{
+		const ssize_t result = write(m_fd, data + written, length - written);
+		if (result >= 0)
+		{
+			written += static_cast<size_t>(result);
+			continue;
+		}
+		if (errno == EINTR)
+		{
+			continue;
+		}
+		if (errno != EAGAIN)
+		{
+			throw SystemError("Failed to write to the serial port");
+		}
+		pollfd descriptor{ m_fd, POLLOUT, 0 };
+		if (poll(&descriptor, 1, 1000) <= 0)
+		{
+			throw std::runtime_error("Serial port write timed out.");
+		}
+	}
+#else
+	(void)data;
+	(void)length;
+	throw std::runtime_error("Serial port is not open.");
+#endif
+}
+
+/**
+ * @brief 读取线程：等待串口可读，按 FIONREAD 的大小分配数据块并读入，直到内核中没有待读数据。
+ * 收到 eventfd 通知时退出；串口挂断或出错时调用错误回调后退出。
+ * 挂断以 epoll 报告的 EPOLLHUP/EPOLLERR 为准，读完剩余数据后才报告；
+ * 没有挂断时 read 返回 0 只表示暂时没有数据（VMIN=0/VTIME=0），read 出错（例如 USB 转串口拔出时的 EIO）直接报告。
+ */
+void NativeSerialPort::Run()
+{
+#ifdef MYSOFTWARE_HAVE_EPOLL
+	CrashHandler::InstallThreadStack();
+	epoll_event events[2];
+	for (;;)
+	{
+		const int count = epoll_wait(m_epoll, events, 2, -1);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (m_onError)
+			{
+				m_onError(std::string("epoll_wait: ") + std::strerror(errno));
+			}
+			return;
+		}
+		bool readable = false;
+		bool hungUp = false;
+		for (int i = 0; i < count; ++i)
+		{
+			if (events[i].data.fd == m_wake)
+			{
+				return;
+			}
+			readable = true;
+			hungUp = hungUp || (events[i].events & (EPOLLHUP | EPOLLERR)) != 0;
+		}
+		if (!readable)
+		{
+			continue;
+		}
+
+		// 水平触发模式：读到内核中暂时没有数据即可回到 epoll_wait，不需要读到 EAGAIN
+		for (bool first = true;; first = false)
+		{
+			int available = 0;
+			if (ioctl(m_fd, FIONREAD, &available) != 0 || available <= 0)
+			{
+				if (!first)
+				{
+					break;
+				}
+				available = 4096;
+			}
+			QByteArray chunk(available < kMaxRead ? available : kMaxRead, Qt::Uninitialized);
+			const ssize_t length = read(m_fd, chunk.data(), static_cast<size_t>(chunk.size()));
+			if (length > 0)
+			{
+				if (length < chunk.size())
+				{
+					chunk.truncate(static_cast<int>(length));
+				}
+				m_readBytes.fetch_add(static_cast<uint64_t>(length), std::memory_order_relaxed);
+				m_readCalls.fetch_add(1, std::memory_order_relaxed);
+				if (m_onData)
+				{
+					m_onData(chunk);
+				}
+				continue;
+			}
+			if (length < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			const bool noData = length == 0 || (length < 0 && errno == EAGAIN);
+			if (noData && !hungUp)
+			{
+				break;
+			}
+			// 挂断后数据已经读完，或者 read 出错
+			if (m_onError)
+			{
+				m_onError(noData ? std::string("Serial device hung up.")
+					: std::string("Serial read failed: ") + std::strerror(errno));
+			}
+			return;
+		}
+	}
+#endif
+}
@@ -0,0 +1,113 @@
+/*
+ * @Description: Linux 原生串口后端，termios 配置串口，epoll 等待数据，read 直接读入接收数据块
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 22:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QByteArray>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief NativeSerialPort 不经过 QSerialPort，直接用 termios/epoll 读写 tty。
+ *
+ * 读取线程阻塞在 epoll_wait 上，可读时先用 FIONREAD 查询内核中待读的字节数，
+ * 分配同样大小的 QByteArray 后 read 直接读入，这个数据块就是交给回调、放入 RxRing 和发出信号的那一份，
+ * 中间没有 QSerialPort 内部缓冲到 readAll() 的拷贝，也不经过事件循环的通知器。
+ * 停止通过 eventfd 唤醒读取线程。写入在调用线程中完成，写缓冲满时用 poll 等待。
+ * 仅支持 Linux，其他平台上 Open 抛出异常。
+ */
+class NativeSerialPort
+{
+public:
+	/**
+	 * @brief 串口参数，取值与 SerialInfo 中的 QSerialPort 枚举相同。
+	 */
+	struct Settings
+	{
+		int baudRate = 115200;  /**< 波特率。 */
+		int dataBits = 8;       /**< 数据位，5 到 8。 */
+		int stopBits = 1;       /**< 停止位，1 或 2（QSerialPort::TwoStop）。 */
+		int parity = 0;         /**< QSerialPort::Parity 的数值。 */
+	};
+
+	/**
+	 * @brief 单次 read 的最大字节数。
+	 */
+	static constexpr int kMaxRead = 64 * 1024;
+
+	using DataHandler = std::function<void(const QByteArray& data)>;
+	using ErrorHandler = std::function<void(const std::string& message)>;
+
+	NativeSerialPort() = default;
+	~NativeSerialPort();
+
+	NativeSerialPort(const NativeSerialPort&) = delete;
+	NativeSerialPort& operator=(const NativeSerialPort&) = delete;
+
+	/**
+	 * @brief 当前平台是否支持原生后端。
+	 */
+	static bool IsSupported();
+
+	/**
+	 * @brief 设置数据回调，在读取线程中调用。需要在 Open 之前设置。
+	 */
+	void SetDataHandler(DataHandler handler) { m_onData = std::move(handler); }
+
+	/**
+	 * @brief 设置错误回调（例如设备被拔出），在读取线程中调用，之后读取线程退出。
+	 */
+	void SetErrorHandler(ErrorHandler handler) { m_onError = std::move(handler); }
+
+	/**
+	 * @brief 打开并配置串口，启动读取线程。
+	 * @param name 设备名称，不以 '/' 开头时加上 /dev/。
+	 * @param settings 串口参数。
+	 * @throw std::runtime_error 如果打开或配置失败、参数不受支持或平台不支持。
+	 */
+	void Open(const std::string& name, const Settings& settings);
+
+	/**
+	 * @brief 停止读取线程并关闭串口。
+	 */
+	void Close();
+
+	bool IsOpen() const { return m_fd >= 0; }
+
+	/**
+	 * @brief 写出全部数据，写缓冲满时等待。可在任意线程调用，与 Close 互斥。
+	 * @throw std::runtime_error 如果串口未打开、写入出错或 1 秒内无法继续写入。
+	 */
+	void Write(const char* data, size_t length);
+
+	/**
+	 * @brief 累计读取的字节数。
+	 */
+	uint64_t ReadBytes() const { return m_readBytes.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief 累计的 read 调用次数，即交给回调的数据块数量。
+	 */
+	uint64_t ReadCalls() const { return m_readCalls.load(std::memory_order_relaxed); }
+
+private:
+	void Run();
+	void CloseDescriptors();
+
+	int m_fd = -1;                     /**< 串口文件描述符，打开和关闭时持有 m_writeMutex。 */
+	int m_epoll = -1;                  /**< epoll 实例。 */
+	int m_wake = -1;                   /**< 停止读取线程用的 eventfd。 */
+	std::thread m_thread;              /**< 读取线程。 */
+	std::mutex m_writeMutex;           /**< 串行化多个线程的写入，并与关闭串口互斥。 */
+	DataHandler m_onData;              /**< 数据回调。 */
+	ErrorHandler m_onError;            /**< 错误回调。 */
+	std::atomic<uint64_t> m_readBytes{ 0 }; /**< 累计读取的字节数。 */
+	std::atomic<uint64_t> m_readCalls{ 0 }; /**< 累计的 read 次数。 */
+};
@@ -0,0 +1,142 @@
+/*
+ * @Description: NMEA-0183 语句解码器，校验 *hh 校验和并把字段切分为片段
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 11:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "NmeaDecoder.h"
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+	/**
+	 * @brief 解析一个十六进制字符，非法字符返回 -1。
+	 */
+	int HexValue(char c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if (c >= 'A' && c <= 'F')
+			return c - 'A' + 10;
+		if (c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		return -1;
+	}
+
+	/**
+	 * @brief 把字段解析为数值，空字段或非数字字段返回 NaN。
+	 */
+	double ParseField(ByteSpan field)
+	{
+		double value = std::numeric_limits<double>::quiet_NaN();
+		if (!field.empty())
+		{
+			const char* end = field.data() + field.size();
+			auto result = std::from_chars(field.data(), end, value);
+			if (result.ec != std::errc() || result.ptr != end)
+			{
+				value = std::numeric_limits<double>::quiet_NaN();
+			}
+		}
+		return value;
+	}
+}
+
+/**
+ * @brief 构造函数。
+ * @param requireChecksum 是否要求语句必须带校验和。
+ */
+NmeaDecoder::NmeaDecoder(bool requireChecksum)
+	: m_framer(256), m_requireChecksum(requireChecksum)
+{
+}
+
+void NmeaDecoder::Feed(ByteSpan chunk, RecordSink& sink)
+{
+	m_framer.Feed(chunk.data(), chunk.size(), [this, &sink](ByteSpan line) { FeedLine(line, sink); });
+}
+
+void NmeaDecoder::Reset()
+{
+	m_framer.Reset();
+}
+
+/**
+ * @brief 解码一行 NMEA 语句。
+ * 空行和不以 '$'/'!' 开头的行（例如混在一起的调试输出）直接忽略，不计为错误。
+ */
+void NmeaDecoder::FeedLine(ByteSpan line, RecordSink& sink)
+{
+	while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+	{
+		line.remove_suffix(1);
+	}
+	if (line.empty() || (line.front() != '$' && line.front() != '!'))
+	{
+		return;
+	}
+
+	ByteSpan body = line.substr(1);
+	const size_t star = body.rfind('*');
+	if (star != ByteSpan::npos)
+	{
+		const ByteSpan checksum = body.substr(star + 1);
+		const int high = checksum.size() == 2 ? HexValue(checksum[0]) : -1;
+		const int low = checksum.size() == 2 ? HexValue(checksum[1]) : -1;
+		body = body.substr(0, star);
+		if (high < 0 || low < 0 || Checksum(body) != static_cast<unsigned char>(high * 16 + low))
+		{
+			++m_errorCount;
+			return;
+		}
+	}
+	else if (m_requireChecksum)
+	{
+		++m_errorCount;
+		return;
+	}
+
+	// 第一个字段是地址字段，其余字段依次放入暂存区
+	size_t comma = body.find(',');
+	DecodedRecord record;
+	record.kind = RecordKind::NmeaSentence;
+	record.name = body.substr(0, comma);
+	size_t count = 0;
+	while (comma != ByteSpan::npos)
+	{
+		if (count == kMaxFields)
+		{
+			++m_errorCount;
+			return;
+		}
+		const size_t begin = comma + 1;
+		comma = body.find(',', begin);
+		const ByteSpan field = body.substr(begin, comma == ByteSpan::npos ? ByteSpan::npos : comma - begin);
+		m_fields[count] = field;
+		m_values[count] = ParseField(field);
+		++count;
+	}
+
+	record.raw = line;
+	record.texts = m_fields;
+	record.values = m_values;
+	record.count = count;
+	++m_recordCount;
+	sink.OnRecord(record);
+}
+
+/**
+ * @brief 计算 '$' 与 '*' 之间所有字节的异或校验和。
+ */
+unsigned char NmeaDecoder::Checksum(ByteSpan body)
+{
+	unsigned char sum = 0;
+	for (char c : body)
+	{
+		sum ^= static_cast<unsigned char>(c);
+	}
+	return sum;
+}
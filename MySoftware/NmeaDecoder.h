@@ -0,0 +1,55 @@
+/*
+ * @Description: NMEA-0183 语句解码器，校验 *hh 校验和并把字段切分为片段
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 11:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include "LineFramer.h"
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief NmeaDecoder 解码以 '$' 或 '!' 开头、以 "*hh" 结尾的 NMEA-0183 语句。
+ *
+ * 记录的 name 为地址字段 (例如 "GPGGA")，texts 为其后各字段的原文片段，
+ * values 为对应的数值，空字段或非数字字段为 NaN。
+ * 校验和不匹配、缺少校验和（requireChecksum 为 true 时）或字段过多的语句计入错误并丢弃。
+ */
+class NmeaDecoder : public ProtocolDecoder
+{
+public:
+	/**
+	 * @brief 单条语句允许的最大字段数，超过时视为非法语句。
+	 */
+	static constexpr size_t kMaxFields = 64;
+
+	/**
+	 * @brief 构造函数。
+	 * @param requireChecksum 是否要求语句必须带校验和。
+	 */
+	explicit NmeaDecoder(bool requireChecksum = true);
+
+	const char* Name() const override { return "nmea"; }
+	void Feed(ByteSpan chunk, RecordSink& sink) override;
+	void Reset() override;
+	bool IsIdle() const override { return !m_framer.HasPartialLine(); }
+
+	/**
+	 * @brief 解码一行 NMEA 语句。
+	 * @param line 一行文本，可以带 '\r'。
+	 * @param sink 记录接收方。
+	 */
+	void FeedLine(ByteSpan line, RecordSink& sink);
+
+	/**
+	 * @brief 计算 '$' 与 '*' 之间所有字节的异或校验和。
+	 */
+	static unsigned char Checksum(ByteSpan body);
+
+private:
+	LineFramer m_framer;              /**< 行切分器。 */
+	bool m_requireChecksum;           /**< 是否要求校验和。 */
+	ByteSpan m_fields[kMaxFields];    /**< 字段片段暂存区。 */
+	double m_values[kMaxFields];      /**< 字段数值暂存区。 */
+};
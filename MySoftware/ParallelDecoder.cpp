@@ -0,0 +1,317 @@
+/*
+ * @Description: 大采集文件的多核离线解码，数据块并行解码后按顺序拼接，结果与顺序解码一致
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 21:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "ParallelDecoder.h"
+#include "CrashHandler.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @brief 块内的一个空闲位置：解码到 offset（行末）时解码器空闲，此时已有的输出长度和计数。
+	 */
+	struct SyncPoint
+	{
+		size_t offset;
+		size_t outputBytes;
+		uint64_t records;
+		uint64_t errors;
+	};
+
+	/**
+	 * @brief 一个数据块的解码结果。
+	 */
+	struct Chunk
+	{
+		size_t begin = 0;
+		size_t end = 0;
+		std::unique_ptr<ProtocolDecoder> decoder; /**< 解码完本块后的解码器。 */
+		std::string output;                       /**< 格式化后的输出。 */
+		std::vector<SyncPoint> syncs;             /**< 块开头的空闲位置，按 offset 递增。 */
+		bool done = false;                        /**< 由 ParallelDecoder::Run 中的互斥量保护。 */
+	};
+
+	/**
+	 * @brief 每个线程一个队列的任务分配。线程取自己队列的队首，空了再窃取其他队列的队首，
+	 * 取最早的数据块而不是最晚的，使各线程的进度都靠近写出位置。
+	 */
+	class WorkQueues
+	{
+	public:
+		explicit WorkQueues(unsigned threads)
+			: m_queues(threads)
+		{
+		}
+
+		void Push(unsigned thread, size_t item)
+		{
+			Queue& queue = m_queues[thread];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.items.push_back(item);
+		}
+
+		/**
+		 * @brief 取下一个数据块。
+		 * @param stolen 是否来自其他线程的队列。
+		 * @return 是否取到。
+		 */
+		bool Pop(unsigned thread, size_t& item, bool& stolen)
+		{
+			const unsigned count = static_cast<unsigned>(m_queues.size());
+			for (unsigned i = 0; i < count; ++i)
+			{
+				Queue& queue = m_queues[(thread + i) % count];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.items.empty())
+				{
+					item = queue.items.front();
+					queue.items.pop_front();
+					stolen = i != 0;
+					return true;
+				}
+			}
+			return false;
+		}
+
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<size_t> items;
+		};
+		std::vector<Queue> m_queues;
+	};
+
+	/**
+	 * @brief 返回 pos 所在行的行末之后的位置，没有换行时返回 end。
+	 */
+	size_t NextLine(const char* data, size_t pos, size_t end)
+	{
+		const void* newline = std::memchr(data + pos, '\n', end - pos);
+		return newline == nullptr ? end : static_cast<size_t>(static_cast<const char*>(newline) - data) + 1;
+	}
+}
+
+ParallelDecoder::ParallelDecoder(Factory factory, unsigned threads, size_t chunkBytes)
+	: m_factory(std::move(factory)),
+	m_threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+	m_chunkBytes(std::max<size_t>(chunkBytes, 4096))
+{
+}
+
+void ParallelDecoder::FormatLine(const DecodedRecord& record, std::string& out)
+{
+	out.append(FormatRecord(record, ","));
+	out.push_back('\n');
+}
+
+/**
+ * @brief 并行解码并按顺序拼接。
+ *
+ * 1. 以 m_chunkBytes 为间隔切分，每个边界移到其后第一个换行之后。
+ * 2. 工作线程解码数据块：除第一块外，先逐行解码并在每个空闲的行末记录 SyncPoint，
+ *    记满 kMaxSyncPoints 个后把剩余部分一次交给解码器。
+ * 3. 调用线程按顺序等待各块完成，用上一块的解码器接续解码本块开头，
+ *    在第一个两者都空闲的行末汇合，拼接后写出并释放上一块。
+ */
+ParallelDecodeResult ParallelDecoder::Run(ByteSpan data, const Formatter& format, const Writer& write)
+{
+	const auto start = std::chrono::steady_clock::now();
+	ParallelDecodeResult result;
+	result.bytes = data.size();
+	result.threads = m_threads;
+
+	std::vector<Chunk> chunks;
+	for (size_t begin = 0; begin < data.size();)
+	{
+		const size_t target = std::min(data.size(), begin + m_chunkBytes);
+		const size_t end = target >= data.size() ? data.size() : NextLine(data.data(), target, data.size());
+		chunks.emplace_back();
+		chunks.back().begin = begin;
+		chunks.back().end = end;
+		begin = end;
+	}
+	result.chunks = chunks.size();
+	if (chunks.empty())
+	{
+		return result;
+	}
+
+	WorkQueues queues(m_threads);
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		queues.Push(static_cast<unsigned>(i % m_threads), i);
+	}
+
+	std::mutex mutex;
+	std::condition_variable chunkDone;
+	std::condition_variable windowMoved;
+	size_t written = 0;
+	std::atomic<uint64_t> steals{ 0 };
+	const size_t window = static_cast<size_t>(m_threads) * kWindowPerThread;
+
+	auto decodeChunk = [&](Chunk& chunk, bool first) {
+		TRACE_ZONE("ParallelDecoder::DecodeChunk");
+		chunk.decoder = m_factory();
+		ProtocolDecoder& decoder = *chunk.decoder;
+		auto sink = MakeRecordSink([&chunk, &format](const DecodedRecord& record) { format(record, chunk.output); });
+
+		size_t pos = chunk.begin;
+		if (!first)
+		{
+			chunk.syncs.push_back(SyncPoint{ pos, 0, 0, 0 });
+			while (pos < chunk.end && chunk.syncs.size() < kMaxSyncPoints)
+			{
+				const size_t next = NextLine(data.data(), pos, chunk.end);
+				decoder.Feed(data.substr(pos, next - pos), sink);
+				pos = next;
+				if (decoder.IsIdle())
+				{
+					chunk.syncs.push_back(SyncPoint{ pos, chunk.output.size(), decoder.RecordCount(), decoder.ErrorCount() });
+				}
+			}
+		}
+		if (pos < chunk.end)
+		{
+			decoder.Feed(data.substr(pos, chunk.end - pos), sink);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < m_threads; ++t)
+	{
+		workers.emplace_back([&, t]() {
+			TraceRecorder::SetThreadName(("decode " + std::to_string(t)).c_str());
+			CrashHandler::InstallThreadStack();
+			size_t index = 0;
+			bool stolen = false;
+			while (queues.Pop(t, index, stolen))
+			{
+				steals += stolen ? 1 : 0;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					windowMoved.wait(lock, [&]() { return index < written + window; });
+				}
+				decodeChunk(chunks[index], index == 0);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					chunks[index].done = true;
+				}
+				chunkDone.notify_all();
+			}
+			});
+	}
+
+	std::string fixed;
+	for (size_t k = 0; k < chunks.size(); ++k)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			chunkDone.wait(lock, [&]() { return chunks[k].done; });
+		}
+		Chunk& chunk = chunks[k];
+		if (k == 0)
+		{
+			write(chunk.output);
+			result.records += chunk.decoder->RecordCount();
+			result.errors += chunk.decoder->ErrorCount();
+		}
+		else
+		{
+			// 上一块结束时的解码器状态就是顺序解码在本块起点的状态
+			std::unique_ptr<ProtocolDecoder> sequential = std::move(chunks[k - 1].decoder);
+			const uint64_t records = sequential->RecordCount();
+			const uint64_t errors = sequential->ErrorCount();
+			fixed.clear();
+			auto sink = MakeRecordSink([&fixed, &format](const DecodedRecord& record) { format(record, fixed); });
+
+			size_t pos = chunk.begin;
+			size_t sync = 0;
+			bool merged = false;
+			while (sync < chunk.syncs.size())
+			{
+				if (chunk.syncs[sync].offset == pos && sequential->IsIdle())
+				{
+					merged = true;
+					break;
+				}
+				if (chunk.syncs[sync].offset <= pos)
+				{
+					++sync;
+					continue;
+				}
+				const size_t next = NextLine(data.data(), pos, chunk.end);
+				sequential->Feed(data.substr(pos, next - pos), sink);
+				++result.resyncLines;
+				pos = next;
+			}
+
+			result.resyncedChunks += pos != chunk.begin ? 1 : 0;
+			if (merged)
+			{
+				const SyncPoint& point = chunk.syncs[sync];
+				write(fixed);
+				write(chunk.output.substr(point.outputBytes));
+				result.records += sequential->RecordCount() - records + chunk.decoder->RecordCount() - point.records;
+				result.errors += sequential->ErrorCount() - errors + chunk.decoder->ErrorCount() - point.errors;
+			}
+			else
+			{
+				// 记录的空闲位置里没有汇合点，本块剩余部分按顺序解码，下一块从这个解码器接续
+				++result.fallbackChunks;
+				if (pos < chunk.end)
+				{
+					sequential->Feed(data.substr(pos, chunk.end - pos), sink);
+				}
+				write(fixed);
+				result.records += sequential->RecordCount() - records;
+				result.errors += sequential->ErrorCount() - errors;
+				chunk.decoder = std::move(sequential);
+			}
+		}
+
+		std::string().swap(chunk.output);
+		std::vector<SyncPoint>().swap(chunk.syncs);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			written = k + 1;
+		}
+		windowMoved.notify_all();
+	}
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	result.steals = steals.load();
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+std::string ParallelDecoder::Format(const ParallelDecodeResult& result)
+{
+	char text[320];
+	std::snprintf(text, sizeof(text),
+		"%llu bytes, %llu records, %llu errors, %zu chunks on %u threads (%llu stolen), "
+		"%zu resynced (%llu lines), %zu sequential fallbacks, %.3f s, %.1f MB/s",
+		static_cast<unsigned long long>(result.bytes), static_cast<unsigned long long>(result.records),
+		static_cast<unsigned long long>(result.errors), result.chunks, result.threads,
+		static_cast<unsigned long long>(result.steals), result.resyncedChunks,
+		static_cast<unsigned long long>(result.resyncLines), result.fallbackChunks, result.seconds,
+		result.seconds > 0 ? result.bytes / result.seconds / 1e6 : 0.0);
+	return text;
+}
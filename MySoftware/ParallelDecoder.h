@@ -0,0 +1,93 @@
+/*
+ * @Description: 大采集文件的多核离线解码，数据块并行解码后按顺序拼接，结果与顺序解码一致
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 21:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief 一次离线解码的统计。
+ */
+struct ParallelDecodeResult
+{
+	uint64_t bytes = 0;          /**< 输入字节数。 */
+	uint64_t records = 0;        /**< 输出的记录数。 */
+	uint64_t errors = 0;         /**< 错误计数。 */
+	size_t chunks = 0;           /**< 数据块数量。 */
+	unsigned threads = 0;        /**< 工作线程数。 */
+	size_t resyncedChunks = 0;   /**< 起点处顺序解码不空闲、需要接续校正的数据块数量。 */
+	uint64_t resyncLines = 0;    /**< 接续校正时重新解码的行数。 */
+	size_t fallbackChunks = 0;   /**< 没有找到汇合点、整块顺序重新解码的数据块数量。 */
+	uint64_t steals = 0;         /**< 从其他线程队列中取走的数据块数量。 */
+	double seconds = 0.0;        /**< 耗时（秒）。 */
+};
+
+/**
+ * @brief ParallelDecoder 把一整段内存（通常是映射的采集文件）切成数据块，在多个线程上解码。
+ *
+ * 数据块边界对齐到换行之后，每块由一个新建的解码器从空闲状态开始解码，输出格式化为文本暂存。
+ * 顺序解码在块边界处未必空闲（例如 PID 帧跨越了边界），因此拼接时用上一块结束时的解码器
+ * 逐行接着解码本块，直到它与本块的解码器在同一行末尾都处于空闲状态（ProtocolDecoder::IsIdle），
+ * 此后两者状态相同，本块其余的输出可以直接使用。工作线程在每块开头记录最多 kMaxSyncPoints 个空闲位置，
+ * 找不到汇合点时整块按顺序重新解码，所以输出总是与顺序解码逐字节相同。
+ *
+ * 数据块按轮转分配到各线程的队列，线程先取自己队列的队首，空了再从其他队列的队首窃取；
+ * 已解码但尚未写出的数据块不超过线程数的 kWindowPerThread 倍，输出缓冲的内存与文件大小无关。
+ */
+class ParallelDecoder
+{
+public:
+	/**
+	 * @brief 每块开头记录的空闲位置数量上限。
+	 */
+	static constexpr size_t kMaxSyncPoints = 64;
+
+	/**
+	 * @brief 每个线程允许领先写出位置的数据块数量。
+	 */
+	static constexpr size_t kWindowPerThread = 4;
+
+	using Factory = std::function<std::unique_ptr<ProtocolDecoder>()>;
+	using Formatter = std::function<void(const DecodedRecord& record, std::string& out)>;
+	using Writer = std::function<void(const std::string& text)>;
+
+	/**
+	 * @brief 构造函数。
+	 * @param factory 创建解码器，每个数据块调用一次，可能在任意工作线程中调用。
+	 * @param threads 工作线程数，0 表示使用硬件线程数。
+	 * @param chunkBytes 数据块的目标大小。
+	 */
+	explicit ParallelDecoder(Factory factory, unsigned threads = 0, size_t chunkBytes = size_t(8) << 20);
+
+	/**
+	 * @brief 解码 data，按原始顺序把每块的输出交给 writer。
+	 * @param data 输入数据，解码期间必须保持有效。
+	 * @param format 把一条记录追加为文本，在工作线程中调用，不能依赖共享状态。
+	 * @param write 接收按顺序拼接的输出，在调用 Run 的线程中调用。
+	 * @return 统计信息。
+	 */
+	ParallelDecodeResult Run(ByteSpan data, const Formatter& format, const Writer& write);
+
+	/**
+	 * @brief 默认的记录格式：FormatRecord(record, ",") 加换行。
+	 */
+	static void FormatLine(const DecodedRecord& record, std::string& out);
+
+	/**
+	 * @brief 把统计信息格式化为一行文本。
+	 */
+	static std::string Format(const ParallelDecodeResult& result);
+
+private:
+	Factory m_factory;    /**< 解码器工厂。 */
+	unsigned m_threads;   /**< 工作线程数。 */
+	size_t m_chunkBytes;  /**< 数据块目标大小。 */
+};
@@ -0,0 +1,179 @@
+/*
+ * @Description: PID 参数表格模型，支持任意数量的控制器并按行范围批量通知视图
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 15:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "PidTableModel.h"
+#include <algorithm>
+
+PidTableModel::PidTableModel(QObject* parent)
+	: QAbstractTableModel(parent)
+{
+}
+
+void PidTableModel::SetHeaders(std::vector<QString> headers)
+{
+	beginResetModel();
+	m_headers = std::move(headers);
+	m_rows.clear();
+	m_rowOfHeader.assign(m_headers.size(), -1);
+	m_anyDirty = false;
+	endResetModel();
+}
+
+void PidTableModel::Clear()
+{
+	beginResetModel();
+	m_rows.clear();
+	std::fill(m_rowOfHeader.begin(), m_rowOfHeader.end(), -1);
+	m_anyDirty = false;
+	endResetModel();
+}
+
+/**
+ * @brief 更新一个控制器的参数。
+ * 第一次出现的控制器会立即插入新行，插入很少发生，之后的更新只修改数据。
+ */
+bool PidTableModel::Update(size_t headerIndex, const double* values, size_t count)
+{
+	if (headerIndex >= m_headers.size())
+	{
+		return false;
+	}
+
+	int row = m_rowOfHeader[headerIndex];
+	if (row < 0)
+	{
+		row = InsertRow(headerIndex);
+	}
+
+	Row& target = m_rows[static_cast<size_t>(row)];
+	const size_t n = std::min<size_t>(count, 3);
+	std::copy(values, values + n, target.values);
+	++target.frames;
+	target.dirty = true;
+	m_anyDirty = true;
+	return true;
+}
+
+/**
+ * @brief 对更新过的行发出 dataChanged，只覆盖数值列。
+ */
+void PidTableModel::Flush()
+{
+	if (!m_anyDirty)
+	{
+		return;
+	}
+	m_anyDirty = false;
+
+	const int rows = static_cast<int>(m_rows.size());
+	int first = -1;
+	for (int row = 0; row <= rows; ++row)
+	{
+		const bool dirty = row < rows && m_rows[static_cast<size_t>(row)].dirty;
+		if (dirty)
+		{
+			m_rows[static_cast<size_t>(row)].dirty = false;
+			if (first < 0)
+			{
+				first = row;
+			}
+		}
+		else if (first >= 0)
+		{
+			emit dataChanged(index(first, KpColumn), index(row - 1, FramesColumn), { Qt::DisplayRole });
+			first = -1;
+		}
+	}
+}
+
+int PidTableModel::InsertRow(size_t headerIndex)
+{
+	auto position = std::lower_bound(m_rows.begin(), m_rows.end(), headerIndex,
+		[](const Row& row, size_t value) { return row.headerIndex < value; });
+	const int row = static_cast<int>(std::distance(m_rows.begin(), position));
+
+	beginInsertRows(QModelIndex(), row, row);
+	m_rows.insert(position, Row{ headerIndex, { 0.0, 0.0, 0.0 }, 0, false });
+	for (size_t i = static_cast<size_t>(row); i < m_rows.size(); ++i)
+	{
+		m_rowOfHeader[m_rows[i].headerIndex] = static_cast<int>(i);
+	}
+	endInsertRows();
+	return row;
+}
+
+int PidTableModel::rowCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+}
+
+int PidTableModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant PidTableModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= static_cast<int>(m_rows.size()))
+	{
+		return QVariant();
+	}
+	const Row& row = m_rows[static_cast<size_t>(index.row())];
+
+	if (role == Qt::TextAlignmentRole)
+	{
+		return index.column() == NameColumn
+			? QVariant(int(Qt::AlignLeft | Qt::AlignVCenter))
+			: QVariant(int(Qt::AlignRight | Qt::AlignVCenter));
+	}
+	if (role != Qt::DisplayRole)
+	{
+		return QVariant();
+	}
+
+	switch (index.column())
+	{
+	case NameColumn:
+		return m_headers[row.headerIndex];
+	case KpColumn:
+	case KiColumn:
+	case KdColumn:
+		return QString::number(row.values[index.column() - KpColumn]);
+	case FramesColumn:
+		return row.frames;
+	default:
+		return QVariant();
+	}
+}
+
+QVariant PidTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (role != Qt::DisplayRole)
+	{
+		return QVariant();
+	}
+	if (orientation == Qt::Vertical)
+	{
+		return section + 1;
+	}
+
+	switch (section)
+	{
+	case NameColumn:
+		return "Header";
+	case KpColumn:
+		return "P";
+	case KiColumn:
+		return "I";
+	case KdColumn:
+		return "D";
+	case FramesColumn:
+		return "Frames";
+	default:
+		return QVariant();
+	}
+}
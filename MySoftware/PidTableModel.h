@@ -0,0 +1,93 @@
+/*
+ * @Description: PID 参数表格模型，支持任意数量的控制器并按行范围批量通知视图
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 15:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QString>
+#include <vector>
+
+/**
+ * @brief PidTableModel 以表格形式保存每个控制器的最新 PID 参数。
+ *
+ * 每个帧头对应一个控制器，收到该帧头的第一帧时才插入对应的行，行按帧头顺序排列。
+ * Update 只修改数据并记录脏行，不通知视图；Flush 把连续的脏行合并成区间，
+ * 每个区间发出一次 dataChanged，由界面刷新时钟定期调用。
+ * 因此视图的重绘次数只与刷新频率有关，与控制器数量和帧率无关。
+ */
+class PidTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	/**
+	 * @brief 表格列。
+	 */
+	enum Column
+	{
+		NameColumn,   /**< 帧头名称。 */
+		KpColumn,     /**< 比例系数。 */
+		KiColumn,     /**< 积分系数。 */
+		KdColumn,     /**< 微分系数。 */
+		FramesColumn, /**< 收到的帧数。 */
+		ColumnCount
+	};
+
+	explicit PidTableModel(QObject* parent = nullptr);
+
+	/**
+	 * @brief 设置帧头列表并清空所有行。
+	 * @param headers 帧头列表，下标与 DecodedRecord::index 一致。
+	 */
+	void SetHeaders(std::vector<QString> headers);
+
+	/**
+	 * @brief 更新一个控制器的参数，不立即通知视图。
+	 * @param headerIndex 帧头序号。
+	 * @param values 数值，依次为 Kp、Ki、Kd。
+	 * @param count 数值个数，超过 3 个时忽略多余部分。
+	 * @return 帧头序号有效时返回 true。
+	 */
+	bool Update(size_t headerIndex, const double* values, size_t count);
+
+	/**
+	 * @brief 对自上次调用以来更新过的行发出 dataChanged，连续的行合并为一个区间。
+	 */
+	void Flush();
+
+	/**
+	 * @brief 清空所有行，保留帧头列表。
+	 */
+	void Clear();
+
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+	/**
+	 * @brief 一行数据。
+	 */
+	struct Row
+	{
+		size_t headerIndex;  /**< 帧头序号。 */
+		double values[3];    /**< Kp、Ki、Kd。 */
+		quint64 frames;      /**< 收到的帧数。 */
+		bool dirty;          /**< 自上次 Flush 以来是否更新过。 */
+	};
+
+	/**
+	 * @brief 按帧头序号有序插入一行。
+	 * @return 新行的行号。
+	 */
+	int InsertRow(size_t headerIndex);
+
+	std::vector<QString> m_headers; /**< 帧头列表。 */
+	std::vector<Row> m_rows;        /**< 已出现的控制器，按帧头序号排列。 */
+	std::vector<int> m_rowOfHeader; /**< 帧头序号到行号的映射，-1 表示尚未出现。 */
+	bool m_anyDirty = false;        /**< 是否有脏行。 */
+};
@@ -0,0 +1,153 @@
+/*
+ * @Description: 协议解码器登记表与通用格式化函数
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 11:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "ProtocolDecoder.h"
+#include "FrameDecoder.h"
+#include "NmeaDecoder.h"
+#include "KeyValueDecoder.h"
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief 获取全局唯一的登记表。
+ */
+std::vector<std::string> DefaultPidHeaders()
+{
+	std::vector<std::string> headers;
+	headers.reserve(kMaxPidControllers);
+	for (int i = 1; i <= kMaxPidControllers; ++i)
+	{
+		headers.push_back("START" + std::to_string(i));
+	}
+	return headers;
+}
+
+DecoderRegistry& DecoderRegistry::Instance()
+{
+	static DecoderRegistry registry;
+	return registry;
+}
+
+/**
+ * @brief 构造函数，登记内置解码器。
+ */
+DecoderRegistry::DecoderRegistry()
+{
+	Register("pid", "START/float/END text frames", [](const DecoderOptions& options) {
+		return std::make_unique<FrameDecoder>(options.headers, options.endFrame);
+		});
+	Register("nmea", "NMEA-0183 sentences with checksum validation", [](const DecoderOptions& options) {
+		return std::make_unique<NmeaDecoder>(options.requireNmeaChecksum);
+		});
+	Register("kv", "Line-delimited key=value pairs", [](const DecoderOptions&) {
+		return std::make_unique<KeyValueDecoder>();
+		});
+}
+
+/**
+ * @brief 登记一个解码器，同名登记会覆盖之前的工厂。
+ */
+void DecoderRegistry::Register(const std::string& name, const std::string& description, Factory factory)
+{
+	for (Entry& entry : m_entries)
+	{
+		if (entry.name == name)
+		{
+			entry.description = description;
+			entry.factory = std::move(factory);
+			return;
+		}
+	}
+	m_entries.push_back(Entry{ name, description, std::move(factory) });
+}
+
+/**
+ * @brief 按名称创建解码器。
+ * @throw std::invalid_argument 如果名称没有登记。
+ */
+std::unique_ptr<ProtocolDecoder> DecoderRegistry::Create(const std::string& name, const DecoderOptions& options) const
+{
+	for (const Entry& entry : m_entries)
+	{
+		if (entry.name == name)
+		{
+			return entry.factory(options);
+		}
+	}
+	throw std::invalid_argument("Unknown protocol decoder: " + name);
+}
+
+/**
+ * @brief 已登记的解码器名称，按登记顺序排列。
+ */
+std::vector<std::string> DecoderRegistry::Names() const
+{
+	std::vector<std::string> names;
+	names.reserve(m_entries.size());
+	for (const Entry& entry : m_entries)
+	{
+		names.push_back(entry.name);
+	}
+	return names;
+}
+
+/**
+ * @brief 解码器的说明文字。
+ */
+bool DecoderRegistry::Contains(const std::string& name) const
+{
+	for (const Entry& entry : m_entries)
+	{
+		if (entry.name == name)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+std::string DecoderRegistry::Description(const std::string& name) const
+{
+	for (const Entry& entry : m_entries)
+	{
+		if (entry.name == name)
+		{
+			return entry.description;
+		}
+	}
+	return std::string();
+}
+
+/**
+ * @brief 把记录格式化为一行文本。
+ * 有原文的字段直接输出原文，否则按 %g 输出数值；key=value 记录输出为 key=value。
+ */
+std::string FormatRecord(const DecodedRecord& record, std::string_view separator)
+{
+	std::string text(record.name);
+	for (size_t i = 0; i < record.count; ++i)
+	{
+		if (!text.empty())
+		{
+			text.append(separator);
+		}
+		if (record.keys != nullptr)
+		{
+			text.append(record.keys[i]);
+			text.push_back('=');
+		}
+		if (record.texts != nullptr)
+		{
+			text.append(record.texts[i]);
+		}
+		else
+		{
+			text.append(FrameDecoder::FormatValue(static_cast<float>(record.values[i])));
+		}
+	}
+	return text;
+}
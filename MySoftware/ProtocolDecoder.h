@@ -0,0 +1,220 @@
+/*
+ * @Description: 协议解码器插件接口，解码器直接在接收缓冲区的字节片段上工作并输出类型化记录
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 11:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 指向接收缓冲区内一段连续字节的只读视图，不持有数据。
+ */
+using ByteSpan = std::string_view;
+
+/**
+ * @brief 解码记录的类型。
+ */
+enum class RecordKind
+{
+	PidFrame,     /**< START/数据/END 帧，values 为 Kp、Ki、Kd。 */
+	NmeaSentence, /**< NMEA-0183 语句，texts 为各字段原文。 */
+	KeyValue      /**< 一行 key=value 列表，keys 为键名。 */
+};
+
+/**
+ * @brief 解码器输出的一条类型化记录。
+ *
+ * 所有 ByteSpan 和数组指针都指向接收缓冲区或解码器内部的暂存区，
+ * 只在 RecordSink::OnRecord 回调期间有效，需要保留时由接收方自行拷贝。
+ */
+struct DecodedRecord
+{
+	RecordKind kind = RecordKind::PidFrame; /**< 记录类型。 */
+	size_t index = 0;              /**< PID 帧的帧头下标，其他协议为 0。 */
+	ByteSpan name;                 /**< 帧头、NMEA 语句类型，key=value 记录为空。 */
+	ByteSpan raw;                  /**< 产生该记录的最后一行原文。 */
+	const ByteSpan* keys = nullptr;  /**< 每个值对应的键名，仅 key=value 记录有效。 */
+	const ByteSpan* texts = nullptr; /**< 每个值的原文，PID 帧为 nullptr。 */
+	const double* values = nullptr;  /**< 数值，无法解析为数字的字段为 NaN。 */
+	size_t count = 0;              /**< 值的个数，keys/texts 与 values 等长。 */
+};
+
+/**
+ * @brief 解码记录的接收方。
+ */
+class RecordSink
+{
+public:
+	virtual ~RecordSink() = default;
+	/**
+	 * @brief 收到一条解码记录。
+	 * @param record 解码记录，仅在回调期间有效。
+	 */
+	virtual void OnRecord(const DecodedRecord& record) = 0;
+};
+
+/**
+ * @brief 把任意可调用对象包装为 RecordSink。
+ */
+template <typename Callback>
+class CallbackSink : public RecordSink
+{
+public:
+	explicit CallbackSink(Callback callback) : m_callback(std::move(callback)) {}
+	void OnRecord(const DecodedRecord& record) override { m_callback(record); }
+
+private:
+	Callback m_callback;
+};
+
+template <typename Callback>
+CallbackSink<Callback> MakeRecordSink(Callback callback)
+{
+	return CallbackSink<Callback>(std::move(callback));
+}
+
+/**
+ * @brief 协议解码器接口。
+ *
+ * Feed() 接收的是接收缓冲区中的一段连续字节，解码器不拷贝完整落在片段内的数据，
+ * 只在帧跨越片段边界时暂存不完整的部分。解码器是有状态的，每个串口各自持有一个实例。
+ */
+class ProtocolDecoder
+{
+public:
+	virtual ~ProtocolDecoder() = default;
+
+	/**
+	 * @brief 解码器名称，与 DecoderRegistry 中注册的名称一致。
+	 */
+	virtual const char* Name() const = 0;
+
+	/**
+	 * @brief 输入一段接收到的字节，解出的记录依次交给 sink。
+	 * @param chunk 接收缓冲区中的一段连续字节。
+	 * @param sink 记录接收方。
+	 */
+	virtual void Feed(ByteSpan chunk, RecordSink& sink) = 0;
+
+	/**
+	 * @brief 丢弃半帧，回到初始状态。
+	 */
+	virtual void Reset() = 0;
+
+	/**
+	 * @brief 解码器是否处于与刚创建时等价的状态：没有半行、没有正在接收的帧。
+	 * 离线并行解码据此判断从某个位置起各数据块的结果与顺序解码一致，
+	 * 无法判断的解码器返回 false，并行解码会退回到顺序解码这些数据块。
+	 */
+	virtual bool IsIdle() const { return false; }
+
+	/**
+	 * @brief 已输出的记录数。
+	 */
+	uint64_t RecordCount() const { return m_recordCount; }
+	/**
+	 * @brief 被丢弃的非法行或字段数。
+	 */
+	uint64_t ErrorCount() const { return m_errorCount; }
+
+protected:
+	uint64_t m_recordCount = 0; /**< 已输出的记录数。 */
+	uint64_t m_errorCount = 0;  /**< 错误计数。 */
+};
+
+/**
+ * @brief START/数据/END 协议支持的最大控制器数量，帧头依次为 START1 到 START64。
+ */
+constexpr int kMaxPidControllers = 64;
+
+/**
+ * @brief 默认的 PID 帧头列表 START1 到 START<kMaxPidControllers>。
+ * 界面和命令行的默认值都由此生成，两者在默认参数下接受相同的帧。
+ */
+std::vector<std::string> DefaultPidHeaders();
+
+/**
+ * @brief 创建解码器时使用的参数，各解码器只读取自己关心的字段。
+ */
+struct DecoderOptions
+{
+	std::vector<std::string> headers = DefaultPidHeaders(); /**< PID 帧的合法帧头。 */
+	std::string endFrame = "END";     /**< PID 帧的帧尾。 */
+	bool requireNmeaChecksum = true;  /**< NMEA 语句是否必须带校验和。 */
+};
+
+/**
+ * @brief DecoderRegistry 按名称登记和创建解码器。
+ *
+ * 内置解码器 pid、nmea、kv 在第一次访问时登记，
+ * 其他协议可以调用 Register() 加入，之后即可在界面和命令行中按名称选择。
+ */
+class DecoderRegistry
+{
+public:
+	using Factory = std::function<std::unique_ptr<ProtocolDecoder>(const DecoderOptions&)>;
+
+	/**
+	 * @brief 获取全局唯一的登记表。
+	 */
+	static DecoderRegistry& Instance();
+
+	/**
+	 * @brief 登记一个解码器，同名登记会覆盖之前的工厂。
+	 * @param name 解码器名称。
+	 * @param description 简短说明。
+	 * @param factory 创建函数。
+	 */
+	void Register(const std::string& name, const std::string& description, Factory factory);
+
+	/**
+	 * @brief 按名称创建解码器。
+	 * @param name 解码器名称。
+	 * @param options 创建参数。
+	 * @return 新的解码器实例。
+	 * @throw std::invalid_argument 如果名称没有登记。
+	 */
+	std::unique_ptr<ProtocolDecoder> Create(const std::string& name, const DecoderOptions& options = {}) const;
+
+	/**
+	 * @brief 已登记的解码器名称，按登记顺序排列。
+	 */
+	std::vector<std::string> Names() const;
+
+	/**
+	 * @brief 名称是否已经登记。
+	 */
+	bool Contains(const std::string& name) const;
+
+	/**
+	 * @brief 解码器的说明文字，名称不存在时返回空字符串。
+	 */
+	std::string Description(const std::string& name) const;
+
+private:
+	DecoderRegistry();
+
+	struct Entry
+	{
+		std::string name;        /**< 解码器名称。 */
+		std::string description; /**< 说明文字。 */
+		Factory factory;         /**< 创建函数。 */
+	};
+	std::vector<Entry> m_entries; /**< 已登记的解码器。 */
+};
+
+/**
+ * @brief 把记录格式化为一行文本：名称后依次是各字段，key=value 记录输出为 key=value。
+ * @param record 解码记录。
+ * @param separator 字段分隔符。
+ * @return 格式化后的文本。
+ */
+std::string FormatRecord(const DecodedRecord& record, std::string_view separator);
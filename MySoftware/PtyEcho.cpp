@@ -0,0 +1,131 @@
+/*
+ * @Description: 伪终端回显桩，没有硬件时代替设备把收到的数据原样发回
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 17:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "PtyEcho.h"
+#include "CrashHandler.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#define MYSOFTWARE_HAVE_PTY 1
+#endif
+
+PtyEcho::~PtyEcho()
+{
+	Stop();
+}
+
+/**
+ * @brief 创建伪终端并启动回显线程。
+ * 从端设置为原始模式，避免行规程回显或转换换行符，干扰延迟测量。
+ */
+void PtyEcho::Start(int delayUs)
+{
+	Stop();
+#ifdef MYSOFTWARE_HAVE_PTY
+	m_master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0)
+	{
+		const int error = errno;
+		Stop();
+		throw std::runtime_error(std::string("Failed to create pty: ") + std::strerror(error));
+	}
+	m_slavePath = ptsname(m_master);
+
+	m_slaveHold = open(m_slavePath.c_str(), O_RDWR | O_NOCTTY);
+	if (m_slaveHold >= 0)
+	{
+		termios options;
+		if (tcgetattr(m_slaveHold, &options) == 0)
+		{
+			cfmakeraw(&options);
+			tcsetattr(m_slaveHold, TCSANOW, &options);
+		}
+	}
+
+	m_delayUs = delayUs;
+	m_stop.store(false);
+	m_echoed.store(0);
+	m_thread = std::thread(&PtyEcho::Run, this);
+#else
+	(void)delayUs;
+	throw std::runtime_error("The pty echo stand-in requires POSIX ptys.");
+#endif
+}
+
+void PtyEcho::Stop()
+{
+	m_stop.store(true);
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+#ifdef MYSOFTWARE_HAVE_PTY
+	if (m_slaveHold >= 0)
+	{
+		close(m_slaveHold);
+	}
+	if (m_master >= 0)
+	{
+		close(m_master);
+	}
+#endif
+	m_slaveHold = -1;
+	m_master = -1;
+	m_slavePath.clear();
+}
+
+/**
+ * @brief 回显线程：等待主端可读，读出的数据按需延迟后原样写回。
+ * poll 使用 100 ms 超时，以便及时响应停止标志。
+ */
+void PtyEcho::Run()
+{
+#ifdef MYSOFTWARE_HAVE_PTY
+	CrashHandler::InstallThreadStack();
+	char buffer[4096];
+	while (!m_stop.load())
+	{
+		pollfd descriptor{ m_master, POLLIN, 0 };
+		const int ready = poll(&descriptor, 1, 100);
+		if (ready <= 0 || !(descriptor.revents & POLLIN))
+		{
+			continue;
+		}
+		const ssize_t length = read(m_master, buffer, sizeof(buffer));
+		if (length <= 0)
+		{
+			continue;
+		}
+		if (m_delayUs > 0)
+		{
+			usleep(static_cast<useconds_t>(m_delayUs));
+		}
+		ssize_t written = 0;
+		while (written < length)
+		{
+			const ssize_t result = write(m_master, buffer + written, static_cast<size_t>(length - written));
+			if (result < 0)
+			{
+				if (errno == EINTR || errno == EAGAIN)
+				{
+					continue;
+				}
+				break;
+			}
+			written += result;
+		}
+		m_echoed.fetch_add(static_cast<uint64_t>(written > 0 ? written : 0), std::memory_order_relaxed);
+	}
+#endif
+}
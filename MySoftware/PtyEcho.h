@@ -0,0 +1,61 @@
+/*
+ * @Description: 伪终端回显桩，没有硬件时代替设备把收到的数据原样发回
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 17:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/**
+ * @brief PtyEcho 创建一对伪终端，在后台线程中把写入从端的数据原样写回。
+ *
+ * 串口程序打开 SlavePath() 即可像连接了一个回显设备一样工作，
+ * 可选的固定延迟用来模拟设备的处理时间。仅支持 POSIX 系统，其他平台上 Start 抛出异常。
+ */
+class PtyEcho
+{
+public:
+	PtyEcho() = default;
+	~PtyEcho();
+
+	PtyEcho(const PtyEcho&) = delete;
+	PtyEcho& operator=(const PtyEcho&) = delete;
+
+	/**
+	 * @brief 创建伪终端并启动回显线程。
+	 * @param delayUs 每次回显前的延迟（微秒）。
+	 * @throw std::runtime_error 如果创建伪终端失败或平台不支持。
+	 */
+	void Start(int delayUs = 0);
+
+	/**
+	 * @brief 停止回显线程并关闭伪终端。
+	 */
+	void Stop();
+
+	/**
+	 * @brief 从端设备路径，例如 /dev/pts/3。
+	 */
+	const std::string& SlavePath() const { return m_slavePath; }
+
+	/**
+	 * @brief 回显的字节数。
+	 */
+	uint64_t EchoedBytes() const { return m_echoed.load(std::memory_order_relaxed); }
+
+private:
+	void Run();
+
+	int m_master = -1;                 /**< 主端文件描述符。 */
+	int m_slaveHold = -1;              /**< 保持从端打开，避免串口程序重新打开前主端收到挂断。 */
+	int m_delayUs = 0;                 /**< 回显延迟。 */
+	std::string m_slavePath;           /**< 从端设备路径。 */
+	std::thread m_thread;              /**< 回显线程。 */
+	std::atomic<bool> m_stop{ false }; /**< 停止标志。 */
+	std::atomic<uint64_t> m_echoed{ 0 }; /**< 回显的字节数。 */
+};
@@ -0,0 +1,96 @@
+/*
+ * @Description: 伪终端对，主端由测试代码读写，从端作为串口交给被测程序打开
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 22:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "PtyPair.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#define MYSOFTWARE_HAVE_PTY 1
+#endif
+
+/**
+ * @brief 创建伪终端，从端设置为原始模式，避免行规程回显或转换换行符。
+ */
+PtyPair::PtyPair()
+{
+#ifdef MYSOFTWARE_HAVE_PTY
+	m_master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0)
+	{
+		const std::string message = std::string("Failed to create pty: ") + std::strerror(errno);
+		Close();
+		throw std::runtime_error(message);
+	}
+	m_slavePath = ptsname(m_master);
+	m_slaveHold = open(m_slavePath.c_str(), O_RDWR | O_NOCTTY);
+	termios options;
+	if (m_slaveHold >= 0 && tcgetattr(m_slaveHold, &options) == 0)
+	{
+		cfmakeraw(&options);
+		tcsetattr(m_slaveHold, TCSANOW, &options);
+	}
+#else
+	throw std::runtime_error("Pty pairs require POSIX ptys.");
+#endif
+}
+
+PtyPair::~PtyPair()
+{
+	Close();
+}
+
+size_t PtyPair::WriteAll(const char* data, size_t length)
+{
+	size_t written = 0;
+#ifdef MYSOFTWARE_HAVE_PTY
+	while (written < length)
+	{
+		const ssize_t result = write(m_master, data + written, length - written);
+		if (result > 0)
+		{
+			written += static_cast<size_t>(result);
+			continue;
+		}
+		if (result < 0 && errno != EAGAIN && errno != EINTR)
+		{
+			break;
+		}
+		pollfd descriptor{ m_master, POLLOUT, 0 };
+		if (poll(&descriptor, 1, 1000) <= 0)
+		{
+			break;
+		}
+	}
+#else
+	(void)data;
+	(void)length;
+#endif
+	return written;
+}
+
+void PtyPair::Close()
+{
+#ifdef MYSOFTWARE_HAVE_PTY
+	if (m_slaveHold >= 0)
+	{
+		close(m_slaveHold);
+	}
+	if (m_master >= 0)
+	{
+		close(m_master);
+	}
+#endif
+	m_slaveHold = -1;
+	m_master = -1;
+}
@@ -0,0 +1,52 @@
+/*
+ * @Description: 伪终端对，主端由测试代码读写，从端作为串口交给被测程序打开
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 22:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <string>
+
+/**
+ * @brief PtyPair 创建一对伪终端，模拟串口另一端连接的设备。
+ *
+ * 主端为非阻塞模式，由测试线程直接 read/write；从端设置为原始模式并保持打开，
+ * 被测程序重新打开从端之前主端不会收到挂断。仅支持 POSIX 系统，其他平台上构造函数抛出异常。
+ */
+class PtyPair
+{
+public:
+	/**
+	 * @brief 创建伪终端。
+	 * @throw std::runtime_error 如果创建失败或平台不支持。
+	 */
+	PtyPair();
+	~PtyPair();
+
+	PtyPair(const PtyPair&) = delete;
+	PtyPair& operator=(const PtyPair&) = delete;
+
+	/**
+	 * @brief 主端文件描述符。
+	 */
+	int Master() const { return m_master; }
+
+	/**
+	 * @brief 从端设备路径，例如 /dev/pts/3。
+	 */
+	const std::string& SlavePath() const { return m_slavePath; }
+
+	/**
+	 * @brief 向主端写出全部数据，缓冲满时等待。
+	 * @return 写出的字节数，出错时小于 length。
+	 */
+	size_t WriteAll(const char* data, size_t length);
+
+private:
+	void Close();
+
+	int m_master = -1;        /**< 主端文件描述符。 */
+	int m_slaveHold = -1;     /**< 保持从端打开。 */
+	std::string m_slavePath;  /**< 从端设备路径。 */
+};
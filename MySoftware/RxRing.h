@@ -0,0 +1,130 @@
+/*
+ * @Description: 接收环形缓冲区，按序号保存最近收到的数据块，供多个读者各自按游标读取
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 13:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QByteArray>
+#include <QtCore/QtGlobal>
+#include <deque>
+
+/**
+ * @brief RxRing 保存串口最近收到的数据块。
+ *
+ * 每个数据块分配一个递增的序号，读者只需要记住自己的序号游标，
+ * 数据块本身通过 QByteArray 的隐式共享被所有读者共用，不做拷贝。
+ * 总块数和总字节数都有上限，超出时淘汰最旧的数据块；
+ * 游标落在已淘汰范围内的读者说明跟不上输入速度，由读者自行处理（例如断开）。
+ * 此类不加锁，只能在串口所在线程中使用。
+ */
+class RxRing
+{
+public:
+	/**
+	 * @brief 构造函数。
+	 * @param maxChunks 最多保存的数据块数量。
+	 * @param maxBytes 最多保存的字节数。
+	 */
+	explicit RxRing(int maxChunks = 4096, qint64 maxBytes = 4 * 1024 * 1024)
+		: m_maxChunks(maxChunks), m_maxBytes(maxBytes)
+	{
+	}
+
+	/**
+	 * @brief 追加一个数据块，必要时淘汰最旧的数据块。
+	 * @param chunk 数据块，与调用方共享同一份数据。
+	 * @return 该数据块的序号。
+	 */
+	quint64 Push(const QByteArray& chunk)
+	{
+		m_chunks.push_back({ chunk, m_totalBytes });
+		m_bytes += chunk.size();
+		m_totalBytes += static_cast<quint64>(chunk.size());
+		while (!m_chunks.empty() &&
+			(static_cast<int>(m_chunks.size()) > m_maxChunks || (m_bytes > m_maxBytes && m_chunks.size() > 1)))
+		{
+			m_bytes -= m_chunks.front().data.size();
+			m_chunks.pop_front();
+			++m_firstSeq;
+		}
+		return m_firstSeq + m_chunks.size() - 1;
+	}
+
+	/**
+	 * @brief 获取指定序号的数据块。
+	 * @param seq 数据块序号。
+	 * @return 数据块指针，已被淘汰或尚未到达时返回 nullptr。
+	 */
+	const QByteArray* At(quint64 seq) const
+	{
+		if (seq < m_firstSeq || seq >= NextSeq())
+		{
+			return nullptr;
+		}
+		return &m_chunks[static_cast<size_t>(seq - m_firstSeq)].data;
+	}
+
+	/**
+	 * @brief 指定序号的数据块在整个接收流中的起始字节位置。
+	 * @param seq 数据块序号，等于 NextSeq() 时返回 TotalBytes()。
+	 */
+	quint64 StreamOffset(quint64 seq) const
+	{
+		if (seq >= NextSeq())
+		{
+			return m_totalBytes;
+		}
+		if (seq < m_firstSeq)
+		{
+			return m_chunks.empty() ? m_totalBytes : m_chunks.front().offset;
+		}
+		return m_chunks[static_cast<size_t>(seq - m_firstSeq)].offset;
+	}
+
+	/**
+	 * @brief 仍在缓冲区中的最旧数据块序号。
+	 */
+	quint64 FirstSeq() const { return m_firstSeq; }
+	/**
+	 * @brief 下一个数据块将使用的序号。
+	 */
+	quint64 NextSeq() const { return m_firstSeq + m_chunks.size(); }
+	/**
+	 * @brief 当前保存的字节数。
+	 */
+	qint64 Bytes() const { return m_bytes; }
+	/**
+	 * @brief 最多保存的字节数。
+	 */
+	qint64 MaxBytes() const { return m_maxBytes; }
+	/**
+	 * @brief 累计写入过的字节数，包括已淘汰的部分。
+	 */
+	quint64 TotalBytes() const { return m_totalBytes; }
+
+	/**
+	 * @brief 清空缓冲区，序号继续递增，读者游标不会与新数据混淆。
+	 */
+	void Clear()
+	{
+		m_firstSeq += m_chunks.size();
+		m_chunks.clear();
+		m_bytes = 0;
+	}
+
+private:
+	struct Entry
+	{
+		QByteArray data;  /**< 数据块。 */
+		quint64 offset;   /**< 数据块在接收流中的起始字节位置。 */
+	};
+
+	std::deque<Entry> m_chunks;      /**< 保存的数据块。 */
+	quint64 m_firstSeq = 0;          /**< m_chunks.front() 的序号。 */
+	qint64 m_bytes = 0;              /**< 当前保存的字节数。 */
+	quint64 m_totalBytes = 0;        /**< 累计写入的字节数。 */
+	int m_maxChunks;                 /**< 最多保存的数据块数量。 */
+	qint64 m_maxBytes;               /**< 最多保存的字节数。 */
+};
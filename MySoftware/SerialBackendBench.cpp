@@ -0,0 +1,509 @@
+/*
+ * @Description: 串口后端与双口转发基准测试，在伪终端上测量吞吐、每 MB CPU 时间、往返延迟和转发附加延迟
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 22:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "SerialBackendBench.h"
+#include "DecoderBench.h"
+#include "PtyEcho.h"
+#include "PtyPair.h"
+#include "TraceRecorder.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#define MYSOFTWARE_HAVE_BACKEND_BENCH 1
+#endif
+
+namespace
+{
+#ifdef MYSOFTWARE_HAVE_BACKEND_BENCH
+	/**
+	 * @brief 用户态加内核态 CPU 时间（秒）。
+	 * @param who RUSAGE_SELF 为整个进程，RUSAGE_THREAD 为调用线程。
+	 */
+	double CpuSeconds(int who)
+	{
+		rusage usage{};
+		getrusage(who, &usage);
+		return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+			+ (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+	}
+
+	/**
+	 * @brief 按测试需要的参数打开串口，伪终端忽略波特率。
+	 */
+	void OpenSerial(SerialInfo& serial, SerialInfo::Backend backend, const std::string& path)
+	{
+		serial.SetBackend(backend);
+		serial.SetSerialConfiguration(115200, 8, 1, "None", QString::fromStdString(path));
+		serial.SerialChangestate(false);
+	}
+
+	/**
+	 * @brief 运行事件循环直到 done() 为真或超时，测量的时间在信号处理中记录，与检查间隔无关。
+	 * @return done() 的结果。
+	 */
+	bool RunUntil(const std::function<bool()>& done, int timeoutMs)
+	{
+		if (done())
+		{
+			return true;
+		}
+		QEventLoop loop;
+		QTimer check;
+		QObject::connect(&check, &QTimer::timeout, &loop, [&]() {
+			if (done())
+			{
+				loop.quit();
+			}
+			});
+		check.start(1);
+		QTimer::singleShot(timeoutMs, &loop, &QEventLoop::quit);
+		loop.exec();
+		return done();
+	}
+
+	/**
+	 * @brief 转发测试的消息：方向标记、8 位十六进制序号、空格、16 位十六进制发送时间和换行，共 27 字节。
+	 */
+	constexpr size_t kRelayMessageSize = 27;
+
+	/**
+	 * @brief 以 1 kHz 向伪终端主端写入转发测试消息。
+	 */
+	void WriteRelayMessages(PtyPair& pty, char tag, int messages)
+	{
+		char line[kRelayMessageSize + 1];
+		for (int i = 0; i < messages; ++i)
+		{
+			std::snprintf(line, sizeof(line), "%c%08x %016llx\n", tag, static_cast<unsigned>(i),
+				static_cast<unsigned long long>(TraceRecorder::NowNs()));
+			if (pty.WriteAll(line, kRelayMessageSize) < kRelayMessageSize)
+			{
+				return;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	/**
+	 * @brief 从伪终端主端读出转发过来的消息，检查方向标记和序号，记录端到端延迟。
+	 * 读到最后一条消息或 2 秒内没有新数据时返回。
+	 */
+	void ReadRelayMessages(PtyPair& pty, char tag, int messages, uint64_t& received, uint64_t& mismatched, RttHistogram& histogram)
+	{
+		std::string pending;
+		char buffer[4096];
+		uint32_t expected = 0;
+		while (expected < static_cast<uint32_t>(messages))
+		{
+			pollfd descriptor{ pty.Master(), POLLIN, 0 };
+			if (poll(&descriptor, 1, 2000) <= 0)
+			{
+				return;
+			}
+			const ssize_t length = read(pty.Master(), buffer, sizeof(buffer));
+			if (length <= 0)
+			{
+				if (length < 0 && (errno == EAGAIN || errno == EINTR))
+				{
+					continue;
+				}
+				return;
+			}
+			const int64_t nowNs = TraceRecorder::NowNs();
+			pending.append(buffer, static_cast<size_t>(length));
+			size_t begin = 0;
+			for (size_t end; (end = pending.find('\n', begin)) != std::string::npos; begin = end + 1)
+			{
+				const std::string line = pending.substr(begin, end - begin);
+				if (line.size() + 1 != kRelayMessageSize || line[0] != tag)
+				{
+					++mismatched;
+					continue;
+				}
+				// 序号不连续说明中间有消息丢失或乱序，从收到的序号继续检查
+				const uint32_t sequence = static_cast<uint32_t>(std::strtoul(line.substr(1, 8).c_str(), nullptr, 16));
+				mismatched += sequence != expected ? 1 : 0;
+				expected = sequence + 1;
+				++received;
+				histogram.Record(nowNs - static_cast<int64_t>(std::strtoull(line.c_str() + 10, nullptr, 16)));
+			}
+			pending.erase(0, begin);
+		}
+	}
+#endif
+}
+
+/**
+ * @brief 测试一个后端：先测吞吐和 CPU 时间，再测往返延迟，两部分各用一个新的 SerialInfo。
+ * 写入线程的 CPU 时间用 RUSAGE_THREAD 单独统计后从进程 CPU 时间中减去，两个后端的结果只差在读取路径上。
+ */
+SerialBackendBenchResult SerialBackendBench::Run(SerialInfo::Backend backend, uint64_t bytes, int pings)
+{
+	SerialBackendBenchResult result;
+	result.backend = backend == SerialInfo::Backend::Native ? "native" : "qt";
+#ifdef MYSOFTWARE_HAVE_BACKEND_BENCH
+	{
+		PtyPair pty;
+		SerialInfo serial;
+		OpenSerial(serial, backend, pty.SlavePath());
+
+		QEventLoop loop;
+		QObject::connect(&serial, &SerialInfo::DataReceived, &loop, [&](const QByteArray& data) {
+			result.bytes += static_cast<uint64_t>(data.size());
+			++result.chunks;
+			if (result.bytes >= bytes)
+			{
+				loop.quit();
+			}
+			});
+		QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+
+		const std::string sample = DecoderBench::GenerateSample("pid", size_t(1) << 20);
+		std::atomic<bool> stop{ false };
+		double feederCpu = 0.0;
+		const double cpuStart = CpuSeconds(RUSAGE_SELF);
+		QElapsedTimer clock;
+		clock.start();
+		std::thread feeder([&]() {
+			uint64_t sent = 0;
+			while (sent < bytes && !stop.load())
+			{
+				const size_t offset = static_cast<size_t>(sent % sample.size());
+				const size_t length = static_cast<size_t>(std::min<uint64_t>({ 4096, bytes - sent, sample.size() - offset }));
+				const size_t written = pty.WriteAll(sample.data() + offset, length);
+				sent += written;
+				if (written < length)
+				{
+					break;
+				}
+			}
+			feederCpu = CpuSeconds(RUSAGE_THREAD);
+			});
+		loop.exec();
+		result.seconds = clock.nsecsElapsed() / 1e9;
+		result.cpuSeconds = CpuSeconds(RUSAGE_SELF) - cpuStart;
+		stop.store(true);
+		feeder.join();
+		result.cpuSeconds -= feederCpu;
+		serial.SerialChangestate(true);
+	}
+
+	{
+		PtyEcho echo;
+		echo.Start();
+		SerialInfo serial;
+		OpenSerial(serial, backend, echo.SlavePath());
+
+		LatencyProbe probe;
+		QElapsedTimer clock;
+		clock.start();
+		QEventLoop loop;
+		QObject::connect(&serial, &SerialInfo::DataReceived, &loop, [&](const QByteArray& data) {
+			probe.OnReceive(ByteSpan(data.constData(), static_cast<size_t>(data.size())), clock.nsecsElapsed());
+			if (probe.Received() + probe.Lost() >= static_cast<uint64_t>(pings))
+			{
+				loop.quit();
+			}
+			});
+		QTimer sender;
+		sender.setTimerType(Qt::PreciseTimer);
+		QObject::connect(&sender, &QTimer::timeout, &loop, [&]() {
+			const int64_t nowNs = clock.nsecsElapsed();
+			if (probe.Sent() < static_cast<uint64_t>(pings))
+			{
+				const std::string& ping = probe.NextPing(nowNs);
+				try
+				{
+					serial.SerialSendBytes(QByteArray(ping.data(), static_cast<int>(ping.size())));
+				}
+				catch (const std::runtime_error& e)
+				{
+					std::fprintf(stderr, "Probe send failed: %s\n", e.what());
+					loop.quit();
+				}
+				return;
+			}
+			probe.Expire(nowNs);
+			if (probe.Received() + probe.Lost() >= static_cast<uint64_t>(pings))
+			{
+				loop.quit();
+			}
+			});
+		sender.start(1);
+		QTimer::singleShot(pings + 5000, &loop, &QEventLoop::quit);
+		loop.exec();
+		sender.stop();
+		serial.SerialChangestate(true);
+
+		result.latency = probe.Format();
+		result.p50Ns = probe.Histogram().Percentile(0.5);
+		result.p99Ns = probe.Histogram().Percentile(0.99);
+	}
+#else
+	(void)bytes;
+	(void)pings;
+	throw std::runtime_error("The serial backend benchmark requires Linux ptys.");
+#endif
+	return result;
+}
+
+/**
+ * @brief 双口转发测试。
+ * 设备端伪终端的从端由 deviceSide 打开，控制器端的由 controllerSide 打开，两者互相转发；
+ * 每个方向一个写线程和一个读线程直接操作伪终端主端，附加延迟来自 DataRelayed 信号。
+ */
+RelayBenchResult SerialBackendBench::RunRelay(SerialInfo::Backend backend, int messages)
+{
+	RelayBenchResult result;
+	result.backend = backend == SerialInfo::Backend::Native ? "native" : "qt";
+	result.messages = static_cast<uint64_t>(messages);
+#ifdef MYSOFTWARE_HAVE_BACKEND_BENCH
+	PtyPair device;
+	PtyPair controller;
+	SerialInfo deviceSide;
+	SerialInfo controllerSide;
+	OpenSerial(deviceSide, backend, device.SlavePath());
+	OpenSerial(controllerSide, backend, controller.SlavePath());
+	deviceSide.SetRelayTarget(&controllerSide);
+	controllerSide.SetRelayTarget(&deviceSide);
+
+	QEventLoop loop;
+	SerialInfo* const sides[2] = { &deviceSide, &controllerSide };
+	for (int direction = 0; direction < 2; ++direction)
+	{
+		QObject::connect(sides[direction], &SerialInfo::DataRelayed, &loop,
+			[&result, direction](const QByteArray&, qint64 receivedNs, qint64 relayedNs) {
+				if (relayedNs < 0)
+				{
+					++result.dropped[direction];
+					return;
+				}
+				result.added[direction].Record(relayedNs - receivedNs);
+			});
+	}
+
+	std::atomic<int> readersDone{ 0 };
+	auto reader = [&](PtyPair& pty, char tag, int direction) {
+		ReadRelayMessages(pty, tag, messages, result.received[direction], result.mismatched[direction], result.endToEnd[direction]);
+		if (++readersDone == 2)
+		{
+			QMetaObject::invokeMethod(&loop, &QEventLoop::quit, Qt::QueuedConnection);
+		}
+	};
+	std::thread toController(reader, std::ref(controller), 'D', 0);
+	std::thread toDevice(reader, std::ref(device), 'C', 1);
+	std::thread fromDevice(WriteRelayMessages, std::ref(device), 'D', messages);
+	std::thread fromController(WriteRelayMessages, std::ref(controller), 'C', messages);
+	QTimer::singleShot(messages + 10000, &loop, &QEventLoop::quit);
+	loop.exec();
+	for (std::thread* thread : { &fromDevice, &fromController, &toController, &toDevice })
+	{
+		thread->join();
+	}
+	// 最后几个数据块的 DataRelayed 可能还在事件队列中
+	QCoreApplication::processEvents();
+
+	deviceSide.SetRelayTarget(nullptr);
+	controllerSide.SetRelayTarget(nullptr);
+	deviceSide.SerialChangestate(true);
+	controllerSide.SerialChangestate(true);
+#else
+	throw std::runtime_error("The relay benchmark requires Linux ptys.");
+#endif
+	return result;
+}
+
+/**
+ * @brief 断线重连测试。
+ * 设备用伪终端模拟，从端路径经一个符号链接交给 SerialInfo：拔出时删除链接并关闭伪终端，SerialInfo 读到挂断；
+ * 插回时创建新的伪终端，把链接原子地指向新的从端，相当于 USB 转串口重新枚举后出现同名的设备节点。
+ * 每个周期写入一批完整的 PID 帧和半个帧，全部读到之后才拔出（伪终端关闭时未读的数据会丢失），
+ * 最后再写一批帧，解码帧数等于写出的完整帧数、没有解码错误，说明半帧在断开时被丢弃，没有破坏下一批的第一帧。
+ */
+ReconnectBenchResult SerialBackendBench::RunReconnect(SerialInfo::Backend backend, int cycles)
+{
+	ReconnectBenchResult result;
+	result.backend = backend == SerialInfo::Backend::Native ? "native" : "qt";
+	result.cycles = cycles;
+#ifdef MYSOFTWARE_HAVE_BACKEND_BENCH
+	const std::string link = "/tmp/MySoftware-reconnect-" + std::to_string(getpid());
+	auto plug = [&link](const PtyPair& pty) {
+		const std::string temporary = link + ".new";
+		unlink(temporary.c_str());
+		if (symlink(pty.SlavePath().c_str(), temporary.c_str()) != 0 || rename(temporary.c_str(), link.c_str()) != 0)
+		{
+			throw std::runtime_error("Failed to create " + link);
+		}
+	};
+
+	// 截到最后一个完整帧为止
+	std::string frames = DecoderBench::GenerateSample("pid", 8192);
+	frames.resize(frames.rfind("END
+") + 4);
+	uint64_t framesPerBatch = 0;
+	for (size_t at = 0; (at = frames.find("END
+", at)) != std::string::npos; at += 4)
+	{
+		++framesPerBatch;
+	}
+	const std::string halfFrame = "START2
+1.234
+0.1";
+
+	auto pty = std::make_unique<PtyPair>();
+	plug(*pty);
+	SerialInfo serial;
+	std::unique_ptr<ProtocolDecoder> decoder = DecoderRegistry::Instance().Create("pid");
+	auto sink = MakeRecordSink([](const DecodedRecord&) {});
+	uint64_t receivedBytes = 0;
+	bool lost = false;
+	bool restored = false;
+	int64_t unpluggedNs = 0;
+	int64_t pluggedNs = 0;
+	// 处理函数在本线程的事件循环中执行，与 RunUntil 的检查不存在竞争；同一线程发出的数据和断开保持顺序
+	QObject context;
+	QObject::connect(&serial, &SerialInfo::DataReceived, &context, [&](const QByteArray& data) {
+		receivedBytes += static_cast<uint64_t>(data.size());
+		decoder->Feed(ByteSpan(data.constData(), static_cast<size_t>(data.size())), sink);
+		});
+	QObject::connect(&serial, &SerialInfo::ConnectionLost, &context, [&](const QString&) {
+		result.detect.Record(TraceRecorder::NowNs() - unpluggedNs);
+		decoder->Reset();
+		lost = true;
+		});
+	QObject::connect(&serial, &SerialInfo::Reconnected, &context, [&](qint64, qint64) {
+		result.reopen.Record(TraceRecorder::NowNs() - pluggedNs);
+		++result.reconnected;
+		restored = true;
+		});
+	OpenSerial(serial, backend, link);
+
+	auto sendBatch = [&](bool withHalfFrame) {
+		const uint64_t expected = receivedBytes + frames.size() + (withHalfFrame ? halfFrame.size() : 0);
+		pty->WriteAll(frames.data(), frames.size());
+		if (withHalfFrame)
+		{
+			pty->WriteAll(halfFrame.data(), halfFrame.size());
+		}
+		result.framesSent += framesPerBatch;
+		return RunUntil([&]() { return receivedBytes >= expected; }, 2000);
+	};
+
+	std::mt19937 random(1);
+	for (int cycle = 0; cycle < cycles; ++cycle)
+	{
+		if (!sendBatch(true))
+		{
+			std::fprintf(stderr, "Cycle %d: data not received.
+", cycle);
+			break;
+		}
+		lost = false;
+		unpluggedNs = TraceRecorder::NowNs();
+		unlink(link.c_str());
+		pty.reset();
+		if (!RunUntil([&]() { return lost; }, 2000))
+		{
+			std::fprintf(stderr, "Cycle %d: disconnect not detected.
+", cycle);
+			break;
+		}
+		// 设备离线 20~200 ms
+		RunUntil([]() { return false; }, 20 + static_cast<int>(random() % 181));
+		restored = false;
+		pty = std::make_unique<PtyPair>();
+		pluggedNs = TraceRecorder::NowNs();
+		plug(*pty);
+		if (!RunUntil([&]() { return restored; }, 2000))
+		{
+			std::fprintf(stderr, "Cycle %d: not reconnected.
+", cycle);
+			break;
+		}
+	}
+	if (result.reconnected == cycles && !sendBatch(false))
+	{
+		std::fprintf(stderr, "Final batch not received.
+");
+	}
+	result.framesDecoded = decoder->RecordCount();
+	result.decodeErrors = decoder->ErrorCount();
+	serial.SerialChangestate(true);
+	unlink(link.c_str());
+#else
+	(void)backend;
+	throw std::runtime_error("The reconnect benchmark requires Linux ptys.");
+#endif
+	return result;
+}
+
+std::string SerialBackendBench::Format(const ReconnectBenchResult& result)
+{
+	char text[320];
+	std::snprintf(text, sizeof(text),
+		"%-6s %d/%d reconnected, frames %llu/%llu, %llu decode errors, detect p50 %.1f ms max %.1f ms, "
+		"device to reopen p50 %.1f ms p99 %.1f ms max %.1f ms",
+		result.backend.c_str(), result.reconnected, result.cycles,
+		static_cast<unsigned long long>(result.framesDecoded), static_cast<unsigned long long>(result.framesSent),
+		static_cast<unsigned long long>(result.decodeErrors),
+		result.detect.Percentile(0.5) / 1e6, result.detect.Max() / 1e6,
+		result.reopen.Percentile(0.5) / 1e6, result.reopen.Percentile(0.99) / 1e6, result.reopen.Max() / 1e6);
+	return text;
+}
+
+std::string SerialBackendBench::Format(const RelayBenchResult& result)
+{
+	static const char* const kDirections[] = { "device>controller", "controller>device" };
+	std::string text;
+	for (int direction = 0; direction < 2; ++direction)
+	{
+		const RttHistogram& endToEnd = result.endToEnd[direction];
+		const RttHistogram& added = result.added[direction];
+		char line[320];
+		std::snprintf(line, sizeof(line),
+			"%-6s %s: %llu/%llu messages, %llu mismatched, %llu dropped, end-to-end p50 %.1f us p99 %.1f us, "
+			"added p50 %.1f us p99 %.1f us max %.1f us\n",
+			result.backend.c_str(), kDirections[direction], static_cast<unsigned long long>(result.received[direction]),
+			static_cast<unsigned long long>(result.messages), static_cast<unsigned long long>(result.mismatched[direction]),
+			static_cast<unsigned long long>(result.dropped[direction]),
+			endToEnd.Percentile(0.5) / 1e3, endToEnd.Percentile(0.99) / 1e3,
+			added.Percentile(0.5) / 1e3, added.Percentile(0.99) / 1e3, added.Max() / 1e3);
+		text += line;
+	}
+	text.pop_back();
+	return text;
+}
+
+std::string SerialBackendBench::Format(const SerialBackendBenchResult& result)
+{
+	const double megabytes = result.bytes / 1e6;
+	char text[512];
+	std::snprintf(text, sizeof(text),
+		"%-6s %.1f MB in %.3f s (%.1f MB/s), %llu chunks (%.0f B/chunk), CPU %.3f s = %.2f ms/MB\n"
+		"%-6s latency p50 %.1f us, p99 %.1f us (%s)",
+		result.backend.c_str(), megabytes, result.seconds, result.seconds > 0 ? megabytes / result.seconds : 0.0,
+		static_cast<unsigned long long>(result.chunks), result.chunks > 0 ? static_cast<double>(result.bytes) / result.chunks : 0.0,
+		result.cpuSeconds, megabytes > 0 ? result.cpuSeconds * 1e3 / megabytes : 0.0,
+		result.backend.c_str(), result.p50Ns / 1e3, result.p99Ns / 1e3, result.latency.c_str());
+	return text;
+}
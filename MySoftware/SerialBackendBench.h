@@ -0,0 +1,115 @@
+/*
+ * @Description: 串口后端与双口转发基准测试，在伪终端上测量吞吐、每 MB CPU 时间、往返延迟和转发附加延迟
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 22:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include "LatencyProbe.h"
+#include "SerialInfo.h"
+
+/**
+ * @brief 一个串口后端的测试结果。
+ */
+struct SerialBackendBenchResult
+{
+	std::string backend;       /**< 后端名称。 */
+	uint64_t bytes = 0;        /**< 收到的字节数。 */
+	uint64_t chunks = 0;       /**< DataReceived 发出的数据块数量。 */
+	double seconds = 0.0;      /**< 吞吐测试的耗时（秒）。 */
+	double cpuSeconds = 0.0;   /**< 吞吐测试中本进程的 CPU 时间，不含写入伪终端的线程。 */
+	std::string latency;       /**< 往返延迟统计，格式见 LatencyProbe::Format。 */
+	int64_t p50Ns = 0;         /**< 往返延迟中位数。 */
+	int64_t p99Ns = 0;         /**< 往返延迟的 99 分位数。 */
+};
+
+/**
+ * @brief 双口转发测试的结果，下标 0 为设备到控制器，1 为控制器到设备。
+ */
+struct RelayBenchResult
+{
+	std::string backend;           /**< 后端名称。 */
+	uint64_t messages = 0;         /**< 每个方向发送的消息数。 */
+	uint64_t received[2] = {};     /**< 对端收到的消息数。 */
+	uint64_t mismatched[2] = {};   /**< 内容或顺序不对的消息数。 */
+	uint64_t dropped[2] = {};      /**< 写到目标串口失败的数据块数。 */
+	RttHistogram endToEnd[2];      /**< 从写入一端伪终端到另一端读出的延迟。 */
+	RttHistogram added[2];         /**< 转发附加延迟：从读到数据到写出到目标串口。 */
+};
+
+/**
+ * @brief 断线重连测试的结果。
+ */
+struct ReconnectBenchResult
+{
+	std::string backend;          /**< 后端名称。 */
+	int cycles = 0;               /**< 拔插次数。 */
+	int reconnected = 0;          /**< 重新打开成功的次数。 */
+	uint64_t framesSent = 0;      /**< 写出的完整帧数。 */
+	uint64_t framesDecoded = 0;   /**< 解码出的帧数。 */
+	uint64_t decodeErrors = 0;    /**< 解码错误数。 */
+	RttHistogram detect;          /**< 从拔出设备到收到 ConnectionLost。 */
+	RttHistogram reopen;          /**< 从设备重新出现到收到 Reconnected。 */
+};
+
+/**
+ * @brief SerialBackendBench 用伪终端代替设备，对同一个 SerialInfo 接口的两种后端做相同的测试。
+ *
+ * 吞吐：一个线程把合成的 PID 数据尽快写入伪终端主端，SerialInfo 打开从端，
+ * 在 DataReceived 的接收线程（主线程）中计数，统计耗时和进程 CPU 时间（减去写入线程自己的 CPU 时间），
+ * 得到包含读取、信号排队和分发在内的每 MB CPU 时间。
+ * 延迟：SerialInfo 打开 PtyEcho 的从端，以 1 kHz 发送 LatencyProbe 探测帧，
+ * 测量从写出到主线程收到回显的往返时间。
+ * 转发：两对伪终端分别模拟设备和控制器，两个 SerialInfo 互相设为转发目标，
+ * 两端以 1 kHz 发送带序号和发送时间的消息，检查对端收到的内容与顺序。
+ * 重连：反复拔出、插回模拟设备，测量检测断开和重新打开的时间，检查半帧没有破坏重连后的帧。仅支持 Linux。
+ */
+class SerialBackendBench
+{
+public:
+	/**
+	 * @brief 测试一个后端。
+	 * @param backend 串口后端。
+	 * @param bytes 吞吐测试的数据量。
+	 * @param pings 延迟测试的探测帧数量。
+	 * @return 测试结果。
+	 * @throw std::runtime_error 如果创建伪终端或打开串口失败。
+	 */
+	static SerialBackendBenchResult Run(SerialInfo::Backend backend, uint64_t bytes, int pings);
+
+	/**
+	 * @brief 把结果格式化为两行文本。
+	 */
+	static std::string Format(const SerialBackendBenchResult& result);
+
+	/**
+	 * @brief 在两对伪终端之间测试双口转发。
+	 * @param backend 两个串口使用的后端。
+	 * @param messages 每个方向发送的消息数。
+	 * @return 测试结果。
+	 * @throw std::runtime_error 如果创建伪终端或打开串口失败。
+	 */
+	static RelayBenchResult RunRelay(SerialInfo::Backend backend, int messages);
+
+	/**
+	 * @brief 把转发测试结果格式化为每个方向一行。
+	 */
+	static std::string Format(const RelayBenchResult& result);
+
+	/**
+	 * @brief 断线重连测试。
+	 * @param backend 串口后端。
+	 * @param cycles 拔插次数。
+	 * @return 测试结果，某个周期超时时提前结束，reconnected 小于 cycles。
+	 * @throw std::runtime_error 如果创建伪终端或打开串口失败。
+	 */
+	static ReconnectBenchResult RunReconnect(SerialInfo::Backend backend, int cycles);
+
+	/**
+	 * @brief 把重连测试结果格式化为一行。
+	 */
+	static std::string Format(const ReconnectBenchResult& result);
+};
@@ -0,0 +1,252 @@
+/*
+ * @Description: 串口数据流的本地 TCP / Unix 套接字分发桥，多个本地程序共享同一个串口
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 13:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "SerialFanout.h"
+#include <QtCore/QDebug>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief 构造函数。
+ * 默认允许单个客户端落后整个环形缓冲区的一半，留出余量给其他客户端。
+ */
+SerialFanout::SerialFanout(const RxRing& ring, QObject* parent)
+	: QObject(parent), m_ring(ring), m_maxClientLag(ring.MaxBytes() / 2)
+{
+}
+
+SerialFanout::~SerialFanout()
+{
+	Close();
+}
+
+/**
+ * @brief 在 127.0.0.1 上监听 TCP 端口。
+ * @throw std::runtime_error 如果监听失败。
+ */
+void SerialFanout::ListenTcp(quint16 port)
+{
+	if (m_tcpServer == nullptr)
+	{
+		m_tcpServer = new QTcpServer(this);
+		connect(m_tcpServer, &QTcpServer::newConnection, this, [this]() {
+			while (QTcpSocket* socket = m_tcpServer->nextPendingConnection())
+			{
+				socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+				connect(socket, &QTcpSocket::disconnected, this, [this, socket]() { RemoveClient(socket, false); });
+				AddClient(socket);
+			}
+			});
+	}
+	if (!m_tcpServer->listen(QHostAddress::LocalHost, port))
+	{
+		throw std::runtime_error(QString("Failed to listen on 127.0.0.1:%1: %2")
+			.arg(port).arg(m_tcpServer->errorString()).toStdString());
+	}
+	qDebug() << "Serial fan-out listening on 127.0.0.1:" << m_tcpServer->serverPort();
+}
+
+/**
+ * @brief 监听本地套接字。
+ * 上次异常退出留下的同名套接字文件会先被删除。
+ * @throw std::runtime_error 如果监听失败。
+ */
+void SerialFanout::ListenLocal(const QString& name)
+{
+	if (m_localServer == nullptr)
+	{
+		m_localServer = new QLocalServer(this);
+		connect(m_localServer, &QLocalServer::newConnection, this, [this]() {
+			while (QLocalSocket* socket = m_localServer->nextPendingConnection())
+			{
+				connect(socket, &QLocalSocket::disconnected, this, [this, socket]() { RemoveClient(socket, false); });
+				AddClient(socket);
+			}
+			});
+	}
+	QLocalServer::removeServer(name);
+	if (!m_localServer->listen(name))
+	{
+		throw std::runtime_error(QString("Failed to listen on local socket %1: %2")
+			.arg(name, m_localServer->errorString()).toStdString());
+	}
+	qDebug() << "Serial fan-out listening on" << m_localServer->fullServerName();
+}
+
+/**
+ * @brief 关闭监听并断开所有客户端。
+ */
+void SerialFanout::Close()
+{
+	if (m_tcpServer)
+	{
+		m_tcpServer->close();
+	}
+	if (m_localServer)
+	{
+		m_localServer->close();
+	}
+	// RemoveClient 会修改 m_clients，先取出套接字列表
+	std::vector<QIODevice*> sockets;
+	for (const Client& client : m_clients)
+	{
+		sockets.push_back(client.socket);
+	}
+	for (QIODevice* socket : sockets)
+	{
+		RemoveClient(socket, false);
+	}
+}
+
+void SerialFanout::SetTxHandler(TxHandler handler)
+{
+	m_txHandler = std::move(handler);
+}
+
+void SerialFanout::SetMaxClientLag(qint64 bytes)
+{
+	m_maxClientLag = bytes;
+}
+
+/**
+ * @brief 环形缓冲区中有新数据时调用，推动所有客户端发送。
+ * Pump 可能断开客户端，因此按下标倒序遍历。
+ */
+void SerialFanout::Publish()
+{
+	for (size_t i = m_clients.size(); i > 0; --i)
+	{
+		Pump(m_clients[i - 1]);
+	}
+}
+
+/**
+ * @brief 登记新客户端，从下一个到达的数据块开始发送，不回放历史数据。
+ */
+void SerialFanout::AddClient(QIODevice* socket)
+{
+	m_clients.push_back({ socket, m_ring.NextSeq(), 0 });
+	connect(socket, &QIODevice::bytesWritten, this, [this, socket]() {
+		if (Client* client = FindClient(socket))
+		{
+			Pump(*client);
+		}
+		});
+	connect(socket, &QIODevice::readyRead, this, [this, socket]() { HandleClientData(socket); });
+	qDebug() << "Serial fan-out client connected, total" << m_clients.size();
+	emit ClientCountChanged(ClientCount());
+}
+
+/**
+ * @brief 移除客户端。
+ * @param dropped 是否因为跟不上而被主动断开。
+ */
+void SerialFanout::RemoveClient(QIODevice* socket, bool dropped)
+{
+	auto it = std::find_if(m_clients.begin(), m_clients.end(),
+		[socket](const Client& client) { return client.socket == socket; });
+	if (it == m_clients.end())
+	{
+		return;
+	}
+	m_clients.erase(it);
+	if (dropped)
+	{
+		++m_droppedClients;
+		qDebug() << "Serial fan-out client dropped: too slow";
+	}
+	// 先从列表中移除再断开，避免 disconnected 信号重入时重复处理
+	socket->disconnect(this);
+	if (auto* tcp = qobject_cast<QTcpSocket*>(socket))
+	{
+		tcp->abort();
+	}
+	else if (auto* local = qobject_cast<QLocalSocket*>(socket))
+	{
+		local->abort();
+	}
+	socket->deleteLater();
+	emit ClientCountChanged(ClientCount());
+}
+
+/**
+ * @brief 把环形缓冲区中尚未发送的数据写给客户端。
+ * 套接字内部积压超过 kSocketHighWater 时停止写入，等待 bytesWritten 再继续；
+ * 游标已被淘汰或落后超过 m_maxClientLag 时断开客户端。
+ */
+void SerialFanout::Pump(Client& client)
+{
+	if (client.nextSeq < m_ring.FirstSeq() || Lag(client) > m_maxClientLag)
+	{
+		RemoveClient(client.socket, true);
+		return;
+	}
+
+	QIODevice* socket = client.socket;
+	while (client.nextSeq < m_ring.NextSeq() && socket->bytesToWrite() < kSocketHighWater)
+	{
+		const QByteArray* chunk = m_ring.At(client.nextSeq);
+		const qint64 remaining = chunk->size() - client.offset;
+		const qint64 written = socket->write(chunk->constData() + client.offset, remaining);
+		if (written < 0)
+		{
+			RemoveClient(socket, false);
+			return;
+		}
+		m_bytesSent += static_cast<quint64>(written);
+		client.offset += written;
+		if (client.offset < chunk->size())
+		{
+			break;
+		}
+		client.offset = 0;
+		++client.nextSeq;
+	}
+}
+
+/**
+ * @brief 把客户端发来的数据转发给 TX 处理函数。
+ */
+void SerialFanout::HandleClientData(QIODevice* socket)
+{
+	const QByteArray data = socket->readAll();
+	if (data.isEmpty())
+	{
+		return;
+	}
+	m_bytesFromClients += static_cast<quint64>(data.size());
+	if (m_txHandler)
+	{
+		m_txHandler(data);
+	}
+}
+
+SerialFanout::Client* SerialFanout::FindClient(QIODevice* socket)
+{
+	for (Client& client : m_clients)
+	{
+		if (client.socket == socket)
+		{
+			return &client;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * @brief 计算客户端尚未发送的字节数，包括套接字内部积压的部分。
+ */
+qint64 SerialFanout::Lag(const Client& client) const
+{
+	const quint64 sent = m_ring.StreamOffset(client.nextSeq) + static_cast<quint64>(client.offset);
+	return static_cast<qint64>(m_ring.TotalBytes() - sent) + client.socket->bytesToWrite();
+}
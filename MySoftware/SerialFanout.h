@@ -0,0 +1,133 @@
+/*
+ * @Description: 串口数据流的本地 TCP / Unix 套接字分发桥，多个本地程序共享同一个串口
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 13:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <functional>
+#include <vector>
+#include "RxRing.h"
+
+class QIODevice;
+class QTcpServer;
+class QLocalServer;
+
+/**
+ * @brief SerialFanout 把串口接收数据分发给任意数量的本地客户端，并把客户端发来的数据转发到串口。
+ *
+ * 客户端只保存一个指向 RxRing 的序号游标，发送时直接从环形缓冲区中的共享数据块写入套接字，
+ * 不为每个客户端复制排队数据。每个套接字内部待发送的数据不超过 kSocketHighWater，
+ * 客户端落后超过 maxClientLag 字节或者游标已被环形缓冲区淘汰时立即断开，
+ * 慢客户端不会拖慢串口，也不会让内存无限增长。
+ * 只监听 127.0.0.1 和本地套接字，不对外网开放。
+ */
+class SerialFanout : public QObject
+{
+	Q_OBJECT
+
+public:
+	/**
+	 * @brief 单个套接字内部允许积压的最大字节数，超过后暂停写入，等待 bytesWritten。
+	 */
+	static constexpr qint64 kSocketHighWater = 64 * 1024;
+
+	using TxHandler = std::function<void(const QByteArray&)>;
+
+	/**
+	 * @brief 构造函数。
+	 * @param ring 串口接收环形缓冲区，由 SerialInfo 持有。
+	 * @param parent 父对象。
+	 */
+	explicit SerialFanout(const RxRing& ring, QObject* parent = nullptr);
+	~SerialFanout();
+
+	/**
+	 * @brief 在 127.0.0.1 上监听 TCP 端口。
+	 * @param port TCP 端口号。
+	 * @throw std::runtime_error 如果监听失败。
+	 */
+	void ListenTcp(quint16 port);
+
+	/**
+	 * @brief 监听本地套接字（Unix 域套接字 / Windows 命名管道）。
+	 * @param name 套接字名称或路径。
+	 * @throw std::runtime_error 如果监听失败。
+	 */
+	void ListenLocal(const QString& name);
+
+	/**
+	 * @brief 关闭监听并断开所有客户端。
+	 */
+	void Close();
+
+	/**
+	 * @brief 设置客户端发来数据时的处理函数，通常写入串口。
+	 */
+	void SetTxHandler(TxHandler handler);
+
+	/**
+	 * @brief 设置单个客户端允许落后的最大字节数。
+	 */
+	void SetMaxClientLag(qint64 bytes);
+
+	/**
+	 * @brief 环形缓冲区中有新数据时调用，推动所有客户端发送。
+	 */
+	void Publish();
+
+	/**
+	 * @brief 当前连接的客户端数量。
+	 */
+	int ClientCount() const { return static_cast<int>(m_clients.size()); }
+	/**
+	 * @brief 因为跟不上而被断开的客户端累计数量。
+	 */
+	quint64 DroppedClients() const { return m_droppedClients; }
+	/**
+	 * @brief 累计发送给客户端的字节数。
+	 */
+	quint64 BytesSent() const { return m_bytesSent; }
+	/**
+	 * @brief 累计从客户端收到并转发到串口的字节数。
+	 */
+	quint64 BytesFromClients() const { return m_bytesFromClients; }
+
+signals:
+	/**
+	 * @brief 客户端数量变化时发出。
+	 */
+	void ClientCountChanged(int count);
+
+private:
+	/**
+	 * @brief 单个客户端的发送状态。
+	 */
+	struct Client
+	{
+		QIODevice* socket;  /**< 客户端套接字。 */
+		quint64 nextSeq;    /**< 下一个要发送的数据块序号。 */
+		qint64 offset;      /**< 当前数据块中已发送的字节数。 */
+	};
+
+	void AddClient(QIODevice* socket);
+	void RemoveClient(QIODevice* socket, bool dropped);
+	void Pump(Client& client);
+	void HandleClientData(QIODevice* socket);
+	Client* FindClient(QIODevice* socket);
+	qint64 Lag(const Client& client) const;
+
+	const RxRing& m_ring;                /**< 串口接收环形缓冲区。 */
+	QTcpServer* m_tcpServer = nullptr;   /**< TCP 监听。 */
+	QLocalServer* m_localServer = nullptr; /**< 本地套接字监听。 */
+	std::vector<Client> m_clients;       /**< 已连接的客户端。 */
+	TxHandler m_txHandler;               /**< 客户端发送数据的处理函数。 */
+	qint64 m_maxClientLag;               /**< 单个客户端允许落后的最大字节数。 */
+	quint64 m_droppedClients = 0;        /**< 被断开的慢客户端数量。 */
+	quint64 m_bytesSent = 0;             /**< 发送给客户端的字节数。 */
+	quint64 m_bytesFromClients = 0;      /**< 客户端发来的字节数。 */
+};
@@ -6,36 +6,38 @@
  * @Copyright: Copyright (c) 2025 CAUC
  */
 #include "SerialInfo.h"
-#include <QDialog>
+#include "CrashHandler.h"
+#include "SerialFanout.h"
+#include "TraceRecorder.h"
 #include <stdexcept>
-#include <QMessageBox>
+#include <QFileInfo>
 #include <QRegularExpression> // Added for QRegularExpression
 
+namespace
+{
+	constexpr int kPresencePollMs = 10; /**< 等待设备重新出现时检查设备节点的间隔。 */
+	constexpr int kFirstRetryMs = 5;    /**< 设备出现后第一次打开失败的重试间隔，之后每次加倍。 */
+	constexpr int kMaxRetryMs = 40;     /**< 重试间隔上限，保证设备可用后 40 ms 内打开。 */
+}
+
  /**
   * @brief SerialInfo类的构造函数。
-  * 初始化串口参数为默认值。
+  * 初始化串口参数为默认值，启动串口线程并把本对象和重连定时器移动到该线程中。
+  * 对象没有父对象，moveToThread 才能成功；QSerialPort 之后在串口线程中创建。
   */
-SerialInfo::SerialInfo(QObject* parent) : QObject(parent), dataBits(QSerialPort::Data8), stopBits(QSerialPort::OneStop),
-parity(QSerialPort::NoParity), serialPort(nullptr), serialReadThread(new QThread(this))
+SerialInfo::SerialInfo() : QObject(nullptr), dataBits(QSerialPort::Data8), stopBits(QSerialPort::OneStop),
+parity(QSerialPort::NoParity), serialPort(nullptr), serialReadThread(new QThread()), reconnectTimer(new QTimer())
 {
-	// 将 SerialInfo 对象移动到新线程
-	this->moveToThread(serialReadThread);
+	reconnectTimer->setSingleShot(true);
+	reconnectTimer->setTimerType(Qt::PreciseTimer);
+	connect(reconnectTimer.get(), &QTimer::timeout, this, [this]() { TryReconnect(); });
+	reconnectTimer->moveToThread(serialReadThread);
 
-	// 连接线程的 started 信号到 SerialInfo 的槽，以便在线程启动时进行初始化
-	connect(serialReadThread, &QThread::started, this, [this]() {
-		// 确保 serialPort 在这个线程中被创建和使用
-		if (serialPort == nullptr) {
-			serialPort = new QSerialPort();
-			ConfigureSerialPort(); // 重新配置串口，确保在正确线程中
-		}
-		// 连接 readyRead 信号
-		connect(serialPort, &QSerialPort::readyRead, this, &SerialInfo::handleReadyRead);
-		});
-
-	// 连接线程的 finished 信号，以便在线程结束时进行清理
-	connect(serialReadThread, &QThread::finished, serialReadThread, &QThread::deleteLater);
-	// 注意：serialPort 的 deleteLater 应该在 SerialInfo 的析构函数中处理，或者在线程停止时处理
-	// 这里不直接 delete serialPort，因为它可能在其他地方被引用
+	// started 在新线程中发出，没有接收对象时直接在该线程中调用
+	connect(serialReadThread, &QThread::started, []() { CrashHandler::InstallThreadStack(); });
+	// 将 SerialInfo 对象移动到新线程，readyRead 和重连都在这个线程中处理
+	this->moveToThread(serialReadThread);
+	serialReadThread->start();
 }
 
 /**
@@ -44,18 +46,28 @@ parity(QSerialPort::NoParity), serialPort(nullptr), serialReadThread(new QThread
  */
 SerialInfo::~SerialInfo()
 {
-	if (serialReadThread->isRunning()) {
-		serialReadThread->quit();
-		serialReadThread->wait(); // 等待线程结束
-	}
-	if (serialPort) {
-		if (serialPort->isOpen()) {
-			serialPort->close();
+	memoryRegistration.Reset();
+	relayTarget.store(nullptr);
+	// 定时器、分发桥和 QSerialPort 都属于串口线程，在该线程中停止和删除
+	RunOnPortThread([this]() {
+		StopReconnect();
+		reconnectTimer.reset();
+		// 原生后端的读取线程会访问分发桥，需要先停止
+		nativePort.reset();
+		// 分发桥引用 rxRing，需要在成员析构之前删除
+		delete fanout;
+		fanout = nullptr;
+		if (serialPort) {
+			if (serialPort->isOpen()) {
+				serialPort->close();
+			}
+			delete serialPort;
+			serialPort = nullptr;
 		}
-		delete serialPort;
-		//serialPort = nullptr;
-	}
-	// serialReadThread 会在 finished 信号中 deleteLater
+		});
+	serialReadThread->quit();
+	serialReadThread->wait(); // 等待线程结束
+	delete serialReadThread;
 }
 
 /**
@@ -68,8 +80,8 @@ void SerialInfo::SetSerialPort(QString SerialName)
 }
 
 /**
- * @brief 配置串口参数。
- * 如果serialPort对象为空，则创建一个新的QSerialPort实例。
+ * @brief 配置串口参数，在串口线程中调用。
+ * 如果serialPort对象为空，则在串口线程中创建一个新的QSerialPort实例，连接 readyRead 和错误信号。
  * 然后设置波特率、数据位、停止位、校验位和端口名称。
  */
 void SerialInfo::ConfigureSerialPort()
@@ -77,6 +89,9 @@ void SerialInfo::ConfigureSerialPort()
 	if (serialPort == nullptr)
 	{
 		serialPort = new QSerialPort();
+		connect(serialPort, &QSerialPort::readyRead, this, &SerialInfo::handleReadyRead);
+		connect(serialPort, &QSerialPort::errorOccurred, this,
+			[this](QSerialPort::SerialPortError error) { HandleSerialError(error); });
 	}
 	serialPort->setBaudRate(baudRate);
 	serialPort->setDataBits(dataBits);
@@ -85,6 +100,77 @@ void SerialInfo::ConfigureSerialPort()
 	serialPort->setPortName(portName);
 }
 
+/**
+ * @brief 用原生后端打开串口。
+ * 读取线程中的数据块经 DeliverReceived 发出；设备挂断时输出警告，开启自动重连时在读取线程中
+ * 发出 ConnectionLost 后开始重连，否则通知串口已关闭。
+ */
+void SerialInfo::OpenNative()
+{
+	if (!nativePort)
+	{
+		nativePort = std::make_unique<NativeSerialPort>();
+		nativePort->SetDataHandler([this](const QByteArray& data) { DeliverReceived(data, TraceRecorder::NowNs()); });
+		nativePort->SetErrorHandler([this](const std::string& message) {
+			qWarning() << "Serial port" << portName << "error:" << QString::fromStdString(message);
+			if (autoReconnect.load())
+			{
+				if (!reconnecting.exchange(true))
+				{
+					NotifyLinkLost(QString::fromStdString(message));
+					QMetaObject::invokeMethod(reconnectTimer.get(), [this]() { BeginReconnect(); }, Qt::QueuedConnection);
+				}
+				return;
+			}
+			emit SerialStateChanged(false);
+			});
+	}
+	NativeSerialPort::Settings settings;
+	settings.baudRate = static_cast<int>(baudRate);
+	settings.dataBits = static_cast<int>(dataBits);
+	settings.stopBits = static_cast<int>(stopBits);
+	settings.parity = static_cast<int>(parity);
+	nativePort->Open(portName.toStdString(), settings);
+}
+
+/**
+ * @brief 按名称获取后端。
+ * @throw std::invalid_argument 如果名称无法识别或当前平台不支持该后端。
+ */
+SerialInfo::Backend SerialInfo::BackendFromName(const QString& name)
+{
+	if (name.compare("qt", Qt::CaseInsensitive) == 0)
+	{
+		return Backend::QtSerialPort;
+	}
+	if (name.compare("native", Qt::CaseInsensitive) == 0)
+	{
+		if (!NativeSerialPort::IsSupported())
+		{
+			throw std::invalid_argument("The native serial backend requires Linux.");
+		}
+		return Backend::Native;
+	}
+	throw std::invalid_argument("Unknown serial backend: " + name.toStdString());
+}
+
+/**
+ * @brief 选择串口后端。
+ * @throw std::runtime_error 如果串口已打开。
+ */
+void SerialInfo::SetBackend(Backend newBackend)
+{
+	if (QThread::currentThread() != serialReadThread)
+	{
+		return RunOnPortThread([this, newBackend]() { SetBackend(newBackend); });
+	}
+	if ((serialPort && serialPort->isOpen()) || (nativePort && nativePort->IsOpen()))
+	{
+		throw std::runtime_error("Close the serial port before changing the backend.");
+	}
+	backend = newBackend;
+}
+
 /**
  * @brief 设置串口波特率。
  * @param baudRate 要设置的波特率值 (例如 9600, 19200 等)。
@@ -186,6 +272,10 @@ void SerialInfo::SetParity(QString parityStr)
 void SerialInfo::SetSerialConfiguration(qint32 baudRate, qint32 dataBits,
 	qint32 stopBits, QString parity, QString SerialName)
 {
+	if (QThread::currentThread() != serialReadThread)
+	{
+		return RunOnPortThread([this, baudRate, dataBits, stopBits, parity, SerialName]() { SetSerialConfiguration(baudRate, dataBits, stopBits, parity, SerialName); });
+	}
 	// 调用各个单独的设置函数来更新成员变量
 	// SetBaudRate 内部包含对波特率有效性的检查
 	SetBaudRate(baudRate);
@@ -214,10 +304,33 @@ QSerialPort* SerialInfo::GetSerialPort()
  */
 bool SerialInfo::SerialChangestate(bool currentState)
 {
+	// 打开和关闭与自动重连都在串口线程中进行，不会交错
+	if (QThread::currentThread() != serialReadThread)
+	{
+		return RunOnPortThread([this, currentState]() { return SerialChangestate(currentState); });
+	}
+	// 用户打开或关闭串口时结束正在进行的自动重连，设备此时已经关闭
+	StopReconnect();
+	if (backend == Backend::Native)
+	{
+		if (currentState == false)
+		{
+			OpenNative();
+			qDebug() << "Serial port opened with the native backend.";
+			emit SerialStateChanged(true);
+			return true;
+		}
+		if (nativePort && nativePort->IsOpen())
+		{
+			nativePort->Close();
+			qDebug() << "Serial port closed.";
+		}
+		emit SerialStateChanged(false);
+		return false;
+	}
+
 	if (serialPort == nullptr)
 	{
-		// serialPort 应该在线程启动时创建，这里只是一个备用检查
-		serialPort = new QSerialPort();
 		ConfigureSerialPort();
 	}
 
@@ -226,10 +339,6 @@ bool SerialInfo::SerialChangestate(bool currentState)
 		if (serialPort->open(QIODevice::ReadWrite | QIODevice::ExistingOnly))
 		{
 			qDebug() << "Serial port opened successfully.";
-			// 启动线程来处理 readyRead 信号
-			if (!serialReadThread->isRunning()) {
-				serialReadThread->start();
-			}
 			emit SerialStateChanged(true); // 发出串口状态改变信号
 			return true;
 		}
@@ -242,17 +351,8 @@ bool SerialInfo::SerialChangestate(bool currentState)
 	{
 		if (serialPort->isOpen())
 		{
-			// 断开 readyRead 信号连接，防止在关闭过程中继续触发
-			disconnect(serialPort, &QSerialPort::readyRead, this, &SerialInfo::handleReadyRead);
-
 			serialPort->close();
 			qDebug() << "Serial port closed.";
-
-			// 停止线程
-			if (serialReadThread->isRunning()) {
-				serialReadThread->quit();
-				serialReadThread->wait(); // 等待线程结束
-			}
 			emit SerialStateChanged(false); // 发出串口状态改变信号
 			return false;
 		}
@@ -270,6 +370,18 @@ bool SerialInfo::SerialChangestate(bool currentState)
  */
 void SerialInfo::SerialSendMessage(QString Mess)
 {
+	if (backend == Backend::Native)
+	{
+		const QByteArray data = Mess.toLatin1();
+		SerialSendBytes(data);
+		qDebug() << "Message sent:" << Mess;
+		return;
+	}
+
+	if (QThread::currentThread() != serialReadThread)
+	{
+		return RunOnPortThread([this, Mess]() { SerialSendMessage(Mess); });
+	}
 	// 检查串口是否已初始化
 	if (serialPort == nullptr)
 	{
@@ -285,6 +397,7 @@ void SerialInfo::SerialSendMessage(QString Mess)
 	// 将消息转换为字节数组并发送
 	auto data = Mess.toLatin1();
 	qint64 bytesWritten = serialPort->write(data);
+	FlightRecorder::Instance().Record(FlightRecorder::Kind::Tx, flightChannel, data.constData(), static_cast<size_t>(data.size()));
 
 	// 检查是否成功写入
 	if (bytesWritten == -1)
@@ -295,21 +408,396 @@ void SerialInfo::SerialSendMessage(QString Mess)
 	qDebug() << "Message sent:" << Mess;
 }
 
+/**
+ * @brief 通过串口原样发送字节数据。
+ * @param data 要发送的数据。
+ * @throw std::runtime_error 如果串口未初始化、未打开或写入失败。
+ */
+void SerialInfo::SerialSendBytes(const QByteArray& data)
+{
+	if (backend == Backend::Native)
+	{
+		if (!nativePort || !nativePort->IsOpen())
+		{
+			throw std::runtime_error("Serial port is not open.");
+		}
+		nativePort->Write(data.constData(), static_cast<size_t>(data.size()));
+		FlightRecorder::Instance().Record(FlightRecorder::Kind::Tx, flightChannel, data.constData(), static_cast<size_t>(data.size()));
+		return;
+	}
+	if (QThread::currentThread() != serialReadThread)
+	{
+		return RunOnPortThread([this, data]() { SerialSendBytes(data); });
+	}
+	if (serialPort == nullptr || !serialPort->isOpen())
+	{
+		throw std::runtime_error("Serial port is not open.");
+	}
+	if (serialPort->write(data) == -1)
+	{
+		throw std::runtime_error("Failed to write to the serial port.");
+	}
+	FlightRecorder::Instance().Record(FlightRecorder::Kind::Tx, flightChannel, data.constData(), static_cast<size_t>(data.size()));
+}
+
+/**
+ * @brief 启用本地分发桥。
+ * 客户端发来的数据在串口未打开时直接丢弃，不影响其他客户端。
+ * @throw std::runtime_error 如果监听失败。
+ */
+void SerialInfo::EnableFanout(quint16 tcpPort, const QString& localName)
+{
+	if (QThread::currentThread() != serialReadThread)
+	{
+		return RunOnPortThread([this, tcpPort, localName]() { EnableFanout(tcpPort, localName); });
+	}
+	if (fanout == nullptr)
+	{
+		fanout = new SerialFanout(rxRing, this);
+		fanout->SetTxHandler([this](const QByteArray& data) {
+			try
+			{
+				SerialSendBytes(data);
+			}
+			catch (const std::runtime_error& e)
+			{
+				qDebug() << "Fan-out TX dropped:" << e.what();
+			}
+			});
+	}
+	fanoutActive.store(true);
+	if (tcpPort != 0)
+	{
+		fanout->ListenTcp(tcpPort);
+	}
+	if (!localName.isEmpty())
+	{
+		fanout->ListenLocal(localName);
+	}
+}
+
+/**
+ * @brief 关闭本地分发桥并断开所有客户端，同时释放接收环形缓冲区中的数据。
+ */
+void SerialInfo::DisableFanout()
+{
+	if (QThread::currentThread() != serialReadThread)
+	{
+		return RunOnPortThread([this]() { DisableFanout(); });
+	}
+	if (fanout == nullptr)
+	{
+		return;
+	}
+	fanoutActive.store(false);
+	fanout->Close();
+	fanout->deleteLater();
+	fanout = nullptr;
+	rxRing.Clear();
+}
+
+SerialFanout* SerialInfo::GetFanout() const
+{
+	return fanout;
+}
+
 /**
  * @brief 处理串口 readyRead 信号的槽函数。
  * 读取所有可用数据并通过 DataReceived 信号发出。
+ * 启用分发桥时数据块同时放入接收环形缓冲区，与信号共享同一份数据。
  */
 void SerialInfo::handleReadyRead()
 {
+	TRACE_ZONE("SerialInfo::handleReadyRead");
 	if (serialPort && serialPort->isOpen() && serialPort->isReadable())
 	{
+		const qint64 receivedNs = TraceRecorder::NowNs();
 		QByteArray data = serialPort->readAll();
 		if (!data.isEmpty())
 		{
-			emit DataReceived(data);
-			qDebug() << "Data received from serial port:" << data;
+			DeliverReceived(data, receivedNs);
+		}
+	}
+}
+
+/**
+ * @brief 处理一个接收数据块。
+ * QSerialPort 后端在本对象的线程中调用，原生后端在其读取线程中调用，
+ * 此时放入环形缓冲区的操作排队到本对象的线程中执行，数据块仍然是同一份。
+ */
+void SerialInfo::DeliverReceived(const QByteArray& data, qint64 receivedNs)
+{
+	// 转发在记录和解码之前完成，附加延迟只包含一次写出
+	if (SerialInfo* target = relayTarget.load(std::memory_order_acquire))
+	{
+		target->RelayFrom(this, data, receivedNs);
+	}
+	FlightRecorder::Instance().Record(FlightRecorder::Kind::Rx, flightChannel, data.constData(), static_cast<size_t>(data.size()));
+	if (fanoutActive.load(std::memory_order_relaxed))
+	{
+		if (QThread::currentThread() == thread())
+		{
+			rxRing.Push(data);
+			fanout->Publish();
+		}
+		else
+		{
+			QMetaObject::invokeMethod(this, [this, data]() {
+				if (fanout != nullptr)
+				{
+					rxRing.Push(data);
+					fanout->Publish();
+				}
+				}, Qt::QueuedConnection);
+		}
+	}
+	if (queueTracked.load(std::memory_order_relaxed))
+	{
+		if (shedding.load(std::memory_order_relaxed))
+		{
+			if (queuedBytes.load(std::memory_order_acquire) > 0)
+			{
+				if (gapBytes == 0)
+				{
+					emit SheddingStarted();
+				}
+				gapBytes += static_cast<quint64>(data.size());
+				shedBytes.fetch_add(static_cast<quint64>(data.size()), std::memory_order_relaxed);
+				return;
+			}
+			shedding.store(false, std::memory_order_relaxed);
+			qWarning() << "Serial port" << portName << "resumed after shedding" << ShedBytes() << "bytes in total.";
+		}
+		if (gapBytes > 0)
+		{
+			emit SheddingStopped(gapBytes);
+			gapBytes = 0;
+		}
+		queuedBytes.fetch_add(data.size(), std::memory_order_relaxed);
+	}
+	emit DataReceived(data, receivedNs);
+}
+
+/**
+ * @brief 登记接收队列和分发桥环形缓冲区。
+ * 环形缓冲区按上限计入，它的大小固定；接收队列的积压只能靠暂停接收来减少，
+ * 释放函数因此只设置暂停标志，积压随接收方处理逐渐下降，下一次检查时计入。
+ */
+void SerialInfo::TrackMemory(const std::string& name)
+{
+	queueTracked.store(true, std::memory_order_relaxed);
+	memoryRegistration = MemoryBudget::Instance().Register(name, MemoryBudget::Policy::DropNewest,
+		[this]() {
+			const qint64 queued = queuedBytes.load(std::memory_order_relaxed);
+			const qint64 ring = fanoutActive.load(std::memory_order_relaxed) ? rxRing.MaxBytes() : 0;
+			return static_cast<size_t>(qMax<qint64>(queued, 0) + ring);
+		},
+		[this](size_t, MemoryBudget::Policy) {
+			if (queuedBytes.load(std::memory_order_relaxed) > 0 && !shedding.exchange(true))
+			{
+				qWarning() << "Serial port" << portName << "over the memory budget, pausing DataReceived.";
+			}
+			return size_t(0);
+		});
+}
+
+void SerialInfo::SetRelayTarget(SerialInfo* target)
+{
+	relayTarget.store(target, std::memory_order_release);
+}
+
+/**
+ * @brief 把 source 收到的数据写到本串口。
+ * QSerialPort 只能在它所在的线程中使用，不在该线程时排队执行；写入后 flush 把数据立即交给内核，
+ * relayedNs 因此是数据离开本程序的时间。
+ */
+void SerialInfo::RelayFrom(SerialInfo* source, const QByteArray& data, qint64 receivedNs)
+{
+	if (backend == Backend::Native || serialPort == nullptr)
+	{
+		qint64 relayedNs = -1;
+		try
+		{
+			SerialSendBytes(data);
+			relayedNs = TraceRecorder::NowNs();
+		}
+		catch (const std::runtime_error& e)
+		{
+			qWarning() << "Relay to" << portName << "dropped:" << e.what();
+		}
+		emit source->DataRelayed(data, receivedNs, relayedNs);
+		return;
+	}
+	QMetaObject::invokeMethod(serialPort, [this, source, data, receivedNs]() {
+		qint64 relayedNs = -1;
+		if (serialPort->isOpen() && serialPort->write(data) == data.size())
+		{
+			serialPort->flush();
+			relayedNs = TraceRecorder::NowNs();
+			FlightRecorder::Instance().Record(FlightRecorder::Kind::Tx, flightChannel, data.constData(), static_cast<size_t>(data.size()));
+		}
+		else
+		{
+			qWarning() << "Relay to" << portName << "dropped:" << serialPort->errorString();
+		}
+		emit source->DataRelayed(data, receivedNs, relayedNs);
+		});
+}
+
+/**
+ * @brief 处理 QSerialPort 的错误。
+ * USB 转串口被拔出时报告 ResourceError；伪终端等设备挂断时 read 返回 0，报告的错误类型取决于 errno，
+ * 这时以设备节点是否已经消失为准。打开失败等串口未打开时的错误由打开方处理。
+ */
+void SerialInfo::HandleSerialError(QSerialPort::SerialPortError error)
+{
+	if (error == QSerialPort::NoError || error == QSerialPort::TimeoutError || !serialPort->isOpen())
+	{
+		return;
+	}
+	if (error != QSerialPort::ResourceError && DevicePresent())
+	{
+		return;
+	}
+	if (!autoReconnect.load() || reconnecting.exchange(true))
+	{
+		return;
+	}
+	const QString reason = serialPort->errorString();
+	qWarning() << "Serial port" << portName << "error:" << reason;
+	// 错误在 QSerialPort 内部的读写处理中报告，回到事件循环后再读出剩余数据、发出 ConnectionLost 并关闭设备
+	QMetaObject::invokeMethod(this, [this, reason]() {
+		handleReadyRead();
+		NotifyLinkLost(reason);
+		BeginReconnect();
+		}, Qt::QueuedConnection);
+}
+
+void SerialInfo::NotifyLinkLost(const QString& reason)
+{
+	lostNs = TraceRecorder::NowNs();
+	const QByteArray note = ("link lost: " + reason).toUtf8();
+	FlightRecorder::Instance().Record(FlightRecorder::Kind::Note, flightChannel, note.constData(), static_cast<size_t>(note.size()));
+	emit ConnectionLost(reason);
+}
+
+/**
+ * @brief 关闭断开的设备，开始检查设备节点。用户已经关闭串口时什么也不做。
+ */
+void SerialInfo::BeginReconnect()
+{
+	if (!reconnecting.load())
+	{
+		return;
+	}
+	if (backend == Backend::Native)
+	{
+		nativePort->Close();
+	}
+	else
+	{
+		serialPort->close();
+		serialPort->clearError();
+	}
+	++reconnectStats.losses;
+	appearedNs = 0;
+	retryMs = kFirstRetryMs;
+	qWarning() << "Serial port" << portName << "lost, waiting for the device to return.";
+	reconnectTimer->start(kPresencePollMs);
+}
+
+/**
+ * @brief 设备不存在时每 kPresencePollMs 检查一次；存在时立即打开，失败后从 kFirstRetryMs 开始加倍退避。
+ * 设备节点出现到可以打开之间通常有几到几十毫秒（udev 设置权限、驱动初始化），退避上限取 kMaxRetryMs，
+ * 重连时间由检查间隔和这段时间决定。reconnecting 在打开之前清除，原生后端的读取线程启动后立即发生的断开也能检测到。
+ */
+void SerialInfo::TryReconnect()
+{
+	if (!reconnecting.load())
+	{
+		return;
+	}
+	if (!DevicePresent())
+	{
+		appearedNs = 0;
+		retryMs = kFirstRetryMs;
+		reconnectTimer->start(kPresencePollMs);
+		return;
+	}
+	if (appearedNs == 0)
+	{
+		appearedNs = TraceRecorder::NowNs();
+	}
+	QString error;
+	reconnecting.store(false);
+	if (!Reopen(error))
+	{
+		reconnecting.store(true);
+		if (backend == Backend::QtSerialPort && serialPort->error() == QSerialPort::DeviceNotFoundError)
+		{
+			appearedNs = 0;
+			reconnectTimer->start(kPresencePollMs);
+			return;
 		}
+		++reconnectStats.failedOpens;
+		qDebug() << "Reopening" << portName << "failed:" << error << "- retrying in" << retryMs << "ms";
+		reconnectTimer->start(retryMs);
+		retryMs = qMin(retryMs * 2, kMaxRetryMs);
+		return;
 	}
+
+	const qint64 openedNs = TraceRecorder::NowNs();
+	const qint64 outageNs = openedNs - lostNs;
+	const qint64 reopenNs = openedNs - appearedNs;
+	++reconnectStats.reconnects;
+	reconnectStats.lastOutageNs = outageNs;
+	reconnectStats.lastReopenNs = reopenNs;
+	reconnectStats.maxReopenNs = qMax(reconnectStats.maxReopenNs, reopenNs);
+	const QByteArray note = QString("link restored after %1 ms, reopened %2 ms after the device returned")
+		.arg(outageNs / 1e6, 0, 'f', 1).arg(reopenNs / 1e6, 0, 'f', 1).toUtf8();
+	FlightRecorder::Instance().Record(FlightRecorder::Kind::Note, flightChannel, note.constData(), static_cast<size_t>(note.size()));
+	qDebug() << "Serial port" << portName << note;
+	emit Reconnected(outageNs, reopenNs);
+}
+
+void SerialInfo::StopReconnect()
+{
+	if (reconnecting.exchange(false))
+	{
+		reconnectTimer->stop();
+	}
+}
+
+bool SerialInfo::DevicePresent() const
+{
+#ifdef Q_OS_WIN
+	return true;
+#else
+	return QFileInfo::exists(portName.startsWith('/') ? portName : "/dev/" + portName);
+#endif
+}
+
+bool SerialInfo::Reopen(QString& error)
+{
+	if (backend == Backend::Native)
+	{
+		try
+		{
+			OpenNative();
+			return true;
+		}
+		catch (const std::runtime_error& e)
+		{
+			error = e.what();
+			return false;
+		}
+	}
+	if (serialPort->open(QIODevice::ReadWrite | QIODevice::ExistingOnly))
+	{
+		return true;
+	}
+	error = serialPort->errorString();
+	return false;
 }
 
 /**
@@ -318,18 +806,13 @@ void SerialInfo::handleReadyRead()
  */
 void SerialInfo::startSerialReadThread()
 {
-	// 实际的线程启动逻辑已经在构造函数和 SerialChangestate 中处理
-	// 这个槽函数可以作为外部触发线程启动的接口，但其内部逻辑可能很简单，
-	// 或者用于确保对象在正确线程中被初始化。
-	// 由于 SerialInfo 已经移动到 serialReadThread，这个槽函数将在 serialReadThread 中执行。
-	// 确保 serialPort 在此线程中被创建和使用。
-	if (serialPort == nullptr) {
-		serialPort = new QSerialPort();
-		ConfigureSerialPort();
-	}
-	// 连接 readyRead 信号到 handleReadyRead 槽
-	connect(serialPort, &QSerialPort::readyRead, this, &SerialInfo::handleReadyRead);
-	qDebug() << "Serial read thread started and readyRead connected.";
+	// 线程在构造函数中启动，readyRead 在 ConfigureSerialPort 创建 QSerialPort 时连接，
+	// 这里只确保 serialPort 在串口线程中被创建
+	RunOnPortThread([this]() {
+		if (serialPort == nullptr) {
+			ConfigureSerialPort();
+		}
+		});
 }
 
 /**
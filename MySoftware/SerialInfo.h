@@ -6,15 +6,22 @@
  * @Copyright: Copyright (c) 2025 CAUC
  */
 #pragma once
-#include "ui_USARTAss.h"
 #include <QtSerialPort/QSerialPort>
 #include <QtSerialPort/QSerialPortInfo>
-#include <QtWidgets/QDialog>
 #include <QtCore/QtGlobal>
 #include <vector>
 #include <QtCore/QDebug>
-#include <QtCharts/QChartView> // 添加此行以包含 QChartView 的定义
 #include <QThread>
+#include <QTimer>
+#include <memory>
+#include <atomic>
+#include <future>
+#include "RxRing.h"
+#include "FlightRecorder.h"
+#include "MemoryBudget.h"
+#include "NativeSerialPort.h"
+
+class SerialFanout;
 
  /**
   * @brief SerialInfo类用于管理串口通信的配置和操作。
@@ -22,6 +29,10 @@
   * 此类提供设置串口参数（如波特率、数据位、停止位、校验位）、
   * 打开/关闭串口、发送和接收数据的功能。
   * 它采用单例模式确保全局只有一个串口配置实例。
+  *
+  * 对象本身、QSerialPort、重连定时器和分发桥都在串口线程中，读取、转发和分发不经过界面线程的事件循环；
+  * 其他线程调用的公共函数经 RunOnPortThread 在串口线程中执行并等待完成。
+  * 因此对象不能有父对象，由创建方用 std::unique_ptr 或成员变量持有。
   */
 class SerialInfo : public QObject
 {
@@ -29,9 +40,24 @@ class SerialInfo : public QObject
 
 public:
 	/**
-	 * @brief SerialInfo类的构造函数。
+	 * @brief 串口读写后端。
 	 */
-	SerialInfo(QObject* parent = nullptr);
+	enum class Backend
+	{
+		QtSerialPort, /**< QSerialPort，所有平台可用。 */
+		Native        /**< NativeSerialPort，Linux 上的 termios/epoll 实现。 */
+	};
+
+	/**
+	 * @brief 按名称获取后端，"qt" 或 "native"。
+	 * @throw std::invalid_argument 如果名称无法识别或当前平台不支持该后端。
+	 */
+	static Backend BackendFromName(const QString& name);
+
+	/**
+	 * @brief SerialInfo类的构造函数，启动串口线程并把对象移动到该线程中。
+	 */
+	SerialInfo();
 	/**
 	 * @brief SerialInfo类的析构函数。
 	 */
@@ -49,10 +75,47 @@ public:
 		QString parity, QString SerialName);
 	/**
 	 * @brief 获取当前的QSerialPort对象。
-	 * @return 返回指向QSerialPort对象的指针。
+	 * 对象在串口线程中，其他线程只能经 RunOnPortThread 使用它。
+	 * @return 返回指向QSerialPort对象的指针，使用原生后端时串口始终处于关闭状态。
 	 */
 	QSerialPort* GetSerialPort();
 
+	/**
+	 * @brief 在串口线程中执行 fn 并等待完成，在串口线程中调用时直接执行。
+	 * @return fn 的返回值，fn 抛出的异常在调用线程中重新抛出。
+	 */
+	template <typename Fn>
+	auto RunOnPortThread(Fn fn) -> decltype(fn())
+	{
+		if (QThread::currentThread() == serialReadThread)
+		{
+			return fn();
+		}
+		std::packaged_task<decltype(fn())()> task(std::move(fn));
+		auto result = task.get_future();
+		QMetaObject::invokeMethod(this, [&task]() { task(); }, Qt::BlockingQueuedConnection);
+		return result.get();
+	}
+
+	/**
+	 * @brief 选择串口后端，只能在串口关闭时调用。
+	 * 原生后端在读取线程中直接把数据块交给 DataReceived，不经过 QSerialPort 的内部缓冲和事件循环通知器；
+	 * 依赖 QSerialPort 写缓冲的文件发送只支持 QSerialPort 后端。
+	 * @throw std::runtime_error 如果串口已打开。
+	 */
+	void SetBackend(Backend backend);
+
+	/**
+	 * @brief 当前使用的串口后端。
+	 */
+	Backend GetBackend() const { return backend; }
+
+	/**
+	 * @brief 原生后端对象。
+	 * @return 使用 QSerialPort 后端或尚未打开过串口时返回 nullptr。
+	 */
+	const NativeSerialPort* GetNativePort() const { return nativePort.get(); }
+
 	/**
 	 * @brief 更改串口的打开/关闭状态。
 	 * @param currentState 当前串口是否打开的状态 (true表示已打开, false表示已关闭)。
@@ -65,16 +128,142 @@ public:
 	 * @param Mess 要发送的字符串消息。
 	 */
 	void SerialSendMessage(QString Mess);
+
+	/**
+	 * @brief 通过串口原样发送字节数据。
+	 * @param data 要发送的数据。
+	 * @throw std::runtime_error 如果串口未初始化、未打开或写入失败。
+	 */
+	void SerialSendBytes(const QByteArray& data);
+
+	/**
+	 * @brief 启用本地分发桥，把接收数据分发给 TCP / 本地套接字客户端，并把客户端数据发到串口。
+	 * 可以多次调用以同时监听 TCP 端口和本地套接字。
+	 * @param tcpPort 127.0.0.1 上的 TCP 端口，0 表示不监听 TCP。
+	 * @param localName 本地套接字名称，空表示不监听本地套接字。
+	 * @throw std::runtime_error 如果监听失败。
+	 */
+	void EnableFanout(quint16 tcpPort, const QString& localName = QString());
+
+	/**
+	 * @brief 关闭本地分发桥并断开所有客户端。
+	 */
+	void DisableFanout();
+
+	/**
+	 * @brief 获取本地分发桥。
+	 * @return 未启用时返回 nullptr。
+	 */
+	SerialFanout* GetFanout() const;
+
+	/**
+	 * @brief 设置透明转发目标：本串口收到的数据在 I/O 线程中先写到 target，再做记录、解码和界面处理，
+	 * 写出后发出 DataRelayed。两个串口互相设置即为双向的中间人转发（嗅探）模式。
+	 * 原生后端在读取线程中直接写出；QSerialPort 后端排队到目标 QSerialPort 所在的线程写出并立即 flush。
+	 * @param target 转发目标，nullptr 取消转发。目标对象必须在取消转发之后才能销毁。
+	 */
+	void SetRelayTarget(SerialInfo* target);
+
+	/**
+	 * @brief 在 MemoryBudget 中登记接收队列和分发桥环形缓冲区。
+	 * 登记后 DataReceived 的接收方必须在处理完每个数据块后调用 ChunkConsumed，
+	 * 排队等待接收方处理的字节数计入预算；超过预算时暂停发出 DataReceived（DropNewest），
+	 * 直到积压的数据块处理完。已经排队的数据块无法收回，只能丢弃新到的数据，
+	 * 丢弃的前后发出 SheddingStarted 和 SheddingStopped，接收方像断线一样复位解码器并标记空白。
+	 * 转发、飞行记录和分发桥不受影响。
+	 * @param name 在预算中显示的名称。
+	 */
+	void TrackMemory(const std::string& name);
+
+	/**
+	 * @brief DataReceived 的接收方处理完一个数据块后调用，见 TrackMemory。
+	 */
+	void ChunkConsumed(qint64 bytes) { queuedBytes.fetch_sub(bytes, std::memory_order_release); }
+
+	/**
+	 * @brief 因超过内存预算没有发出 DataReceived 的累计字节数。
+	 */
+	quint64 ShedBytes() const { return shedBytes.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief 本串口在飞行记录仪中的通道号。
+	 */
+	quint8 FlightChannel() const { return flightChannel; }
+
+	/**
+	 * @brief 自动重连的统计，在串口线程中更新。
+	 */
+	struct ReconnectStats
+	{
+		quint64 losses = 0;       /**< 检测到的断开次数。 */
+		quint64 reconnects = 0;   /**< 重新打开成功的次数。 */
+		quint64 failedOpens = 0;  /**< 设备出现后打开失败的次数，例如设备节点的权限还没有设置好。 */
+		qint64 lastOutageNs = 0;  /**< 最近一次从检测到断开到重新打开的时间。 */
+		qint64 lastReopenNs = 0;  /**< 最近一次从设备重新出现到打开成功的时间。 */
+		qint64 maxReopenNs = 0;   /**< 设备重新出现到打开成功的最长时间。 */
+	};
+
+	/**
+	 * @brief 设置是否自动重连，默认开启。
+	 * 开启时，设备断开（QSerialPort 的 ResourceError、原生后端的挂断）后串口在逻辑上保持打开：
+	 * 发出 ConnectionLost 后关闭设备，每 10 ms 检查设备节点是否重新出现，出现后立即打开，
+	 * 失败时（udev 还在设置权限、驱动还未就绪）按 5、10、20、40 ms 退避重试，成功后发出 Reconnected。
+	 * 关闭时设备断开后的行为与以前相同。
+	 */
+	void SetAutoReconnect(bool enabled) { autoReconnect.store(enabled); }
+
+	/**
+	 * @brief 是否正在等待设备重新出现。
+	 */
+	bool IsReconnecting() const { return reconnecting.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief 自动重连统计的副本。
+	 */
+	ReconnectStats GetReconnectStats() { return RunOnPortThread([this]() { return reconnectStats; }); }
 	// 删除 SerialRecvMessage 方法，数据接收将通过 readyRead 信号触发，并在槽函数中处理
 
 signals:
 	/**
 	 * @brief 串口数据接收完成后发出的信号。
+	 * 接收方在界面线程中处理时可能已经排队了一段时间，按数据时间求值的报警、滤波等应使用 receivedNs。
 	 * @param data 接收到的数据。
+	 * @param receivedNs 从串口读到这个数据块的时间（TraceRecorder::NowNs）。
+	 */
+	void DataReceived(const QByteArray& data, qint64 receivedNs);
+	/**
+	 * @brief 转发模式下，本串口收到的数据块写到目标串口之后发出。
+	 * @param data 转发的数据。
+	 * @param receivedNs 读到数据的时间（TraceRecorder::NowNs）。
+	 * @param relayedNs 写到目标串口的时间，转发失败时为 -1。
 	 */
-	void DataReceived(const QByteArray& data);
+	void DataRelayed(const QByteArray& data, qint64 receivedNs, qint64 relayedNs);
 	// 添加一个信号，用于通知外部串口已打开/关闭
 	void SerialStateChanged(bool isOpen);
+	/**
+	 * @brief 自动重连模式下检测到设备断开，例如 USB 转串口被拔出或复位。
+	 * 与 DataReceived 在同一线程中、断开前最后一个数据块之后发出，接收方在这里复位解码器，
+	 * 断开前的半帧不会与重连后的数据拼在一起。串口在逻辑上保持打开，不发出 SerialStateChanged。
+	 * @param reason 错误描述。
+	 */
+	void ConnectionLost(const QString& reason);
+	/**
+	 * @brief 断开后重新打开成功。
+	 * @param outageNs 从检测到断开到重新打开的时间。
+	 * @param reopenNs 从设备重新出现到打开成功的时间。
+	 */
+	void Reconnected(qint64 outageNs, qint64 reopenNs);
+	/**
+	 * @brief 超过内存预算，开始丢弃接收数据。
+	 * 与 DataReceived 在同一线程中、丢弃前最后一个数据块之后发出，接收方在这里复位解码器并开始一段空白，
+	 * 半帧不会与恢复后的数据拼在一起。
+	 */
+	void SheddingStarted();
+	/**
+	 * @brief 积压处理完，恢复发出 DataReceived，在恢复后的第一个数据块之前发出。
+	 * @param droppedBytes 本次丢弃的字节数。
+	 */
+	void SheddingStopped(quint64 droppedBytes);
 
 public slots:
 	//void SerialDatadisposed(float data);
@@ -95,6 +284,62 @@ private:
 	 * @brief 配置串口参数。
 	 */
 	void ConfigureSerialPort();
+
+	/**
+	 * @brief 用原生后端打开串口并启动读取线程。
+	 * @throw std::runtime_error 如果打开失败。
+	 */
+	void OpenNative();
+
+	/**
+	 * @brief 处理一个接收数据块：写入飞行记录仪，启用分发桥时放入接收环形缓冲区，然后发出 DataReceived。
+	 * 可以在任意线程中调用，环形缓冲区的写入总是在本对象所在线程中完成。
+	 * @param data 接收到的数据。
+	 * @param receivedNs 读到数据的时间（TraceRecorder::NowNs）。
+	 */
+	void DeliverReceived(const QByteArray& data, qint64 receivedNs);
+
+	/**
+	 * @brief 处理 QSerialPort 的错误，在串口所在线程中调用。设备断开时开始自动重连。
+	 */
+	void HandleSerialError(QSerialPort::SerialPortError error);
+
+	/**
+	 * @brief 记录断开并发出 ConnectionLost，在发出 DataReceived 的线程中调用。
+	 */
+	void NotifyLinkLost(const QString& reason);
+
+	/**
+	 * @brief 关闭断开的设备并开始等待设备重新出现，在重连定时器所在线程中调用。
+	 */
+	void BeginReconnect();
+
+	/**
+	 * @brief 重连定时器到期：设备存在时尝试打开，失败时退避重试。
+	 */
+	void TryReconnect();
+
+	/**
+	 * @brief 结束正在进行的自动重连，用户打开或关闭串口时调用。
+	 */
+	void StopReconnect();
+
+	/**
+	 * @brief 设备节点是否存在。Windows 上总是返回 true，COM 口不存在时打开会立即失败。
+	 */
+	bool DevicePresent() const;
+
+	/**
+	 * @brief 用当前后端重新打开设备，不启动或停止本对象的线程，也不发出 SerialStateChanged。
+	 * @param error 失败时的错误描述。
+	 * @return 是否成功。
+	 */
+	bool Reopen(QString& error);
+
+	/**
+	 * @brief 把 source 收到的数据写到本串口，完成后由 source 发出 DataRelayed。
+	 */
+	void RelayFrom(SerialInfo* source, const QByteArray& data, qint64 receivedNs);
 	/**
 	 * @brief 设置串口名称。
 	 * @param SerialName 包含串口名称的字符串。
@@ -131,5 +376,25 @@ public:
 	QSerialPort::BaudRate baudRate; /**< 波特率。 */
 
 private:
-	QThread* serialReadThread; // 用于串口读取的线程
+	QThread* serialReadThread; // 串口线程，构造时启动，析构时停止
+	RxRing rxRing;             /**< 接收环形缓冲区，仅在启用分发桥时写入。 */
+	SerialFanout* fanout = nullptr; /**< 本地分发桥，子对象，在串口线程中创建和删除。 */
+	std::atomic<bool> fanoutActive{ false }; /**< 是否启用了分发桥，供原生后端的读取线程判断。 */
+	Backend backend = Backend::QtSerialPort; /**< 串口后端。 */
+	std::unique_ptr<NativeSerialPort> nativePort; /**< 原生后端，第一次用原生后端打开时创建。 */
+	std::atomic<SerialInfo*> relayTarget{ nullptr }; /**< 透明转发目标，在 I/O 线程中读取。 */
+	quint8 flightChannel = FlightRecorder::NextChannel(); /**< 飞行记录仪通道号。 */
+	std::atomic<bool> queueTracked{ false };   /**< 是否统计接收队列的积压。 */
+	std::atomic<qint64> queuedBytes{ 0 };      /**< 已发出 DataReceived、接收方尚未处理的字节数。 */
+	std::atomic<bool> shedding{ false };       /**< 超过预算后暂停发出 DataReceived，直到积压清空。 */
+	std::atomic<quint64> shedBytes{ 0 };       /**< 暂停期间没有发出的字节数。 */
+	quint64 gapBytes = 0;                      /**< 本次暂停丢弃的字节数，只在发出 DataReceived 的线程中访问。 */
+	std::unique_ptr<QTimer> reconnectTimer;    /**< 重连定时器，与 QSerialPort 一起在串口线程中。 */
+	std::atomic<bool> autoReconnect{ true };   /**< 是否自动重连。 */
+	std::atomic<bool> reconnecting{ false };   /**< 检测到断开后直到重新打开或用户关闭串口。 */
+	qint64 lostNs = 0;                         /**< 检测到断开的时间（TraceRecorder::NowNs）。 */
+	qint64 appearedNs = 0;                     /**< 设备重新出现的时间，0 表示还没有出现。 */
+	int retryMs = 0;                           /**< 下一次打开失败后的重试间隔。 */
+	ReconnectStats reconnectStats;             /**< 自动重连统计。 */
+	MemoryBudget::Registration memoryRegistration; /**< 预算登记项，析构函数中最先注销。 */
 };
@@ -0,0 +1,149 @@
+/*
+ * @Description: 解码帧共享内存环形缓冲区的内存布局，写端与外部读端共用，不依赖 Qt
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 14:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#if !defined(__unix__) && !defined(__APPLE__)
+#include <chrono>
+#endif
+
+/**
+ * @brief 共享内存中的解码帧环形缓冲区。
+ *
+ * 布局为一个 Header 后接 slotCount 个 Slot。第 n 帧（从 0 开始）写入 Slots[n % slotCount]，
+ * 写完后 Header::writeCount 更新为 n + 1。每个 Slot 用 sequence 做顺序锁：
+ * 写端先把 sequence 加一（奇数表示正在写），写完数据后再加一；
+ * 读端在读取前后各读一次 sequence，两次相同且为偶数才说明读到的是完整的一帧。
+ * 读端只需要轮询 writeCount，整个过程不需要任何系统调用，也不会阻塞写端。
+ */
+namespace ShmFrame
+{
+	constexpr uint32_t kMagic = 0x5246534D;  /**< "MSFR"。 */
+	constexpr uint32_t kVersion = 1;
+	constexpr uint32_t kMaxValues = 16;      /**< 每帧最多保存的数值个数。 */
+
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory needs lock-free atomics");
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory needs lock-free atomics");
+
+	/**
+	 * @brief 一帧数据，读端从 Slot 中复制出来的结果。
+	 */
+	struct Frame
+	{
+		uint64_t frameNumber;       /**< 帧序号，从 0 开始连续递增。 */
+		int64_t timestampNs;        /**< 写入时的 CLOCK_MONOTONIC 时间（纳秒）。 */
+		uint32_t source;            /**< 来源串口序号。 */
+		uint32_t headerIndex;       /**< 帧头序号，对应 DecodedRecord::index。 */
+		uint32_t count;             /**< values 中有效的个数。 */
+		uint32_t reserved;
+		double values[kMaxValues];  /**< 数值。 */
+	};
+
+	/**
+	 * @brief 环形缓冲区中的一个槽，按缓存行对齐，避免相邻槽之间的伪共享。
+	 */
+	struct alignas(64) Slot
+	{
+		std::atomic<uint32_t> sequence; /**< 顺序锁计数，奇数表示正在写入。 */
+		uint32_t reserved;
+		Frame frame;                    /**< 帧数据。 */
+	};
+
+	/**
+	 * @brief 共享内存头部。
+	 */
+	struct alignas(64) Header
+	{
+		uint32_t magic;                     /**< kMagic。 */
+		uint32_t version;                   /**< kVersion。 */
+		uint32_t slotCount;                 /**< 槽数量。 */
+		uint32_t slotSize;                  /**< sizeof(Slot)，读端用来检查布局是否一致。 */
+		alignas(64) std::atomic<uint64_t> writeCount; /**< 已发布的帧数。 */
+	};
+
+	/**
+	 * @brief 给定槽数量时共享内存段的总字节数。
+	 */
+	inline size_t SegmentSize(uint32_t slotCount)
+	{
+		return sizeof(Header) + static_cast<size_t>(slotCount) * sizeof(Slot);
+	}
+
+	/**
+	 * @brief 获取槽数组的起始地址。
+	 */
+	inline Slot* Slots(Header* header)
+	{
+		return reinterpret_cast<Slot*>(reinterpret_cast<char*>(header) + sizeof(Header));
+	}
+
+	inline const Slot* Slots(const Header* header)
+	{
+		return reinterpret_cast<const Slot*>(reinterpret_cast<const char*>(header) + sizeof(Header));
+	}
+
+	/**
+	 * @brief 当前 CLOCK_MONOTONIC 时间（纳秒），进程之间可以直接比较。
+	 */
+	inline int64_t NowNs()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	/**
+	 * @brief 写端写入一帧，只能由唯一的写端调用。
+	 * @param header 共享内存头部。
+	 * @param frame 帧数据，frameNumber 由本函数填写。
+	 */
+	inline void WriteFrame(Header* header, const Frame& frame)
+	{
+		const uint64_t number = header->writeCount.load(std::memory_order_relaxed);
+		Slot& slot = Slots(header)[number % header->slotCount];
+		const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+
+		slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		std::memcpy(&slot.frame, &frame, sizeof(Frame));
+		slot.frame.frameNumber = number;
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+
+		header->writeCount.store(number + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief 读端读取第 number 帧。
+	 * @param header 共享内存头部。
+	 * @param number 帧序号。
+	 * @param out 读取结果。
+	 * @return 读到完整的第 number 帧时返回 true；
+	 *         正在被写入或已经被后面的帧覆盖时返回 false，调用方可根据 writeCount 判断是哪一种。
+	 */
+	inline bool ReadFrame(const Header* header, uint64_t number, Frame& out)
+	{
+		const Slot& slot = Slots(header)[number % header->slotCount];
+		const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+		if (before & 1u)
+		{
+			return false;
+		}
+		std::memcpy(&out, &slot.frame, sizeof(Frame));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint32_t after = slot.sequence.load(std::memory_order_relaxed);
+		return before == after && out.frameNumber == number;
+	}
+}
@@ -0,0 +1,134 @@
+/*
+ * @Description: 把解码帧发布到 POSIX 共享内存，供同一台机器上的其他进程无系统调用地轮询读取
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 14:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "ShmFramePublisher.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define MYSOFTWARE_HAVE_SHM 1
+#endif
+
+ShmFramePublisher::~ShmFramePublisher()
+{
+	Close();
+}
+
+/**
+ * @brief 创建共享内存段。
+ * 同名的旧段会先被删除，避免读端连到上一次运行留下的数据。
+ * @throw std::runtime_error 如果创建或映射失败，或平台不支持。
+ */
+void ShmFramePublisher::Open(const std::string& name, uint32_t slotCount)
+{
+	Close();
+	if (slotCount == 0)
+	{
+		throw std::runtime_error("Shared memory slot count must be positive.");
+	}
+
+#ifdef MYSOFTWARE_HAVE_SHM
+	const std::string shmName = name.empty() || name[0] != '/' ? "/" + name : name;
+	const size_t size = ShmFrame::SegmentSize(slotCount);
+
+	shm_unlink(shmName.c_str());
+	const int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0)
+	{
+		throw std::runtime_error("shm_open " + shmName + " failed: " + std::strerror(errno));
+	}
+	if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+	{
+		const int error = errno;
+		close(fd);
+		shm_unlink(shmName.c_str());
+		throw std::runtime_error("ftruncate " + shmName + " failed: " + std::strerror(error));
+	}
+	void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (address == MAP_FAILED)
+	{
+		const int error = errno;
+		shm_unlink(shmName.c_str());
+		throw std::runtime_error("mmap " + shmName + " failed: " + std::strerror(error));
+	}
+
+	// ftruncate 得到的内存已经清零，这里只需构造原子变量并填写头部
+	auto* header = new (address) ShmFrame::Header;
+	ShmFrame::Slot* slots = ShmFrame::Slots(header);
+	for (uint32_t i = 0; i < slotCount; ++i)
+	{
+		new (&slots[i]) ShmFrame::Slot;
+		slots[i].sequence.store(0, std::memory_order_relaxed);
+	}
+	header->slotCount = slotCount;
+	header->slotSize = sizeof(ShmFrame::Slot);
+	header->version = ShmFrame::kVersion;
+	header->writeCount.store(0, std::memory_order_relaxed);
+	// magic 最后写入，读端看到 magic 时其余字段都已就绪
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = ShmFrame::kMagic;
+
+	m_name = shmName;
+	m_header = header;
+	m_size = size;
+#else
+	(void)name;
+	throw std::runtime_error("Shared memory publication requires POSIX shm_open.");
+#endif
+}
+
+/**
+ * @brief 取消映射并删除共享内存段，已经连接的读端仍可读取最后的数据直到自行断开。
+ */
+void ShmFramePublisher::Close()
+{
+#ifdef MYSOFTWARE_HAVE_SHM
+	if (m_header != nullptr)
+	{
+		munmap(m_header, m_size);
+		shm_unlink(m_name.c_str());
+	}
+#endif
+	m_header = nullptr;
+	m_size = 0;
+	m_name.clear();
+}
+
+/**
+ * @brief 发布一条解码记录。
+ * 时间戳在写入时取得，读端用自己的 CLOCK_MONOTONIC 相减即可得到可见延迟。
+ */
+void ShmFramePublisher::Publish(uint32_t source, const DecodedRecord& record)
+{
+	if (m_header == nullptr || record.values == nullptr || record.count == 0)
+	{
+		return;
+	}
+
+	ShmFrame::Frame frame;
+	frame.frameNumber = 0;
+	frame.source = source;
+	frame.headerIndex = static_cast<uint32_t>(record.index);
+	frame.count = static_cast<uint32_t>(std::min<size_t>(record.count, ShmFrame::kMaxValues));
+	frame.reserved = 0;
+	std::copy(record.values, record.values + frame.count, frame.values);
+	std::fill(frame.values + frame.count, frame.values + ShmFrame::kMaxValues, 0.0);
+	frame.timestampNs = ShmFrame::NowNs();
+	ShmFrame::WriteFrame(m_header, frame);
+}
+
+uint64_t ShmFramePublisher::PublishedCount() const
+{
+	return m_header != nullptr ? m_header->writeCount.load(std::memory_order_relaxed) : 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * @Description: 把解码帧发布到 POSIX 共享内存，供同一台机器上的其他进程无系统调用地轮询读取
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 14:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include "ProtocolDecoder.h"
+#include "ShmFrameLayout.h"
+
+/**
+ * @brief ShmFramePublisher 创建共享内存段并按 ShmFrameLayout.h 的布局写入解码帧。
+ *
+ * 只能有一个写端；读端见 ShmReaderExample.cpp。
+ * 写入一帧只是一次内存复制加几次原子存储，不加锁、不进入内核，可以直接在解码回调中调用。
+ * 仅支持提供 shm_open 的 POSIX 系统，其他平台上 Open 抛出异常。
+ */
+class ShmFramePublisher
+{
+public:
+	ShmFramePublisher() = default;
+	~ShmFramePublisher();
+
+	ShmFramePublisher(const ShmFramePublisher&) = delete;
+	ShmFramePublisher& operator=(const ShmFramePublisher&) = delete;
+
+	/**
+	 * @brief 创建（或重新创建）共享内存段。
+	 * @param name 共享内存名称，不以 '/' 开头时自动补上。
+	 * @param slotCount 槽数量，读端落后超过该数量的帧会被覆盖。
+	 * @throw std::runtime_error 如果创建或映射失败，或平台不支持。
+	 */
+	void Open(const std::string& name, uint32_t slotCount = 4096);
+
+	/**
+	 * @brief 取消映射并删除共享内存段。
+	 */
+	void Close();
+
+	/**
+	 * @brief 是否已经打开。
+	 */
+	bool IsOpen() const { return m_header != nullptr; }
+
+	/**
+	 * @brief 发布一条解码记录，只有带数值的记录才会写入。
+	 * @param source 来源串口序号。
+	 * @param record 解码记录，超过 ShmFrame::kMaxValues 的数值被截断。
+	 */
+	void Publish(uint32_t source, const DecodedRecord& record);
+
+	/**
+	 * @brief 已发布的帧数。
+	 */
+	uint64_t PublishedCount() const;
+
+	/**
+	 * @brief 共享内存名称（以 '/' 开头）。
+	 */
+	const std::string& Name() const { return m_name; }
+
+private:
+	std::string m_name;                   /**< 共享内存名称。 */
+	ShmFrame::Header* m_header = nullptr; /**< 映射后的共享内存头部。 */
+	size_t m_size = 0;                    /**< 映射的字节数。 */
+};
@@ -0,0 +1,275 @@
+/*
+ * @Description: 共享内存解码帧的读端示例与写端到读端可见延迟基准测试，不依赖 Qt
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 14:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ShmFramePublisher.h"
+
+namespace
+{
+	volatile std::sig_atomic_t g_stop = 0;
+
+	void RequestStop(int)
+	{
+		g_stop = 1;
+	}
+
+	/**
+	 * @brief 以只读方式连接写端创建的共享内存段。
+	 * @throw std::runtime_error 如果共享内存不存在或布局不一致。
+	 */
+	const ShmFrame::Header* Attach(const std::string& name)
+	{
+		const std::string shmName = name.empty() || name[0] != '/' ? "/" + name : name;
+		const int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+		if (fd < 0)
+		{
+			throw std::runtime_error("shm_open " + shmName + " failed: " + std::strerror(errno));
+		}
+		struct stat info;
+		if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ShmFrame::Header))
+		{
+			close(fd);
+			throw std::runtime_error(shmName + " is not a frame segment.");
+		}
+		void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (address == MAP_FAILED)
+		{
+			throw std::runtime_error("mmap " + shmName + " failed: " + std::strerror(errno));
+		}
+
+		const auto* header = static_cast<const ShmFrame::Header*>(address);
+		if (header->magic != ShmFrame::kMagic || header->version != ShmFrame::kVersion ||
+			header->slotSize != sizeof(ShmFrame::Slot) ||
+			static_cast<size_t>(info.st_size) < ShmFrame::SegmentSize(header->slotCount))
+		{
+			throw std::runtime_error(shmName + " has an incompatible layout.");
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return header;
+	}
+
+	/**
+	 * @brief 轮询读端：按帧序号依次读取，落后超过一圈时跳到最早仍然有效的帧。
+	 */
+	class Reader
+	{
+	public:
+		explicit Reader(const ShmFrame::Header* header)
+			: m_header(header), m_next(header->writeCount.load(std::memory_order_acquire))
+		{
+		}
+
+		/**
+		 * @brief 尝试读取下一帧，没有新帧时立即返回 false。
+		 */
+		bool Poll(ShmFrame::Frame& frame)
+		{
+			const uint64_t written = m_header->writeCount.load(std::memory_order_acquire);
+			if (m_next >= written)
+			{
+				return false;
+			}
+			if (written - m_next > m_header->slotCount)
+			{
+				m_lost += written - m_header->slotCount - m_next;
+				m_next = written - m_header->slotCount;
+			}
+			// 读取失败说明该槽正在被写入或刚被覆盖，下次调用时根据 writeCount 重新定位
+			if (!ShmFrame::ReadFrame(m_header, m_next, frame))
+			{
+				return false;
+			}
+			++m_next;
+			return true;
+		}
+
+		uint64_t Lost() const { return m_lost; }
+
+	private:
+		const ShmFrame::Header* m_header;
+		uint64_t m_next;
+		uint64_t m_lost = 0;
+	};
+
+	/**
+	 * @brief 输出延迟分布。
+	 */
+	void PrintLatency(const char* label, std::vector<int64_t>& samples, uint64_t lost)
+	{
+		if (samples.empty())
+		{
+			std::printf("%s frames=0 lost=%llu\n", label, static_cast<unsigned long long>(lost));
+			return;
+		}
+		std::sort(samples.begin(), samples.end());
+		auto at = [&samples](double q) {
+			return static_cast<long long>(samples[static_cast<size_t>(q * (samples.size() - 1))]);
+		};
+		std::printf("%s frames=%zu lost=%llu latency ns: min=%lld p50=%lld p90=%lld p99=%lld p99.9=%lld max=%lld\n",
+			label, samples.size(), static_cast<unsigned long long>(lost),
+			at(0.0), at(0.5), at(0.9), at(0.99), at(0.999), at(1.0));
+		std::fflush(stdout);
+	}
+
+	/**
+	 * @brief 连接到运行中的写端，打印帧或每秒统计一次可见延迟。
+	 */
+	int RunReader(const std::string& name, bool latencyOnly)
+	{
+		Reader reader(Attach(name));
+		std::vector<int64_t> samples;
+		int64_t reportAt = ShmFrame::NowNs() + 1000000000;
+		ShmFrame::Frame frame;
+		while (!g_stop)
+		{
+			if (!reader.Poll(frame))
+			{
+				const int64_t now = ShmFrame::NowNs();
+				if (latencyOnly && now >= reportAt)
+				{
+					PrintLatency("[shm]", samples, reader.Lost());
+					samples.clear();
+					reportAt = now + 1000000000;
+				}
+				continue;
+			}
+			if (latencyOnly)
+			{
+				samples.push_back(ShmFrame::NowNs() - frame.timestampNs);
+				continue;
+			}
+			std::printf("%llu,%lld,%u,%u", static_cast<unsigned long long>(frame.frameNumber),
+				static_cast<long long>(frame.timestampNs), frame.source, frame.headerIndex);
+			for (uint32_t i = 0; i < frame.count; ++i)
+			{
+				std::printf(",%g", frame.values[i]);
+			}
+			std::printf("\n");
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief 写端到读端可见延迟基准测试。
+	 *
+	 * 父进程创建共享内存并每隔 intervalNs 发布一帧，fork 出的子进程作为读端忙等轮询，
+	 * 统计从写端取时间戳到读端读到该帧之间的延迟。两个进程最好运行在不同的 CPU 核上。
+	 */
+	int RunBench(uint64_t frames, int64_t intervalNs)
+	{
+		if (sysconf(_SC_NPROCESSORS_ONLN) < 2)
+		{
+			std::fprintf(stderr, "Warning: only one CPU online, reader and writer share it and latency reflects scheduling.\n");
+		}
+		const std::string name = "/MySoftwareShmBench." + std::to_string(getpid());
+		ShmFramePublisher publisher;
+		publisher.Open(name, 4096);
+
+		const pid_t child = fork();
+		if (child < 0)
+		{
+			throw std::runtime_error(std::string("fork failed: ") + std::strerror(errno));
+		}
+		if (child == 0)
+		{
+			Reader reader(Attach(name));
+			std::vector<int64_t> samples;
+			samples.reserve(static_cast<size_t>(frames));
+			ShmFrame::Frame frame;
+			const int64_t deadline = ShmFrame::NowNs() + 30000000000LL;
+			while (samples.size() + reader.Lost() < frames && ShmFrame::NowNs() < deadline)
+			{
+				if (reader.Poll(frame))
+				{
+					samples.push_back(ShmFrame::NowNs() - frame.timestampNs);
+				}
+			}
+			PrintLatency("[shm-bench]", samples, reader.Lost());
+			_exit(0);
+		}
+
+		// 等读端连接后再开始发布，读端从连接时的 writeCount 开始读取
+		usleep(200000);
+		double values[3] = { 1.0, 2.0, 3.0 };
+		DecodedRecord record;
+		record.values = values;
+		record.count = 3;
+		int64_t next = ShmFrame::NowNs();
+		for (uint64_t i = 0; i < frames; ++i)
+		{
+			while (ShmFrame::NowNs() < next)
+			{
+			}
+			record.index = static_cast<size_t>(i % 3);
+			values[0] = static_cast<double>(i);
+			publisher.Publish(0, record);
+			next += intervalNs;
+		}
+
+		int status = 0;
+		waitpid(child, &status, 0);
+		return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+	}
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"Usage: MySoftwareShmReader NAME            print frames published by MySoftwareCli --shm NAME\n"
+			"       MySoftwareShmReader NAME --latency  report writer-to-reader latency every second\n"
+			"       MySoftwareShmReader --bench [FRAMES] [INTERVAL_NS]\n");
+	}
+}
+
+/**
+ * @brief 共享内存读端示例的入口点。
+ */
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+	std::signal(SIGINT, RequestStop);
+	std::signal(SIGTERM, RequestStop);
+
+	try
+	{
+		const std::string first = argv[1];
+		if (first == "--bench")
+		{
+			const uint64_t frames = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+			const int64_t intervalNs = argc > 3 ? std::strtoll(argv[3], nullptr, 10) : 10000;
+			return RunBench(frames, intervalNs);
+		}
+		if (first == "-h" || first == "--help")
+		{
+			PrintUsage();
+			return 0;
+		}
+		return RunReader(first, argc > 2 && std::string(argv[2]) == "--latency");
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "Error: %s\n", e.what());
+		return 1;
+	}
+}
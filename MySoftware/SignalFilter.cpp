@@ -0,0 +1,488 @@
+/*
+ * @Description: 解码数值的数字滤波器：滑动平均、EMA、二阶低通/高通、中值、一维卡尔曼，按数据块处理
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 19:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "SignalFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+	constexpr double kPi = 3.14159265358979323846;
+
+	std::vector<std::string> Split(const std::string& text, char separator)
+	{
+		std::vector<std::string> parts;
+		std::string part;
+		std::istringstream stream(text);
+		while (std::getline(stream, part, separator))
+		{
+			const size_t begin = part.find_first_not_of(" \t");
+			const size_t end = part.find_last_not_of(" \t");
+			parts.push_back(begin == std::string::npos ? std::string() : part.substr(begin, end - begin + 1));
+		}
+		return parts;
+	}
+
+	double ParseNumber(const std::string& text, const std::string& stage)
+	{
+		char* end = nullptr;
+		const double value = std::strtod(text.c_str(), &end);
+		if (text.empty() || end == nullptr || *end != '\0' || !std::isfinite(value))
+		{
+			throw std::invalid_argument("Invalid parameter '" + text + "' in filter '" + stage + "'.");
+		}
+		return value;
+	}
+
+	std::string FormatNumber(double value)
+	{
+		std::ostringstream stream;
+		stream << value;
+		return stream.str();
+	}
+
+	std::unique_ptr<FilterStage> ParseStage(const std::string& text)
+	{
+		const std::vector<std::string> parts = Split(text, ':');
+		const std::string& name = parts.front();
+		std::vector<double> args;
+		for (size_t i = 1; i < parts.size(); ++i)
+		{
+			args.push_back(ParseNumber(parts[i], text));
+		}
+		auto expect = [&](size_t min, size_t max) {
+			if (args.size() < min || args.size() > max)
+			{
+				throw std::invalid_argument("Wrong number of parameters in filter '" + text + "'.");
+			}
+			};
+
+		if (name == "ma")
+		{
+			expect(1, 1);
+			return std::make_unique<MovingAverageFilter>(static_cast<size_t>(args[0]));
+		}
+		if (name == "ema")
+		{
+			expect(1, 1);
+			return std::make_unique<EmaFilter>(args[0]);
+		}
+		if (name == "lowpass" || name == "highpass")
+		{
+			expect(2, 3);
+			return std::make_unique<BiquadFilter>(name == "lowpass" ? BiquadFilter::Type::LowPass : BiquadFilter::Type::HighPass,
+				args[0], args[1], args.size() > 2 ? args[2] : 0.70710678118654752);
+		}
+		if (name == "median")
+		{
+			expect(1, 1);
+			return std::make_unique<MedianFilter>(static_cast<size_t>(args[0]));
+		}
+		if (name == "kalman")
+		{
+			expect(2, 2);
+			return std::make_unique<KalmanFilter>(args[0], args[1]);
+		}
+		throw std::invalid_argument("Unknown filter '" + name + "', expected ma, ema, lowpass, highpass, median or kalman.");
+	}
+}
+
+MovingAverageFilter::MovingAverageFilter(size_t window)
+	: m_window(window)
+{
+	if (window == 0)
+	{
+		throw std::invalid_argument("Moving average window must be positive.");
+	}
+	m_ring.assign(window, 0.0);
+}
+
+void MovingAverageFilter::Process(double* data, size_t count)
+{
+	double* ring = m_ring.data();
+	size_t pos = m_pos;
+	size_t filled = m_filled;
+	double sum = m_sum;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const double x = data[i];
+		sum += x - ring[pos];
+		ring[pos] = x;
+		pos = pos + 1 == m_window ? 0 : pos + 1;
+		filled += filled < m_window ? 1 : 0;
+		data[i] = sum / static_cast<double>(filled);
+	}
+	m_pos = pos;
+	m_filled = filled;
+
+	// 每处理约 64 个窗口长度的样本重新求和一次，长时间运行时加减的舍入误差不会累积
+	m_sinceResum += count;
+	if (m_sinceResum >= m_window * 64)
+	{
+		sum = 0.0;
+		for (size_t i = 0; i < m_window; ++i)
+		{
+			sum += ring[i];
+		}
+		m_sinceResum = 0;
+	}
+	m_sum = sum;
+}
+
+void MovingAverageFilter::Reset()
+{
+	std::fill(m_ring.begin(), m_ring.end(), 0.0);
+	m_pos = 0;
+	m_filled = 0;
+	m_sum = 0.0;
+	m_sinceResum = 0;
+}
+
+std::string MovingAverageFilter::Describe() const
+{
+	return "ma:" + std::to_string(m_window);
+}
+
+EmaFilter::EmaFilter(double alpha)
+	: m_alpha(alpha)
+{
+	if (!(alpha > 0.0 && alpha <= 1.0))
+	{
+		throw std::invalid_argument("EMA alpha must be in (0, 1].");
+	}
+}
+
+void EmaFilter::Process(double* data, size_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	size_t i = 0;
+	if (!m_primed)
+	{
+		m_y = data[0];
+		m_primed = true;
+		i = 1;
+	}
+	const double alpha = m_alpha;
+	double y = m_y;
+	for (; i < count; ++i)
+	{
+		y += alpha * (data[i] - y);
+		data[i] = y;
+	}
+	m_y = y;
+}
+
+std::string EmaFilter::Describe() const
+{
+	return "ema:" + FormatNumber(m_alpha);
+}
+
+BiquadFilter::BiquadFilter(Type type, double cutoffHz, double sampleRateHz, double q)
+	: m_type(type), m_cutoffHz(cutoffHz), m_sampleRateHz(sampleRateHz), m_q(q)
+{
+	if (!(sampleRateHz > 0.0 && cutoffHz > 0.0 && cutoffHz < sampleRateHz / 2) || !(q > 0.0))
+	{
+		throw std::invalid_argument("Biquad cutoff must be between 0 and half the sample rate, q must be positive.");
+	}
+
+	// RBJ Audio EQ Cookbook
+	const double w0 = 2.0 * kPi * cutoffHz / sampleRateHz;
+	const double cosW0 = std::cos(w0);
+	const double alpha = std::sin(w0) / (2.0 * q);
+	const double a0 = 1.0 + alpha;
+	if (type == Type::LowPass)
+	{
+		m_b0 = (1.0 - cosW0) / 2.0 / a0;
+		m_b1 = (1.0 - cosW0) / a0;
+	}
+	else
+	{
+		m_b0 = (1.0 + cosW0) / 2.0 / a0;
+		m_b1 = -(1.0 + cosW0) / a0;
+	}
+	m_b2 = m_b0;
+	m_a1 = -2.0 * cosW0 / a0;
+	m_a2 = (1.0 - alpha) / a0;
+}
+
+void BiquadFilter::Process(double* data, size_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	if (!m_primed)
+	{
+		// 按第一个样本为直流输入时的稳态设置延迟单元：低通输出等于输入，高通输出为 0
+		const double x = data[0];
+		const double y = m_type == Type::LowPass ? x : 0.0;
+		m_z2 = m_b2 * x - m_a2 * y;
+		m_z1 = m_b1 * x - m_a1 * y + m_z2;
+		m_primed = true;
+	}
+	const double b0 = m_b0, b1 = m_b1, b2 = m_b2, a1 = m_a1, a2 = m_a2;
+	double z1 = m_z1, z2 = m_z2;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const double x = data[i];
+		const double y = b0 * x + z1;
+		z1 = b1 * x - a1 * y + z2;
+		z2 = b2 * x - a2 * y;
+		data[i] = y;
+	}
+	m_z1 = z1;
+	m_z2 = z2;
+}
+
+void BiquadFilter::Reset()
+{
+	m_z1 = 0.0;
+	m_z2 = 0.0;
+	m_primed = false;
+}
+
+std::string BiquadFilter::Describe() const
+{
+	return std::string(m_type == Type::LowPass ? "lowpass:" : "highpass:") + FormatNumber(m_cutoffHz) + ":" +
+		FormatNumber(m_sampleRateHz) + ":" + FormatNumber(m_q);
+}
+
+MedianFilter::MedianFilter(size_t window)
+	: m_window(window)
+{
+	if (window == 0 || window > kMaxWindow)
+	{
+		throw std::invalid_argument("Median window must be between 1 and " + std::to_string(kMaxWindow) + ".");
+	}
+	m_ring.reserve(window);
+	m_sorted.reserve(window);
+}
+
+/**
+ * @brief 窗口未满时插入新样本，窗口已满时把最旧样本在有序数组中的位置替换为新样本并局部移动。
+ * 偶数窗口取中间两个值的平均。
+ */
+void MedianFilter::Process(double* data, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const double x = data[i];
+		if (m_ring.size() < m_window)
+		{
+			m_ring.push_back(x);
+			m_sorted.insert(std::upper_bound(m_sorted.begin(), m_sorted.end(), x), x);
+		}
+		else
+		{
+			const double old = m_ring[m_pos];
+			m_ring[m_pos] = x;
+			m_pos = m_pos + 1 == m_window ? 0 : m_pos + 1;
+
+			auto at = std::lower_bound(m_sorted.begin(), m_sorted.end(), old);
+			if (x > old)
+			{
+				// 向右移动，直到右边的元素不小于 x
+				auto next = at + 1;
+				while (next != m_sorted.end() && *next < x)
+				{
+					*at = *next;
+					at = next++;
+				}
+			}
+			else
+			{
+				while (at != m_sorted.begin() && *(at - 1) > x)
+				{
+					*at = *(at - 1);
+					--at;
+				}
+			}
+			*at = x;
+		}
+
+		const size_t n = m_sorted.size();
+		data[i] = (n & 1) ? m_sorted[n / 2] : (m_sorted[n / 2 - 1] + m_sorted[n / 2]) / 2.0;
+	}
+}
+
+void MedianFilter::Reset()
+{
+	m_ring.clear();
+	m_sorted.clear();
+	m_pos = 0;
+}
+
+std::string MedianFilter::Describe() const
+{
+	return "median:" + std::to_string(m_window);
+}
+
+KalmanFilter::KalmanFilter(double q, double r)
+	: m_q(q), m_r(r)
+{
+	if (!(q >= 0.0) || !(r > 0.0))
+	{
+		throw std::invalid_argument("Kalman q must be non-negative and r positive.");
+	}
+}
+
+void KalmanFilter::Process(double* data, size_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	size_t i = 0;
+	if (!m_primed)
+	{
+		m_x = data[0];
+		m_p = m_r;
+		m_primed = true;
+		i = 1;
+	}
+	const double q = m_q, r = m_r;
+	double x = m_x, p = m_p;
+	for (; i < count; ++i)
+	{
+		p += q;
+		const double k = p / (p + r);
+		x += k * (data[i] - x);
+		p *= 1.0 - k;
+		data[i] = x;
+	}
+	m_x = x;
+	m_p = p;
+}
+
+std::string KalmanFilter::Describe() const
+{
+	return "kalman:" + FormatNumber(m_q) + ":" + FormatNumber(m_r);
+}
+
+FilterChain FilterChain::Parse(const std::string& spec)
+{
+	FilterChain chain;
+	for (const std::string& stage : Split(spec, ','))
+	{
+		if (!stage.empty())
+		{
+			chain.m_stages.push_back(ParseStage(stage));
+		}
+	}
+	if (chain.m_stages.empty())
+	{
+		throw std::invalid_argument("Empty filter chain '" + spec + "'.");
+	}
+	return chain;
+}
+
+FilterChain FilterChain::Clone() const
+{
+	FilterChain chain;
+	for (const auto& stage : m_stages)
+	{
+		chain.m_stages.push_back(stage->Clone());
+	}
+	return chain;
+}
+
+void FilterChain::Process(double* data, size_t count)
+{
+	for (const auto& stage : m_stages)
+	{
+		stage->Process(data, count);
+	}
+}
+
+void FilterChain::Reset()
+{
+	for (const auto& stage : m_stages)
+	{
+		stage->Reset();
+	}
+}
+
+std::string FilterChain::Describe() const
+{
+	std::string text;
+	for (const auto& stage : m_stages)
+	{
+		text += (text.empty() ? "" : ",") + stage->Describe();
+	}
+	return text;
+}
+
+FilterConfig FilterConfig::Parse(const std::string& spec)
+{
+	FilterConfig config;
+	for (const std::string& rule : Split(spec, ';'))
+	{
+		if (rule.empty())
+		{
+			continue;
+		}
+		const size_t equals = rule.find('=');
+		Rule parsed;
+		parsed.pattern = equals == std::string::npos ? "*" : Split(rule.substr(0, equals), ' ').front();
+		parsed.chain = FilterChain::Parse(equals == std::string::npos ? rule : rule.substr(equals + 1));
+		if (parsed.pattern.empty())
+		{
+			throw std::invalid_argument("Missing channel name in filter rule '" + rule + "'.");
+		}
+		config.m_rules.push_back(std::move(parsed));
+	}
+	return config;
+}
+
+int FilterConfig::Match(const std::string& channel) const
+{
+	for (size_t i = 0; i < m_rules.size(); ++i)
+	{
+		const std::string& pattern = m_rules[i].pattern;
+		const bool prefix = pattern.back() == '*';
+		if (prefix ? channel.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0
+			: channel == pattern)
+		{
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+std::string FilterConfig::Describe() const
+{
+	std::string text;
+	for (const Rule& rule : m_rules)
+	{
+		text += (text.empty() ? "" : ";") + rule.pattern + "=" + rule.chain.Describe();
+	}
+	return text;
+}
+
+FilterConfig::FilterConfig(const FilterConfig& other)
+{
+	*this = other;
+}
+
+FilterConfig& FilterConfig::operator=(const FilterConfig& other)
+{
+	if (this != &other)
+	{
+		m_rules.clear();
+		for (const Rule& rule : other.m_rules)
+		{
+			m_rules.push_back(Rule{ rule.pattern, rule.chain.Clone() });
+		}
+	}
+	return *this;
+}
@@ -0,0 +1,253 @@
+/*
+ * @Description: 解码数值的数字滤波器：滑动平均、EMA、二阶低通/高通、中值、一维卡尔曼，按数据块处理
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 19:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 滤波器的一级，持有一个通道的状态。
+ *
+ * Process 一次处理一个通道的一整块连续样本（原地修改），
+ * 状态在块内保存在局部变量中，块与块之间的结果与逐个样本处理完全相同。
+ */
+class FilterStage
+{
+public:
+	virtual ~FilterStage() = default;
+
+	/**
+	 * @brief 原地处理一块样本。
+	 * @param data 样本，处理后为滤波输出。
+	 * @param count 样本数量。
+	 */
+	virtual void Process(double* data, size_t count) = 0;
+
+	/**
+	 * @brief 清除状态，下一个样本视为第一个样本。
+	 */
+	virtual void Reset() = 0;
+
+	/**
+	 * @brief 复制一个参数相同、状态为初始值的滤波器，用于为每个通道创建独立的实例。
+	 */
+	virtual std::unique_ptr<FilterStage> Clone() const = 0;
+
+	/**
+	 * @brief 配置字符串形式的描述，例如 "ema:0.1"。
+	 */
+	virtual std::string Describe() const = 0;
+};
+
+/**
+ * @brief 滑动平均，窗口内样本数不足时按已有样本平均。
+ */
+class MovingAverageFilter : public FilterStage
+{
+public:
+	/**
+	 * @throw std::invalid_argument 如果窗口为 0。
+	 */
+	explicit MovingAverageFilter(size_t window);
+	void Process(double* data, size_t count) override;
+	void Reset() override;
+	std::unique_ptr<FilterStage> Clone() const override { return std::make_unique<MovingAverageFilter>(m_window); }
+	std::string Describe() const override;
+
+private:
+	size_t m_window;              /**< 窗口长度。 */
+	std::vector<double> m_ring;   /**< 窗口内的样本。 */
+	size_t m_pos = 0;             /**< 下一个写入位置。 */
+	size_t m_filled = 0;          /**< 窗口内已有的样本数。 */
+	double m_sum = 0.0;           /**< 窗口内样本之和。 */
+	size_t m_sinceResum = 0;      /**< 距离上一次重新求和的样本数，定期重新求和以消除累积误差。 */
+};
+
+/**
+ * @brief 指数滑动平均 y += alpha * (x - y)，第一个样本直接作为输出。
+ */
+class EmaFilter : public FilterStage
+{
+public:
+	/**
+	 * @throw std::invalid_argument 如果 alpha 不在 (0, 1] 内。
+	 */
+	explicit EmaFilter(double alpha);
+	void Process(double* data, size_t count) override;
+	void Reset() override { m_primed = false; }
+	std::unique_ptr<FilterStage> Clone() const override { return std::make_unique<EmaFilter>(m_alpha); }
+	std::string Describe() const override;
+
+private:
+	double m_alpha;       /**< 平滑系数。 */
+	double m_y = 0.0;     /**< 上一个输出。 */
+	bool m_primed = false; /**< 是否已有输出。 */
+};
+
+/**
+ * @brief 二阶 IIR（RBJ 低通/高通），直接 II 型转置结构。
+ */
+class BiquadFilter : public FilterStage
+{
+public:
+	enum class Type
+	{
+		LowPass,
+		HighPass
+	};
+
+	/**
+	 * @param type 低通或高通。
+	 * @param cutoffHz 截止频率。
+	 * @param sampleRateHz 采样率，即该通道的帧率。
+	 * @param q 品质因数，默认 0.7071 为巴特沃斯响应。
+	 * @throw std::invalid_argument 如果截止频率不在 (0, sampleRateHz / 2) 内或 q 不为正。
+	 */
+	BiquadFilter(Type type, double cutoffHz, double sampleRateHz, double q = 0.70710678118654752);
+	void Process(double* data, size_t count) override;
+	void Reset() override;
+	std::unique_ptr<FilterStage> Clone() const override { return std::make_unique<BiquadFilter>(m_type, m_cutoffHz, m_sampleRateHz, m_q); }
+	std::string Describe() const override;
+
+private:
+	Type m_type;
+	double m_cutoffHz;
+	double m_sampleRateHz;
+	double m_q;
+	double m_b0, m_b1, m_b2, m_a1, m_a2; /**< 归一化后的系数。 */
+	double m_z1 = 0.0, m_z2 = 0.0;       /**< 延迟单元。 */
+	bool m_primed = false;               /**< 第一个样本时把延迟单元设为稳态，避免从 0 开始的阶跃。 */
+};
+
+/**
+ * @brief 滑动中值，窗口内维护一个有序数组，每个样本一次二分查找和一次移动。
+ */
+class MedianFilter : public FilterStage
+{
+public:
+	/**
+	 * @throw std::invalid_argument 如果窗口为 0 或大于 kMaxWindow。
+	 */
+	explicit MedianFilter(size_t window);
+	void Process(double* data, size_t count) override;
+	void Reset() override;
+	std::unique_ptr<FilterStage> Clone() const override { return std::make_unique<MedianFilter>(m_window); }
+	std::string Describe() const override;
+
+	static constexpr size_t kMaxWindow = 255;
+
+private:
+	size_t m_window;              /**< 窗口长度。 */
+	std::vector<double> m_ring;   /**< 按到达顺序的样本。 */
+	std::vector<double> m_sorted; /**< 同一批样本的有序副本。 */
+	size_t m_pos = 0;             /**< 下一个写入位置。 */
+};
+
+/**
+ * @brief 一维卡尔曼滤波，状态模型为随机游走。
+ * q 为过程噪声方差，r 为测量噪声方差，q/r 越小输出越平滑。
+ */
+class KalmanFilter : public FilterStage
+{
+public:
+	/**
+	 * @throw std::invalid_argument 如果 q 为负或 r 不为正。
+	 */
+	KalmanFilter(double q, double r);
+	void Process(double* data, size_t count) override;
+	void Reset() override { m_primed = false; }
+	std::unique_ptr<FilterStage> Clone() const override { return std::make_unique<KalmanFilter>(m_q, m_r); }
+	std::string Describe() const override;
+
+private:
+	double m_q;            /**< 过程噪声方差。 */
+	double m_r;            /**< 测量噪声方差。 */
+	double m_x = 0.0;      /**< 估计值。 */
+	double m_p = 0.0;      /**< 估计误差方差。 */
+	bool m_primed = false; /**< 是否已有估计。 */
+};
+
+/**
+ * @brief FilterChain 是按顺序作用于一个通道的若干级滤波器。
+ */
+class FilterChain
+{
+public:
+	FilterChain() = default;
+	FilterChain(FilterChain&&) = default;
+	FilterChain& operator=(FilterChain&&) = default;
+
+	/**
+	 * @brief 由配置字符串创建，各级以逗号分隔，参数以冒号分隔：
+	 *   ma:N  ema:alpha  lowpass:fc:fs[:q]  highpass:fc:fs[:q]  median:N  kalman:q:r
+	 * 例如 "median:5,lowpass:20:1000"。
+	 * @throw std::invalid_argument 如果配置无法解析。
+	 */
+	static FilterChain Parse(const std::string& spec);
+
+	/**
+	 * @brief 复制参数，状态为初始值。
+	 */
+	FilterChain Clone() const;
+
+	/**
+	 * @brief 依次经过每一级，原地处理一块样本。
+	 */
+	void Process(double* data, size_t count);
+
+	void Reset();
+	bool IsEmpty() const { return m_stages.empty(); }
+	std::string Describe() const;
+
+private:
+	std::vector<std::unique_ptr<FilterStage>> m_stages; /**< 各级滤波器。 */
+};
+
+/**
+ * @brief FilterConfig 把通道名称映射到滤波器链。
+ *
+ * 配置字符串由分号分隔的 "通道=滤波器链" 组成，通道可以是完整名称、以 * 结尾的前缀或单独的 *，
+ * 按出现顺序匹配第一条，例如 "START1.P=median:5,ema:0.2;START2.*=kalman:0.01:1"。
+ * 只有滤波器链而没有 "通道=" 时等同于 "*=..."。
+ */
+class FilterConfig
+{
+public:
+	/**
+	 * @throw std::invalid_argument 如果配置无法解析。
+	 */
+	static FilterConfig Parse(const std::string& spec);
+
+	/**
+	 * @brief 第一条匹配通道名称的规则序号，没有匹配时返回 -1。
+	 */
+	int Match(const std::string& channel) const;
+
+	/**
+	 * @brief 第 rule 条规则的滤波器链副本。
+	 */
+	FilterChain Create(int rule) const { return m_rules[static_cast<size_t>(rule)].chain.Clone(); }
+
+	bool IsEmpty() const { return m_rules.empty(); }
+	std::string Describe() const;
+
+	FilterConfig() = default;
+	FilterConfig(const FilterConfig& other);
+	FilterConfig& operator=(const FilterConfig& other);
+	FilterConfig(FilterConfig&&) = default;
+	FilterConfig& operator=(FilterConfig&&) = default;
+
+private:
+	struct Rule
+	{
+		std::string pattern; /**< 通道名称、前缀加 * 或 *。 */
+		FilterChain chain;   /**< 滤波器链原型。 */
+	};
+	std::vector<Rule> m_rules; /**< 按顺序匹配的规则。 */
+};
@@ -0,0 +1,178 @@
+/*
+ * @Description: 启动阶段计时，记录从 main 到首次绘制的各阶段耗时
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 09:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "StartupTrace.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEvent>
+#include <QtCore/QTimer>
+#include <QtCore/QDebug>
+#include <QtCore/QPointer>
+#include <QtWidgets/QWidget>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct Phase
+	{
+		const char* name; /**< 阶段名称。 */
+		qint64 nsecs;     /**< 相对 Begin() 的纳秒数。 */
+	};
+
+	constexpr int kMaxPhases = 32;
+
+	QElapsedTimer g_clock;
+	Phase g_phases[kMaxPhases];
+	int g_phaseCount = 0;
+	bool g_firstPaintDone = false;
+	bool g_firstByteSeen = false;
+
+	/**
+	 * @brief 等待首次绘制完成后执行的回调。
+	 */
+	struct DeferredCall
+	{
+		QPointer<QObject> context;      /**< 回调上下文，销毁后跳过。 */
+		std::function<void()> callback; /**< 回调函数。 */
+	};
+	std::vector<DeferredCall> g_deferred;
+
+	/**
+	 * @brief 首次绘制事件过滤器，收到第一个 Paint 事件后自行卸载。
+	 */
+	class FirstPaintFilter : public QObject
+	{
+	public:
+		using QObject::QObject;
+
+	protected:
+		bool eventFilter(QObject* watched, QEvent* event) override
+		{
+			if (event->type() == QEvent::Paint)
+			{
+				watched->removeEventFilter(this);
+				StartupTrace::Mark("first paint event");
+				// 事件循环回到空闲时，本帧已经提交给窗口系统
+				QTimer::singleShot(0, this, [this]() {
+					StartupTrace::Mark("first frame presented");
+					g_firstPaintDone = true;
+					StartupTrace::Report();
+					auto deferred = std::move(g_deferred);
+					g_deferred.clear();
+					for (auto& call : deferred)
+					{
+						if (call.context)
+						{
+							call.callback();
+						}
+					}
+					deleteLater();
+					});
+			}
+			return false;
+		}
+	};
+}
+
+/**
+ * @brief 开始计时，应在 main 的第一行调用。
+ */
+void StartupTrace::Begin()
+{
+	g_clock.start();
+	g_phaseCount = 0;
+	Mark("main");
+}
+
+/**
+ * @brief 记录一个启动阶段的结束时间点。
+ * 超过 kMaxPhases 的记录会被忽略。
+ * @param phase 阶段名称，必须是静态字符串。
+ */
+void StartupTrace::Mark(const char* phase)
+{
+	if (!g_clock.isValid() || g_phaseCount >= kMaxPhases)
+	{
+		return;
+	}
+	g_phases[g_phaseCount++] = Phase{ phase, g_clock.nsecsElapsed() };
+}
+
+/**
+ * @brief 监视窗口的首次绘制，绘制完成后输出启动报告。
+ * @param window 被监视的顶层窗口。
+ */
+void StartupTrace::WatchFirstPaint(QWidget* window)
+{
+	window->installEventFilter(new FirstPaintFilter(window));
+}
+
+/**
+ * @brief 注册一个在首次绘制完成后执行的回调。
+ * @param context 回调的上下文对象，对象销毁后回调不再执行。
+ * @param callback 回调函数。
+ */
+void StartupTrace::AfterFirstPaint(QObject* context, std::function<void()> callback)
+{
+	if (g_firstPaintDone)
+	{
+		QTimer::singleShot(0, context, std::move(callback));
+		return;
+	}
+	g_deferred.push_back(DeferredCall{ context, std::move(callback) });
+}
+
+/**
+ * @brief 记录收到第一个串口字节的时间点，仅第一次调用有效。
+ */
+void StartupTrace::MarkFirstByte()
+{
+	if (g_firstByteSeen)
+	{
+		return;
+	}
+	g_firstByteSeen = true;
+	Mark("first RX byte");
+	qInfo().noquote() << QString("[startup] %1 %2 ms")
+		.arg("first RX byte", -24)
+		.arg(ElapsedMs(), 9, 'f', 1);
+}
+
+/**
+ * @brief 获取从 Begin() 到现在经过的毫秒数。
+ * @return 经过的毫秒数。
+ */
+double StartupTrace::ElapsedMs()
+{
+	return g_clock.isValid() ? g_clock.nsecsElapsed() / 1e6 : 0.0;
+}
+
+/**
+ * @brief 首次绘制是否已经完成。
+ */
+bool StartupTrace::FirstPaintDone()
+{
+	return g_firstPaintDone;
+}
+
+/**
+ * @brief 输出所有已记录阶段的汇总报告。
+ * 每行包含阶段名称、累计耗时和相对上一阶段的增量。
+ */
+void StartupTrace::Report()
+{
+	qint64 previous = 0;
+	for (int i = 0; i < g_phaseCount; ++i)
+	{
+		const Phase& phase = g_phases[i];
+		qInfo().noquote() << QString("[startup] %1 %2 ms (+%3 ms)")
+			.arg(phase.name, -24)
+			.arg(phase.nsecs / 1e6, 9, 'f', 1)
+			.arg((phase.nsecs - previous) / 1e6, 0, 'f', 1);
+		previous = phase.nsecs;
+	}
+}
@@ -0,0 +1,70 @@
+/*
+ * @Description: 启动阶段计时，记录从 main 到首次绘制的各阶段耗时
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 09:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QtGlobal>
+#include <functional>
+
+class QObject;
+class QWidget;
+
+/**
+ * @brief StartupTrace 用于记录程序冷启动各阶段的时间点。
+ *
+ * 所有阶段都保存在固定大小的静态数组中，记录本身不分配内存，
+ * 只在 GUI 线程中调用。首次绘制完成后输出一次汇总报告，
+ * 之后收到第一个串口字节时再补充输出一行。
+ */
+class StartupTrace
+{
+public:
+	/**
+	 * @brief 开始计时，应在 main 的第一行调用。
+	 */
+	static void Begin();
+
+	/**
+	 * @brief 记录一个启动阶段的结束时间点。
+	 * @param phase 阶段名称，必须是静态字符串。
+	 */
+	static void Mark(const char* phase);
+
+	/**
+	 * @brief 监视窗口的首次绘制，绘制完成后输出启动报告。
+	 * @param window 被监视的顶层窗口。
+	 */
+	static void WatchFirstPaint(QWidget* window);
+
+	/**
+	 * @brief 注册一个在首次绘制完成后执行的回调，用于推迟非必要的初始化工作。
+	 * 如果首次绘制已经完成，回调会在下一次事件循环中执行。
+	 * @param context 回调的上下文对象，对象销毁后回调不再执行。
+	 * @param callback 回调函数。
+	 */
+	static void AfterFirstPaint(QObject* context, std::function<void()> callback);
+
+	/**
+	 * @brief 记录收到第一个串口字节的时间点，仅第一次调用有效。
+	 */
+	static void MarkFirstByte();
+
+	/**
+	 * @brief 获取从 Begin() 到现在经过的毫秒数。
+	 * @return 经过的毫秒数。
+	 */
+	static double ElapsedMs();
+
+	/**
+	 * @brief 首次绘制是否已经完成。
+	 */
+	static bool FirstPaintDone();
+
+	/**
+	 * @brief 输出所有已记录阶段的汇总报告。
+	 */
+	static void Report();
+};
@@ -0,0 +1,428 @@
+/*
+ * @Description: PID 阶跃响应分析，检测设定值阶跃并增量计算上升时间、超调量、调节时间和稳态误差
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "StepAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+	constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+	std::string Trim(const std::string& text)
+	{
+		const size_t begin = text.find_first_not_of(" \t\r");
+		if (begin == std::string::npos)
+		{
+			return std::string();
+		}
+		const size_t end = text.find_last_not_of(" \t\r");
+		return text.substr(begin, end - begin + 1);
+	}
+
+	std::vector<std::string> Split(const std::string& text, const char* separators)
+	{
+		std::vector<std::string> parts;
+		size_t begin = 0;
+		while (begin <= text.size())
+		{
+			const size_t end = text.find_first_of(separators, begin);
+			const std::string part = Trim(text.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+			if (!part.empty())
+			{
+				parts.push_back(part);
+			}
+			if (end == std::string::npos)
+			{
+				break;
+			}
+			begin = end + 1;
+		}
+		return parts;
+	}
+
+	double ParseNumber(const std::string& text, const std::string& rule)
+	{
+		char* end = nullptr;
+		const double value = std::strtod(text.c_str(), &end);
+		if (text.empty() || end == nullptr || *end != '\0' || !std::isfinite(value) || value < 0)
+		{
+			throw std::invalid_argument("Invalid number '" + text + "' in step rule '" + rule + "'.");
+		}
+		return value;
+	}
+
+	/**
+	 * @brief 解析时长，单位为 ms 或 s，没有单位时按秒。
+	 */
+	double ParseSeconds(const std::string& text, const std::string& rule)
+	{
+		if (text.size() > 2 && text.compare(text.size() - 2, 2, "ms") == 0)
+		{
+			return ParseNumber(text.substr(0, text.size() - 2), rule) / 1e3;
+		}
+		if (text.size() > 1 && text.back() == 's')
+		{
+			return ParseNumber(text.substr(0, text.size() - 1), rule);
+		}
+		return ParseNumber(text, rule);
+	}
+
+	std::string FormatNumber(double value)
+	{
+		std::ostringstream stream;
+		stream << value;
+		return stream.str();
+	}
+
+	/**
+	 * @brief 在两个样本之间线性插值求穿越 level 的时刻。
+	 */
+	double Crossing(double t0, double y0, double t1, double y1, double level)
+	{
+		return y1 == y0 ? t1 : t0 + (level - y0) / (y1 - y0) * (t1 - t0);
+	}
+}
+
+StepConfig StepConfig::Parse(const std::string& spec)
+{
+	StepConfig config;
+	for (const std::string& text : Split(spec, ";\n"))
+	{
+		const size_t colon = text.find(':');
+		if (colon == std::string::npos)
+		{
+			throw std::invalid_argument("Missing 'name:' in step rule '" + text + "'.");
+		}
+		StepRule rule;
+		rule.name = Trim(text.substr(0, colon));
+		if (rule.name.empty())
+		{
+			throw std::invalid_argument("Missing controller name in step rule '" + text + "'.");
+		}
+		for (int i = 0; i < 3; ++i)
+		{
+			rule.gains[i] = rule.name + "." + "PID"[i];
+		}
+		for (const std::string& option : Split(text.substr(colon + 1), " \t"))
+		{
+			const size_t equals = option.find('=');
+			const std::string key = option.substr(0, equals);
+			const std::string value = equals == std::string::npos ? std::string() : option.substr(equals + 1);
+			if (value.empty())
+			{
+				throw std::invalid_argument("Missing value for '" + key + "' in step rule '" + text + "'.");
+			}
+			if (key == "sp")
+			{
+				rule.setpoint = value;
+			}
+			else if (key == "pv")
+			{
+				rule.measurement = value;
+			}
+			else if (key == "gains")
+			{
+				const std::vector<std::string> gains = Split(value, ",");
+				if (gains.size() != 3)
+				{
+					throw std::invalid_argument("gains needs three channels (Kp,Ki,Kd) in step rule '" + text + "'.");
+				}
+				for (int i = 0; i < 3; ++i)
+				{
+					rule.gains[i] = gains[static_cast<size_t>(i)];
+				}
+			}
+			else if (key == "band")
+			{
+				const bool percent = value.back() == '%';
+				rule.band = ParseNumber(percent ? value.substr(0, value.size() - 1) : value, text) / (percent ? 100.0 : 1.0);
+			}
+			else if (key == "window")
+			{
+				rule.window = ParseSeconds(value, text);
+			}
+			else if (key == "hold")
+			{
+				rule.hold = ParseSeconds(value, text);
+			}
+			else if (key == "min-step")
+			{
+				rule.minStep = ParseNumber(value, text);
+			}
+			else
+			{
+				throw std::invalid_argument("Unknown option '" + key + "' in step rule '" + text +
+					"', expected sp, pv, gains, band, window, hold or min-step.");
+			}
+		}
+		if (rule.setpoint.empty() || rule.measurement.empty())
+		{
+			throw std::invalid_argument("Step rule '" + text + "' needs sp= and pv= channels.");
+		}
+		config.m_rules.push_back(std::move(rule));
+	}
+	return config;
+}
+
+std::string StepConfig::Describe() const
+{
+	std::string text;
+	for (const StepRule& rule : m_rules)
+	{
+		text += (text.empty() ? "" : ";") + rule.name + ": sp=" + rule.setpoint + " pv=" + rule.measurement +
+			" gains=" + rule.gains[0] + "," + rule.gains[1] + "," + rule.gains[2] +
+			" band=" + FormatNumber(rule.band * 100.0) + "% window=" + FormatNumber(rule.window) +
+			"s hold=" + FormatNumber(rule.hold) + "s";
+		if (rule.minStep > 0)
+		{
+			text += " min-step=" + FormatNumber(rule.minStep);
+		}
+	}
+	return text;
+}
+
+StepAnalyzer::StepAnalyzer(StepRule rule, int controller)
+	: m_rule(std::move(rule)), m_controller(controller)
+{
+}
+
+/**
+ * @brief 收到设定值：第一次只记录，之后变化超过 minStep 时结束上一次阶跃并开始新的阶跃。
+ * 变化量不超过 minStep 的设定值漂移直接更新，不影响正在进行的阶跃。
+ */
+void StepAnalyzer::OnSetpoint(double t, double value)
+{
+	if (!m_haveSetpoint)
+	{
+		m_haveSetpoint = true;
+		m_setpoint = value;
+		return;
+	}
+	const double threshold = std::max(m_rule.minStep, 1e-9 * std::max(1.0, std::fabs(m_setpoint)));
+	if (std::fabs(value - m_setpoint) <= threshold)
+	{
+		return;
+	}
+	if (m_active)
+	{
+		FinishStep();
+	}
+	StartStep(t, m_setpoint, value);
+	m_setpoint = value;
+}
+
+void StepAnalyzer::StartStep(double t, double from, double to)
+{
+	m_active = true;
+	m_stepSet = m_history.empty() ? -1 : static_cast<int>(m_history.size() - 1 + m_droppedSets);
+	m_step = StepMetrics{};
+	m_step.t0 = t;
+	m_step.from = from;
+	m_step.to = to;
+	// 以阶跃时的测量值为起点；上一次阶跃还没有到达时起点不是 from
+	m_start = m_haveMeasurement ? m_lastValue : from;
+	m_span = to - m_start;
+	if (std::fabs(m_span) < 1e-12)
+	{
+		m_span = to - from;
+	}
+	m_prevY = 0.0;
+	m_t10 = kNaN;
+	m_t90 = kNaN;
+	m_peak = 0.0;
+	m_inBandSince = kNaN;
+	m_errorSum = 0.0;
+	m_errorCount = 0;
+}
+
+/**
+ * @brief 收到测量值：更新穿越时刻、峰值和调节带状态，满足结束条件时输出结果。
+ * 第一个样本之前的 prevY 为 0（起点），因此阶跃后的第一个样本也可以插值。
+ */
+void StepAnalyzer::OnMeasurement(double t, double value)
+{
+	const double prevT = m_haveMeasurement ? m_lastTime : t;
+	m_haveMeasurement = true;
+	m_lastValue = value;
+	m_lastTime = t;
+	if (!m_active)
+	{
+		return;
+	}
+
+	const double y = (value - m_start) / m_span;
+	const double fromT = std::max(prevT, m_step.t0);
+	if (std::isnan(m_t10) && y >= 0.1)
+	{
+		m_t10 = Crossing(fromT, m_prevY, t, y, 0.1);
+	}
+	if (std::isnan(m_t90) && y >= 0.9)
+	{
+		m_t90 = Crossing(fromT, m_prevY, t, y, 0.9);
+	}
+	m_peak = std::max(m_peak, y);
+	m_prevY = y;
+
+	const double error = m_step.to - value;
+	if (std::fabs(error) > m_rule.band * std::fabs(m_step.to - m_step.from))
+	{
+		m_inBandSince = kNaN;
+		m_errorSum = 0.0;
+		m_errorCount = 0;
+	}
+	else
+	{
+		if (std::isnan(m_inBandSince))
+		{
+			m_inBandSince = t;
+		}
+		m_errorSum += error;
+		++m_errorCount;
+	}
+
+	const bool held = !std::isnan(m_t90) && !std::isnan(m_inBandSince) && t - m_inBandSince >= m_rule.hold;
+	if (held || t - m_step.t0 >= m_rule.window)
+	{
+		FinishStep();
+	}
+}
+
+/**
+ * @brief 收到一个增益：三个增益都收到后，与当前增益组不同时开始新的一组。
+ */
+void StepAnalyzer::OnGain(int index, double t, double value)
+{
+	m_gains[index] = value;
+	m_gainMask |= 1 << index;
+	if (m_gainMask != 7)
+	{
+		return;
+	}
+	if (!m_history.empty())
+	{
+		const double* current = m_history.back().gains;
+		if (current[0] == m_gains[0] && current[1] == m_gains[1] && current[2] == m_gains[2])
+		{
+			return;
+		}
+	}
+	// 三个增益通常在同一条记录中依次到达，等到 Kd 再比较，避免生成只改了一部分的中间组合
+	if (index != 2 && !m_history.empty())
+	{
+		return;
+	}
+	if (m_history.size() == kMaxGainSets)
+	{
+		m_history.erase(m_history.begin());
+		++m_droppedSets;
+	}
+	GainSetStats set;
+	set.gains[0] = m_gains[0];
+	set.gains[1] = m_gains[1];
+	set.gains[2] = m_gains[2];
+	set.since = t;
+	m_history.push_back(set);
+}
+
+void StepAnalyzer::Finish()
+{
+	if (m_active)
+	{
+		FinishStep();
+	}
+}
+
+/**
+ * @brief 跨过中断的阶跃没有可信的上升和调节时间，直接丢弃而不输出。
+ */
+void StepAnalyzer::Reset()
+{
+	m_active = false;
+	m_haveSetpoint = false;
+	m_haveMeasurement = false;
+}
+
+/**
+ * @brief 结束当前阶跃：计算指标，计入阶跃开始时的增益组并回调。
+ */
+void StepAnalyzer::FinishStep()
+{
+	m_active = false;
+	StepMetrics& m = m_step;
+	m.riseTime = std::isnan(m_t10) || std::isnan(m_t90) ? kNaN : m_t90 - m_t10;
+	m.overshoot = std::max(0.0, m_peak - 1.0) * 100.0;
+	m.settlingTime = std::isnan(m_inBandSince) || std::isnan(m_t90) ? kNaN : m_inBandSince - m.t0;
+	m.steadyStateError = m_errorCount > 0 ? m_errorSum / static_cast<double>(m_errorCount)
+		: (m_haveMeasurement ? m.to - m_lastValue : kNaN);
+
+	StepResult result{ m_controller, -1, { kNaN, kNaN, kNaN }, m };
+	const int64_t index = static_cast<int64_t>(m_stepSet) - static_cast<int64_t>(m_droppedSets);
+	if (m_stepSet >= 0 && index >= 0)
+	{
+		GainSetStats& set = m_history[static_cast<size_t>(index)];
+		result.gainSet = m_stepSet;
+		result.gains[0] = set.gains[0];
+		result.gains[1] = set.gains[1];
+		result.gains[2] = set.gains[2];
+		++set.steps;
+		set.last = m;
+		set.overshootSum += m.overshoot;
+		if (!std::isnan(m.riseTime))
+		{
+			set.riseSum += m.riseTime;
+			++set.riseCount;
+		}
+		if (!std::isnan(m.settlingTime))
+		{
+			set.settlingSum += m.settlingTime;
+			++set.settled;
+		}
+		if (!std::isnan(m.steadyStateError))
+		{
+			set.errorSum += std::fabs(m.steadyStateError);
+			++set.errorCount;
+		}
+	}
+	if (m_onResult)
+	{
+		m_onResult(result);
+	}
+}
+
+std::string FormatStepResult(const StepResult& result, const std::string& controller)
+{
+	const StepMetrics& m = result.metrics;
+	char line[256];
+	std::snprintf(line, sizeof(line), "%s,%g,%g,%g,%g,%g,%.3f,%.2f,%.3f,%g", controller.c_str(),
+		result.gains[0], result.gains[1], result.gains[2], m.from, m.to,
+		m.riseTime * 1e3, m.overshoot, m.settlingTime * 1e3, m.steadyStateError);
+	return line;
+}
+
+std::string FormatGainHistory(const std::string& controller, const std::vector<GainSetStats>& history)
+{
+	std::string text;
+	char line[256];
+	for (const GainSetStats& set : history)
+	{
+		const double rise = set.riseCount ? set.riseSum / set.riseCount * 1e3 : kNaN;
+		const double overshoot = set.steps ? set.overshootSum / set.steps : kNaN;
+		const double settling = set.settled ? set.settlingSum / set.settled * 1e3 : kNaN;
+		const double error = set.errorCount ? set.errorSum / set.errorCount : kNaN;
+		std::snprintf(line, sizeof(line),
+			"%s Kp=%g Ki=%g Kd=%g from %.3fs: %u steps (%u settled), rise %.1f ms, overshoot %.1f%%, settling %.1f ms, |ess| %g\n",
+			controller.c_str(), set.gains[0], set.gains[1], set.gains[2], set.since, set.steps, set.settled,
+			rise, overshoot, settling, error);
+		text += line;
+	}
+	return text;
+}
@@ -0,0 +1,191 @@
+/*
+ * @Description: PID 阶跃响应分析，检测设定值阶跃并增量计算上升时间、超调量、调节时间和稳态误差
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 一个控制器的分析配置。
+ */
+struct StepRule
+{
+	std::string name;         /**< 控制器名称，例如 START1。 */
+	std::string setpoint;     /**< 设定值通道。 */
+	std::string measurement;  /**< 测量值通道。 */
+	std::string gains[3];     /**< Kp、Ki、Kd 通道，默认为 "名称.P"、"名称.I"、"名称.D"，即 PID 帧的通道。 */
+	double band = 0.02;       /**< 调节带宽，阶跃幅度的比例。 */
+	double window = 10.0;     /**< 一次阶跃最长观察时间（秒）。 */
+	double hold = 0.5;        /**< 进入调节带并保持这么久（秒）后认为已经稳定，提前结束这次阶跃。 */
+	double minStep = 0.0;     /**< 设定值变化超过这个值才算阶跃。 */
+};
+
+/**
+ * @brief 阶跃分析配置，每个控制器一条规则。
+ *
+ * 文本格式：规则之间用 ';' 或换行分隔，每条规则为 "名称: 键=值 ..."，
+ * 键有 sp、pv（必需）、gains=Kp通道,Ki通道,Kd通道、band（比例或百分数，例如 2%）、window、hold 和 min-step，
+ * 例如 "START1: sp=sp1 pv=pos1 band=2% window=5"。
+ */
+class StepConfig
+{
+public:
+	/**
+	 * @brief 解析配置文本。
+	 * @throw std::invalid_argument 如果格式错误或缺少 sp、pv。
+	 */
+	static StepConfig Parse(const std::string& spec);
+
+	/**
+	 * @brief 转换回配置文本。
+	 */
+	std::string Describe() const;
+
+	bool IsEmpty() const { return m_rules.empty(); }
+	const std::vector<StepRule>& Rules() const { return m_rules; }
+
+private:
+	std::vector<StepRule> m_rules; /**< 各控制器的规则。 */
+};
+
+/**
+ * @brief 一次阶跃的分析结果，无法得到的指标为 NaN。
+ */
+struct StepMetrics
+{
+	double t0 = 0.0;               /**< 阶跃时间（秒）。 */
+	double from = 0.0;             /**< 阶跃前的设定值。 */
+	double to = 0.0;               /**< 阶跃后的设定值。 */
+	double riseTime;               /**< 从 10% 到 90% 的时间（秒）。 */
+	double overshoot;              /**< 超调量（百分比），没有超调时为 0。 */
+	double settlingTime;           /**< 从阶跃到最后一次进入调节带的时间（秒），结束时不在调节带内为 NaN。 */
+	double steadyStateError;       /**< 稳态误差（设定值减测量值），取最后一次进入调节带后的平均值。 */
+};
+
+/**
+ * @brief 一组增益下所有阶跃的汇总。
+ */
+struct GainSetStats
+{
+	double gains[3] = {};          /**< Kp、Ki、Kd。 */
+	double since = 0.0;            /**< 收到这组增益的时间（秒）。 */
+	uint32_t steps = 0;            /**< 阶跃次数。 */
+	uint32_t settled = 0;          /**< 在观察时间内稳定的次数。 */
+	StepMetrics last;              /**< 最近一次阶跃。 */
+	double riseSum = 0.0;          /**< 上升时间之和，用于求平均。 */
+	uint32_t riseCount = 0;        /**< 有上升时间的次数。 */
+	double overshootSum = 0.0;     /**< 超调量之和。 */
+	double settlingSum = 0.0;      /**< 调节时间之和。 */
+	double errorSum = 0.0;         /**< 稳态误差绝对值之和。 */
+	uint32_t errorCount = 0;       /**< 有稳态误差的次数。 */
+};
+
+/**
+ * @brief 一次完成的阶跃。
+ */
+struct StepResult
+{
+	int controller;                /**< 控制器序号，即规则序号。 */
+	int gainSet;                   /**< 增益组在该控制器历史中的序号，还没有收到增益时为 -1。 */
+	double gains[3];               /**< 阶跃开始时的 Kp、Ki、Kd，没有时为 NaN。 */
+	StepMetrics metrics;           /**< 分析结果。 */
+};
+
+/**
+ * @brief StepAnalyzer 对一个控制器做增量的阶跃响应分析，每个样本 O(1)，不保存样本历史。
+ *
+ * 设定值变化超过 minStep 时开始一次阶跃，以阶跃时的测量值为起点、新设定值为终点把测量值归一化为 0~1：
+ * 上升时间在相邻样本之间线性插值求 10% 和 90% 的穿越时刻；超调量取归一化峰值超出 1 的部分；
+ * 测量值离开调节带时记录时间并清零误差累计，调节时间是最后一次进入调节带的时刻。
+ * 下一次阶跃、超过观察时间或到达 90% 后在调节带内保持 hold 秒时结束本次阶跃并输出结果。
+ * 增益三个通道都收到后，数值与当前增益组不同即开始新的增益组，之后完成的阶跃计入新组。
+ */
+class StepAnalyzer
+{
+public:
+	using ResultHandler = std::function<void(const StepResult&)>;
+
+	/**
+	 * @brief 构造函数。
+	 * @param rule 分析配置。
+	 * @param controller 控制器序号，写入 StepResult。
+	 */
+	StepAnalyzer(StepRule rule, int controller);
+
+	void SetResultHandler(ResultHandler handler) { m_onResult = std::move(handler); }
+
+	void OnSetpoint(double t, double value);
+	void OnMeasurement(double t, double value);
+	/**
+	 * @brief 收到一个增益通道的数值。
+	 * @param index 0~2 对应 Kp、Ki、Kd。
+	 */
+	void OnGain(int index, double t, double value);
+
+	/**
+	 * @brief 结束正在进行的阶跃，例如停止采集时。
+	 */
+	void Finish();
+
+	/**
+	 * @brief 数据中断后重新开始：丢弃正在进行的阶跃，下一个设定值只作为起点，增益组历史保留。
+	 */
+	void Reset();
+
+	const StepRule& Rule() const { return m_rule; }
+	const std::vector<GainSetStats>& History() const { return m_history; }
+
+	/**
+	 * @brief 最多保留的增益组数量，超出时丢弃最旧的一组。
+	 */
+	static constexpr size_t kMaxGainSets = 256;
+
+private:
+	void StartStep(double t, double from, double to);
+	void FinishStep();
+
+	StepRule m_rule;               /**< 分析配置。 */
+	int m_controller;              /**< 控制器序号。 */
+	ResultHandler m_onResult;      /**< 阶跃完成时的回调。 */
+
+	bool m_haveSetpoint = false;   /**< 是否收到过设定值。 */
+	double m_setpoint = 0.0;       /**< 当前设定值。 */
+	bool m_haveMeasurement = false; /**< 是否收到过测量值。 */
+	double m_lastValue = 0.0;      /**< 最近的测量值。 */
+	double m_lastTime = 0.0;       /**< 最近测量值的时间。 */
+
+	double m_gains[3] = {};        /**< 最近收到的增益。 */
+	int m_gainMask = 0;            /**< 已收到的增益通道。 */
+	std::vector<GainSetStats> m_history; /**< 增益组历史。 */
+	uint64_t m_droppedSets = 0;    /**< 因超过 kMaxGainSets 丢弃的增益组数。 */
+
+	// 正在进行的阶跃
+	bool m_active = false;         /**< 是否有正在进行的阶跃。 */
+	int m_stepSet = -1;            /**< 阶跃开始时的增益组序号（含已丢弃的组）。 */
+	StepMetrics m_step;            /**< 阶跃的起止设定值和时间。 */
+	double m_start = 0.0;          /**< 归一化的起点（阶跃时的测量值）。 */
+	double m_span = 1.0;           /**< 归一化的幅度。 */
+	double m_prevY = 0.0;          /**< 上一个样本的归一化值。 */
+	double m_t10 = 0.0;            /**< 穿越 10% 的时刻，未穿越为 NaN。 */
+	double m_t90 = 0.0;            /**< 穿越 90% 的时刻，未穿越为 NaN。 */
+	double m_peak = 0.0;           /**< 归一化峰值。 */
+	double m_inBandSince = 0.0;    /**< 最后一次进入调节带的时刻，不在带内为 NaN。 */
+	double m_errorSum = 0.0;       /**< 进入调节带后的误差之和。 */
+	uint64_t m_errorCount = 0;     /**< 进入调节带后的样本数。 */
+};
+
+/**
+ * @brief 把一次阶跃格式化为一行：控制器,Kp,Ki,Kd,起点,终点,上升ms,超调%,调节ms,稳态误差。
+ */
+std::string FormatStepResult(const StepResult& result, const std::string& controller);
+
+/**
+ * @brief 把一个控制器的增益组历史格式化为多行文本，每组一行平均指标。
+ */
+std::string FormatGainHistory(const std::string& controller, const std::vector<GainSetStats>& history);
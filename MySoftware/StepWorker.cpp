@@ -0,0 +1,393 @@
+/*
+ * @Description: 在工作线程上对各控制器运行阶跃响应分析，输出完成的阶跃和每组增益的历史指标
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "StepWorker.h"
+#include "CrashHandler.h"
+#include "TimeSeriesStore.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+	int64_t NowNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+StepWorker::StepWorker(size_t blockSamples, int maxLatencyMs)
+	: m_blockSamples(blockSamples), m_maxLatencyMs(maxLatencyMs), m_startNs(NowNs())
+{
+	m_thread = std::thread(&StepWorker::Run, this);
+}
+
+StepWorker::~StepWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_one();
+	m_thread.join();
+}
+
+/**
+ * @brief 更换配置：清空通道映射，工作线程在下一批开始前重建全部分析器。
+ */
+void StepWorker::SetConfig(const StepConfig& config)
+{
+	m_config = config;
+	m_bindings.clear();
+
+	std::vector<std::string> names;
+	for (const StepRule& rule : m_config.Rules())
+	{
+		names.push_back(rule.name);
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_newConfig = std::make_unique<StepConfig>(m_config);
+	m_names = std::move(names);
+	m_history.assign(m_names.size(), std::vector<GainSetStats>());
+}
+
+const std::vector<StepWorker::Binding>* StepWorker::Bindings(const std::string& name)
+{
+	auto it = m_bindings.find(name);
+	if (it == m_bindings.end())
+	{
+		std::vector<Binding> bindings;
+		const std::vector<StepRule>& rules = m_config.Rules();
+		for (size_t i = 0; i < rules.size(); ++i)
+		{
+			const int controller = static_cast<int>(i);
+			if (rules[i].setpoint == name)
+			{
+				bindings.push_back(Binding{ controller, Role::Setpoint });
+			}
+			if (rules[i].measurement == name)
+			{
+				bindings.push_back(Binding{ controller, Role::Measurement });
+			}
+			for (int g = 0; g < 3; ++g)
+			{
+				if (rules[i].gains[g] == name)
+				{
+					bindings.push_back(Binding{ controller, static_cast<Role>(static_cast<int>(Role::Kp) + g) });
+				}
+			}
+		}
+		it = m_bindings.emplace(name, std::move(bindings)).first;
+	}
+	return it->second.empty() ? nullptr : &it->second;
+}
+
+void StepWorker::Submit(const Input* inputs, size_t count)
+{
+	bool wake = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending.insert(m_pending.end(), inputs, inputs + count);
+		m_submitted += count;
+		wake = m_pending.size() >= m_blockSamples;
+	}
+	if (wake)
+	{
+		m_wake.notify_one();
+	}
+}
+
+/**
+ * @brief 提交一条记录：先在不加锁的情况下查出各值的引用，再一次加锁追加。
+ */
+void StepWorker::PushRecord(double t, const DecodedRecord& record, const std::string& prefix)
+{
+	if (record.values == nullptr || m_config.IsEmpty())
+	{
+		return;
+	}
+
+	Input inputs[16];
+	size_t count = 0;
+	for (size_t i = 0; i < record.count; ++i)
+	{
+		if (std::isnan(record.values[i]))
+		{
+			continue;
+		}
+		TimeSeriesStore::ChannelKey(record, i, m_keyBuffer);
+		if (!prefix.empty())
+		{
+			m_keyBuffer.insert(0, prefix);
+		}
+		const std::vector<Binding>* bindings = Bindings(m_keyBuffer);
+		if (bindings == nullptr)
+		{
+			continue;
+		}
+		for (const Binding& binding : *bindings)
+		{
+			inputs[count++] = Input{ binding.controller, binding.role, t, record.values[i] };
+			if (count == sizeof(inputs) / sizeof(inputs[0]))
+			{
+				Submit(inputs, count);
+				count = 0;
+			}
+		}
+	}
+	if (count > 0)
+	{
+		Submit(inputs, count);
+	}
+}
+
+void StepWorker::Push(const std::string& channel, double t, double value)
+{
+	if (m_config.IsEmpty() || std::isnan(value))
+	{
+		return;
+	}
+	const std::vector<Binding>* bindings = Bindings(channel);
+	if (bindings == nullptr)
+	{
+		return;
+	}
+	for (const Binding& binding : *bindings)
+	{
+		const Input input{ binding.controller, binding.role, t, value };
+		Submit(&input, 1);
+	}
+}
+
+void StepWorker::Flush(bool finish)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_flushRequested = true;
+	m_finishRequested = m_finishRequested || finish;
+	m_wake.notify_one();
+	m_idle.wait(lock, [this]() { return m_processed == m_submitted && !m_finishRequested; });
+}
+
+void StepWorker::Reset(const std::string& prefix)
+{
+	if (m_config.IsEmpty())
+	{
+		return;
+	}
+	Flush();
+	std::vector<int> controllers;
+	for (const auto& [name, bindings] : m_bindings)
+	{
+		if (name.compare(0, prefix.size(), prefix) != 0)
+		{
+			continue;
+		}
+		for (const Binding& binding : bindings)
+		{
+			controllers.push_back(binding.controller);
+		}
+	}
+	std::sort(controllers.begin(), controllers.end());
+	controllers.erase(std::unique(controllers.begin(), controllers.end()), controllers.end());
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_resetControllers.insert(m_resetControllers.end(), controllers.begin(), controllers.end());
+}
+
+size_t StepWorker::Drain(std::vector<StepResult>& out)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const size_t count = m_output.size();
+	out.insert(out.end(), m_output.begin(), m_output.end());
+	m_output.clear();
+	return count;
+}
+
+std::vector<GainSetStats> StepWorker::History(int controller) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (controller < 0 || static_cast<size_t>(controller) >= m_history.size())
+	{
+		return std::vector<GainSetStats>();
+	}
+	return m_history[static_cast<size_t>(controller)];
+}
+
+std::string StepWorker::FormatHistory() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::string text;
+	for (size_t i = 0; i < m_history.size() && i < m_names.size(); ++i)
+	{
+		text += FormatGainHistory(m_names[i], m_history[i]);
+	}
+	return text;
+}
+
+uint64_t StepWorker::ProcessedSamples() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_processed;
+}
+
+double StepWorker::BusySeconds() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_busyNs / 1e9;
+}
+
+std::string StepWorker::Format() const
+{
+	uint64_t processed = 0;
+	uint64_t steps = 0;
+	double busy = 0.0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		processed = m_processed;
+		steps = m_steps;
+		busy = m_busyNs / 1e9;
+	}
+	const double elapsed = (NowNs() - m_startNs) / 1e9;
+	char text[160];
+	std::snprintf(text, sizeof(text), "steps controllers=%zu samples=%llu steps=%llu busy=%.3fs load=%.2f%%",
+		m_config.Rules().size(), static_cast<unsigned long long>(processed),
+		static_cast<unsigned long long>(steps), busy, elapsed > 0 ? busy / elapsed * 100.0 : 0.0);
+	return text;
+}
+
+/**
+ * @brief 工作线程：等待一整块或超时，取走待处理样本后在锁外处理。
+ */
+void StepWorker::Run()
+{
+	TraceRecorder::SetThreadName("steps");
+	CrashHandler::InstallThreadStack();
+	std::vector<Input> batch;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stop)
+	{
+		m_wake.wait_for(lock, std::chrono::milliseconds(m_maxLatencyMs), [this]() {
+			return m_stop || m_flushRequested || m_pending.size() >= m_blockSamples;
+			});
+		if (m_stop)
+		{
+			break;
+		}
+		m_flushRequested = false;
+		if (m_pending.empty() && !m_newConfig && !m_finishRequested && m_resetControllers.empty())
+		{
+			m_idle.notify_all();
+			continue;
+		}
+
+		batch.swap(m_pending);
+		std::unique_ptr<StepConfig> config = std::move(m_newConfig);
+		const bool finish = m_finishRequested;
+		std::vector<int> resets = std::move(m_resetControllers);
+		m_resetControllers.clear();
+		lock.unlock();
+
+		const int64_t startNs = NowNs();
+		if (config)
+		{
+			m_analyzers.clear();
+			for (const StepRule& rule : config->Rules())
+			{
+				const int controller = static_cast<int>(m_analyzers.size());
+				m_analyzers.push_back(std::make_unique<StepAnalyzer>(rule, controller));
+				m_analyzers.back()->SetResultHandler([this](const StepResult& result) {
+					m_results.push_back(result);
+					m_changed[static_cast<size_t>(result.controller)] = 1;
+					});
+			}
+			m_changed.assign(m_analyzers.size(), 0);
+		}
+		for (const int controller : resets)
+		{
+			if (static_cast<size_t>(controller) < m_analyzers.size())
+			{
+				m_analyzers[static_cast<size_t>(controller)]->Reset();
+			}
+		}
+		ProcessBatch(batch);
+		if (finish)
+		{
+			for (auto& analyzer : m_analyzers)
+			{
+				analyzer->Finish();
+			}
+		}
+		const int64_t busyNs = NowNs() - startNs;
+
+		lock.lock();
+		m_processed += batch.size();
+		m_busyNs += busyNs;
+		m_steps += m_results.size();
+		if (finish)
+		{
+			m_finishRequested = false;
+		}
+		batch.clear();
+		const bool ready = !m_results.empty();
+		m_output.insert(m_output.end(), m_results.begin(), m_results.end());
+		m_results.clear();
+		// 配置在本批处理期间又被更换时，历史属于旧配置，不再复制
+		for (size_t c = 0; c < m_changed.size(); ++c)
+		{
+			if (m_changed[c] && !m_newConfig && c < m_history.size())
+			{
+				m_history[c] = m_analyzers[c]->History();
+			}
+			m_changed[c] = 0;
+		}
+		m_idle.notify_all();
+		if (m_readyHandler && ready)
+		{
+			lock.unlock();
+			m_readyHandler();
+			lock.lock();
+		}
+	}
+}
+
+/**
+ * @brief 处理一批样本：按提交顺序分发给各控制器的分析器。
+ * 阶跃分析依赖设定值和测量值的先后顺序，因此不像滤波那样按通道重排。
+ */
+void StepWorker::ProcessBatch(const std::vector<Input>& batch)
+{
+	if (batch.empty())
+	{
+		return;
+	}
+	TRACE_ZONE("StepWorker::ProcessBatch");
+
+	for (const Input& input : batch)
+	{
+		if (static_cast<size_t>(input.controller) >= m_analyzers.size())
+		{
+			continue;
+		}
+		StepAnalyzer& analyzer = *m_analyzers[static_cast<size_t>(input.controller)];
+		switch (input.role)
+		{
+		case Role::Setpoint:
+			analyzer.OnSetpoint(input.t, input.value);
+			break;
+		case Role::Measurement:
+			analyzer.OnMeasurement(input.t, input.value);
+			break;
+		default:
+			analyzer.OnGain(static_cast<int>(input.role) - static_cast<int>(Role::Kp), input.t, input.value);
+			m_changed[static_cast<size_t>(input.controller)] = 1;
+			break;
+		}
+	}
+}
@@ -0,0 +1,185 @@
+/*
+ * @Description: 在工作线程上对各控制器运行阶跃响应分析，输出完成的阶跃和每组增益的历史指标
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 23:00:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ProtocolDecoder.h"
+#include "StepAnalyzer.h"
+
+/**
+ * @brief StepWorker 把设定值、测量值和增益样本交给工作线程，每个控制器一个 StepAnalyzer。
+ *
+ * 结构与 FilterWorker 相同：生产者线程按通道名称查出样本属于哪个控制器的哪个输入，
+ * 只有配置中引用的通道才进入队列；工作线程按提交顺序整批处理，
+ * 同一控制器的设定值和测量值之间的先后关系保持不变。
+ * 每批处理完后把有变化的控制器的增益组历史复制一份，界面线程用 History 读取，不访问工作线程的状态。
+ *
+ * 通道命名与 TimeSeriesStore 相同。SetConfig、PushRecord、Push、Flush、Drain 应在同一个线程中调用。
+ */
+class StepWorker
+{
+public:
+	/**
+	 * @brief 构造函数，启动工作线程。
+	 * @param blockSamples 累积到多少个样本时立即唤醒工作线程。
+	 * @param maxLatencyMs 样本最多等待多久被处理（毫秒）。
+	 */
+	explicit StepWorker(size_t blockSamples = 1024, int maxLatencyMs = 20);
+
+	/**
+	 * @brief 析构函数，停止工作线程，未处理的样本被丢弃。
+	 */
+	~StepWorker();
+
+	StepWorker(const StepWorker&) = delete;
+	StepWorker& operator=(const StepWorker&) = delete;
+
+	/**
+	 * @brief 更换配置，所有控制器的分析状态和历史重新开始。
+	 */
+	void SetConfig(const StepConfig& config);
+	const StepConfig& Config() const { return m_config; }
+
+	/**
+	 * @brief 提交一条解码记录中被配置引用的数值。
+	 * @param t 时间（秒）。
+	 * @param record 解码记录。
+	 * @param prefix 加在通道名称前的前缀，多个串口时用于区分同名通道。
+	 */
+	void PushRecord(double t, const DecodedRecord& record, const std::string& prefix = std::string());
+
+	/**
+	 * @brief 提交一个样本，例如派生通道的输出。
+	 */
+	void Push(const std::string& channel, double t, double value);
+
+	/**
+	 * @brief 等待已提交的样本全部处理完。
+	 * @param finish 是否同时结束所有正在进行的阶跃，例如停止采集时。
+	 */
+	void Flush(bool finish = false);
+
+	/**
+	 * @brief 数据中断后让分析器重新开始，见 StepAnalyzer::Reset。先处理完已提交的样本。
+	 * @param prefix 只重置引用了以此开头的通道的控制器，为空时重置所有控制器。
+	 */
+	void Reset(const std::string& prefix = std::string());
+
+	/**
+	 * @brief 取出完成的阶跃，追加到 out。
+	 * @return 取出的数量。
+	 */
+	size_t Drain(std::vector<StepResult>& out);
+
+	/**
+	 * @brief 一个控制器的增益组历史，截至最近一批处理完的时刻。
+	 */
+	std::vector<GainSetStats> History(int controller) const;
+
+	/**
+	 * @brief 所有控制器的增益组历史，格式见 FormatGainHistory。
+	 */
+	std::string FormatHistory() const;
+
+	/**
+	 * @brief 设置有新结果时的回调，在工作线程中调用，应在提交样本之前设置。
+	 */
+	void SetReadyHandler(std::function<void()> handler) { m_readyHandler = std::move(handler); }
+
+	/**
+	 * @brief 统计信息：控制器数、样本数、完成的阶跃数和工作线程占用率。
+	 */
+	std::string Format() const;
+
+	uint64_t ProcessedSamples() const;
+	double BusySeconds() const;
+
+private:
+	/**
+	 * @brief 样本的用途：设定值、测量值或第几个增益。
+	 */
+	enum class Role : uint8_t
+	{
+		Setpoint,
+		Measurement,
+		Kp,
+		Ki,
+		Kd
+	};
+
+	/**
+	 * @brief 一个通道被哪个控制器以什么用途引用，同一通道可以被多个控制器引用。
+	 */
+	struct Binding
+	{
+		int controller;
+		Role role;
+	};
+
+	/**
+	 * @brief 待处理的样本。
+	 */
+	struct Input
+	{
+		int controller;
+		Role role;
+		double t;
+		double value;
+	};
+
+	/**
+	 * @brief 生产者线程中查找通道的引用，没有被引用时返回 nullptr。
+	 */
+	const std::vector<Binding>* Bindings(const std::string& name);
+
+	void Submit(const Input* inputs, size_t count);
+	void Run();
+	void ProcessBatch(const std::vector<Input>& batch);
+
+	const size_t m_blockSamples;                 /**< 立即唤醒工作线程的样本数。 */
+	const int m_maxLatencyMs;                    /**< 最长等待时间。 */
+	std::function<void()> m_readyHandler;        /**< 有新结果时的回调。 */
+
+	// 生产者线程使用
+	StepConfig m_config;                         /**< 当前配置。 */
+	std::unordered_map<std::string, std::vector<Binding>> m_bindings; /**< 通道名称到引用的映射，未引用的通道为空数组。 */
+	std::string m_keyBuffer;                     /**< 生成通道名称的缓冲。 */
+
+	// 由 m_mutex 保护
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;              /**< 唤醒工作线程。 */
+	std::condition_variable m_idle;              /**< 一批处理完成。 */
+	std::vector<Input> m_pending;                /**< 待处理的样本。 */
+	std::unique_ptr<StepConfig> m_newConfig;     /**< 待生效的配置。 */
+	std::vector<int> m_resetControllers;         /**< 待重置的控制器。 */
+	uint64_t m_submitted = 0;                    /**< 已提交的样本数。 */
+	uint64_t m_processed = 0;                    /**< 已处理的样本数。 */
+	uint64_t m_steps = 0;                        /**< 完成的阶跃数。 */
+	int64_t m_busyNs = 0;                        /**< 工作线程处理耗时。 */
+	bool m_stop = false;                         /**< 是否停止。 */
+	bool m_flushRequested = false;               /**< Flush 正在等待，工作线程不等满一块。 */
+	bool m_finishRequested = false;              /**< Flush 要求结束正在进行的阶跃。 */
+	std::vector<StepResult> m_output;            /**< 完成、等待取出的阶跃。 */
+	std::vector<std::string> m_names;            /**< 各控制器名称。 */
+	std::vector<std::vector<GainSetStats>> m_history; /**< 各控制器增益组历史的副本。 */
+
+	// 工作线程使用
+	std::vector<std::unique_ptr<StepAnalyzer>> m_analyzers; /**< 各控制器的分析器。 */
+	std::vector<StepResult> m_results;           /**< 本批完成的阶跃。 */
+	std::vector<char> m_changed;                 /**< 本批中历史有变化的控制器。 */
+
+	int64_t m_startNs = 0;                       /**< 启动时间，用于计算占用率。 */
+	std::thread m_thread;                        /**< 工作线程，最后构造。 */
+};
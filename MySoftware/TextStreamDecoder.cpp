@@ -0,0 +1,221 @@
+/*
+ * @Description: 有状态的增量文本解码，跨数据块保留不完整的多字节字符，纯 ASCII 数据走快速路径
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 19:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "TextStreamDecoder.h"
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXT_HAVE_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define TEXT_HAVE_NEON 1
+#endif
+
+namespace
+{
+	/**
+	 * @brief UTF-8 数据末尾不完整字符的字节数（0 到 3）。
+	 * 从末尾向前最多看 3 个字节，找到前导字节后按其声明的长度判断是否完整；
+	 * 非法序列交给 fromUtf8 处理为替换字符。
+	 */
+	size_t IncompleteUtf8Tail(const char* data, size_t length)
+	{
+		for (size_t i = 1; i <= 3 && i <= length; ++i)
+		{
+			const unsigned char c = static_cast<unsigned char>(data[length - i]);
+			if ((c & 0xC0) == 0x80)
+			{
+				continue;
+			}
+			if (c < 0xC0)
+			{
+				return 0;
+			}
+			const size_t need = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : 2;
+			return need > i ? i : 0;
+		}
+		return 0;
+	}
+}
+
+QStringList TextStreamDecoder::Encodings()
+{
+	return { "UTF-8", "GBK", "Latin-1" };
+}
+
+TextStreamDecoder::TextStreamDecoder(const QString& encoding)
+	: m_encoding(encoding)
+{
+	const QString name = encoding.toUpper().remove('-');
+	if (name == "UTF8")
+	{
+		m_kind = Kind::Utf8;
+		return;
+	}
+	if (name == "LATIN1" || name == "ISO88591")
+	{
+		m_kind = Kind::Latin1;
+		return;
+	}
+
+	m_kind = Kind::Codec;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+	m_codec = std::make_unique<QStringDecoder>(encoding.toLatin1().constData());
+	if (!m_codec->isValid())
+	{
+		throw std::invalid_argument(QString("Encoding %1 is not supported by this Qt build.").arg(encoding).toStdString());
+	}
+#else
+	QTextCodec* codec = QTextCodec::codecForName(encoding.toLatin1());
+	if (codec == nullptr)
+	{
+		throw std::invalid_argument(QString("Encoding %1 is not supported by this Qt build.").arg(encoding).toStdString());
+	}
+	m_codec.reset(codec->makeDecoder());
+#endif
+}
+
+TextStreamDecoder::~TextStreamDecoder() = default;
+
+bool TextStreamDecoder::IsAscii(const char* data, size_t length)
+{
+	size_t i = 0;
+#if defined(TEXT_HAVE_SSE2)
+	// 每 64 字节合并一次最高位，再用一次 movemask 判断
+	for (; i + 64 <= length; i += 64)
+	{
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16));
+		const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 32));
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 48));
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0)
+		{
+			return false;
+		}
+	}
+	for (; i + 16 <= length; i += 16)
+	{
+		if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))) != 0)
+		{
+			return false;
+		}
+	}
+#elif defined(TEXT_HAVE_NEON)
+	for (; i + 16 <= length; i += 16)
+	{
+		if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i))) >= 0x80)
+		{
+			return false;
+		}
+	}
+#endif
+	for (; i + 8 <= length; i += 8)
+	{
+		quint64 word;
+		std::memcpy(&word, data + i, sizeof(word));
+		if (word & 0x8080808080808080ull)
+		{
+			return false;
+		}
+	}
+	for (; i < length; ++i)
+	{
+		if (static_cast<unsigned char>(data[i]) >= 0x80)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief 解码一个数据块。
+ * 没有残留字节且整块为 ASCII 时，任何编码下都与 Latin-1 等价，直接展开。
+ */
+QString TextStreamDecoder::Decode(ByteSpan chunk)
+{
+	const bool boundary = m_kind == Kind::Utf8 ? m_carry.empty() : !m_codecPending;
+	if (m_kind == Kind::Latin1 || (boundary && IsAscii(chunk.data(), chunk.size())))
+	{
+		m_fastBytes += chunk.size();
+		return QString::fromLatin1(chunk.data(), static_cast<int>(chunk.size()));
+	}
+	m_slowBytes += chunk.size();
+	return m_kind == Kind::Utf8 ? DecodeUtf8(chunk) : DecodeWithCodec(chunk);
+}
+
+/**
+ * @brief UTF-8：上一块残留的字节与本块拼接，末尾不完整的字符留到下一块。
+ */
+QString TextStreamDecoder::DecodeUtf8(ByteSpan chunk)
+{
+	if (m_carry.empty())
+	{
+		const size_t tail = IncompleteUtf8Tail(chunk.data(), chunk.size());
+		m_carry.assign(chunk.data() + chunk.size() - tail, tail);
+		return QString::fromUtf8(chunk.data(), static_cast<int>(chunk.size() - tail));
+	}
+
+	std::string bytes;
+	bytes.reserve(m_carry.size() + chunk.size());
+	bytes.append(m_carry).append(chunk.data(), chunk.size());
+	const size_t tail = IncompleteUtf8Tail(bytes.data(), bytes.size());
+	m_carry.assign(bytes.data() + bytes.size() - tail, tail);
+	return QString::fromUtf8(bytes.data(), static_cast<int>(bytes.size() - tail));
+}
+
+QString TextStreamDecoder::DecodeWithCodec(ByteSpan chunk)
+{
+	UpdateDoubleByteState(chunk);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+	return m_codec->decode(QByteArrayView(chunk.data(), static_cast<qsizetype>(chunk.size())));
+#else
+	return m_codec->toUnicode(chunk.data(), static_cast<int>(chunk.size()));
+#endif
+}
+
+/**
+ * @brief 跟踪双字节编码（GBK）是否停在前导字节之后，以判断下一块能否走快速路径。
+ * 0x81-0xFE 为前导字节，其后一个字节无论取值都属于同一个字符。
+ */
+void TextStreamDecoder::UpdateDoubleByteState(ByteSpan chunk)
+{
+	bool pending = m_codecPending;
+	for (const char c : chunk)
+	{
+		if (pending)
+		{
+			pending = false;
+		}
+		else if (static_cast<unsigned char>(c) >= 0x81 && static_cast<unsigned char>(c) != 0xFF)
+		{
+			pending = true;
+		}
+	}
+	m_codecPending = pending;
+}
+
+void TextStreamDecoder::Reset()
+{
+	m_carry.clear();
+	m_codecPending = false;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+	if (m_codec)
+	{
+		m_codec->resetState();
+	}
+#else
+	if (m_codec)
+	{
+		// QTextDecoder 没有 reset，重新创建一个
+		QTextCodec* codec = QTextCodec::codecForName(m_encoding.toLatin1());
+		m_codec.reset(codec->makeDecoder());
+	}
+#endif
+}
@@ -0,0 +1,99 @@
+/*
+ * @Description: 有状态的增量文本解码，跨数据块保留不完整的多字节字符，纯 ASCII 数据走快速路径
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 19:10:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QtGlobal>
+#include <memory>
+#include <string>
+#include "ProtocolDecoder.h"
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtCore/QStringDecoder>
+#else
+#include <QtCore/QTextCodec>
+#endif
+
+/**
+ * @brief TextStreamDecoder 把串口字节流逐块解码为文本。
+ *
+ * 与对每个数据块单独调用 QString::fromUtf8 不同，被数据块边界截断的多字节字符
+ * （例如固件输出的中文日志）会保留到下一块再解码，不会变成替换字符。
+ * 当前没有残留字节且整块都是 ASCII 时（用 SIMD 检查），直接按 Latin-1 展开，跳过编码校验。
+ *
+ * 支持 UTF-8、GBK 和 Latin-1。GBK 使用 Qt 的有状态解码器，
+ * Qt 6 需要带 ICU 编译才能支持，不支持时构造函数抛出异常。
+ */
+class TextStreamDecoder
+{
+public:
+	/**
+	 * @brief 支持的编码名称。
+	 */
+	static QStringList Encodings();
+
+	/**
+	 * @brief 构造函数。
+	 * @param encoding 编码名称，见 Encodings()。
+	 * @throw std::invalid_argument 如果编码未知或当前 Qt 不支持。
+	 */
+	explicit TextStreamDecoder(const QString& encoding = "UTF-8");
+	~TextStreamDecoder();
+
+	TextStreamDecoder(const TextStreamDecoder&) = delete;
+	TextStreamDecoder& operator=(const TextStreamDecoder&) = delete;
+
+	/**
+	 * @brief 解码一个数据块，末尾不完整的字符留到下一次。
+	 */
+	QString Decode(ByteSpan chunk);
+	QString Decode(const QByteArray& chunk) { return Decode(ByteSpan(chunk.constData(), static_cast<size_t>(chunk.size()))); }
+
+	/**
+	 * @brief 丢弃残留的不完整字符。
+	 */
+	void Reset();
+
+	const QString& Encoding() const { return m_encoding; }
+
+	/**
+	 * @brief 经快速路径与完整解码的字节数，用于确认快速路径的命中率。
+	 */
+	quint64 FastPathBytes() const { return m_fastBytes; }
+	quint64 SlowPathBytes() const { return m_slowBytes; }
+
+	/**
+	 * @brief 数据是否全部是 7 位 ASCII。x86 使用 SSE2，ARM64 使用 NEON，其他平台按 8 字节字检查。
+	 */
+	static bool IsAscii(const char* data, size_t length);
+
+private:
+	enum class Kind
+	{
+		Utf8,
+		Latin1,
+		Codec
+	};
+
+	QString DecodeUtf8(ByteSpan chunk);
+	QString DecodeWithCodec(ByteSpan chunk);
+	void UpdateDoubleByteState(ByteSpan chunk);
+
+	QString m_encoding;          /**< 编码名称。 */
+	Kind m_kind = Kind::Utf8;    /**< 解码方式。 */
+	std::string m_carry;         /**< UTF-8 末尾不完整的字节。 */
+	bool m_codecPending = false; /**< 双字节编码是否停在前导字节之后。 */
+	quint64 m_fastBytes = 0;     /**< 快速路径字节数。 */
+	quint64 m_slowBytes = 0;     /**< 完整解码字节数。 */
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+	std::unique_ptr<QStringDecoder> m_codec; /**< GBK 等编码的有状态解码器。 */
+#else
+	std::unique_ptr<QTextDecoder> m_codec;   /**< GBK 等编码的有状态解码器。 */
+#endif
+};
@@ -0,0 +1,361 @@
+/*
+ * @Description: 多分辨率时间序列存储，按 2 的幂逐级抽取 min/max/mean，任意缩放级别按像素数读取
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 16:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "TimeSeriesStore.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	constexpr size_t kGroupSize = size_t(1) << LodSeries::kFirstStoredLevel;
+}
+
+/**
+ * @brief 追加一个样本。
+ * 每凑齐 256 个样本生成一项最低保存级别的摘要，再与同级等待配对的项逐级向上合并。
+ * 摘要使用取整后的时间，与解码出的样本一致。
+ */
+void LodSeries::Append(double t, double value)
+{
+	m_samples.Append(t, value);
+	t = m_samples.LastTime();
+
+	if (m_groupCount == 0)
+	{
+		m_group = Summary{ t, t, value, value, value };
+	}
+	else
+	{
+		m_group.tEnd = t;
+		m_group.min = std::min(m_group.min, value);
+		m_group.max = std::max(m_group.max, value);
+		m_group.sum += value;
+	}
+	if (++m_groupCount < kGroupSize)
+	{
+		return;
+	}
+	m_groupCount = 0;
+
+	Summary carry = m_group;
+	for (size_t r = 0;; ++r)
+	{
+		if (r == m_levels.size())
+		{
+			m_levels.emplace_back();
+			m_pending.push_back(Summary{});
+			m_hasPending.push_back(0);
+		}
+		m_levels[r].PushBack(carry);
+		if (!m_hasPending[r])
+		{
+			m_pending[r] = carry;
+			m_hasPending[r] = 1;
+			return;
+		}
+
+		// 凑齐两项，合并为上一级的一项
+		const Summary& first = m_pending[r];
+		carry = Summary{ first.tBegin, carry.tEnd, std::min(first.min, carry.min),
+			std::max(first.max, carry.max), first.sum + carry.sum };
+		m_hasPending[r] = 0;
+	}
+}
+
+size_t LodSeries::LevelSize(int level) const
+{
+	return level < kFirstStoredLevel ? (m_samples.Size() >> level)
+		: m_levels[static_cast<size_t>(level - kFirstStoredLevel)].Size();
+}
+
+LodSeries::Summary LodSeries::Entry(int level, size_t index, CompressedSeries::Cursor& cursor) const
+{
+	if (level >= kFirstStoredLevel)
+	{
+		return m_levels[static_cast<size_t>(level - kFirstStoredLevel)][index];
+	}
+
+	const size_t count = size_t(1) << level;
+	cursor.Seek(index << level);
+	Summary entry{ cursor.Time(), cursor.Time(), cursor.Value(), cursor.Value(), 0.0 };
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (i > 0)
+		{
+			cursor.Next();
+		}
+		const double v = cursor.Value();
+		entry.min = std::min(entry.min, v);
+		entry.max = std::max(entry.max, v);
+		entry.sum += v;
+	}
+	entry.tEnd = cursor.Time();
+	return entry;
+}
+
+/**
+ * @brief 查询时间范围内的数据。
+ *
+ * 先用二分查找确定样本范围，再选择使每个桶覆盖至少一项摘要的最高级别；
+ * 末尾不足一项的样本依次用更低的级别补齐，最多额外读取 level 项。
+ * 低级别的项按下标递增读取，同一个 Cursor 在块内接着解码，每个样本只解码一次。
+ * 范围两端的摘要项可能包含少量范围外的样本，对绘图没有影响。
+ */
+void LodSeries::Query(double t0, double t1, size_t pixels, std::vector<LodBucket>& out, int* level) const
+{
+	out.clear();
+	if (level)
+	{
+		*level = 0;
+	}
+	if (Size() == Begin() || pixels == 0 || !(t1 >= t0))
+	{
+		return;
+	}
+
+	// 二分查找样本范围 [first, last)
+	const size_t first = m_samples.LowerBound(t0);
+	const size_t last = m_samples.UpperBound(t1);
+	if (first >= last)
+	{
+		return;
+	}
+
+	int useLevel = 0;
+	const size_t perPixel = (last - first) / pixels;
+	while (useLevel < MaxLevel() && (size_t(2) << useLevel) <= perPixel)
+	{
+		++useLevel;
+	}
+	if (level)
+	{
+		*level = useLevel;
+	}
+
+	const double span = t1 > t0 ? t1 - t0 : 1.0;
+	const double scale = static_cast<double>(pixels) / span;
+	out.reserve(pixels);
+	auto addEntry = [&](const Summary& entry, uint64_t count) {
+		size_t bucket = static_cast<size_t>(std::max(0.0, (entry.tBegin - t0) * scale));
+		bucket = std::min(bucket, pixels - 1);
+		if (!out.empty() && out.back().tBegin <= entry.tBegin &&
+			static_cast<size_t>(std::max(0.0, (out.back().tBegin - t0) * scale)) >= bucket)
+		{
+			LodBucket& target = out.back();
+			target.tEnd = entry.tEnd;
+			target.min = std::min(target.min, entry.min);
+			target.max = std::max(target.max, entry.max);
+			target.mean += entry.sum;  // 先累加总和，最后再除以样本数
+			target.count += count;
+			return;
+		}
+		out.push_back(LodBucket{ entry.tBegin, entry.tEnd, entry.min, entry.max, entry.sum, count });
+	};
+
+	CompressedSeries::Cursor cursor(m_samples);
+
+	// 主体部分：第 useLevel 级的完整项
+	size_t position = first;
+	size_t index = first >> useLevel;
+	const size_t fullEnd = std::min(LevelSize(useLevel), ((last - 1) >> useLevel) + 1);
+	for (; index < fullEnd; ++index)
+	{
+		addEntry(Entry(useLevel, index, cursor), uint64_t(1) << useLevel);
+		position = (index + 1) << useLevel;
+	}
+
+	// 末尾不足一项的部分依次使用更低的级别
+	for (int lower = useLevel - 1; lower >= 0 && position < last; --lower)
+	{
+		size_t lowerIndex = position >> lower;
+		while (lowerIndex < LevelSize(lower) && (lowerIndex << lower) < last)
+		{
+			addEntry(Entry(lower, lowerIndex, cursor), uint64_t(1) << lower);
+			++lowerIndex;
+			position = lowerIndex << lower;
+		}
+	}
+
+	for (LodBucket& bucket : out)
+	{
+		bucket.mean /= static_cast<double>(bucket.count);
+	}
+}
+
+size_t LodSeries::MemoryBytes() const
+{
+	size_t bytes = m_samples.MemoryBytes();
+	for (const auto& level : m_levels)
+	{
+		bytes += level.CapacityBytes();
+	}
+	return bytes;
+}
+
+/**
+ * @brief 丢弃最旧的样本。
+ * 新的起始下标是 4096 的倍数，因此低于 kFirstStoredLevel 的级别仍可由原始样本计算；
+ * 各级摘要只丢弃完全落在起始下标之前的块，查询时跨越起始下标的摘要项可能包含已丢弃的样本，
+ * 与范围两端的处理相同，对绘图没有影响。
+ */
+size_t LodSeries::DropOldest(size_t samples, std::FILE* spill, const std::string& name)
+{
+	constexpr size_t kBlock = CompressedSeries::kBlockSamples;
+	const size_t begin = Begin();
+	const size_t wanted = begin + (samples + kBlock - 1) / kBlock * kBlock;
+	const size_t newBegin = std::min(wanted, Size() / kBlock * kBlock);
+	if (newBegin <= begin)
+	{
+		return 0;
+	}
+
+	if (spill != nullptr)
+	{
+		CompressedSeries::Cursor cursor(m_samples);
+		cursor.Seek(begin);
+		for (size_t i = begin; i < newBegin; ++i, cursor.Next())
+		{
+			std::fprintf(spill, "%.6f,%s,%.17g\n", cursor.Time(), name.c_str(), cursor.Value());
+		}
+	}
+	m_samples.DropBefore(newBegin);
+	for (size_t r = 0; r < m_levels.size(); ++r)
+	{
+		m_levels[r].DropBefore(newBegin >> (kFirstStoredLevel + r));
+	}
+	return newBegin - begin;
+}
+
+void LodSeries::Clear()
+{
+	m_samples.Clear();
+	m_levels.clear();
+	m_pending.clear();
+	m_hasPending.clear();
+	m_groupCount = 0;
+}
+
+int TimeSeriesStore::Channel(const std::string& name)
+{
+	auto it = m_channelIds.find(name);
+	if (it != m_channelIds.end())
+	{
+		return it->second;
+	}
+	const int id = static_cast<int>(m_series.size());
+	m_series.push_back(std::make_unique<LodSeries>());
+	m_names.push_back(name);
+	m_channelIds.emplace(name, id);
+	return id;
+}
+
+int TimeSeriesStore::FindChannel(const std::string& name) const
+{
+	auto it = m_channelIds.find(name);
+	return it == m_channelIds.end() ? -1 : it->second;
+}
+
+/**
+ * @brief 生成通道名称，规则见类说明。
+ */
+void TimeSeriesStore::ChannelKey(const DecodedRecord& record, size_t i, std::string& out)
+{
+	static const char* const kPidFields[] = { "P", "I", "D" };
+	if (record.keys != nullptr)
+	{
+		out.assign(record.keys[i].data(), record.keys[i].size());
+		return;
+	}
+	out.assign(record.name.data(), record.name.size());
+	out.push_back('.');
+	if (record.kind == RecordKind::PidFrame && i < 3)
+	{
+		out.append(kPidFields[i]);
+	}
+	else
+	{
+		out.append(std::to_string(i));
+	}
+}
+
+/**
+ * @brief 写入一条解码记录中的所有数值，通道名称规则见类说明。
+ */
+void TimeSeriesStore::Append(double t, const DecodedRecord& record)
+{
+	if (record.values == nullptr)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < record.count; ++i)
+	{
+		const double value = record.values[i];
+		if (std::isnan(value))
+		{
+			continue;
+		}
+		ChannelKey(record, i, m_keyBuffer);
+		m_series[static_cast<size_t>(Channel(m_keyBuffer))]->Append(t, value);
+	}
+}
+
+size_t TimeSeriesStore::MemoryBytes() const
+{
+	size_t bytes = 0;
+	for (const auto& series : m_series)
+	{
+		bytes += series->MemoryBytes();
+	}
+	return bytes;
+}
+
+/**
+ * @brief 按相同比例丢弃每个通道最旧的样本。
+ * 样本少于一块的通道不会被丢弃，它们的内存本来就很少。
+ */
+size_t TimeSeriesStore::ReleaseOldest(size_t bytes, std::FILE* spill)
+{
+	const size_t before = MemoryBytes();
+	if (before == 0 || bytes == 0)
+	{
+		return 0;
+	}
+	const double fraction = std::min(1.0, static_cast<double>(bytes) / static_cast<double>(before));
+	for (size_t i = 0; i < m_series.size(); ++i)
+	{
+		LodSeries& series = *m_series[i];
+		const size_t stored = series.Size() - series.Begin();
+		series.DropOldest(static_cast<size_t>(std::ceil(stored * fraction)), spill, m_names[i]);
+	}
+	return before - MemoryBytes();
+}
+
+void TimeSeriesStore::BeginGap(double t)
+{
+	if (m_gaps.empty() || m_gaps.back().end != std::numeric_limits<double>::infinity())
+	{
+		m_gaps.push_back(TimeGap{ t, std::numeric_limits<double>::infinity() });
+	}
+}
+
+void TimeSeriesStore::EndGap(double t)
+{
+	if (!m_gaps.empty() && m_gaps.back().end == std::numeric_limits<double>::infinity())
+	{
+		m_gaps.back().end = std::max(t, m_gaps.back().begin);
+	}
+}
+
+void TimeSeriesStore::Clear()
+{
+	m_series.clear();
+	m_names.clear();
+	m_channelIds.clear();
+	m_gaps.clear();
+}
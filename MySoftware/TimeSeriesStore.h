@@ -0,0 +1,280 @@
+/*
+ * @Description: 多分辨率时间序列存储，按 2 的幂逐级抽取 min/max/mean，任意缩放级别按像素数读取
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 16:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CompressedSeries.h"
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief 查询结果中的一个桶，对应屏幕上的一列像素。
+ */
+struct LodBucket
+{
+	double tBegin;   /**< 桶内第一个样本的时间。 */
+	double tEnd;     /**< 桶内最后一个样本的时间。 */
+	double min;      /**< 最小值。 */
+	double max;      /**< 最大值。 */
+	double mean;     /**< 平均值。 */
+	uint64_t count;  /**< 样本数。 */
+};
+
+/**
+ * @brief 一段没有数据的时间，例如串口断开到重新打开之间。
+ */
+struct TimeGap
+{
+	double begin;  /**< 开始时间（秒）。 */
+	double end;    /**< 结束时间（秒），尚未结束时为正无穷。 */
+};
+
+/**
+ * @brief 只追加的分块数组，扩容时不移动已有元素，避免长时间运行时的大块重新分配与复制。
+ * 可以按整块丢弃最旧的元素，下标保持不变，Begin() 之前的下标不能再访问。
+ */
+template<typename T, size_t BlockSize = 4096>
+class BlockArray
+{
+public:
+	static constexpr size_t kBlockSize = BlockSize;
+
+	void PushBack(const T& value)
+	{
+		if (m_size == (m_droppedBlocks + m_blocks.size()) * BlockSize)
+		{
+			m_blocks.emplace_back(new T[BlockSize]);
+		}
+		const size_t block = m_size / BlockSize - m_droppedBlocks;
+		m_blocks[block][m_size % BlockSize] = value;
+		++m_size;
+	}
+
+	const T& operator[](size_t index) const { return m_blocks[index / BlockSize - m_droppedBlocks][index % BlockSize]; }
+	size_t Size() const { return m_size; }
+	size_t Begin() const { return m_droppedBlocks * BlockSize; }
+	size_t CapacityBytes() const { return m_blocks.size() * BlockSize * sizeof(T); }
+
+	/**
+	 * @brief 丢弃下标小于 index 的所有完整块。
+	 */
+	void DropBefore(size_t index)
+	{
+		const size_t blocks = std::min(index / BlockSize, m_size / BlockSize);
+		if (blocks > m_droppedBlocks)
+		{
+			m_blocks.erase(m_blocks.begin(), m_blocks.begin() + static_cast<std::ptrdiff_t>(blocks - m_droppedBlocks));
+			m_droppedBlocks = blocks;
+		}
+	}
+
+	void Clear()
+	{
+		m_blocks.clear();
+		m_size = 0;
+		m_droppedBlocks = 0;
+	}
+
+private:
+	std::vector<std::unique_ptr<T[]>> m_blocks; /**< 数据块。 */
+	size_t m_size = 0;                          /**< 元素数量，包括已丢弃的部分。 */
+	size_t m_droppedBlocks = 0;                 /**< 已丢弃的块数。 */
+};
+
+/**
+ * @brief LodSeries 保存一个通道的全部样本及其多级摘要。
+ *
+ * 第 0 级是原始样本，第 k 级的第 j 项是原始样本 [j * 2^k, (j + 1) * 2^k) 的 min/max/sum，
+ * 由两项第 k - 1 级摘要合并得到。每追加一个样本最多向上合并若干级，均摊 O(1)。
+ * 原始样本保存在 CompressedSeries 中，等间隔采样的慢变信号每个样本只占 1～3 字节；
+ * 只保存 kFirstStoredLevel 及以上级别的摘要，每个样本约 0.3 字节，更低的级别查询时顺序解码不超过 128 个原始样本计算。
+ * 查询时根据每像素样本数选择级别，只读取 O(像素数) 个摘要项，与数据总量无关。
+ * 时间按微秒取整，必须单调不减，乱序的样本按上一个样本的时间记录。
+ */
+class LodSeries
+{
+public:
+	/**
+	 * @brief 保存摘要的最低级别，每项覆盖 256 个原始样本。
+	 */
+	static constexpr int kFirstStoredLevel = 8;
+
+	/**
+	 * @brief 追加一个样本。
+	 * @param t 时间（秒）。
+	 * @param value 数值。
+	 */
+	void Append(double t, double value);
+
+	/**
+	 * @brief 查询时间范围内的数据，合并为最多 pixels 个桶。
+	 * @param t0 起始时间。
+	 * @param t1 结束时间。
+	 * @param pixels 桶数量，通常为绘图区宽度。
+	 * @param out 查询结果，会先被清空，重复使用以避免分配。
+	 * @param level 实际使用的摘要级别，可为 nullptr。
+	 */
+	void Query(double t0, double t1, size_t pixels, std::vector<LodBucket>& out, int* level = nullptr) const;
+
+	/**
+	 * @brief 样本数量，包括已丢弃的样本，样本下标从 Begin() 开始有效。
+	 */
+	size_t Size() const { return m_samples.Size(); }
+	size_t Begin() const { return m_samples.Begin(); }
+	double FirstTime() const { return m_samples.FirstTime(); }
+	double LastTime() const { return m_samples.LastTime(); }
+
+	/**
+	 * @brief 原始样本，用 CompressedSeries::Cursor 顺序读取。
+	 */
+	const CompressedSeries& Samples() const { return m_samples; }
+
+	/**
+	 * @brief 可用的最高摘要级别。
+	 */
+	int MaxLevel() const { return kFirstStoredLevel - 1 + static_cast<int>(m_levels.size()); }
+
+	/**
+	 * @brief 占用的内存（字节）。
+	 */
+	size_t MemoryBytes() const;
+
+	/**
+	 * @brief 丢弃最旧的样本，按整块（4096 个样本）丢弃，最后一个未写满的块总是保留。
+	 * @param samples 希望丢弃的样本数，向上取整为整块。
+	 * @param spill 不为空时先把丢弃的样本按 "时间,名称,数值" 逐行写入。
+	 * @param name 写入 spill 的通道名称。
+	 * @return 实际丢弃的样本数。
+	 */
+	size_t DropOldest(size_t samples, std::FILE* spill = nullptr, const std::string& name = std::string());
+
+	/**
+	 * @brief 清空所有数据。
+	 */
+	void Clear();
+
+private:
+	/**
+	 * @brief 一项摘要。
+	 */
+	struct Summary
+	{
+		double tBegin;
+		double tEnd;
+		double min;
+		double max;
+		double sum;
+	};
+
+	/**
+	 * @brief 读取第 level 级的第 index 项，低于 kFirstStoredLevel 的级别用 cursor 解码原始样本计算。
+	 */
+	Summary Entry(int level, size_t index, CompressedSeries::Cursor& cursor) const;
+
+	/**
+	 * @brief 第 level 级已完成的项数。
+	 */
+	size_t LevelSize(int level) const;
+
+	CompressedSeries m_samples;                 /**< 压缩的原始样本。 */
+	std::vector<BlockArray<Summary, 1024>> m_levels; /**< m_levels[r] 为第 kFirstStoredLevel + r 级摘要。 */
+	std::vector<Summary> m_pending;             /**< 每一级等待配对的项。 */
+	std::vector<char> m_hasPending;             /**< 每一级是否有等待配对的项。 */
+	Summary m_group{};                          /**< 正在累积的最低保存级别的项。 */
+	size_t m_groupCount = 0;                    /**< m_group 中的样本数。 */
+};
+
+/**
+ * @brief TimeSeriesStore 按通道名称保存多个 LodSeries。
+ *
+ * 通道名称由解码记录生成：key=value 记录使用键名，PID 帧为 "START1.P" 这样的帧头加参数名，
+ * 其他记录为 "名称.字段序号"。NaN 值不写入。
+ */
+class TimeSeriesStore
+{
+public:
+	/**
+	 * @brief 按名称获取通道编号，不存在时创建。
+	 */
+	int Channel(const std::string& name);
+
+	/**
+	 * @brief 按名称查找通道编号。
+	 * @return 不存在时返回 -1。
+	 */
+	int FindChannel(const std::string& name) const;
+
+	/**
+	 * @brief 写入一条解码记录中的所有数值。
+	 * @param t 时间（秒）。
+	 * @param record 解码记录。
+	 */
+	void Append(double t, const DecodedRecord& record);
+
+	/**
+	 * @brief 生成记录中第 i 个值的通道名称，滤波等按通道处理的模块使用同一套命名。
+	 * @param record 解码记录。
+	 * @param i 值的序号。
+	 * @param out 通道名称。
+	 */
+	static void ChannelKey(const DecodedRecord& record, size_t i, std::string& out);
+
+	/**
+	 * @brief 通道数量。
+	 */
+	int ChannelCount() const { return static_cast<int>(m_series.size()); }
+
+	const std::string& ChannelName(int channel) const { return m_names[static_cast<size_t>(channel)]; }
+	const LodSeries& Series(int channel) const { return *m_series[static_cast<size_t>(channel)]; }
+	LodSeries& Series(int channel) { return *m_series[static_cast<size_t>(channel)]; }
+
+	/**
+	 * @brief 所有通道占用的内存（字节）。
+	 */
+	size_t MemoryBytes() const;
+
+	/**
+	 * @brief 按相同比例丢弃每个通道最旧的样本，使总内存约减少 bytes 字节。
+	 * @param bytes 希望释放的字节数。
+	 * @param spill 不为空时先把丢弃的样本写入，格式见 LodSeries::DropOldest。
+	 * @return 实际释放的字节数。
+	 */
+	size_t ReleaseOldest(size_t bytes, std::FILE* spill = nullptr);
+
+	/**
+	 * @brief 标记一段没有数据的时间的开始，曲线在空白处断开并用底色标出。上一段空白尚未结束时忽略。
+	 */
+	void BeginGap(double t);
+
+	/**
+	 * @brief 结束正在进行的空白，没有时忽略。
+	 */
+	void EndGap(double t);
+
+	/**
+	 * @brief 所有空白，按开始时间排序。
+	 */
+	const std::vector<TimeGap>& Gaps() const { return m_gaps; }
+
+	/**
+	 * @brief 删除所有通道和空白。
+	 */
+	void Clear();
+
+private:
+	std::vector<std::unique_ptr<LodSeries>> m_series;  /**< 各通道数据。 */
+	std::vector<std::string> m_names;                  /**< 各通道名称。 */
+	std::unordered_map<std::string, int> m_channelIds; /**< 名称到编号的映射。 */
+	std::string m_keyBuffer;                           /**< 生成通道名称的缓冲，重复使用。 */
+	std::vector<TimeGap> m_gaps;                       /**< 没有数据的时间段。 */
+};
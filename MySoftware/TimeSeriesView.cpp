@@ -0,0 +1,275 @@
+/*
+ * @Description: 基于多分辨率存储的曲线窗口，任意缩放级别只读取与像素数相当的摘要
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 16:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "TimeSeriesView.h"
+#include "TraceRecorder.h"
+#include <QtGui/QMouseEvent>
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+#include <QtGui/QWheelEvent>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QVBoxLayout>
+#include <algorithm>
+
+TimeSeriesView::TimeSeriesView(const TimeSeriesStore& store, QWidget* parent)
+	: QWidget(parent), m_store(&store)
+{
+	setMinimumSize(400, 200);
+	setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void TimeSeriesView::SetChannel(int channel)
+{
+	m_channel = channel;
+	m_follow = Follow::All;
+	Refresh();
+}
+
+void TimeSeriesView::SetSource(const TimeSeriesStore& store, int channel)
+{
+	m_store = &store;
+	SetChannel(channel);
+}
+
+void TimeSeriesView::Refresh()
+{
+	UpdateRange();
+	update();
+}
+
+void TimeSeriesView::UpdateRange()
+{
+	if (!HasChannel() || m_follow == Follow::None)
+	{
+		return;
+	}
+	const LodSeries& series = m_store->Series(m_channel);
+	if (m_follow == Follow::All)
+	{
+		m_t0 = series.FirstTime();
+		m_t1 = std::max(series.LastTime(), m_t0 + 1e-3);
+	}
+	else
+	{
+		const double span = m_t1 - m_t0;
+		m_t1 = series.LastTime();
+		m_t0 = m_t1 - span;
+	}
+}
+
+/**
+ * @brief 绘制曲线：先用底色标出空白（例如串口断开期间），再画每列像素一条 min/max 竖线，最后叠加均值折线，
+ * 折线在空白处断开，不把断开前后的数据连起来。
+ */
+void TimeSeriesView::paintEvent(QPaintEvent*)
+{
+	TRACE_ZONE("TimeSeriesView::paintEvent");
+	QPainter painter(this);
+	painter.fillRect(rect(), Qt::white);
+	if (!HasChannel())
+	{
+		return;
+	}
+
+	const LodSeries& series = m_store->Series(m_channel);
+	series.Query(m_t0, m_t1, static_cast<size_t>(std::max(1, width())), m_buckets, &m_lastLevel);
+	if (m_buckets.empty())
+	{
+		return;
+	}
+
+	double vmin = m_buckets.front().min;
+	double vmax = m_buckets.front().max;
+	for (const LodBucket& bucket : m_buckets)
+	{
+		vmin = std::min(vmin, bucket.min);
+		vmax = std::max(vmax, bucket.max);
+	}
+	if (vmax - vmin < 1e-12)
+	{
+		vmin -= 0.5;
+		vmax += 0.5;
+	}
+
+	const double margin = 8.0;
+	const double plotHeight = height() - 2 * margin;
+	const double xScale = width() / (m_t1 - m_t0);
+	const double yScale = plotHeight / (vmax - vmin);
+	auto x = [&](double t) { return (t - m_t0) * xScale; };
+	auto y = [&](double v) { return margin + (vmax - v) * yScale; };
+
+	const std::vector<TimeGap>& gaps = m_store->Gaps();
+	for (const TimeGap& gap : gaps)
+	{
+		if (gap.end > m_t0 && gap.begin < m_t1)
+		{
+			const double left = x(std::max(gap.begin, m_t0));
+			const double right = x(std::min(gap.end, m_t1));
+			painter.fillRect(QRectF(left, 0, std::max(right - left, 1.0), height()), QColor(250, 225, 225));
+		}
+	}
+
+	painter.setPen(QColor(160, 190, 230));
+	for (const LodBucket& bucket : m_buckets)
+	{
+		const double px = x(bucket.tBegin);
+		painter.drawLine(QPointF(px, y(bucket.max)), QPointF(std::max(px, x(bucket.tEnd)), y(bucket.min)));
+	}
+
+	QPainterPath meanPath;
+	meanPath.moveTo(x(m_buckets.front().tBegin), y(m_buckets.front().mean));
+	size_t gap = static_cast<size_t>(std::lower_bound(gaps.begin(), gaps.end(), m_buckets.front().tBegin,
+		[](const TimeGap& g, double t) { return g.begin < t; }) - gaps.begin());
+	double previousEnd = m_buckets.front().tBegin;
+	for (const LodBucket& bucket : m_buckets)
+	{
+		// 上一个桶之后、这个桶之前开始的空白处断开折线；缩小到一个桶跨过空白时不断开
+		bool broken = false;
+		for (; gap < gaps.size() && gaps[gap].begin < bucket.tBegin; ++gap)
+		{
+			broken = broken || gaps[gap].begin >= previousEnd;
+		}
+		previousEnd = bucket.tEnd;
+		const QPointF point(x((bucket.tBegin + bucket.tEnd) / 2), y(bucket.mean));
+		if (broken)
+		{
+			meanPath.moveTo(point);
+		}
+		else
+		{
+			meanPath.lineTo(point);
+		}
+	}
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.setPen(QPen(QColor(20, 80, 160), 1.2));
+	painter.drawPath(meanPath);
+
+	painter.setPen(Qt::black);
+	painter.drawText(rect().adjusted(6, 4, -6, -4), Qt::AlignTop | Qt::AlignLeft,
+		QString("%1  max %2").arg(QString::fromStdString(m_store->ChannelName(m_channel))).arg(vmax));
+	painter.drawText(rect().adjusted(6, 4, -6, -4), Qt::AlignBottom | Qt::AlignLeft,
+		QString("min %1").arg(vmin));
+	painter.drawText(rect().adjusted(6, 4, -6, -4), Qt::AlignBottom | Qt::AlignRight,
+		QString("%1 s .. %2 s  level %3  %4 samples")
+		.arg(m_t0, 0, 'f', 3).arg(m_t1, 0, 'f', 3).arg(m_lastLevel).arg(series.Size()));
+}
+
+/**
+ * @brief 滚轮以光标所在时间为中心缩放。
+ * 缩放后右端仍在最新数据处时保持跟随，否则固定显示范围。
+ */
+void TimeSeriesView::wheelEvent(QWheelEvent* event)
+{
+	if (!HasChannel())
+	{
+		return;
+	}
+	const double factor = event->angleDelta().y() > 0 ? 0.8 : 1.25;
+	const double ratio = std::clamp(event->position().x() / std::max(1, width()), 0.0, 1.0);
+	const double center = m_t0 + (m_t1 - m_t0) * ratio;
+	const double span = std::max((m_t1 - m_t0) * factor, 1e-6);
+	m_t0 = center - span * ratio;
+	m_t1 = m_t0 + span;
+
+	const LodSeries& series = m_store->Series(m_channel);
+	m_follow = m_t1 >= series.LastTime() ? Follow::Latest : Follow::None;
+	Refresh();
+	event->accept();
+}
+
+void TimeSeriesView::mousePressEvent(QMouseEvent* event)
+{
+	m_dragStart = event->pos();
+	m_dragT0 = m_t0;
+	m_dragT1 = m_t1;
+}
+
+/**
+ * @brief 左键拖动平移显示范围。
+ */
+void TimeSeriesView::mouseMoveEvent(QMouseEvent* event)
+{
+	if (!(event->buttons() & Qt::LeftButton) || !HasChannel())
+	{
+		return;
+	}
+	const double shift = (m_dragStart.x() - event->pos().x()) * (m_dragT1 - m_dragT0) / std::max(1, width());
+	m_t0 = m_dragT0 + shift;
+	m_t1 = m_dragT1 + shift;
+	m_follow = Follow::None;
+	update();
+}
+
+void TimeSeriesView::mouseDoubleClickEvent(QMouseEvent*)
+{
+	m_follow = Follow::All;
+	Refresh();
+}
+
+PlotWindow::PlotWindow(const TimeSeriesStore& store, const TimeSeriesStore& filtered, QWidget* parent)
+	: QWidget(parent, Qt::Window), m_store(store), m_filtered(filtered)
+{
+	setWindowTitle("Plot");
+	resize(900, 420);
+
+	m_channelSelect = new QComboBox(this);
+	m_channelSelect->setMinimumContentsLength(16);
+	m_filteredCheck = new QCheckBox("Filtered", this);
+	m_filteredCheck->setToolTip("Show the output of the filter chain configured with the Filter button");
+	m_memoryLabel = new QLabel(this);
+	m_view = new TimeSeriesView(store, this);
+
+	auto* top = new QHBoxLayout();
+	top->addWidget(new QLabel("Channel: ", this));
+	top->addWidget(m_channelSelect);
+	top->addWidget(m_filteredCheck);
+	top->addStretch();
+	top->addWidget(m_memoryLabel);
+	auto* layout = new QVBoxLayout(this);
+	layout->addLayout(top);
+	layout->addWidget(m_view, 1);
+
+	connect(m_channelSelect, qOverload<int>(&QComboBox::currentIndexChanged), this, &PlotWindow::UpdateSource);
+	connect(m_filteredCheck, &QCheckBox::toggled, this, &PlotWindow::UpdateSource);
+}
+
+/**
+ * @brief 同步新出现的通道并重绘曲线，窗口不可见时不做任何事。
+ * 滤波配置更换后滤波输出会被清空重建，通道编号可能变化，因此每次都按名称重新查找。
+ */
+void PlotWindow::Refresh()
+{
+	if (!isVisible())
+	{
+		return;
+	}
+	for (int channel = m_channelSelect->count(); channel < m_store.ChannelCount(); ++channel)
+	{
+		m_channelSelect->addItem(QString::fromStdString(m_store.ChannelName(channel)));
+	}
+	m_memoryLabel->setText(QString("%1 MB").arg((m_store.MemoryBytes() + m_filtered.MemoryBytes()) / 1048576.0, 0, 'f', 1));
+	UpdateSource();
+	m_view->Refresh();
+}
+
+void PlotWindow::UpdateSource()
+{
+	const int channel = m_channelSelect->currentIndex();
+	const TimeSeriesStore* store = &m_store;
+	int sourceChannel = channel;
+	if (m_filteredCheck->isChecked() && channel >= 0)
+	{
+		store = &m_filtered;
+		sourceChannel = m_filtered.FindChannel(m_store.ChannelName(channel));
+	}
+	if (store != m_source || sourceChannel != m_sourceChannel)
+	{
+		m_source = store;
+		m_sourceChannel = sourceChannel;
+		m_view->SetSource(*store, sourceChannel);
+	}
+}
@@ -0,0 +1,118 @@
+/*
+ * @Description: 基于多分辨率存储的曲线窗口，任意缩放级别只读取与像素数相当的摘要
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 16:20:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtWidgets/QWidget>
+#include <QtWidgets/QCheckBox>
+#include <QtWidgets/QComboBox>
+#include <QtWidgets/QLabel>
+#include <vector>
+#include "TimeSeriesStore.h"
+
+/**
+ * @brief TimeSeriesView 绘制一个通道的曲线。
+ *
+ * 每次绘制按控件宽度查询 LodSeries，每列像素画出 min/max 包络和均值折线，数据来源中标记的空白用底色标出。
+ * 滚轮以光标为中心缩放，左键拖动平移，双击恢复为显示全部数据并跟随最新数据。
+ */
+class TimeSeriesView : public QWidget
+{
+	Q_OBJECT
+
+public:
+	explicit TimeSeriesView(const TimeSeriesStore& store, QWidget* parent = nullptr);
+
+	/**
+	 * @brief 设置显示的通道，-1 表示不显示。
+	 */
+	void SetChannel(int channel);
+
+	/**
+	 * @brief 切换数据来源和通道，例如在原始数据与滤波输出之间切换。
+	 */
+	void SetSource(const TimeSeriesStore& store, int channel);
+
+	/**
+	 * @brief 数据有更新时调用，跟随模式下移动显示范围并重绘。
+	 */
+	void Refresh();
+
+protected:
+	void paintEvent(QPaintEvent* event) override;
+	void wheelEvent(QWheelEvent* event) override;
+	void mousePressEvent(QMouseEvent* event) override;
+	void mouseMoveEvent(QMouseEvent* event) override;
+	void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+private:
+	/**
+	 * @brief 显示模式。
+	 */
+	enum class Follow
+	{
+		All,    /**< 显示全部数据。 */
+		Latest, /**< 保持跨度不变，右端跟随最新数据。 */
+		None    /**< 固定范围。 */
+	};
+
+	/**
+	 * @brief 根据显示模式更新显示范围。
+	 */
+	void UpdateRange();
+
+	/**
+	 * @brief 是否有可显示的通道。数据来源被清空后，旧的通道编号在下一次 SetSource 之前视为无效。
+	 */
+	bool HasChannel() const { return m_channel >= 0 && m_channel < m_store->ChannelCount(); }
+
+	const TimeSeriesStore* m_store;    /**< 数据来源。 */
+	int m_channel = -1;                /**< 显示的通道。 */
+	Follow m_follow = Follow::All;     /**< 显示模式。 */
+	double m_t0 = 0.0;                 /**< 显示范围起点（秒）。 */
+	double m_t1 = 1.0;                 /**< 显示范围终点（秒）。 */
+	int m_lastLevel = 0;               /**< 上一次绘制使用的摘要级别。 */
+	QPoint m_dragStart;                /**< 拖动起点。 */
+	double m_dragT0 = 0.0;             /**< 拖动开始时的显示范围。 */
+	double m_dragT1 = 0.0;
+	std::vector<LodBucket> m_buckets;  /**< 查询结果，重复使用。 */
+};
+
+/**
+ * @brief PlotWindow 是通道选择框加曲线的独立窗口，只在第一次打开时创建。
+ */
+class PlotWindow : public QWidget
+{
+	Q_OBJECT
+
+public:
+	/**
+	 * @param store 原始数据。
+	 * @param filtered 滤波输出，通道名称与原始数据相同。
+	 * @param parent 父窗口。
+	 */
+	PlotWindow(const TimeSeriesStore& store, const TimeSeriesStore& filtered, QWidget* parent = nullptr);
+
+	/**
+	 * @brief 数据有更新时调用：同步新出现的通道并重绘曲线。
+	 */
+	void Refresh();
+
+private:
+	/**
+	 * @brief 按选择的通道名称和是否显示滤波输出，设置曲线的数据来源。
+	 */
+	void UpdateSource();
+
+	const TimeSeriesStore& m_store; /**< 原始数据。 */
+	const TimeSeriesStore& m_filtered; /**< 滤波输出。 */
+	QComboBox* m_channelSelect;     /**< 通道选择框。 */
+	QCheckBox* m_filteredCheck;     /**< 是否显示滤波输出。 */
+	QLabel* m_memoryLabel;          /**< 内存占用显示。 */
+	TimeSeriesView* m_view;         /**< 曲线。 */
+	const TimeSeriesStore* m_source = nullptr; /**< 曲线当前的数据来源。 */
+	int m_sourceChannel = -1;       /**< 曲线当前的通道。 */
+};
@@ -0,0 +1,204 @@
+/*
+ * @Description: 数据处理链路的轻量级追踪，作用域区间写入各线程自己的缓冲区，导出为 Chrome/Perfetto trace JSON
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 18:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> TraceRecorder::s_enabled{ false };
+
+namespace
+{
+	/**
+	 * @brief 一个完整区间。
+	 */
+	struct TraceEvent
+	{
+		const char* name; /**< 区间名称。 */
+		int64_t startNs;  /**< 开始时间。 */
+		int64_t endNs;    /**< 结束时间。 */
+	};
+
+	/**
+	 * @brief 单个线程的事件缓冲区，只由所属线程写入。
+	 */
+	struct ThreadBuffer
+	{
+		std::vector<TraceEvent> events;       /**< 环形缓冲区。 */
+		std::atomic<uint64_t> written{ 0 };   /**< 累计写入的事件数。 */
+		std::atomic<uint64_t> generation{ 0 }; /**< 所属的记录批次，与全局批次不同时视为已清空。 */
+		std::string name;                     /**< 线程名称。 */
+		int tid = 0;                          /**< 导出时使用的线程编号。 */
+	};
+
+	/**
+	 * @brief 所有线程缓冲区的登记表。缓冲区在线程退出后仍保留，导出时可以看到已结束线程的事件。
+	 */
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		std::atomic<uint64_t> generation{ 1 };
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	/**
+	 * @brief 获取当前线程的缓冲区，第一次调用时分配并登记。
+	 */
+	ThreadBuffer& CurrentBuffer()
+	{
+		thread_local ThreadBuffer* buffer = nullptr;
+		if (buffer == nullptr)
+		{
+			Registry& registry = GetRegistry();
+			auto created = std::make_unique<ThreadBuffer>();
+			created->events.resize(TraceRecorder::kEventsPerThread);
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			created->tid = static_cast<int>(registry.buffers.size()) + 1;
+			buffer = created.get();
+			registry.buffers.push_back(std::move(created));
+		}
+		return *buffer;
+	}
+
+	void WriteJsonString(FILE* file, const char* text)
+	{
+		std::fputc('"', file);
+		for (; *text != '\0'; ++text)
+		{
+			const unsigned char c = static_cast<unsigned char>(*text);
+			if (c == '"' || c == '\\')
+			{
+				std::fputc('\\', file);
+				std::fputc(c, file);
+			}
+			else if (c < 0x20)
+			{
+				std::fprintf(file, "\\u%04x", c);
+			}
+			else
+			{
+				std::fputc(c, file);
+			}
+		}
+		std::fputc('"', file);
+	}
+}
+
+void TraceRecorder::Start()
+{
+	// 增加批次号即可让所有线程在下一次写入时从头开始，不需要触碰其他线程的缓冲区
+	GetRegistry().generation.fetch_add(1, std::memory_order_relaxed);
+	s_enabled.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::Stop()
+{
+	s_enabled.store(false, std::memory_order_release);
+}
+
+void TraceRecorder::SetThreadName(const char* name)
+{
+	ThreadBuffer& buffer = CurrentBuffer();
+	std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+	buffer.name = name;
+}
+
+int64_t TraceRecorder::NowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::Record(const char* name, int64_t startNs, int64_t endNs)
+{
+	ThreadBuffer& buffer = CurrentBuffer();
+	const uint64_t generation = GetRegistry().generation.load(std::memory_order_relaxed);
+	uint64_t written = buffer.written.load(std::memory_order_relaxed);
+	if (buffer.generation.load(std::memory_order_relaxed) != generation)
+	{
+		buffer.generation.store(generation, std::memory_order_relaxed);
+		written = 0;
+	}
+	buffer.events[written % kEventsPerThread] = TraceEvent{ name, startNs, endNs };
+	buffer.written.store(written + 1, std::memory_order_release);
+}
+
+/**
+ * @brief 导出为 Chrome trace-event JSON。
+ * 每个区间是一个 "X"（complete）事件，时间单位为微秒，相对于最早的事件；
+ * 每个线程另有一个 "M" 元数据事件给出线程名称。
+ */
+long long TraceRecorder::WriteChromeJson(const std::string& path)
+{
+	FILE* file = std::fopen(path.c_str(), "w");
+	if (file == nullptr)
+	{
+		return -1;
+	}
+
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	const uint64_t generation = registry.generation.load(std::memory_order_relaxed);
+
+	int64_t originNs = 0;
+	for (const auto& buffer : registry.buffers)
+	{
+		const uint64_t written = buffer->written.load(std::memory_order_acquire);
+		if (buffer->generation.load(std::memory_order_relaxed) != generation || written == 0)
+		{
+			continue;
+		}
+		const uint64_t first = written > kEventsPerThread ? written - kEventsPerThread : 0;
+		const int64_t start = buffer->events[first % kEventsPerThread].startNs;
+		originNs = originNs == 0 ? start : std::min(originNs, start);
+	}
+
+	long long count = 0;
+	std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	bool firstLine = true;
+	for (const auto& buffer : registry.buffers)
+	{
+		const uint64_t written = buffer->written.load(std::memory_order_acquire);
+		if (buffer->generation.load(std::memory_order_relaxed) != generation || written == 0)
+		{
+			continue;
+		}
+		if (!buffer->name.empty())
+		{
+			std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+				firstLine ? "" : ",\n", buffer->tid);
+			WriteJsonString(file, buffer->name.c_str());
+			std::fprintf(file, "}}");
+			firstLine = false;
+		}
+		const uint64_t first = written > kEventsPerThread ? written - kEventsPerThread : 0;
+		for (uint64_t i = first; i < written; ++i)
+		{
+			const TraceEvent& event = buffer->events[i % kEventsPerThread];
+			std::fprintf(file, "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+				firstLine ? "" : ",\n", buffer->tid,
+				(event.startNs - originNs) / 1e3, (event.endNs - event.startNs) / 1e3);
+			WriteJsonString(file, event.name);
+			std::fputc('}', file);
+			firstLine = false;
+			++count;
+		}
+	}
+	std::fprintf(file, "\n]}\n");
+	std::fclose(file);
+	return count;
+}
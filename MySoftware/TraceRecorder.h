@@ -0,0 +1,107 @@
+/*
+ * @Description: 数据处理链路的轻量级追踪，作用域区间写入各线程自己的缓冲区，导出为 Chrome/Perfetto trace JSON
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 18:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief TraceRecorder 收集各线程的追踪区间并导出为 Chrome trace-event JSON。
+ *
+ * 每个线程第一次记录时分配自己的环形缓冲区（kEventsPerThread 个事件），之后记录一个区间
+ * 只是写一个数组元素，不加锁、不分配内存，缓冲区满后覆盖最旧的事件。
+ * 区间名称必须是生命周期覆盖整个进程的字符串（通常是字符串字面量），只保存指针。
+ *
+ * 运行时未启用时，TRACE_ZONE 只有一次原子变量读取；
+ * 编译时未定义 MYSOFTWARE_TRACE（CMake 选项 MYSOFTWARE_TRACE=OFF）时，TRACE_ZONE 展开为空。
+ */
+class TraceRecorder
+{
+public:
+	/**
+	 * @brief 每个线程保留的事件数量。
+	 */
+	static constexpr size_t kEventsPerThread = 65536;
+
+	/**
+	 * @brief 清空之前的事件并开始记录。
+	 */
+	static void Start();
+
+	/**
+	 * @brief 停止记录，已记录的事件保留到下一次 Start。
+	 */
+	static void Stop();
+
+	/**
+	 * @brief 是否正在记录。
+	 */
+	static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief 设置当前线程在追踪视图中显示的名称。
+	 */
+	static void SetThreadName(const char* name);
+
+	/**
+	 * @brief 记录一个完整的区间，由 TraceZone 在析构时调用。
+	 */
+	static void Record(const char* name, int64_t startNs, int64_t endNs);
+
+	/**
+	 * @brief 当前单调时钟（纳秒）。
+	 */
+	static int64_t NowNs();
+
+	/**
+	 * @brief 把所有线程的事件写为 Chrome trace-event JSON，可直接在 chrome://tracing 或 ui.perfetto.dev 打开。
+	 * 应在 Stop 之后调用，否则正在写入的线程可能覆盖正在导出的事件。
+	 * @param path 输出文件路径。
+	 * @return 写入的事件数量，打开文件失败时返回 -1。
+	 */
+	static long long WriteChromeJson(const std::string& path);
+
+private:
+	static std::atomic<bool> s_enabled; /**< 是否正在记录。 */
+};
+
+/**
+ * @brief 作用域区间：构造时记下开始时间，析构时记录一个区间，未启用时什么也不做。
+ */
+class TraceZone
+{
+public:
+	explicit TraceZone(const char* name)
+		: m_name(name), m_startNs(TraceRecorder::IsEnabled() ? TraceRecorder::NowNs() : 0)
+	{
+	}
+
+	~TraceZone()
+	{
+		if (m_startNs != 0)
+		{
+			TraceRecorder::Record(m_name, m_startNs, TraceRecorder::NowNs());
+		}
+	}
+
+	TraceZone(const TraceZone&) = delete;
+	TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+	const char* m_name; /**< 区间名称。 */
+	int64_t m_startNs;  /**< 开始时间，0 表示未启用。 */
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef MYSOFTWARE_TRACE
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone_, __LINE__)(name)
+#else
+#define TRACE_ZONE(name) do { } while (false)
+#endif
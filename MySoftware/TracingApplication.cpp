@@ -0,0 +1,52 @@
+/*
+ * @Description: 带事件追踪的 QApplication，记录排队槽调用、绘制和布局等事件的处理耗时
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 18:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "TracingApplication.h"
+#include "TraceRecorder.h"
+#include <QtCore/QEvent>
+
+namespace
+{
+	/**
+	 * @brief 需要追踪的事件类型对应的区间名称，其他事件返回 nullptr。
+	 */
+	const char* ZoneName(QEvent::Type type)
+	{
+		switch (type)
+		{
+		case QEvent::MetaCall: return "event: queued slot";
+		case QEvent::Paint: return "event: Paint";
+		case QEvent::UpdateRequest: return "event: UpdateRequest";
+		case QEvent::LayoutRequest: return "event: LayoutRequest";
+		case QEvent::Resize: return "event: Resize";
+		case QEvent::Timer: return "event: Timer";
+		case QEvent::SockAct: return "event: SockAct";
+		default: return nullptr;
+		}
+	}
+}
+
+TracingApplication::TracingApplication(int& argc, char** argv)
+	: QApplication(argc, argv)
+{
+	TraceRecorder::SetThreadName("GUI");
+}
+
+bool TracingApplication::notify(QObject* receiver, QEvent* event)
+{
+#ifdef MYSOFTWARE_TRACE
+	if (TraceRecorder::IsEnabled())
+	{
+		if (const char* name = ZoneName(event->type()))
+		{
+			TraceZone zone(name);
+			return QApplication::notify(receiver, event);
+		}
+	}
+#endif
+	return QApplication::notify(receiver, event);
+}
@@ -0,0 +1,26 @@
+/*
+ * @Description: 带事件追踪的 QApplication，记录排队槽调用、绘制和布局等事件的处理耗时
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 18:40:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <QtWidgets/QApplication>
+
+/**
+ * @brief TracingApplication 在 notify 中为关心的事件类型加上追踪区间。
+ *
+ * 排队连接的槽（QEvent::MetaCall）、绘制、布局和定时器事件分别显示为独立的区间，
+ * 与 handleReadyRead、解码和刷新区域的区间放在同一条时间线上，
+ * 可以看出界面卡顿来自 I/O、解析、排队的信号还是控件布局。未启用追踪时只多一次原子变量读取。
+ */
+class TracingApplication : public QApplication
+{
+	Q_OBJECT
+
+public:
+	TracingApplication(int& argc, char** argv);
+
+	bool notify(QObject* receiver, QEvent* event) override;
+};
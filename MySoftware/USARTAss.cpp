@@ -12,6 +12,20 @@
 #include <QMessageBox>
 #include <QRegularExpression> // Added for QRegularExpression
 #include <QThread>
+#include <QtWidgets/QHeaderView>
+#include <QtCore/QFileInfo>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QInputDialog>
+#include <QtWidgets/QLineEdit>
+#include <QtCore/QSignalBlocker>
+#include <QtCore/QDir>
+#include <QtCore/QStandardPaths>
+#include <QtGui/QTextCursor>
+#include <cmath>
+#include "EventBridge.h"
+#include "SerialFanout.h"
+#include "StartupTrace.h"
+#include "TraceRecorder.h"
 
  /**
   * @brief USARTAss类的构造函数。
@@ -19,14 +33,56 @@
   */
 USARTAss::USARTAss(QWidget* parent)
 	: QMainWindow(parent), serialOpened(false), serialSendMessage(), totalBytes(0), EndFrame("END"), RecvCheck(false),
-	ChartFrame{ "START1", "START2", "START3" }, FrameIndex(-1),
-	m_serialInfo(new SerialInfo(this)) // 初始化 m_serialInfo
+	m_plotWindow("PlotWindow created", [this]() { return std::make_unique<PlotWindow>(m_store, m_filteredStore, this); }),
+	m_serialInfo("SerialInfo created", [this]() { return CreateSerialInfo(); }),
+	m_fileTransfer("FileTransfer created", [this]() { return CreateFileTransfer(); }),
+	m_filterWorker("FilterWorker created", [this]() {
+		auto worker = std::make_unique<FilterWorker>();
+		// 工作线程处理完一批后通知界面线程在下一个刷新周期取出
+		worker->SetReadyHandler([this]() {
+			QMetaObject::invokeMethod(this, [this]() { m_display.MarkDirty(m_filterRegion); }, Qt::QueuedConnection);
+			});
+		return worker;
+		}),
+	m_stepWorker("StepWorker created", [this]() {
+		auto worker = std::make_unique<StepWorker>();
+		worker->SetReadyHandler([this]() {
+			QMetaObject::invokeMethod(this, [this]() { m_display.MarkDirty(m_stepRegion); }, Qt::QueuedConnection);
+			});
+		return worker;
+		})
 {
 	ui.setupUi(this);
+	StartupTrace::Mark("setupUi");
 
+	for (const std::string& header : DefaultPidHeaders())
+	{
+		ChartFrame.push_back(QString::fromStdString(header));
+	}
+
+	SetupDisplay();
+	SetupDecoderSelector();
+	SetupEncodingSelector();
+	SetupFanoutAction();
+	SetupFileTransferAction();
+	SetupTraceAction();
+	SetupDerivedAction();
+	SetupStepAction();
+	SetupModbusAction();
+	SetupAlarmAction();
+	SetupWatchAction();
+	SetupMemoryBudget();
+	SelectDecoder("pid");
+	SelectEncoding("UTF-8");
 	TotalConnect();
 
-	qDebug() << "ChartFrame" << ChartFrame;
+	// 串口枚举在首次绘制之后进行，避免阻塞窗口显示
+	StartupTrace::AfterFirstPaint(this, [this]() {
+		RefreshUSART_clicked();
+		StartupTrace::Mark("port scan");
+		});
+
+	qDebug() << "ChartFrame" << ChartFrame.front() << "..." << ChartFrame.back();
 }
 
 /**
@@ -34,11 +90,40 @@ USARTAss::USARTAss(QWidget* parent)
  */
 USARTAss::~USARTAss()
 {
-	// m_serialInfo 会在父对象析构时自动删除，因为它是 QObject 的子对象
-	// 但需要确保其内部线程已停止
-	if (m_serialInfo) {
-		// SerialInfo 的析构函数会处理其内部线程的停止和清理
-	}
+	// m_serialInfo 由 LazySubsystem 持有，随成员一起析构
+	// SerialInfo 的析构函数会处理其内部线程的停止和清理
+}
+
+/**
+ * @brief 创建 SerialInfo 对象并连接其信号。
+ *
+ * SerialInfo 会启动读取线程并持有串口对象，启动时并不需要，
+ * 因此推迟到第一次打开串口或发送数据时才创建。
+ * @return 新创建的 SerialInfo 对象。
+ */
+std::unique_ptr<SerialInfo> USARTAss::CreateSerialInfo()
+{
+	// 没有父对象，SerialInfo 移动到自己的串口线程中，只由 m_serialInfo 持有
+	auto serialInfo = std::make_unique<SerialInfo>();
+
+	// 连接 SerialInfo 的 DataReceived 信号到 USARTAss 的 RecvMessage_clicked 槽
+	connect(serialInfo.get(), &SerialInfo::DataReceived, this, &USARTAss::RecvMessage_clicked);
+	serialInfo->TrackMemory("serial rx");
+	// 连接 SerialInfo 的 SerialStateChanged 信号，用于更新 UI 状态
+	connect(serialInfo.get(), &SerialInfo::SerialStateChanged, this, &USARTAss::ChangeSerialButtonText);
+	// 断开在最后一块数据之后送达，此时丢弃半帧不会影响断开前已收到的帧
+	connect(serialInfo.get(), &SerialInfo::ConnectionLost, this, &USARTAss::HandleLinkLost);
+	connect(serialInfo.get(), &SerialInfo::Reconnected, this, &USARTAss::HandleLinkRestored);
+	connect(serialInfo.get(), &SerialInfo::SheddingStarted, this, [this]() {
+		BeginStreamGap();
+		AppendConsole("[memory] over budget, dropping received data");
+		});
+	connect(serialInfo.get(), &SerialInfo::SheddingStopped, this, [this](quint64 droppedBytes) {
+		EndStreamGap();
+		AppendConsole(QString("[memory] receiving again, %1 bytes dropped").arg(droppedBytes));
+		});
+
+	return serialInfo;
 }
 
 /**
@@ -139,191 +224,926 @@ void USARTAss::SendMessage_clicked()
 /**
  * @brief 处理串口接收到数据时的readyRead信号的槽函数。
  *
- * 该函数从SerialInfo单例读取所有可用数据，更新接收字节数显示。
- * 然后，它根据当前的状态机（WaitingForStart, WaitingForData, WaitingForEnd）
- * 处理接收到的数据帧。
- * - WaitingForStart: 等待帧头
- * - WaitingForData: 等待浮点型数据。
- * - WaitingForEnd: 等待帧尾
- * 成功接收完整数据包后，会将数据添加到相应的图表中。
- * 如果在任何阶段接收到无效数据，状态机将重置。
+ * 该函数更新接收字节数显示，然后根据帧检查开关决定处理方式：
+ * - 开启帧检查时，数据块直接交给当前选择的协议解码器，解出的记录由 HandleRecord 处理；
+ *   START/数据/END 协议的解码过程还会通过跟踪回调回显到接收区。
+ * - 关闭帧检查时，按所选编码把收到的文本追加到接收区。
+ * 跨数据块的半帧由解码器暂存，不再依赖每次 readyRead 恰好是一行；
+ * 同样，被数据块截断的多字节字符由 TextStreamDecoder 暂存到下一块。
+ * 配置了监视列表时，两种方式下都先对原始字节扫描一遍，跨数据块的匹配由 WatchList 保存的状态接上。
+ * 这里只更新状态，控件由 DisplayScheduler 在下一个刷新周期统一更新。
  */
-void USARTAss::RecvMessage_clicked(const QByteArray& data) // 接收 QByteArray 参数
+void USARTAss::RecvMessage_clicked(const QByteArray& data, qint64 receivedNs) // 接收 QByteArray 参数
 {
+	TRACE_ZONE("USARTAss::RecvMessage_clicked");
+	StartupTrace::MarkFirstByte();
 	totalBytes += data.size(); // 累加接收到的字节数
-	ShowRecvBytesCount();
-
-	// 将接收到的数据转换为字符串
-	QString receivedData = QString::fromUtf8(data).trimmed(); // 使用传入的 data 参数
-	qDebug() << "Raw received data:" << receivedData;
+	m_display.MarkDirty(m_rxCountRegion);
+	if (!m_storeClock.isValid())
+	{
+		m_storeClock.start();
+	}
+	// 扣除数据块在事件队列中等待的时间，积压时各块的帧仍然按读到的时间求值报警的持续时间和 rate()
+	m_chunkNs = qMax<qint64>(m_storeClock.nsecsElapsed() - (TraceRecorder::NowNs() - receivedNs), 0);
+	if (!m_watch.IsEmpty())
+	{
+		m_watch.Scan(0, ByteSpan(data.constData(), static_cast<size_t>(data.size())), m_chunkNs);
+	}
 
 	if (RecvCheck)
 	{
-		// size_t FrameIndex = -1;
-		std::vector<QString>::iterator ret; // 将变量声明移到switch外部
-		switch (currentState)
+		TRACE_ZONE("decode");
+		auto sink = MakeRecordSink([this](const DecodedRecord& record) { HandleRecord(record); });
+		m_decoder->Feed(ByteSpan(data.constData(), static_cast<size_t>(data.size())), sink);
+	}
+	else
+	{
+		// 将接收到的数据转换为字符串，纯 ASCII 数据块不做编码校验
+		QString receivedData = m_textDecoder->Decode(data).trimmed();
+		AppendConsole("Received Frame: " + receivedData);
+	}
+	m_serialInfo->ChunkConsumed(data.size());
+}
+
+/**
+ * @brief 在工具栏上添加协议选择下拉框，列出 DecoderRegistry 中登记的所有解码器。
+ */
+void USARTAss::SetupDecoderSelector()
+{
+	m_decoderSelect = new QComboBox(this);
+	for (const std::string& name : DecoderRegistry::Instance().Names())
+	{
+		m_decoderSelect->addItem(QString::fromStdString(name));
+		m_decoderSelect->setItemData(m_decoderSelect->count() - 1,
+			QString::fromStdString(DecoderRegistry::Instance().Description(name)), Qt::ToolTipRole);
+	}
+	ui.mainToolBar->addWidget(new QLabel("Protocol: ", this));
+	ui.mainToolBar->addWidget(m_decoderSelect);
+}
+
+/**
+ * @brief 在工具栏上添加接收区文本编码选择下拉框。
+ */
+void USARTAss::SetupEncodingSelector()
+{
+	m_encodingSelect = new QComboBox(this);
+	m_encodingSelect->addItems(TextStreamDecoder::Encodings());
+	m_encodingSelect->setToolTip("Text encoding of the receive area when frame checking is off");
+	ui.mainToolBar->addWidget(new QLabel("Encoding: ", this));
+	ui.mainToolBar->addWidget(m_encodingSelect);
+}
+
+/**
+ * @brief 在工具栏上添加分发桥开关。
+ */
+void USARTAss::SetupFanoutAction()
+{
+	m_fanoutAction = ui.mainToolBar->addAction("Bridge");
+	m_fanoutAction->setCheckable(true);
+	m_fanoutAction->setToolTip("Share the serial stream with local TCP / socket clients");
+}
+
+/**
+ * @brief 打开或关闭本地分发桥。
+ *
+ * 打开时询问 127.0.0.1 上的 TCP 端口，同时监听名为 MySoftware-bridge 的本地套接字，
+ * 报警事件在下一个 TCP 端口上按行广播，状态栏显示当前连接的客户端数量。
+ * @param enabled 是否启用。
+ */
+void USARTAss::ToggleFanout_clicked(bool enabled)
+{
+	if (!enabled)
+	{
+		m_serialInfo->DisableFanout();
+		m_eventBridge->Close();
+		ui.statusBar->clearMessage();
+		return;
+	}
+
+	bool accepted = false;
+	const int port = QInputDialog::getInt(this, "Bridge", "TCP port on 127.0.0.1:", m_fanoutPort, 1, 65535, 1, &accepted);
+	if (!accepted)
+	{
+		m_fanoutAction->setChecked(false);
+		return;
+	}
+	m_fanoutPort = static_cast<quint16>(port);
+
+	try
+	{
+		m_serialInfo->EnableFanout(m_fanoutPort, "MySoftware-bridge");
+	}
+	catch (const std::runtime_error& e)
+	{
+		m_serialInfo->DisableFanout();
+		m_fanoutAction->setChecked(false);
+		QMessageBox::warning(this, "Bridge", e.what());
+		return;
+	}
+
+	// 报警事件在下一个端口上广播，端口被占用时分发桥照常工作
+	QString prefix = QString("Bridge 127.0.0.1:%1").arg(m_fanoutPort);
+	try
+	{
+		m_eventBridge->ListenTcp(static_cast<quint16>(m_fanoutPort + 1));
+		prefix += QString(", events :%1").arg(m_fanoutPort + 1);
+	}
+	catch (const std::runtime_error& e)
+	{
+		qDebug() << "Event bridge disabled:" << e.what();
+	}
+	ui.statusBar->showMessage(prefix + ", 0 clients");
+	connect(m_serialInfo->GetFanout(), &SerialFanout::ClientCountChanged, this, [this, prefix](int count) {
+		ui.statusBar->showMessage(QString("%1, %2 clients").arg(prefix).arg(count));
+		});
+}
+
+/**
+ * @brief 在工具栏上添加文件发送按钮，并登记进度刷新区域。
+ */
+void USARTAss::SetupFileTransferAction()
+{
+	m_sendFileAction = ui.mainToolBar->addAction("Send File");
+	m_sendFileAction->setToolTip("Send a file or firmware image with YMODEM, XMODEM-1K or as a raw stream");
+	m_transferRegion = m_display.AddRegion("transfer", [this]() { ShowTransferProgress(); });
+}
+
+std::unique_ptr<FileTransfer> USARTAss::CreateFileTransfer()
+{
+	auto transfer = std::make_unique<FileTransfer>(m_serialInfo.Get());
+	// 原始模式每写出一块就有一次进度，只标记区域，由刷新周期统一更新状态栏
+	connect(transfer.get(), &FileTransfer::Progress, this, [this]() { m_display.MarkDirty(m_transferRegion); });
+	connect(transfer.get(), &FileTransfer::Finished, this, [this](bool ok, const QString& message) {
+		m_sendFileAction->setText("Send File");
+		ui.statusBar->showMessage(message);
+		if (ok)
 		{
-		case WaitingForStart:
+			QMessageBox::information(this, "Send File", message);
+		}
+		else
 		{
-			ret = std::find(ChartFrame.begin(), ChartFrame.end(), receivedData);
-			if (ret != ChartFrame.end())
-			{
-				FrameIndex = std::distance(ChartFrame.begin(), ret);
-				qDebug() << "Found FrameIndex:" << FrameIndex;
-				currentStartFrame = receivedData; // 保存帧头
-				currentState = WaitingForData1;	  // 切换到等待第一个数据帧状态
-				ui.RecvSpace->append("Received Start Frame: " + currentStartFrame);
-				qDebug() << "Received Start Frame:" << currentStartFrame;
-			}
-			else
-			{
-				this->currentState = WaitingForStart;
-				this->currentStartFrame.clear();
-				this->currentDataFrame1 = 0.0f;
-				this->currentDataFrame2 = 0.0f;
-				this->currentDataFrame3 = 0.0f;
-
-				ui.RecvSpace->append("Invalid Start Frame: " + receivedData);
-				qDebug() << "Invalid Start Frame:" << receivedData;
-			}
-
-			break;
+			QMessageBox::warning(this, "Send File", message);
 		}
-		case WaitingForData1:
+		});
+	return transfer;
+}
+
+/**
+ * @brief 选择文件和模式并开始发送。
+ * XMODEM-1K/YMODEM 需要接收端（例如 bootloader）先发出 'C'，原始模式立即开始。
+ */
+void USARTAss::SendFile_clicked()
+{
+	if (m_fileTransfer.IsCreated() && m_fileTransfer->IsRunning())
+	{
+		if (QMessageBox::question(this, "Send File", "Cancel the running transfer?") == QMessageBox::Yes)
 		{
-			bool isFloat;
-			float value = receivedData.toFloat(&isFloat);
-			if (isFloat)
-			{
-				currentDataFrame1 = value;	  // 保存第一个数据帧
-				currentState = WaitingForData2; // 切换到等待第二个数据帧状态
-				ui.RecvSpace->append("Received Data Frame 1: " + QString::number(currentDataFrame1));
-				qDebug() << "Received Data Frame 1:" << currentDataFrame1;
-			}
-			else
-			{
-				this->currentState = WaitingForStart;
-				this->currentStartFrame.clear();
-				this->currentDataFrame1 = 0.0f;
-				this->currentDataFrame2 = 0.0f;
-				this->currentDataFrame3 = 0.0f;
-
-				ui.RecvSpace->append("Invalid Data Frame 1: " + receivedData);
-				qDebug() << "Invalid Data Frame 1:" << receivedData;
-			}
-			break;
+			m_fileTransfer->Cancel();
 		}
-		case WaitingForData2:
+		return;
+	}
+
+	const QString path = QFileDialog::getOpenFileName(this, "Send File", m_transferDir);
+	if (path.isEmpty())
+	{
+		return;
+	}
+	m_transferDir = QFileInfo(path).absolutePath();
+
+	bool accepted = false;
+	const QString mode = QInputDialog::getItem(this, "Send File", "Mode:", FileTransfer::ModeNames(), 0, false, &accepted);
+	if (!accepted)
+	{
+		return;
+	}
+
+	try
+	{
+		m_fileTransfer->Start(path, FileTransfer::ParseMode(mode));
+	}
+	catch (const std::exception& e)
+	{
+		QMessageBox::warning(this, "Send File", e.what());
+		return;
+	}
+	if (m_fileTransfer->IsRunning())
+	{
+		m_sendFileAction->setText("Cancel Send");
+		ui.statusBar->showMessage(QString("%1: waiting for receiver").arg(m_fileTransfer->FileName()));
+	}
+}
+
+void USARTAss::ShowTransferProgress()
+{
+	if (!m_fileTransfer.IsCreated() || !m_fileTransfer->IsRunning())
+	{
+		return;
+	}
+	const qint64 total = qMax<qint64>(m_fileTransfer->TotalBytes(), 1);
+	ui.statusBar->showMessage(QString("%1%  %2")
+		.arg(100 * m_fileTransfer->SentBytes() / total)
+		.arg(m_fileTransfer->Summary()));
+}
+
+/**
+ * @brief 在工具栏上添加链路追踪开关，编译时关闭追踪则禁用该开关。
+ */
+void USARTAss::SetupTraceAction()
+{
+	m_traceAction = ui.mainToolBar->addAction("Trace");
+	m_traceAction->setCheckable(true);
+#ifdef MYSOFTWARE_TRACE
+	m_traceAction->setToolTip("Record I/O, decoding, queued signals and repaints; export as Chrome trace JSON when stopped");
+#else
+	m_traceAction->setEnabled(false);
+	m_traceAction->setToolTip("Built without MYSOFTWARE_TRACE");
+#endif
+}
+
+/**
+ * @brief 开始或停止链路追踪。
+ * 停止后询问保存路径，导出的文件可以在 chrome://tracing 或 ui.perfetto.dev 中打开。
+ */
+void USARTAss::ToggleTrace_clicked(bool enabled)
+{
+	if (enabled)
+	{
+		TraceRecorder::Start();
+		ui.statusBar->showMessage("Tracing...");
+		return;
+	}
+
+	TraceRecorder::Stop();
+	const QString path = QFileDialog::getSaveFileName(this, "Save Trace", "trace.json", "Chrome trace (*.json)");
+	if (path.isEmpty())
+	{
+		ui.statusBar->clearMessage();
+		return;
+	}
+	const long long count = TraceRecorder::WriteChromeJson(path.toStdString());
+	if (count < 0)
+	{
+		QMessageBox::warning(this, "Trace", QString("Failed to write %1").arg(path));
+		return;
+	}
+	ui.statusBar->showMessage(QString("%1 trace events written to %2").arg(count).arg(path));
+}
+
+/**
+ * @brief 按名称创建协议解码器并替换当前解码器，之前残留的半帧随之丢弃。
+ *
+ * START/数据/END 协议使用 ChartFrame 和 EndFrame 作为帧头与帧尾，
+ * 并把解码过程回显到接收区。
+ * @param name 解码器名称。
+ */
+void USARTAss::SelectDecoder(const QString& name)
+{
+	DecoderOptions options;
+	options.headers.clear();
+	for (const QString& header : ChartFrame)
+	{
+		options.headers.push_back(header.toStdString());
+	}
+	options.endFrame = EndFrame.toStdString();
+
+	std::unique_ptr<ProtocolDecoder> decoder;
+	try
+	{
+		decoder = DecoderRegistry::Instance().Create(name.toStdString(), options);
+	}
+	catch (const std::invalid_argument& e)
+	{
+		QMessageBox::warning(this, "Protocol", e.what());
+		return;
+	}
+	StopModbus();
+	m_decoder = std::move(decoder);
+
+	if (auto* frameDecoder = dynamic_cast<FrameDecoder*>(m_decoder.get()))
+	{
+		frameDecoder->SetTraceHandler([this](const FrameDecoder::TraceEvent& event) {
+			AppendConsole(QString::fromStdString(FrameDecoder::FormatTrace(event)));
+			});
+	}
+	qDebug() << "Protocol decoder selected:" << name;
+}
+
+void USARTAss::SelectEncoding(const QString& name)
+{
+	try
+	{
+		m_textDecoder = std::make_unique<TextStreamDecoder>(name);
+	}
+	catch (const std::invalid_argument& e)
+	{
+		QMessageBox::warning(this, "Encoding", e.what());
+		// 恢复为当前仍在使用的编码
+		if (m_textDecoder)
 		{
-			bool isFloat;
-			float value = receivedData.toFloat(&isFloat);
-			if (isFloat)
-			{
-				currentDataFrame2 = value;	  // 保存第二个数据帧
-				currentState = WaitingForData3; // 切换到等待第三个数据帧状态
-				ui.RecvSpace->append("Received Data Frame 2: " + QString::number(currentDataFrame2));
-				qDebug() << "Received Data Frame 2:" << currentDataFrame2;
-			}
-			else
-			{
-				this->currentState = WaitingForStart;
-				this->currentStartFrame.clear();
-				this->currentDataFrame1 = 0.0f;
-				this->currentDataFrame2 = 0.0f;
-				this->currentDataFrame3 = 0.0f;
-
-				ui.RecvSpace->append("Invalid Data Frame 2: " + receivedData);
-				qDebug() << "Invalid Data Frame 2:" << receivedData;
-			}
-			break;
+			const QSignalBlocker blocker(m_encodingSelect);
+			m_encodingSelect->setCurrentText(m_textDecoder->Encoding());
 		}
-		case WaitingForData3:
+		return;
+	}
+	qDebug() << "Text encoding selected:" << name;
+}
+
+/**
+ * @brief 处理解码器输出的一条记录。
+ * 每条记录先写入飞行记录仪，数值写入多分辨率存储并求值报警规则，再计算受影响的派生通道；
+ * PID 帧再更新表格模型中对应行的数据，其他协议的记录格式化后暂存到接收区缓冲。
+ * @param record 解码记录，仅在本次调用期间有效。
+ */
+void USARTAss::HandleRecord(const DecodedRecord& record)
+{
+	FlightRecorder::Instance().RecordFrame(m_serialInfo->FlightChannel(), record);
+	if (record.values != nullptr)
+	{
+		AppendValues(record);
+		if (!m_derived.IsEmpty())
 		{
-			bool isFloat;
-			float value = receivedData.toFloat(&isFloat);
-			if (isFloat)
-			{
-				currentDataFrame3 = value;	  // 保存第三个数据帧
-				currentState = WaitingForEnd; // 切换到等待帧尾状态
-				ui.RecvSpace->append("Received Data Frame 3: " + QString::number(currentDataFrame3));
-				qDebug() << "Received Data Frame 3:" << currentDataFrame3;
-			}
-			else
-			{
-				this->currentState = WaitingForStart;
-				this->currentStartFrame.clear();
-				this->currentDataFrame1 = 0.0f;
-				this->currentDataFrame2 = 0.0f;
-				this->currentDataFrame3 = 0.0f;
-
-				ui.RecvSpace->append("Invalid Data Frame 3: " + receivedData);
-				qDebug() << "Invalid Data Frame 3:" << receivedData;
-			}
-			break;
+			auto sink = MakeRecordSink([this](const DecodedRecord& derived) { AppendValues(derived); });
+			m_derived.OnRecord(record, sink);
 		}
+	}
 
-		case WaitingForEnd:
+	if (record.kind == RecordKind::PidFrame)
+	{
+		if (!m_pidModel->Update(record.index, record.values, record.count))
 		{
-			if (receivedData == EndFrame)
-			{
-				currentState = WaitingForStart; // 切换回等待帧头状态
-				ui.RecvSpace->append("Received End Frame: " + receivedData);
-				qDebug() << "Received End Frame:" << receivedData;
-
-				// 处理完整数据包
-				QString ShowMessage = "Complete Packet - Start: " + currentStartFrame +
-					", Data1: " + QString::number(currentDataFrame1) +
-					", Data2: " + QString::number(currentDataFrame2) +
-					", Data3: " + QString::number(currentDataFrame3) +
-					", End: " + receivedData;
-				ui.RecvSpace->append(ShowMessage);
-
-				qDebug() << "FrameIndex:" << FrameIndex;
-				qDebug() << "currentStartFrame:" << currentStartFrame;
-
-				if (FrameIndex != -1)
-				{
-					PID_parameters PIDdata;
-					PIDdata.Kp = currentDataFrame1;
-					PIDdata.Ki = currentDataFrame2;
-					PIDdata.Kd = currentDataFrame3;
-					emit PIDReadyToShow(FrameIndex, PIDdata); // 发送数据到图表
-					FrameIndex = -1;
-				}
-				else
-				{
-				}
-			}
-			else
-			{
-				this->currentState = WaitingForStart;
-				this->currentStartFrame.clear();
-				this->currentDataFrame1 = 0.0f;
-				this->currentDataFrame2 = 0.0f;
-				this->currentDataFrame3 = 0.0f;
-
-				ui.RecvSpace->append("Invalid End Frame: " + receivedData);
-				qDebug() << "Invalid End Frame:" << receivedData;
-			}
-			break;
+			qDebug() << "Invalid index for PID data:" << record.index;
+			return;
+		}
+		m_display.MarkDirty(m_pidRegion);
+		return;
+	}
 
-		default:
-			ui.RecvSpace->append("Unknown State");
-			qDebug() << "Unknown State";
-			break;
+	AppendConsole(QString("[%1] %2")
+		.arg(m_decoder->Name())
+		.arg(QString::fromStdString(FormatRecord(record, ", "))));
+}
+
+void USARTAss::AppendValues(const DecodedRecord& record)
+{
+	const qint64 ns = m_chunkNs;
+	const double t = ns / 1e9;
+	m_store.Append(t, record);
+	m_alarms.OnRecord(ns, record);
+	if (m_filterWorker.IsCreated())
+	{
+		m_filterWorker->PushRecord(t, record);
+	}
+	if (m_stepWorker.IsCreated())
+	{
+		m_stepWorker->PushRecord(t, record);
+	}
+	if (m_plotWindow.IsCreated())
+	{
+		m_display.MarkDirty(m_plotRegion);
+	}
+}
+
+/**
+ * @brief 登记界面刷新区域。
+ * 接收区限制最多保留 kMaxConsoleBlocks 行，长时间运行时追加的开销不会随历史增长。
+ */
+void USARTAss::SetupDisplay()
+{
+	constexpr int kMaxConsoleBlocks = 5000;
+	ui.RecvSpace->document()->setMaximumBlockCount(kMaxConsoleBlocks);
+
+	// 固定行高，避免每次 dataChanged 都按内容重新计算行高
+	m_pidModel = new PidTableModel(this);
+	m_pidModel->SetHeaders(ChartFrame);
+	ui.PIDTable->setModel(m_pidModel);
+	ui.PIDTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+	ui.PIDTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+	m_rxCountRegion = m_display.AddRegion("rx count", [this]() { ShowRecvBytesCount(); });
+	m_pidRegion = m_display.AddRegion("pid", [this]() { m_pidModel->Flush(); });
+	m_consoleRegion = m_display.AddRegion("console", [this]() { FlushConsole(); });
+	m_plotRegion = m_display.AddRegion("plot", [this]() { m_plotWindow->Refresh(); });
+
+	m_plotAction = ui.mainToolBar->addAction("Plot");
+	m_plotAction->setToolTip("Zoomable history of every decoded value");
+
+	m_filterRegion = m_display.AddRegion("filter", [this]() { FlushFiltered(); });
+	m_filterAction = ui.mainToolBar->addAction("Filter");
+	m_filterAction->setToolTip("Per-channel filter chain on a worker thread; the plot can show raw or filtered values");
+}
+
+/**
+ * @brief 输入滤波配置，格式见 FilterConfig，例如 START1.*=median:5,lowpass:20:1000。
+ * 更换配置后之前的滤波输出被清空，各通道的滤波器从头开始。
+ */
+void USARTAss::ConfigureFilter_clicked()
+{
+	const QString current = m_filterWorker.IsCreated()
+		? QString::fromStdString(m_filterWorker->Config().Describe()) : QString();
+	bool ok = false;
+	const QString spec = QInputDialog::getText(this, "Filter",
+		"channel=stage,stage;...  stages: ma:N ema:a lowpass:fc:fs[:q] highpass:fc:fs[:q] median:N kalman:q:r\n"
+		"channel: a plot channel name, a prefix ending with '*', or '*' for all; empty disables filtering",
+		QLineEdit::Normal, current, &ok);
+	if (!ok)
+	{
+		return;
+	}
+
+	FilterConfig config;
+	try
+	{
+		config = FilterConfig::Parse(spec.toStdString());
+	}
+	catch (const std::invalid_argument& e)
+	{
+		QMessageBox::warning(this, "Filter", e.what());
+		return;
+	}
+	if (config.IsEmpty() && !m_filterWorker.IsCreated())
+	{
+		return;
+	}
+
+	// 先处理完旧配置下已提交的样本，清空后的滤波输出中只有新配置的结果
+	if (m_filterWorker.IsCreated())
+	{
+		m_filterWorker->Flush();
+		FlushFiltered();
+	}
+	m_filterWorker->SetConfig(config);
+	m_filteredStore.Clear();
+	m_filteredChannels.clear();
+	if (m_plotWindow.IsCreated())
+	{
+		m_plotWindow->Refresh();
+	}
+	qDebug() << "Filter configured:" << QString::fromStdString(config.Describe());
+}
+
+/**
+ * @brief 取出滤波线程的输出，按通道名称写入 m_filteredStore。
+ */
+void USARTAss::FlushFiltered()
+{
+	m_filteredSamples.clear();
+	if (!m_filterWorker.IsCreated() || m_filterWorker->Drain(m_filteredSamples) == 0)
+	{
+		return;
+	}
+	for (const FilteredSample& sample : m_filteredSamples)
+	{
+		const size_t channel = static_cast<size_t>(sample.channel);
+		if (channel >= m_filteredChannels.size())
+		{
+			m_filteredChannels.resize(channel + 1, -1);
 		}
+		if (m_filteredChannels[channel] < 0)
+		{
+			m_filteredChannels[channel] = m_filteredStore.Channel(m_filterWorker->ChannelName(sample.channel));
+		}
+		m_filteredStore.Series(m_filteredChannels[channel]).Append(sample.t, sample.value);
+	}
+	if (m_plotWindow.IsCreated())
+	{
+		m_display.MarkDirty(m_plotRegion);
+	}
+}
+
+/**
+ * @brief 在工具栏上添加报警规则按钮。
+ * 持续时间规则在条件成立后可能不再有新样本到达，由定时器按 5 ms 间隔检查。
+ * 反复触发的规则每帧都可能产生事件，状态栏只在刷新周期显示最近一次。
+ */
+void USARTAss::SetupAlarmAction()
+{
+	m_alarmAction = ui.mainToolBar->addAction("Alarms");
+	m_alarmAction->setToolTip("Threshold, hysteresis, rate and duration alarms on decoded values");
+	m_alarmRegion = m_display.AddRegion("alarm", [this]() { ui.statusBar->showMessage("Alarm: " + m_alarmText, 5000); });
+	m_eventBridge = new EventBridge(this);
+	m_alarmTimer = new QTimer(this);
+	m_alarmTimer->setInterval(5);
+	connect(m_alarmTimer, &QTimer::timeout, this, [this]() {
+		if (m_storeClock.isValid())
+		{
+			m_alarms.Tick(m_storeClock.nsecsElapsed());
 		}
+		});
+}
+
+/**
+ * @brief 编辑报警规则，格式见 AlarmEngine。
+ * 新规则从未触发的状态开始，之前处于触发状态的报警不会产生恢复事件。
+ */
+void USARTAss::ConfigureAlarms_clicked()
+{
+	bool ok = false;
+	const QString text = QInputDialog::getMultiLineText(this, "Alarms",
+		"One rule per line: [name:] channel|rate(channel) >|>=|<|<= limit [clear limit] [for 50ms]\n"
+		"channel: a plot channel name such as START1.D; empty disables alarms",
+		QString::fromStdString(m_alarms.Source()), &ok);
+	if (!ok)
+	{
+		return;
+	}
+
+	try
+	{
+		m_alarms = AlarmEngine::Compile(text.toStdString());
+	}
+	catch (const std::invalid_argument& e)
+	{
+		QMessageBox::warning(this, "Alarms", e.what());
+		return;
+	}
+	m_alarms.SetHandler([this](const AlarmEvent& event) { HandleAlarm(event); });
+	if (m_alarms.HasDurationRules())
+	{
+		m_alarmTimer->start();
 	}
 	else
 	{
-		ui.RecvSpace->append("Received Frame: " + receivedData);
+		m_alarmTimer->stop();
+	}
+	qDebug() << "Alarm rules compiled:" << m_alarms.RuleCount();
+}
+
+/**
+ * @brief 在工具栏上添加监视列表按钮。
+ * 匹配可能很密集，按钮文字、提示中的计数和状态栏中的最近匹配由 DisplayScheduler 按刷新周期更新。
+ */
+void USARTAss::SetupWatchAction()
+{
+	m_watchAction = ui.mainToolBar->addAction("Watch");
+	m_watchAction->setToolTip("Count and log strings such as ERR or fault codes in the raw received bytes");
+	m_watchRegion = m_display.AddRegion("watch", [this]() {
+		m_watchAction->setText(QString("Watch (%1)").arg(m_watch.TotalHits()));
+		m_watchAction->setToolTip(QString::fromStdString(m_watch.FormatCounts()));
+		// 一个刷新周期内的多次匹配只显示最后一次
+		if (!m_watchText.isEmpty())
+		{
+			ui.statusBar->showMessage("Watch: " + m_watchText, 5000);
+			m_watchText.clear();
+		}
+		});
+}
+
+/**
+ * @brief 编辑监视列表，格式见 WatchList。新列表的计数从零开始。
+ */
+void USARTAss::ConfigureWatch_clicked()
+{
+	bool ok = false;
+	const QString text = QInputDialog::getMultiLineText(this, "Watch",
+		"One string per line, matched in the raw received bytes, e.g. ERR or WDT reset\n"
+		"escapes \\n \\r \\t \\\\ \\; \\xHH; empty disables the watch list",
+		QString::fromStdString(m_watch.Source()), &ok);
+	if (!ok)
+	{
+		return;
+	}
+
+	try
+	{
+		m_watch = WatchList::Compile(text.toStdString());
+	}
+	catch (const std::invalid_argument& e)
+	{
+		QMessageBox::warning(this, "Watch", e.what());
+		return;
+	}
+	m_watch.SetHandler([this](const WatchHit& hit) { HandleWatchHit(hit); });
+	m_watchAction->setText(m_watch.IsEmpty() ? QString("Watch") : QString("Watch (0)"));
+	m_watchAction->setToolTip(m_watch.IsEmpty()
+		? QString("Count and log strings such as ERR or fault codes in the raw received bytes") : QString());
+	qDebug() << "Watch list compiled:" << m_watch.PatternCount() << "patterns," << m_watch.StateCount() << "states";
+}
+
+void USARTAss::HandleWatchHit(const WatchHit& hit)
+{
+	const std::string line = m_watch.Format(hit);
+	const QString text = QString::fromStdString(line);
+	AppendConsole("[watch] " + text);
+	m_watchText = text;
+	m_eventBridge->Broadcast(QByteArray::fromStdString(line));
+	m_display.MarkDirty(m_watchRegion);
+}
+
+/**
+ * @brief 设备断开：丢弃各解码器中的半帧，在曲线上开始一段空白，等待 SerialInfo 自动重连。
+ */
+void USARTAss::HandleLinkLost(const QString& reason)
+{
+	BeginStreamGap();
+	AppendConsole(QString("[link] lost: %1, reconnecting").arg(reason));
+	ui.statusBar->showMessage(QString("Link lost: %1, reconnecting...").arg(reason));
+}
+
+void USARTAss::HandleLinkRestored(qint64 outageNs, qint64 reopenNs)
+{
+	EndStreamGap();
+	const QString text = QString("restored after %1 ms (reopened %2 ms after the device returned)")
+		.arg(outageNs / 1e6, 0, 'f', 0)
+		.arg(reopenNs / 1e6, 0, 'f', 1);
+	AppendConsole("[link] " + text);
+	ui.statusBar->showMessage("Link " + text, 5000);
+}
+
+/**
+ * @brief 中断前的半帧和监视列表中匹配到一半的前缀在这里丢弃，不会与恢复后的数据拼在一起；
+ * 滤波器、阶跃分析和报警的状态也重新开始，不把中断两侧的样本当作相邻样本。
+ */
+void USARTAss::BeginStreamGap()
+{
+	if (m_decoder)
+	{
+		m_decoder->Reset();
+	}
+	if (m_textDecoder)
+	{
+		m_textDecoder->Reset();
+	}
+	m_watch.Reset(0);
+	if (m_filterWorker.IsCreated())
+	{
+		m_filterWorker->Reset();
+	}
+	if (m_stepWorker.IsCreated())
+	{
+		m_stepWorker->Reset();
+	}
+	m_alarms.Reset();
+	if (!m_storeClock.isValid())
+	{
+		m_storeClock.start();
+	}
+	const double t = m_storeClock.nsecsElapsed() / 1e9;
+	m_store.BeginGap(t);
+	m_filteredStore.BeginGap(t);
+	if (m_plotWindow.IsCreated())
+	{
+		m_display.MarkDirty(m_plotRegion);
+	}
+}
+
+void USARTAss::EndStreamGap()
+{
+	const double t = m_storeClock.nsecsElapsed() / 1e9;
+	m_store.EndGap(t);
+	m_filteredStore.EndGap(t);
+	if (m_plotWindow.IsCreated())
+	{
+		m_display.MarkDirty(m_plotRegion);
+	}
+}
+
+void USARTAss::SetupDerivedAction()
+{
+	m_derivedAction = ui.mainToolBar->addAction("Derived");
+	m_derivedAction->setToolTip("Channels computed from expressions over decoded values, e.g. u = START1.P * err");
+}
+
+/**
+ * @brief 编辑派生通道定义，格式见 DerivedChannels。
+ * 派生通道出现在曲线窗口中，也可以在报警规则和滤波配置中按名称引用。
+ */
+void USARTAss::ConfigureDerived_clicked()
+{
+	bool ok = false;
+	const QString text = QInputDialog::getMultiLineText(this, "Derived",
+		"One channel per line: name = expression over plot channels, e.g. u = START1.P * 2 + abs(START1.I)\n"
+		"operators + - * / % ^, functions abs sqrt exp log sin cos tan atan min max pow atan2 hypot clamp",
+		QString::fromStdString(m_derived.Source()), &ok);
+	if (!ok)
+	{
+		return;
 	}
+
+	try
+	{
+		m_derived = DerivedChannels::Compile(text.toStdString());
+	}
+	catch (const std::invalid_argument& e)
+	{
+		QMessageBox::warning(this, "Derived", e.what());
+		return;
+	}
+	qDebug() << "Derived channels compiled:" << m_derived.Count();
+}
+
+/**
+ * @brief 在工具栏上添加阶跃分析按钮和阶跃报告按钮。
+ */
+void USARTAss::SetupStepAction()
+{
+	m_stepRegion = m_display.AddRegion("steps", [this]() { FlushSteps(); });
+	m_stepAction = ui.mainToolBar->addAction("Steps");
+	m_stepAction->setToolTip("Rise time, overshoot, settling time and steady-state error of every setpoint step");
+	m_stepReportAction = ui.mainToolBar->addAction("Step report");
+	m_stepReportAction->setToolTip("Average step metrics per controller for each set of gains");
+}
+
+/**
+ * @brief 编辑阶跃分析配置，格式见 StepConfig。
+ * 增益默认取 PID 帧的 "名称.P/I/D" 通道，因此控制器名称与帧头相同时只需给出设定值和测量值通道。
+ * 更换配置后各控制器的分析和增益历史从头开始。
+ */
+void USARTAss::ConfigureSteps_clicked()
+{
+	const QString current = m_stepWorker.IsCreated()
+		? QString::fromStdString(m_stepWorker->Config().Describe()).replace(';', '\n') : QString();
+	bool ok = false;
+	const QString text = QInputDialog::getMultiLineText(this, "Steps",
+		"One controller per line: NAME: sp=channel pv=channel [gains=Kp,Ki,Kd] [band=2%] [window=10s] [hold=0.5s] [min-step=0]\n"
+		"gains default to NAME.P, NAME.I and NAME.D, the channels of PID frames; empty disables the analysis",
+		current, &ok);
+	if (!ok)
+	{
+		return;
+	}
+
+	StepConfig config;
+	try
+	{
+		config = StepConfig::Parse(text.toStdString());
+	}
+	catch (const std::invalid_argument& e)
+	{
+		QMessageBox::warning(this, "Steps", e.what());
+		return;
+	}
+	if (config.IsEmpty() && !m_stepWorker.IsCreated())
+	{
+		return;
+	}
+
+	// 旧配置下正在进行的阶跃先结束并输出，之后的结果都属于新配置
+	if (m_stepWorker.IsCreated())
+	{
+		m_stepWorker->Flush(true);
+		FlushSteps();
+	}
+	m_stepWorker->SetConfig(config);
+	qDebug() << "Step analysis configured:" << QString::fromStdString(config.Describe());
+}
+
+/**
+ * @brief 每完成一次阶跃在接收区输出一行，格式见 FormatStepResult。
+ */
+void USARTAss::FlushSteps()
+{
+	m_stepResults.clear();
+	if (!m_stepWorker.IsCreated() || m_stepWorker->Drain(m_stepResults) == 0)
+	{
+		return;
+	}
+	const std::vector<StepRule>& rules = m_stepWorker->Config().Rules();
+	for (const StepResult& result : m_stepResults)
+	{
+		const std::string name = static_cast<size_t>(result.controller) < rules.size()
+			? rules[static_cast<size_t>(result.controller)].name : std::string("?");
+		AppendConsole("[step] " + QString::fromStdString(FormatStepResult(result, name)));
+	}
+	ui.statusBar->showMessage(QString("Step analysis: %1").arg(QString::fromStdString(m_stepWorker->Format())), 5000);
+}
+
+void USARTAss::ShowStepReport_clicked()
+{
+	const QString report = m_stepWorker.IsCreated()
+		? QString::fromStdString(m_stepWorker->FormatHistory()) : QString();
+	QMessageBox::information(this, "Step report",
+		report.isEmpty() ? QString("No steps with known gains yet. Configure the analysis with Steps.") : report);
+}
+
+void USARTAss::SetupModbusAction()
+{
+	m_modbusAction = ui.mainToolBar->addAction("Modbus");
+	m_modbusAction->setToolTip("Poll Modbus RTU registers on the open port and decode them as channels");
+}
+
+/**
+ * @brief 编辑 Modbus 轮询配置，格式见 ModbusConfig。
+ * 确定后 Modbus 主站代替当前解码器并开启帧检查，串口已打开时立即开始轮询，之后随串口打开和关闭启停；
+ * 从协议下拉框选择其他解码器时停止轮询。
+ */
+void USARTAss::ConfigureModbus_clicked()
+{
+	QString prompt = "One entry per line: [name=]slave:table:address[-end][:type][*scale][@period]\n"
+		"table: hr, ir, coil, di; type: u16, i16, u32, i32, f32; period: 100ms, 1s, 0 (as fast as possible), 20ms..2s or auto (adaptive)\n"
+		"empty stops polling";
+	if (m_modbusPoller)
+	{
+		prompt += "\n\n" + m_modbusPoller->Summary();
+	}
+	bool ok = false;
+	const QString text = QInputDialog::getMultiLineText(this, "Modbus", prompt, m_modbusSpec, &ok);
+	if (!ok)
+	{
+		return;
+	}
+	if (text.trimmed().isEmpty())
+	{
+		m_modbusSpec.clear();
+		if (m_modbus != nullptr)
+		{
+			SelectDecoder(m_decoderSelect->currentText());
+		}
+		return;
+	}
+
+	std::unique_ptr<ModbusMaster> master;
+	try
+	{
+		master = std::make_unique<ModbusMaster>(ModbusConfig::Parse(text.toStdString()));
+	}
+	catch (const std::invalid_argument& e)
+	{
+		QMessageBox::warning(this, "Modbus", e.what());
+		return;
+	}
+	m_modbusSpec = text;
+	qDebug().noquote() << "Modbus plan:\n" + QString::fromStdString(master->DescribePlan()).trimmed();
+
+	StopModbus();
+	m_modbus = master.get();
+	m_decoder = std::move(master);
+	// 轮询连接 DataReceived 的时间晚于 CreateSerialInfo 中的 RecvMessage_clicked，响应先解码再发出下一个请求
+	m_modbusPoller = std::make_unique<ModbusPoller>(m_serialInfo.Get(), m_modbus);
+	connect(m_serialInfo.Get(), &SerialInfo::SerialStateChanged, m_modbusPoller.get(), [this](bool isOpen) {
+		if (isOpen)
+		{
+			m_modbusPoller->Start();
+		}
+		else
+		{
+			m_modbusPoller->Stop();
+			ui.statusBar->showMessage("Modbus: " + m_modbusPoller->Summary(), 5000);
+		}
+		});
+	ui.OpenfraemCheck->setChecked(true);
+	RecvCheck = true;
+	if (serialOpened)
+	{
+		m_modbusPoller->Start();
+	}
+}
+
+void USARTAss::StopModbus()
+{
+	if (m_modbusPoller)
+	{
+		m_modbusPoller->Stop();
+		m_modbusPoller.reset();
+	}
+	m_modbus = nullptr;
+}
+
+void USARTAss::HandleAlarm(const AlarmEvent& event)
+{
+	const std::string line = m_alarms.Format(event);
+	const QString text = QString::fromStdString(line);
+	AppendConsole("[alarm] " + text);
+	if (event.raised)
+	{
+		m_alarmText = text;
+		m_display.MarkDirty(m_alarmRegion);
+	}
+	m_eventBridge->Broadcast(QByteArray::fromStdString(line));
+}
+
+/**
+ * @brief 打开曲线窗口，第一次打开时才创建窗口。
+ */
+void USARTAss::ShowPlot_clicked()
+{
+	m_plotWindow->show();
+	m_plotWindow->raise();
+	m_plotWindow->Refresh();
+}
+
+/**
+ * @brief 把暂存的文本一次性追加到接收区。
+ */
+void USARTAss::FlushConsole()
+{
+	if (!m_console.IsEmpty())
+	{
+		ui.RecvSpace->append(m_console.Take());
+	}
+}
+
+void USARTAss::AppendConsole(QString line)
+{
+	m_console.Append(std::move(line));
+	m_display.MarkDirty(m_consoleRegion);
 }
 
 void USARTAss::OpenfraemCheck_on_click()
 {
 	qDebug() << "i am in on click";
 	// GettheFrameStartandEnd();
+	// 重新开启帧检查时丢弃之前残留的半帧
+	m_decoder->Reset();
 	RecvCheck = true;
 }
 
@@ -339,6 +1159,7 @@ void USARTAss::ClearSendSpace_clicked()
 
 void USARTAss::ClearRecvSpace_clicked()
 {
+	m_console.Clear();
 	ui.RecvSpace->clear();
 }
 
@@ -364,12 +1185,22 @@ void USARTAss::TotalConnect()
 	connect(ui.OpenfraemCheck, &QRadioButton::clicked, this, &USARTAss::OpenfraemCheck_on_click);
 	connect(ui.ClosefraemCheck, &QRadioButton::clicked, this, &USARTAss::ClosefraemCheck_on_click);
 
-	// 连接 SerialInfo 的 DataReceived 信号到 USARTAss 的 RecvMessage_clicked 槽
-	connect(m_serialInfo, &SerialInfo::DataReceived, this, &USARTAss::RecvMessage_clicked);
-	// 连接 SerialInfo 的 SerialStateChanged 信号，用于更新 UI 状态
-	connect(m_serialInfo, &SerialInfo::SerialStateChanged, this, &USARTAss::ChangeSerialButtonText);
+	// SerialInfo 的信号在 CreateSerialInfo 中连接
 
-	connect(this, &USARTAss::PIDReadyToShow, this, &USARTAss::ShowPID);
+	connect(m_decoderSelect, &QComboBox::currentTextChanged, this, &USARTAss::SelectDecoder);
+	connect(m_encodingSelect, &QComboBox::currentTextChanged, this, &USARTAss::SelectEncoding);
+	connect(m_fanoutAction, &QAction::toggled, this, &USARTAss::ToggleFanout_clicked);
+	connect(m_plotAction, &QAction::triggered, this, &USARTAss::ShowPlot_clicked);
+	connect(m_sendFileAction, &QAction::triggered, this, &USARTAss::SendFile_clicked);
+	connect(m_traceAction, &QAction::toggled, this, &USARTAss::ToggleTrace_clicked);
+	connect(m_filterAction, &QAction::triggered, this, &USARTAss::ConfigureFilter_clicked);
+	connect(m_alarmAction, &QAction::triggered, this, &USARTAss::ConfigureAlarms_clicked);
+	connect(m_watchAction, &QAction::triggered, this, &USARTAss::ConfigureWatch_clicked);
+	connect(m_derivedAction, &QAction::triggered, this, &USARTAss::ConfigureDerived_clicked);
+	connect(m_stepAction, &QAction::triggered, this, &USARTAss::ConfigureSteps_clicked);
+	connect(m_stepReportAction, &QAction::triggered, this, &USARTAss::ShowStepReport_clicked);
+	connect(m_modbusAction, &QAction::triggered, this, &USARTAss::ConfigureModbus_clicked);
+	connect(m_memoryAction, &QAction::triggered, this, &USARTAss::ConfigureMemory_clicked);
 }
 
 /**
@@ -436,40 +1267,161 @@ void USARTAss::ShowRecvBytesCount()
 	ui.RXBytescount->setText("RX Bytes:" + QString::number(totalBytes));
 }
 
-void USARTAss::ShowPID(size_t index, PID_parameters PIDdata)
+/**
+ * @brief 处理关闭帧检查复选框点击事件的槽函数。
+ *
+ * 当用户点击“关闭帧检查”复选框时，此函数将 RecvCheck 标志设置为 false，
+ * 禁用接收数据时的帧检查逻辑。
+ */
+void USARTAss::ClosefraemCheck_on_click()
 {
-	if (index == 0)
+	qDebug() << "i am in off click";
+	RecvCheck = false;
+}
+/**
+ * @brief 登记内存预算。
+ * 默认上限 1 GB，历史数据默认丢弃最旧的样本；溢出目录在本机应用数据目录下的 spill 中。
+ * 状态栏显示总用量，悬停时列出每一项的用量、策略和累计释放量。
+ */
+void USARTAss::SetupMemoryBudget()
+{
+	constexpr size_t kDefaultLimit = size_t(1024) << 20;
+	MemoryBudget& budget = MemoryBudget::Instance();
+	budget.SetLimit(kDefaultLimit);
+	m_spillDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/spill";
+
+	m_historyBudget = budget.Register("history", MemoryBudget::Policy::DropOldest,
+		[this]() { return m_store.MemoryBytes() + m_filteredStore.MemoryBytes(); },
+		[this](size_t bytes, MemoryBudget::Policy policy) { return ReleaseHistory(bytes, policy); });
+	m_consoleBudget = budget.Register("console", MemoryBudget::Policy::DropOldest,
+		[this]() { return ConsoleBytes(); },
+		[this](size_t bytes, MemoryBudget::Policy) { return ReleaseConsole(bytes); });
+	m_flightBudget = budget.Register("flight recorder", MemoryBudget::Policy::Fixed,
+		[]() { return FlightRecorder::Instance().Capacity(); });
+
+	m_memoryAction = ui.mainToolBar->addAction("Memory");
+	m_memoryAction->setToolTip("Memory cap for history, console and receive buffers, and what to do when it is reached");
+	m_memoryLabel = new QLabel(this);
+	ui.statusBar->addPermanentWidget(m_memoryLabel);
+	m_memoryTimer = new QTimer(this);
+	connect(m_memoryTimer, &QTimer::timeout, this, [this]() {
+		MemoryBudget& budget = MemoryBudget::Instance();
+		if (budget.Enforce() > 0 && m_plotWindow.IsCreated())
+		{
+			m_display.MarkDirty(m_plotRegion);
+		}
+		const size_t limit = budget.Limit();
+		m_memoryLabel->setText(limit > 0
+			? QString("Mem %1/%2 MB").arg(budget.TotalBytes() / 1048576.0, 0, 'f', 0).arg(limit / 1048576.0, 0, 'f', 0)
+			: QString("Mem %1 MB").arg(budget.TotalBytes() / 1048576.0, 0, 'f', 0));
+		QStringList lines;
+		for (const MemoryBudget::Usage& usage : budget.Snapshot())
+		{
+			lines << QString("%1: %2 MB, %3, %4 MB released").arg(QString::fromStdString(usage.name))
+				.arg(usage.bytes / 1048576.0, 0, 'f', 1).arg(MemoryBudget::PolicyName(usage.policy))
+				.arg(usage.releasedBytes / 1048576.0, 0, 'f', 1);
+		}
+		m_memoryLabel->setToolTip(lines.join('\n'));
+		});
+	m_memoryTimer->start(1000);
+}
+
+/**
+ * @brief 按两个存储各自的用量比例释放，溢出文件每次释放时以追加方式打开，
+ * 原始值和滤波输出分别写到 history.csv 和 history-filtered.csv，每行为 时间,通道,数值。
+ * 溢出文件无法打开时退回到直接丢弃。
+ */
+size_t USARTAss::ReleaseHistory(size_t bytes, MemoryBudget::Policy policy)
+{
+	const size_t raw = m_store.MemoryBytes();
+	const size_t total = raw + m_filteredStore.MemoryBytes();
+	if (total == 0)
 	{
-		ui.PID1_P->setText(QString::number(PIDdata.Kp));
-		ui.PID1_I->setText(QString::number(PIDdata.Ki));
-		ui.PID1_D->setText(QString::number(PIDdata.Kd));
+		return 0;
 	}
-	else if (index == 1)
+	const size_t rawShare = static_cast<size_t>(static_cast<double>(bytes) * raw / total);
+
+	std::FILE* spill[2] = { nullptr, nullptr };
+	if (policy == MemoryBudget::Policy::SpillToDisk)
 	{
-		ui.PID2_P->setText(QString::number(PIDdata.Kp));
-		ui.PID2_I->setText(QString::number(PIDdata.Ki));
-		ui.PID2_D->setText(QString::number(PIDdata.Kd));
+		QDir().mkpath(m_spillDir);
+		const QString names[2] = { "history.csv", "history-filtered.csv" };
+		for (int i = 0; i < 2; ++i)
+		{
+			spill[i] = std::fopen(QDir(m_spillDir).filePath(names[i]).toLocal8Bit().constData(), "a");
+			if (spill[i] == nullptr)
+			{
+				qWarning() << "Cannot open spill file in" << m_spillDir << ", dropping history instead.";
+			}
+		}
 	}
-	else if (index == 2)
+	const size_t released = m_store.ReleaseOldest(rawShare, spill[0])
+		+ m_filteredStore.ReleaseOldest(bytes - rawShare, spill[1]);
+	for (std::FILE* file : spill)
 	{
-		ui.PID3_P->setText(QString::number(PIDdata.Kp));
-		ui.PID3_I->setText(QString::number(PIDdata.Ki));
-		ui.PID3_D->setText(QString::number(PIDdata.Kd));
+		if (file != nullptr)
+		{
+			std::fclose(file);
+		}
 	}
-	else
+	qDebug() << "Memory budget released" << released << "bytes of history," << MemoryBudget::PolicyName(policy);
+	return released;
+}
+
+/**
+ * @brief 接收区占用的内存估算。
+ * 文本本身每个字符 2 字节，QTextBrowser 还为每行保存排版结果（字形、位置和簇索引，每个字符约 30 字节）
+ * 以及块和排版对象（每行约 500 字节），这两部分远大于文本本身，按估算值计入。
+ */
+size_t USARTAss::ConsoleBytes() const
+{
+	constexpr size_t kLayoutBytesPerChar = 30;
+	constexpr size_t kBytesPerBlock = 500;
+	const QTextDocument* document = ui.RecvSpace->document();
+	return static_cast<size_t>(document->characterCount()) * (sizeof(QChar) + kLayoutBytesPerChar)
+		+ static_cast<size_t>(document->blockCount()) * kBytesPerBlock;
+}
+
+/**
+ * @brief 删除接收区最旧的若干行，行数按平均每行的大小估算，至少保留最后一行。
+ */
+size_t USARTAss::ReleaseConsole(size_t bytes)
+{
+	QTextDocument* document = ui.RecvSpace->document();
+	const size_t before = ConsoleBytes();
+	const int blocks = document->blockCount();
+	if (before == 0 || blocks <= 1)
 	{
-		qDebug() << "Invalid index for PID data:" << index;
+		return 0;
 	}
+	const int remove = qMin(blocks - 1, static_cast<int>(std::ceil(static_cast<double>(blocks) * bytes / before)));
+	QTextCursor cursor(document);
+	cursor.movePosition(QTextCursor::Start);
+	cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, remove);
+	cursor.removeSelectedText();
+	return before - qMin(before, ConsoleBytes());
 }
 
 /**
- * @brief 处理关闭帧检查复选框点击事件的槽函数。
- *
- * 当用户点击“关闭帧检查”复选框时，此函数将 RecvCheck 标志设置为 false，
- * 禁用接收数据时的帧检查逻辑。
+ * @brief 输入内存上限（MB，0 表示不限制），再选择历史数据超限时丢弃还是溢出到磁盘。
  */
-void USARTAss::ClosefraemCheck_on_click()
+void USARTAss::ConfigureMemory_clicked()
 {
-	qDebug() << "i am in off click";
-	RecvCheck = false;
-}
\ No newline at end of file
+	MemoryBudget& budget = MemoryBudget::Instance();
+	bool ok = false;
+	const int limitMb = QInputDialog::getInt(this, "Memory", "Memory cap in MB (0 for no cap):",
+		static_cast<int>(budget.Limit() >> 20), 0, 1 << 20, 64, &ok);
+	if (!ok)
+	{
+		return;
+	}
+	const QStringList policies{ "Drop oldest history", "Spill oldest history to " + m_spillDir };
+	const QString policy = QInputDialog::getItem(this, "Memory", "When the cap is reached:", policies, 0, false, &ok);
+	if (!ok)
+	{
+		return;
+	}
+	budget.SetLimit(static_cast<size_t>(limitMb) << 20);
+	budget.SetPolicy("history", policy == policies[1] ? MemoryBudget::Policy::SpillToDisk : MemoryBudget::Policy::DropOldest);
+	qDebug() << "Memory cap set to" << limitMb << "MB," << policy;
+}
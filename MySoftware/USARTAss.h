@@ -14,11 +14,33 @@
 #include <QtCore/QtGlobal>
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QVBoxLayout>
-#include <QtCharts/QChartView> // 添加此行以包含 QChartView 的定义
 #include <vector>
 #include <memory>
 #include <QThread>
 #include "SerialInfo.h" // 添加 SerialInfo 头文件
+#include "FrameDecoder.h"
+#include "ProtocolDecoder.h"
+#include <QtWidgets/QComboBox>
+#include <QAction>
+#include "LazySubsystem.h"
+#include "DisplayScheduler.h"
+#include "PidTableModel.h"
+#include "TimeSeriesStore.h"
+#include "TimeSeriesView.h"
+#include "FileTransfer.h"
+#include "TextStreamDecoder.h"
+#include "FilterWorker.h"
+#include "StepWorker.h"
+#include "ModbusMaster.h"
+#include "ModbusPoller.h"
+#include "AlarmEngine.h"
+#include "DerivedChannels.h"
+#include "WatchList.h"
+#include "MemoryBudget.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+
+class EventBridge;
 
 QT_BEGIN_NAMESPACE
 namespace UI
@@ -27,13 +49,6 @@ namespace UI
 }
 QT_END_NAMESPACE
 
-struct PID_parameters
-{
-	float Kp; /**< 比例系数。 */
-	float Ki; /**< 积分系数。 */
-	float Kd; /**< 微分系数。 */
-};
-
 /**
  * @brief USARTAss类是应用程序的主窗口类。
  *
@@ -46,6 +61,11 @@ class USARTAss : public QMainWindow
 	Q_OBJECT
 
 public:
+	/**
+	 * @brief START/数据/END 协议支持的最大控制器数量，与命令行模式共用 kMaxPidControllers。
+	 */
+	static constexpr int kMaxControllers = kMaxPidControllers;
+
 	/**
 	 * @brief USARTAss类的构造函数。
 	 * @param parent 父QWidget对象，默认为nullptr。
@@ -78,8 +98,9 @@ private slots:
 	/**
 	 * @brief 处理串口接收到数据时的信号的槽函数。
 	 * @param data 接收到的数据。
+	 * @param receivedNs 读到数据的时间（TraceRecorder::NowNs）。
 	 */
-	void RecvMessage_clicked(const QByteArray& data);
+	void RecvMessage_clicked(const QByteArray& data, qint64 receivedNs);
 
 	/**
 	 * @brief 处理打开帧检查复选框点击事件的槽函数。
@@ -90,9 +111,82 @@ private slots:
 	 */
 	void ClosefraemCheck_on_click();
 
+	/**
+	 * @brief 按名称切换当前串口使用的协议解码器。
+	 * @param name 解码器名称。
+	 */
+	void SelectDecoder(const QString& name);
+
+	/**
+	 * @brief 切换接收区原始文本使用的编码，丢弃上一编码残留的不完整字符。
+	 * @param name 编码名称，见 TextStreamDecoder::Encodings()。
+	 */
+	void SelectEncoding(const QString& name);
+
+	/**
+	 * @brief 打开或关闭本地分发桥。
+	 * @param enabled 是否启用。
+	 */
+	void ToggleFanout_clicked(bool enabled);
+
+	/**
+	 * @brief 打开曲线窗口。
+	 */
+	void ShowPlot_clicked();
+
+	/**
+	 * @brief 选择文件和模式并开始发送；正在发送时询问是否取消。
+	 */
+	void SendFile_clicked();
+
+	/**
+	 * @brief 开始或停止链路追踪，停止时导出 Chrome trace JSON。
+	 * @param enabled 是否开始追踪。
+	 */
+	void ToggleTrace_clicked(bool enabled);
+
+	/**
+	 * @brief 输入滤波配置，空配置关闭滤波。
+	 */
+	void ConfigureFilter_clicked();
+
+	/**
+	 * @brief 编辑报警规则，空文本关闭报警。
+	 */
+	void ConfigureAlarms_clicked();
+
+	/**
+	 * @brief 编辑派生通道定义，空文本关闭派生通道。
+	 */
+	void ConfigureDerived_clicked();
+
+	/**
+	 * @brief 编辑原始数据监视列表，空文本关闭监视。
+	 */
+	void ConfigureWatch_clicked();
+
+	/**
+	 * @brief 设置内存上限和历史数据超限时的策略。
+	 */
+	void ConfigureMemory_clicked();
+
+	/**
+	 * @brief 编辑阶跃分析配置，空文本关闭分析。
+	 */
+	void ConfigureSteps_clicked();
+
+	/**
+	 * @brief 显示各控制器每组增益的平均阶跃指标。
+	 */
+	void ShowStepReport_clicked();
+
+	/**
+	 * @brief 编辑 Modbus 轮询配置并以 Modbus 主站代替当前解码器，空文本停止轮询。
+	 */
+	void ConfigureModbus_clicked();
+
 signals:
 	void DataDisposed(int chartIndex, float data);
-	void PIDReadyToShow(size_t index, PID_parameters PIDdata); /**< 信号，表示PID数据已准备好显示。 */
 private:
 	/**
 	 * @brief 连接所有UI控件的信号到相应的槽函数。
@@ -113,39 +207,247 @@ private:
 	 */
 	void ShowRecvBytesCount();
 
-	void ShowPID(size_t index, PID_parameters PIDdata); /**< 显示PID数据的函数。 */
+	/**
+	 * @brief 登记界面刷新区域：接收字节数、PID 参数和接收区。
+	 */
+	void SetupDisplay();
 
-private:
-	Ui::USARTAss ui; /**< 指向通过Qt Designer生成的UI类的实例。 */
+	/**
+	 * @brief 刷新区域：把暂存的文本一次性追加到接收区。
+	 */
+	void FlushConsole();
 
-	bool RecvCheck;
-	QString EndFrame;
+	/**
+	 * @brief 暂存一行要显示在接收区的文本，在下一个刷新周期输出。
+	 */
+	void AppendConsole(QString line);
 
-	std::vector<QString> ChartFrame;
-	size_t FrameIndex; /**< 用于存储图表帧头的字符串数组。 */
+	/**
+	 * @brief 创建 SerialInfo 对象并连接其信号，由 m_serialInfo 在第一次使用时调用。
+	 * @return 新创建的 SerialInfo 对象。
+	 */
+	std::unique_ptr<SerialInfo> CreateSerialInfo();
+
+	/**
+	 * @brief 在工具栏上添加协议选择下拉框。
+	 */
+	void SetupDecoderSelector();
 
 	/**
-	 * @brief 枚举，表示串口数据接收的状态。
+	 * @brief 在工具栏上添加分发桥开关。
 	 */
-	enum FrameState
-	{
-		WaitingForStart, /**< 等待接收帧头状态。 */
-		WaitingForData1, /**< 等待接收第一个数据帧状态。 */
-		WaitingForData2, /**< 等待接收第二个数据帧状态。 */
-		WaitingForData3, /**< 等待接收第三个数据帧状态。 */
-		WaitingForEnd	 /**< 等待接收帧尾状态。 */
-	};
+	void SetupFanoutAction();
 
-	FrameState currentState = WaitingForStart; /**< 当前串口数据接收状态。 */
-	QString currentStartFrame;				   /**< 当前已接收到的帧头字符串。 */
-	float currentDataFrame1;                   /**< 当前已接收到的第一个数据帧的浮点数值。 */
-	float currentDataFrame2;                   /**< 当前已接收到的第二个数据帧的浮点数值。 */
-	float currentDataFrame3;                   /**< 当前已接收到的第三个数据帧的浮点数值。 */
+	/**
+	 * @brief 在工具栏上添加文件发送按钮。
+	 */
+	void SetupFileTransferAction();
+
+	/**
+	 * @brief 刷新区域：在状态栏显示文件发送进度。
+	 */
+	void ShowTransferProgress();
+
+	/**
+	 * @brief 创建文件发送对象并连接其信号，由 m_fileTransfer 在第一次发送时调用。
+	 */
+	std::unique_ptr<FileTransfer> CreateFileTransfer();
+
+	/**
+	 * @brief 在工具栏上添加链路追踪开关。
+	 */
+	void SetupTraceAction();
+
+	/**
+	 * @brief 取出滤波线程的输出写入 m_filteredStore。
+	 */
+	void FlushFiltered();
+
+	/**
+	 * @brief 在工具栏上添加接收区文本编码选择下拉框。
+	 */
+	void SetupEncodingSelector();
+
+	/**
+	 * @brief 在工具栏上添加派生通道按钮。
+	 */
+	void SetupDerivedAction();
+
+	/**
+	 * @brief 在工具栏上添加阶跃分析按钮和阶跃报告按钮，登记结果区域。
+	 */
+	void SetupStepAction();
+
+	/**
+	 * @brief 取出阶跃分析线程完成的阶跃，写入接收区。
+	 */
+	void FlushSteps();
+
+	/**
+	 * @brief 在工具栏上添加 Modbus 轮询按钮。
+	 */
+	void SetupModbusAction();
+
+	/**
+	 * @brief 停止并删除 Modbus 轮询，更换解码器之前调用。
+	 */
+	void StopModbus();
+
+	/**
+	 * @brief 在工具栏上添加报警规则按钮，创建事件广播和持续时间检查定时器。
+	 */
+	void SetupAlarmAction();
+
+	/**
+	 * @brief 在工具栏上添加监视列表按钮，登记匹配计数区域。
+	 */
+	void SetupWatchAction();
+
+	/**
+	 * @brief 记录并广播一次监视匹配，状态栏由 m_watchRegion 刷新。
+	 */
+	void HandleWatchHit(const WatchHit& hit);
+
+	/**
+	 * @brief 设备断开时复位解码器并在历史数据中开始一段空白。
+	 * @param reason 断开原因。
+	 */
+	void HandleLinkLost(const QString& reason);
+
+	/**
+	 * @brief 自动重连成功时结束空白并显示停机时间。
+	 * @param outageNs 从断开到重新打开的时间。
+	 * @param reopenNs 从设备重新出现到打开成功的时间。
+	 */
+	void HandleLinkRestored(qint64 outageNs, qint64 reopenNs);
+
+	/**
+	 * @brief 接收数据中断（断线或超过内存预算丢弃数据）：复位解码器，在历史数据中开始一段空白。
+	 */
+	void BeginStreamGap();
+
+	/**
+	 * @brief 接收数据恢复，结束空白。
+	 */
+	void EndStreamGap();
+
+	/**
+	 * @brief 在 MemoryBudget 中登记历史数据和接收区，在状态栏上显示用量，每秒检查一次上限。
+	 */
+	void SetupMemoryBudget();
+
+	/**
+	 * @brief 释放最旧的历史数据，SpillToDisk 策略先把丢弃的样本追加到溢出目录中的文件。
+	 * @return 实际释放的字节数。
+	 */
+	size_t ReleaseHistory(size_t bytes, MemoryBudget::Policy policy);
+
+	/**
+	 * @brief 删除接收区中最旧的行。
+	 * @return 实际释放的字节数（估算）。
+	 */
+	size_t ReleaseConsole(size_t bytes);
+
+	/**
+	 * @brief 接收区文档占用的内存（按字符数估算）。
+	 */
+	size_t ConsoleBytes() const;
+
+	/**
+	 * @brief 显示、记录并广播一次报警状态变化。
+	 */
+	void HandleAlarm(const AlarmEvent& event);
+
+	/**
+	 * @brief 处理解码器输出的一条记录。
+	 * @param record 解码记录，仅在本次调用期间有效。
+	 */
+	void HandleRecord(const DecodedRecord& record);
+
+	/**
+	 * @brief 把一条记录中的数值写入存储，并交给报警和滤波。解码记录和派生记录共用。
+	 */
+	void AppendValues(const DecodedRecord& record);
+
+private:
+	Ui::USARTAss ui; /**< 指向通过Qt Designer生成的UI类的实例。 */
+
+	bool RecvCheck;
+	QString EndFrame;
+
+	std::vector<QString> ChartFrame; /**< 合法帧头列表，START1 到 START<kMaxControllers>。 */
+	std::unique_ptr<ProtocolDecoder> m_decoder; /**< 当前串口使用的协议解码器，与命令行模式共用。 */
+	QComboBox* m_decoderSelect = nullptr;       /**< 工具栏上的协议选择下拉框。 */
+	QComboBox* m_encodingSelect = nullptr;      /**< 工具栏上的文本编码选择下拉框。 */
+	std::unique_ptr<TextStreamDecoder> m_textDecoder; /**< 关闭帧检查时接收区使用的增量文本解码器。 */
+	QAction* m_fanoutAction = nullptr;          /**< 工具栏上的分发桥开关。 */
+	quint16 m_fanoutPort = 5760;                /**< 分发桥上次使用的 TCP 端口。 */
 
 	bool serialOpened;		   /**< 布尔标志，指示串口是否已打开。 */
 	QString serialSendMessage; /**< 存储待发送的串口消息。 */
-	QByteArray buffer;		   /**< 用于存储从串口接收到的原始数据的缓冲区。 */
 	qint64 totalBytes;		   /**< 记录从串口接收到的总字节数。 */
 
-	SerialInfo* m_serialInfo;      /**< SerialInfo 对象。 */
+	DisplayScheduler m_display;                     /**< 界面刷新调度器，数据到达时只标记区域。 */
+	DisplayScheduler::RegionId m_rxCountRegion = 0; /**< 接收字节数区域。 */
+	DisplayScheduler::RegionId m_pidRegion = 0;     /**< PID 参数区域。 */
+	DisplayScheduler::RegionId m_consoleRegion = 0; /**< 接收区区域。 */
+	PidTableModel* m_pidModel = nullptr;            /**< PID 参数表格模型，每个帧头一行。 */
+	ConsoleBuffer m_console;                        /**< 待追加到接收区的文本。 */
+	DisplayScheduler::RegionId m_plotRegion = 0;    /**< 曲线窗口区域。 */
+
+	TimeSeriesStore m_store;                        /**< 所有解码数值的多分辨率存储。 */
+	TimeSeriesStore m_filteredStore;                /**< 滤波输出，通道名称与 m_store 相同。 */
+	QElapsedTimer m_storeClock;                     /**< 存储使用的时间基准，第一条记录时启动。 */
+	qint64 m_chunkNs = 0;                           /**< 当前数据块的接收时间（m_storeClock 时间基准），作为其中各帧的时间戳。 */
+	QAction* m_plotAction = nullptr;                /**< 工具栏上的曲线窗口按钮。 */
+	LazySubsystem<PlotWindow> m_plotWindow;         /**< 曲线窗口，第一次打开时才创建。 */
+
+	LazySubsystem<SerialInfo> m_serialInfo; /**< SerialInfo 对象，第一次打开或发送时才创建。 */
+
+	QAction* m_sendFileAction = nullptr;            /**< 工具栏上的文件发送按钮。 */
+	DisplayScheduler::RegionId m_transferRegion = 0; /**< 文件发送进度区域。 */
+	QString m_transferDir;                          /**< 上次选择文件的目录。 */
+	QAction* m_traceAction = nullptr;               /**< 工具栏上的链路追踪开关。 */
+	LazySubsystem<FileTransfer> m_fileTransfer;     /**< 文件发送，依赖 m_serialInfo，因此声明在其后、先于其析构。 */
+
+	QAction* m_filterAction = nullptr;              /**< 工具栏上的滤波配置按钮。 */
+	DisplayScheduler::RegionId m_filterRegion = 0;  /**< 滤波输出区域。 */
+	std::vector<FilteredSample> m_filteredSamples;  /**< 取出的滤波输出，重复使用。 */
+	std::vector<int> m_filteredChannels;            /**< 滤波线程的通道编号到 m_filteredStore 通道编号的映射。 */
+	LazySubsystem<FilterWorker> m_filterWorker;     /**< 滤波线程，第一次配置滤波时才创建。 */
+
+	QAction* m_alarmAction = nullptr;               /**< 工具栏上的报警规则按钮。 */
+	AlarmEngine m_alarms;                           /**< 报警规则，在 HandleRecord 中对每条记录求值。 */
+	QTimer* m_alarmTimer = nullptr;                 /**< 持续时间规则的检查定时器，只在有这类规则时运行。 */
+	EventBridge* m_eventBridge = nullptr;           /**< 报警事件和监视匹配广播，随分发桥在下一个端口上启用。 */
+
+	QAction* m_watchAction = nullptr;               /**< 工具栏上的监视列表按钮，文字中显示累计匹配次数。 */
+	WatchList m_watch;                              /**< 原始数据监视列表，在 RecvMessage_clicked 中扫描每个数据块。 */
+	DisplayScheduler::RegionId m_watchRegion = 0;   /**< 匹配计数和状态栏中的最近匹配。 */
+	DisplayScheduler::RegionId m_alarmRegion = 0;   /**< 状态栏中的最近报警。 */
+	QString m_watchText;                            /**< 最近一次匹配，在 m_watchRegion 刷新时显示到状态栏后清空。 */
+	QString m_alarmText;                            /**< 最近一次触发的报警，在 m_alarmRegion 刷新时显示。 */
+
+	QAction* m_derivedAction = nullptr;             /**< 工具栏上的派生通道按钮。 */
+	DerivedChannels m_derived;                      /**< 派生通道，在 HandleRecord 中按记录求值。 */
+
+	QAction* m_stepAction = nullptr;                /**< 工具栏上的阶跃分析配置按钮。 */
+	QAction* m_stepReportAction = nullptr;          /**< 工具栏上的阶跃报告按钮。 */
+	DisplayScheduler::RegionId m_stepRegion = 0;    /**< 阶跃分析结果区域。 */
+	std::vector<StepResult> m_stepResults;          /**< 取出的阶跃结果，重复使用。 */
+	LazySubsystem<StepWorker> m_stepWorker;         /**< 阶跃分析线程，第一次配置时才创建。 */
+
+	QAction* m_modbusAction = nullptr;              /**< 工具栏上的 Modbus 轮询按钮。 */
+	QString m_modbusSpec;                           /**< 上次输入的 Modbus 轮询配置。 */
+	ModbusMaster* m_modbus = nullptr;               /**< 当前解码器为 Modbus 主站时指向 m_decoder，否则为空。 */
+	std::unique_ptr<ModbusPoller> m_modbusPoller;   /**< Modbus 轮询，依赖 m_serialInfo 和 m_decoder，先于它们析构。 */
+
+	QAction* m_memoryAction = nullptr;              /**< 工具栏上的内存预算按钮。 */
+	QLabel* m_memoryLabel = nullptr;                /**< 状态栏上的内存用量。 */
+	QTimer* m_memoryTimer = nullptr;                /**< 每秒检查一次内存上限。 */
+	QString m_spillDir;                             /**< SpillToDisk 策略写出历史数据的目录。 */
+	// 登记项放在最后，先于它们引用的成员析构
+	MemoryBudget::Registration m_historyBudget;     /**< 历史数据（m_store 和 m_filteredStore）。 */
+	MemoryBudget::Registration m_consoleBudget;     /**< 接收区。 */
+	MemoryBudget::Registration m_flightBudget;      /**< 飞行记录仪，固定大小。 */
 };
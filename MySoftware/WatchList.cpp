@@ -0,0 +1,354 @@
+/*
+ * @Description: 原始接收数据的多模式监视列表，所有模式编译为一个 Aho-Corasick 自动机，一次扫描找出全部匹配
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-19 00:50:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "WatchList.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+	/**
+	 * @brief 转移表的最大项数（64 MB），超过时认为模式列表不合理。
+	 */
+	constexpr size_t kMaxTableEntries = size_t(16) << 20;
+
+	std::string Trim(const std::string& text)
+	{
+		const size_t begin = text.find_first_not_of(" \t\r");
+		if (begin == std::string::npos)
+		{
+			return std::string();
+		}
+		const size_t end = text.find_last_not_of(" \t\r");
+		return text.substr(begin, end - begin + 1);
+	}
+
+	int HexDigit(char c)
+	{
+		if (c >= '0' && c <= '9')
+		{
+			return c - '0';
+		}
+		if (c >= 'a' && c <= 'f')
+		{
+			return c - 'a' + 10;
+		}
+		if (c >= 'A' && c <= 'F')
+		{
+			return c - 'A' + 10;
+		}
+		return -1;
+	}
+}
+
+std::string WatchList::Unescape(const std::string& text)
+{
+	std::string bytes;
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		if (text[i] != '\\')
+		{
+			bytes.push_back(text[i]);
+			continue;
+		}
+		if (++i == text.size())
+		{
+			throw std::invalid_argument("Trailing backslash in watch pattern '" + text + "'.");
+		}
+		switch (text[i])
+		{
+		case 'n': bytes.push_back('\n'); break;
+		case 'r': bytes.push_back('\r'); break;
+		case 't': bytes.push_back('\t'); break;
+		case '\\': bytes.push_back('\\'); break;
+		case ';': bytes.push_back(';'); break;
+		case 'x':
+		{
+			const int high = i + 1 < text.size() ? HexDigit(text[i + 1]) : -1;
+			const int low = i + 2 < text.size() ? HexDigit(text[i + 2]) : -1;
+			if (high < 0 || low < 0)
+			{
+				throw std::invalid_argument("Invalid \\x escape in watch pattern '" + text + "', expected two hex digits.");
+			}
+			bytes.push_back(static_cast<char>(high * 16 + low));
+			i += 2;
+			break;
+		}
+		default:
+			throw std::invalid_argument(std::string("Unknown escape \\") + text[i] + " in watch pattern '" + text + "'.");
+		}
+	}
+	return bytes;
+}
+
+/**
+ * @brief 编译模式列表：按行或未转义的分号拆分，解析转义后建立自动机。
+ */
+WatchList WatchList::Compile(const std::string& spec)
+{
+	WatchList list;
+	std::string text;
+	for (size_t i = 0; i <= spec.size(); ++i)
+	{
+		const bool end = i == spec.size() || spec[i] == '\n' || spec[i] == ';';
+		if (!end)
+		{
+			text.push_back(spec[i]);
+			if (spec[i] == '\\' && i + 1 < spec.size())
+			{
+				text.push_back(spec[++i]);
+			}
+			continue;
+		}
+		const std::string entry = Trim(text);
+		text.clear();
+		if (entry.empty() || entry[0] == '#')
+		{
+			continue;
+		}
+		Entry pattern;
+		pattern.text = entry;
+		pattern.bytes = Unescape(entry);
+		list.m_patterns.push_back(std::move(pattern));
+		list.m_source += entry;
+		list.m_source += '\n';
+	}
+	list.Build();
+	return list;
+}
+
+/**
+ * @brief 建立自动机。
+ *
+ * 先为出现在模式中的每个字节分配一个字节类，再按字节类建立字典树；
+ * 然后按广度优先的顺序计算失败链接，缺失的转移直接取失败状态的转移，得到完整的 DFA，
+ * 每个状态的输出为自身结尾的模式加上失败状态的输出。最后把目标状态换算为行起始下标并标记有输出的状态。
+ */
+void WatchList::Build()
+{
+	std::fill(std::begin(m_classes), std::end(m_classes), uint16_t(0));
+	m_classCount = 1;
+	for (const Entry& pattern : m_patterns)
+	{
+		for (const char c : pattern.bytes)
+		{
+			uint16_t& cls = m_classes[static_cast<uint8_t>(c)];
+			if (cls == 0)
+			{
+				cls = static_cast<uint16_t>(m_classCount++);
+			}
+		}
+	}
+	const size_t classes = m_classCount;
+
+	// 字典树，-1 表示没有转移
+	std::vector<int32_t> next(classes, -1);
+	std::vector<std::vector<int>> own(1);
+	for (size_t p = 0; p < m_patterns.size(); ++p)
+	{
+		const std::string& bytes = m_patterns[p].bytes;
+		if (bytes.empty())
+		{
+			throw std::invalid_argument("Empty watch pattern '" + m_patterns[p].text + "'.");
+		}
+		size_t state = 0;
+		for (const char c : bytes)
+		{
+			int32_t& target = next[state * classes + m_classes[static_cast<uint8_t>(c)]];
+			if (target < 0)
+			{
+				if ((own.size() + 1) * classes > kMaxTableEntries)
+				{
+					throw std::invalid_argument("Watch list too large: more than " + std::to_string(kMaxTableEntries)
+						+ " transitions, use fewer or shorter patterns.");
+				}
+				target = static_cast<int32_t>(own.size());
+				own.emplace_back();
+				next.resize(own.size() * classes, -1);
+			}
+			state = static_cast<size_t>(next[state * classes + m_classes[static_cast<uint8_t>(c)]]);
+		}
+		own[state].push_back(static_cast<int>(p));
+	}
+	m_stateCount = own.size();
+
+	// 广度优先计算失败链接并补全转移
+	std::vector<int32_t> fail(m_stateCount, 0);
+	std::vector<int32_t> order;
+	order.reserve(m_stateCount);
+	for (size_t c = 0; c < classes; ++c)
+	{
+		int32_t& target = next[c];
+		if (target < 0)
+		{
+			target = 0;
+		}
+		else
+		{
+			fail[static_cast<size_t>(target)] = 0;
+			order.push_back(target);
+		}
+	}
+	for (size_t head = 0; head < order.size(); ++head)
+	{
+		const size_t state = static_cast<size_t>(order[head]);
+		const size_t failRow = static_cast<size_t>(fail[state]) * classes;
+		for (size_t c = 0; c < classes; ++c)
+		{
+			int32_t& target = next[state * classes + c];
+			if (target < 0)
+			{
+				target = next[failRow + c];
+			}
+			else
+			{
+				fail[static_cast<size_t>(target)] = next[failRow + c];
+				order.push_back(target);
+			}
+		}
+	}
+
+	// 输出按广度优先顺序合并，失败状态总是更浅，已经合并完成
+	std::vector<std::vector<int>> outputs(m_stateCount);
+	for (const int32_t s : order)
+	{
+		const size_t state = static_cast<size_t>(s);
+		outputs[state] = own[state];
+		const std::vector<int>& inherited = outputs[static_cast<size_t>(fail[state])];
+		outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+	}
+	m_outBegin.assign(m_stateCount + 1, 0);
+	m_outputs.clear();
+	for (size_t state = 0; state < m_stateCount; ++state)
+	{
+		m_outBegin[state] = static_cast<uint32_t>(m_outputs.size());
+		m_outputs.insert(m_outputs.end(), outputs[state].begin(), outputs[state].end());
+	}
+	m_outBegin[m_stateCount] = static_cast<uint32_t>(m_outputs.size());
+
+	m_table.resize(next.size());
+	for (size_t i = 0; i < next.size(); ++i)
+	{
+		const size_t target = static_cast<size_t>(next[i]);
+		const int32_t row = static_cast<int32_t>(target * classes);
+		m_table[i] = outputs[target].empty() ? row : ~row;
+	}
+	m_streams.clear();
+}
+
+/**
+ * @brief 扫描一个数据块，内层循环每个字节一次查表；到达有输出的状态时才进入 Report。
+ */
+void WatchList::Scan(int stream, ByteSpan chunk, int64_t timeNs)
+{
+	if (m_patterns.empty() || stream < 0)
+	{
+		return;
+	}
+	if (static_cast<size_t>(stream) >= m_streams.size())
+	{
+		m_streams.resize(static_cast<size_t>(stream) + 1);
+	}
+	Stream& state = m_streams[static_cast<size_t>(stream)];
+	const int32_t* table = m_table.data();
+	const uint16_t* classes = m_classes;
+	const uint8_t* data = reinterpret_cast<const uint8_t*>(chunk.data());
+	const size_t size = chunk.size();
+	int32_t row = state.row;
+	for (size_t i = 0; i < size; ++i)
+	{
+		const int32_t target = table[row + classes[data[i]]];
+		if (target < 0)
+		{
+			row = ~target;
+			Report(row, stream, state.offset + i + 1, timeNs);
+		}
+		else
+		{
+			row = target;
+		}
+	}
+	state.row = row;
+	state.offset += size;
+	m_scanned += size;
+}
+
+/**
+ * @brief 报告到达 row 所在状态时结束的所有模式。
+ * @param end 匹配最后一个字节之后的数据流偏移。
+ */
+void WatchList::Report(int32_t row, int stream, uint64_t end, int64_t timeNs)
+{
+	const size_t state = static_cast<size_t>(row) / m_classCount;
+	for (uint32_t i = m_outBegin[state]; i < m_outBegin[state + 1]; ++i)
+	{
+		const int pattern = m_outputs[i];
+		Entry& entry = m_patterns[static_cast<size_t>(pattern)];
+		++entry.count;
+		++m_hits;
+		if (m_handler)
+		{
+			m_handler(WatchHit{ pattern, stream, end - entry.bytes.size(), timeNs });
+		}
+	}
+}
+
+void WatchList::Reset(int stream)
+{
+	if (stream >= 0 && static_cast<size_t>(stream) < m_streams.size())
+	{
+		m_streams[static_cast<size_t>(stream)].row = 0;
+	}
+}
+
+void WatchList::Reset()
+{
+	for (Stream& stream : m_streams)
+	{
+		stream.row = 0;
+	}
+}
+
+size_t WatchList::TableBytes() const
+{
+	return m_table.size() * sizeof(int32_t) + m_outBegin.size() * sizeof(uint32_t) + m_outputs.size() * sizeof(int);
+}
+
+std::string WatchList::Format(const WatchHit& hit) const
+{
+	char text[96];
+	std::snprintf(text, sizeof(text), "%.6f WATCH ", hit.timeNs / 1e9);
+	std::string line = text;
+	line += Pattern(hit.pattern);
+	std::snprintf(text, sizeof(text), " port=%d offset=%llu", hit.stream, static_cast<unsigned long long>(hit.offset));
+	line += text;
+	return line;
+}
+
+std::string WatchList::FormatCounts(size_t limit) const
+{
+	std::vector<int> order;
+	for (size_t p = 0; p < m_patterns.size(); ++p)
+	{
+		if (m_patterns[p].count > 0)
+		{
+			order.push_back(static_cast<int>(p));
+		}
+	}
+	std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return Count(a) > Count(b); });
+	std::string text;
+	for (size_t i = 0; i < order.size() && i < limit; ++i)
+	{
+		if (!text.empty())
+		{
+			text += ' ';
+		}
+		text += Pattern(order[i]) + "=" + std::to_string(Count(order[i]));
+	}
+	return text;
+}
@@ -0,0 +1,148 @@
+/*
+ * @Description: 原始接收数据的多模式监视列表，所有模式编译为一个 Aho-Corasick 自动机，一次扫描找出全部匹配
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-19 00:50:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief 一次匹配。
+ */
+struct WatchHit
+{
+	int pattern;     /**< 模式序号，文本见 WatchList::Pattern。 */
+	int stream;      /**< 数据流编号，通常为串口序号。 */
+	uint64_t offset; /**< 匹配的第一个字节在数据流中的偏移。 */
+	int64_t timeNs;  /**< 包含匹配结尾的数据块的接收时间。 */
+};
+
+/**
+ * @brief WatchList 在原始接收字节流中查找一组固定字符串，例如 "ERR"、"WDT reset" 或故障码。
+ *
+ * 模式文本每行（或以分号分隔）一个，首尾空白被忽略，'#' 开头的行为注释；
+ * 支持转义 \n \r \t \\ \; 和 \xHH，首尾的空格写作 \x20。
+ *
+ * 编译时所有模式建成一个 Aho-Corasick 自动机，失败链接预先展开为完整的状态转移表（DFA），
+ * 每个状态的输出也预先合并了后缀上的所有模式。字节先映射为字节类——不出现在任何模式中的字节共用一类，
+ * 转移表只有 状态数 x 字节类数 项，几百个模式通常只有几百 KB。转移表中保存的是目标行的起始下标，
+ * 有输出的状态取反表示，扫描每个字节只做一次查表和一次符号判断，与模式数量无关。
+ *
+ * 每个数据流保存自己的当前状态，跨数据块的匹配照常找到；重叠的匹配和互为子串的模式都会分别报告。
+ * 匹配在 Scan 内同步回调，并计入每个模式的计数。
+ */
+class WatchList
+{
+public:
+	using Handler = std::function<void(const WatchHit&)>;
+
+	/**
+	 * @brief 编译模式列表，空文本得到没有模式的列表。
+	 * @throw std::invalid_argument 如果转义无效、模式为空或自动机过大。
+	 */
+	static WatchList Compile(const std::string& spec);
+
+	/**
+	 * @brief 设置匹配回调，在调用 Scan 的线程中调用。
+	 */
+	void SetHandler(Handler handler) { m_handler = std::move(handler); }
+
+	/**
+	 * @brief 扫描一个数据块。
+	 * @param stream 数据流编号，从 0 开始。
+	 * @param chunk 收到的原始字节。
+	 * @param timeNs 数据块的接收时间。
+	 */
+	void Scan(int stream, ByteSpan chunk, int64_t timeNs);
+
+	/**
+	 * @brief 丢弃数据流中正在匹配的前缀，例如串口重新打开后，之前的半行不应与新数据拼成匹配。
+	 */
+	void Reset(int stream);
+
+	/**
+	 * @brief 丢弃所有数据流的匹配状态，计数保留。
+	 */
+	void Reset();
+
+	bool IsEmpty() const { return m_patterns.empty(); }
+	size_t PatternCount() const { return m_patterns.size(); }
+
+	/**
+	 * @brief 模式的原文（转义形式）。
+	 */
+	const std::string& Pattern(int pattern) const { return m_patterns[static_cast<size_t>(pattern)].text; }
+
+	/**
+	 * @brief 模式的累计匹配次数。
+	 */
+	uint64_t Count(int pattern) const { return m_patterns[static_cast<size_t>(pattern)].count; }
+
+	uint64_t TotalHits() const { return m_hits; }
+	uint64_t ScannedBytes() const { return m_scanned; }
+	size_t StateCount() const { return m_stateCount; }
+	size_t ClassCount() const { return m_classCount; }
+
+	/**
+	 * @brief 转移表和输出表占用的内存（字节）。
+	 */
+	size_t TableBytes() const;
+
+	/**
+	 * @brief 模式原文，每行一个。
+	 */
+	const std::string& Source() const { return m_source; }
+
+	/**
+	 * @brief 把匹配格式化为一行文本：秒数 WATCH 模式 port=串口 offset=偏移。
+	 */
+	std::string Format(const WatchHit& hit) const;
+
+	/**
+	 * @brief 匹配次数最多的 limit 个模式，格式为 "模式=次数" 以空格分隔，没有匹配时为空。
+	 */
+	std::string FormatCounts(size_t limit = 10) const;
+
+private:
+	/**
+	 * @brief 一个模式。
+	 */
+	struct Entry
+	{
+		std::string text;    /**< 原文。 */
+		std::string bytes;   /**< 转义后的字节。 */
+		uint64_t count = 0;  /**< 累计匹配次数。 */
+	};
+
+	/**
+	 * @brief 一个数据流的扫描状态。
+	 */
+	struct Stream
+	{
+		int32_t row = 0;      /**< 当前状态在转移表中的起始下标。 */
+		uint64_t offset = 0;  /**< 已扫描的字节数。 */
+	};
+
+	static std::string Unescape(const std::string& text);
+	void Build();
+	void Report(int32_t row, int stream, uint64_t end, int64_t timeNs);
+
+	std::vector<Entry> m_patterns;       /**< 所有模式。 */
+	uint16_t m_classes[256] = {};        /**< 字节到字节类的映射，0 为不出现在任何模式中的字节。 */
+	size_t m_classCount = 1;             /**< 字节类数量。 */
+	size_t m_stateCount = 1;             /**< 状态数量，0 为根。 */
+	std::vector<int32_t> m_table;        /**< 转移表，每个状态一行，取值为目标行的起始下标，有输出的状态取反。 */
+	std::vector<uint32_t> m_outBegin;    /**< 状态 s 的输出为 m_outputs[m_outBegin[s], m_outBegin[s + 1])。 */
+	std::vector<int> m_outputs;          /**< 各状态输出的模式序号。 */
+	std::vector<Stream> m_streams;       /**< 各数据流的扫描状态。 */
+	std::string m_source;                /**< 模式原文。 */
+	Handler m_handler;                   /**< 匹配回调。 */
+	uint64_t m_hits = 0;                 /**< 累计匹配次数。 */
+	uint64_t m_scanned = 0;              /**< 累计扫描的字节数。 */
+};
@@ -0,0 +1,290 @@
+/*
+ * @Description: XMODEM-1K / YMODEM 发送端协议状态机，不依赖 Qt，也不做任何 I/O
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 17:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#include "XmodemSender.h"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+	constexpr char kSoh = 0x01;
+	constexpr char kStx = 0x02;
+	constexpr char kEot = 0x04;
+	constexpr char kAck = 0x06;
+	constexpr char kNak = 0x15;
+	constexpr char kCan = 0x18;
+	constexpr char kCrcRequest = 'C';
+	constexpr char kPad = 0x1A;
+	constexpr size_t kSmallBlock = 128;
+	constexpr size_t kLargeBlock = 1024;
+
+	std::array<uint16_t, 256> MakeCrcTable()
+	{
+		std::array<uint16_t, 256> table{};
+		for (unsigned i = 0; i < 256; ++i)
+		{
+			uint16_t crc = static_cast<uint16_t>(i << 8);
+			for (int bit = 0; bit < 8; ++bit)
+			{
+				crc = static_cast<uint16_t>(crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1);
+			}
+			table[i] = crc;
+		}
+		return table;
+	}
+}
+
+uint16_t XmodemSender::Crc16(const char* data, size_t length)
+{
+	static const std::array<uint16_t, 256> table = MakeCrcTable();
+	uint16_t crc = 0;
+	for (size_t i = 0; i < length; ++i)
+	{
+		crc = static_cast<uint16_t>((crc << 8) ^ table[((crc >> 8) ^ static_cast<uint8_t>(data[i])) & 0xFF]);
+	}
+	return crc;
+}
+
+XmodemSender::XmodemSender(ByteSpan data, Variant variant, std::string fileName)
+	: m_data(data), m_variant(variant), m_fileName(std::move(fileName))
+{
+	m_packet.reserve(kLargeBlock + 5);
+}
+
+/**
+ * @brief 逐字节处理接收端的控制字符，与当前状态无关的字节直接忽略。
+ */
+void XmodemSender::OnReceive(ByteSpan input, std::string& out)
+{
+	for (const char c : input)
+	{
+		if (IsFinished())
+		{
+			return;
+		}
+		if (c == kCan)
+		{
+			if (m_lastWasCancel)
+			{
+				m_state = State::Failed;
+				m_error = "Cancelled by receiver.";
+				return;
+			}
+			m_lastWasCancel = true;
+			continue;
+		}
+		m_lastWasCancel = false;
+
+		switch (m_state)
+		{
+		case State::WaitStart:
+			if (c == kCrcRequest)
+			{
+				m_retries = 0;
+				if (m_variant == Variant::Ymodem)
+				{
+					BuildHeader(false);
+					m_state = State::SendingHeader;
+				}
+				else if (m_data.empty())
+				{
+					m_packet.assign(1, kEot);
+					m_state = State::WaitEotAck;
+				}
+				else
+				{
+					BuildData();
+					m_state = State::Sending;
+				}
+				out += m_packet;
+			}
+			break;
+
+		case State::SendingHeader:
+			if (c == kAck)
+			{
+				m_retries = 0;
+				m_state = State::WaitDataStart;
+			}
+			else if (c == kNak)
+			{
+				Resend(out);
+			}
+			break;
+
+		case State::WaitDataStart:
+			if (c == kCrcRequest)
+			{
+				if (m_data.empty())
+				{
+					m_packet.assign(1, kEot);
+					m_state = State::WaitEotAck;
+				}
+				else
+				{
+					BuildData();
+					m_state = State::Sending;
+				}
+				out += m_packet;
+			}
+			break;
+
+		case State::Sending:
+			if (c == kAck)
+			{
+				m_retries = 0;
+				m_offset += m_blockLength;
+				++m_blockNumber;
+				if (m_offset >= m_data.size())
+				{
+					m_packet.assign(1, kEot);
+					m_state = State::WaitEotAck;
+				}
+				else
+				{
+					BuildData();
+				}
+				out += m_packet;
+			}
+			else if (c == kNak)
+			{
+				Resend(out);
+			}
+			break;
+
+		case State::WaitEotAck:
+			if (c == kAck)
+			{
+				m_retries = 0;
+				m_state = m_variant == Variant::Ymodem ? State::WaitFinalStart : State::Done;
+			}
+			else if (c == kNak)
+			{
+				// 很多接收端对第一个 EOT 回复 NAK，以确认不是线路噪声
+				Resend(out);
+			}
+			break;
+
+		case State::WaitFinalStart:
+			if (c == kCrcRequest)
+			{
+				BuildHeader(true);
+				m_state = State::WaitFinalAck;
+				out += m_packet;
+			}
+			break;
+
+		case State::WaitFinalAck:
+			if (c == kAck)
+			{
+				m_state = State::Done;
+			}
+			else if (c == kNak)
+			{
+				Resend(out);
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+void XmodemSender::OnTimeout(std::string& out)
+{
+	switch (m_state)
+	{
+	case State::WaitStart:
+	case State::WaitDataStart:
+	case State::WaitFinalStart:
+		if (++m_retries > kMaxRetries)
+		{
+			Fail("Receiver did not respond.", out);
+		}
+		break;
+	case State::Done:
+	case State::Failed:
+		break;
+	default:
+		Resend(out);
+		break;
+	}
+}
+
+void XmodemSender::Cancel(std::string& out)
+{
+	if (!IsFinished())
+	{
+		Fail("Cancelled.", out);
+	}
+}
+
+/**
+ * @brief 构造 YMODEM 0 号块：文件名、'\0'、十进制长度，其余填 0。
+ * @param empty 为 true 时构造结束批次用的全 0 块。
+ */
+void XmodemSender::BuildHeader(bool empty)
+{
+	std::string payload;
+	if (!empty)
+	{
+		payload = m_fileName;
+		payload.push_back('\0');
+		payload += std::to_string(m_data.size());
+	}
+	const size_t blockSize = payload.size() + 1 > kSmallBlock ? kLargeBlock : kSmallBlock;
+	payload.resize(blockSize, '\0');
+
+	m_packet.assign(1, blockSize == kLargeBlock ? kStx : kSoh);
+	m_packet.push_back(0);
+	m_packet.push_back(static_cast<char>(0xFF));
+	m_packet += payload.substr(0, blockSize);
+	AppendCrc(3);
+}
+
+/**
+ * @brief 从 m_offset 开始构造一个数据块，不足一块的部分用 0x1A 填充。
+ */
+void XmodemSender::BuildData()
+{
+	const size_t remaining = m_data.size() - m_offset;
+	const size_t blockSize = remaining > kSmallBlock ? kLargeBlock : kSmallBlock;
+	m_blockLength = std::min(remaining, blockSize);
+
+	m_packet.assign(1, blockSize == kLargeBlock ? kStx : kSoh);
+	m_packet.push_back(static_cast<char>(m_blockNumber));
+	m_packet.push_back(static_cast<char>(~m_blockNumber));
+	m_packet.append(m_data.data() + m_offset, m_blockLength);
+	m_packet.append(blockSize - m_blockLength, kPad);
+	AppendCrc(3);
+}
+
+void XmodemSender::AppendCrc(size_t payloadBegin)
+{
+	const uint16_t crc = Crc16(m_packet.data() + payloadBegin, m_packet.size() - payloadBegin);
+	m_packet.push_back(static_cast<char>(crc >> 8));
+	m_packet.push_back(static_cast<char>(crc & 0xFF));
+}
+
+void XmodemSender::Resend(std::string& out)
+{
+	++m_totalRetries;
+	if (++m_retries > kMaxRetries)
+	{
+		Fail("Too many retries.", out);
+		return;
+	}
+	out += m_packet;
+}
+
+void XmodemSender::Fail(std::string error, std::string& out)
+{
+	out.append(3, kCan);
+	m_state = State::Failed;
+	m_error = std::move(error);
+}
@@ -0,0 +1,124 @@
+/*
+ * @Description: XMODEM-1K / YMODEM 发送端协议状态机，不依赖 Qt，也不做任何 I/O
+ * @Version: v1.0.0
+ * @Author: isidore-chen
+ * @Date: 2026-10-18 17:30:00
+ * @Copyright: Copyright (c) 2026 CAUC
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include "ProtocolDecoder.h"
+
+/**
+ * @brief XmodemSender 实现 XMODEM-1K 与 YMODEM（单文件）发送端。
+ *
+ * 调用方把接收端发来的控制字符交给 OnReceive，把超时交给 OnTimeout，
+ * 两者都把需要写到串口的数据追加到 out 中。数据块直接从调用方给出的内存
+ * （通常是文件映射）复制到包缓冲，只使用 CRC16 校验模式。
+ * 剩余数据不超过 128 字节时使用 128 字节的 SOH 块，减少最后一块的填充。
+ */
+class XmodemSender
+{
+public:
+	/**
+	 * @brief 协议变体。
+	 */
+	enum class Variant
+	{
+		Xmodem1k, /**< 收到 'C' 后直接发送数据块。 */
+		Ymodem    /**< 先发送包含文件名和长度的 0 号块，结束时发送空的 0 号块。 */
+	};
+
+	/**
+	 * @brief 发送状态。
+	 */
+	enum class State
+	{
+		WaitStart,      /**< 等待接收端的 'C'。 */
+		SendingHeader,  /**< YMODEM 0 号块已发送，等待 ACK。 */
+		WaitDataStart,  /**< YMODEM 0 号块已确认，等待第二个 'C'。 */
+		Sending,        /**< 数据块已发送，等待 ACK/NAK。 */
+		WaitEotAck,     /**< EOT 已发送，等待 ACK。 */
+		WaitFinalStart, /**< YMODEM 等待结束批次前的 'C'。 */
+		WaitFinalAck,   /**< YMODEM 空 0 号块已发送，等待 ACK。 */
+		Done,           /**< 发送完成。 */
+		Failed          /**< 发送失败或被取消。 */
+	};
+
+	/**
+	 * @brief 同一个数据包连续重发或等待的最大次数。
+	 */
+	static constexpr unsigned kMaxRetries = 10;
+
+	/**
+	 * @brief 构造函数。
+	 * @param data 要发送的数据，在发送结束前必须保持有效。
+	 * @param variant 协议变体。
+	 * @param fileName YMODEM 0 号块中的文件名。
+	 */
+	XmodemSender(ByteSpan data, Variant variant, std::string fileName = std::string());
+
+	/**
+	 * @brief 处理接收端发来的数据。
+	 * @param input 接收到的数据。
+	 * @param out 需要发送的数据追加到这里。
+	 */
+	void OnReceive(ByteSpan input, std::string& out);
+
+	/**
+	 * @brief 处理一次超时：等待开始时计数，发送中则重发当前数据包。
+	 * @param out 需要发送的数据追加到这里。
+	 */
+	void OnTimeout(std::string& out);
+
+	/**
+	 * @brief 取消发送，向接收端发送 CAN 序列。
+	 * @param out 需要发送的数据追加到这里。
+	 */
+	void Cancel(std::string& out);
+
+	State GetState() const { return m_state; }
+	bool IsFinished() const { return m_state == State::Done || m_state == State::Failed; }
+
+	/**
+	 * @brief 已被接收端确认的数据字节数。
+	 */
+	size_t AckedBytes() const { return m_offset; }
+	size_t TotalBytes() const { return m_data.size(); }
+
+	/**
+	 * @brief 累计重发次数。
+	 */
+	unsigned Retries() const { return m_totalRetries; }
+
+	/**
+	 * @brief 失败原因，成功时为空。
+	 */
+	const std::string& Error() const { return m_error; }
+
+	/**
+	 * @brief CRC16-CCITT（多项式 0x1021，初值 0），XMODEM CRC 模式使用的校验。
+	 */
+	static uint16_t Crc16(const char* data, size_t length);
+
+private:
+	void BuildHeader(bool empty);
+	void BuildData();
+	void AppendCrc(size_t payloadBegin);
+	void Resend(std::string& out);
+	void Fail(std::string error, std::string& out);
+
+	ByteSpan m_data;                 /**< 要发送的数据。 */
+	Variant m_variant;               /**< 协议变体。 */
+	std::string m_fileName;          /**< YMODEM 文件名。 */
+	State m_state = State::WaitStart; /**< 当前状态。 */
+	std::string m_packet;            /**< 当前数据包，重发时原样写出。 */
+	size_t m_offset = 0;             /**< 已确认的数据偏移。 */
+	size_t m_blockLength = 0;        /**< 当前数据块携带的有效数据长度。 */
+	uint8_t m_blockNumber = 1;       /**< 下一个数据块的块号。 */
+	unsigned m_retries = 0;          /**< 当前数据包的重发次数。 */
+	unsigned m_totalRetries = 0;     /**< 累计重发次数。 */
+	bool m_lastWasCancel = false;    /**< 上一个字节是否为 CAN，连续两个 CAN 表示取消。 */
+	std::string m_error;             /**< 失败原因。 */
+};